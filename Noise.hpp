@@ -13,7 +13,9 @@ namespace Noise {
     enum class OutputMode {
         None,   // Just return the noise map, don't display or save
         Image,  // Save as image file
-        Map     // Display preview in terminal (WhiteNoise only)
+        Map,    // Display preview in terminal (WhiteNoise only)
+        Raw,    // Save the full-precision float32 map as a .rnm file (see RawMap.hpp)
+        Mmap    // Generate straight into a memory-mapped .rnm file (no intermediate map)
     };
 }
 
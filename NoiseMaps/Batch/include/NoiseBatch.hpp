@@ -0,0 +1,97 @@
+// NoiseBatch.hpp
+// --------------
+// Batch generation: many maps (seeds x parameter sets, any mix of generators) in
+// one call. Setup is shared across the batch: Perlin / Simplex permutation tables
+// are built once per distinct seed, pink scratch buffers once per worker, and
+// jobs are spread over one thread pool (largest first) instead of one parallel
+// call each. Maps come back in job order or are written to disk as they finish.
+//
+// Usage:
+//   std::vector<Noise::BatchJob> jobs;
+//   for (int seed = 0; seed < 64; ++seed)
+//       jobs.push_back(Noise::BatchJob::perlin(512, 512, seed, params));
+//   jobs.push_back(Noise::BatchJob::pink(1024, 1024, 7, {}, "pink7.png"));   // saved
+//   jobs.push_back(Noise::BatchJob::simplex(4096, 4096, 3, {}, "big.rnm"));  // mapped file
+//
+//   std::vector<Noise::BatchResult> results = Noise::generate_batch(jobs);
+
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Noise.hpp"
+#include "NoiseMap.hpp"
+#include "GenerateOptions.hpp"
+#include "ImageOutput.hpp"
+
+namespace Noise {
+
+    class ThreadPool;
+
+    enum class BatchNoise {
+        White,
+        Perlin,
+        Simplex,
+        Pink
+    };
+
+    struct BatchJob {
+        BatchNoise kind = BatchNoise::Perlin;
+        int width = 256;
+        int height = 256;
+        int seed = -1;               // -1 = random (never shares a permutation table)
+        PerlinParams perlinParams;   // used when kind == Perlin
+        SimplexParams simplexParams; // used when kind == Simplex
+        PinkParams pinkParams;       // used when kind == Pink
+        // Empty: the map is returned. Otherwise the map is written to outputDir /
+        // filename: .rnm files are generated in place through a mapping (float32),
+        // anything else is saved as an image (format from the extension).
+        std::string filename;
+        std::string outputDir;       // empty = default ImageOutput/ directory
+
+        static BatchJob white(int width, int height, int seed, const std::string& filename = "");
+        static BatchJob perlin(int width, int height, int seed, const PerlinParams& params, const std::string& filename = "");
+        static BatchJob simplex(int width, int height, int seed, const SimplexParams& params, const std::string& filename = "");
+        static BatchJob pink(int width, int height, int seed, const PinkParams& params, const std::string& filename = "");
+    };
+
+    struct BatchOptions {
+        unsigned threads = 0;       // workers for the whole batch (0 = library default)
+        ThreadPool* pool = nullptr; // nullptr = default_thread_pool()
+        // Per-job generator settings; threads and pool are replaced by the ones above
+        GenerateOptions generate;
+        ImageSaveOptions image;     // for image jobs (JPEG quality 0 = 90, pink 95)
+        bool keepMaps = false;      // also return the maps of jobs written to disk
+    };
+
+    struct BatchResult {
+        NoiseMap map;               // empty for jobs written to disk unless keepMaps
+        std::filesystem::path file; // written file, empty for in-memory jobs
+    };
+
+    // Failure of one batch job. what() is "batch job <i>: " plus the job's own
+    // message; the job's exception itself, with its type, is nested
+    // (std::rethrow_if_nested(e) rethrows it).
+    class BatchJobError : public std::runtime_error {
+    public:
+        BatchJobError(std::size_t job, const std::string& message)
+            : std::runtime_error("batch job " + std::to_string(job) + ": " + message), job_(job) {}
+
+        std::size_t job() const noexcept { return job_; }
+
+    private:
+        std::size_t job_;
+    };
+
+    // Runs every job and returns one result per job, in job order. The maps equal
+    // those of the single-map generators with the same arguments. Workers claim
+    // jobs largest first; a job running while others are idle spreads its tiles
+    // over them. Sizes are checked up front (std::invalid_argument). The first
+    // failing job stops the batch: no further jobs start, and a BatchJobError
+    // holding its exception is thrown. A cancelled batch (Cancellation.hpp)
+    // throws GenerationCancelled itself.
+    std::vector<BatchResult> generate_batch(const std::vector<BatchJob>& jobs, const BatchOptions& options = {});
+
+} // namespace Noise
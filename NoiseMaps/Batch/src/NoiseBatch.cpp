@@ -0,0 +1,237 @@
+// NoiseBatch.cpp
+#include "NoiseBatch.hpp"
+#include "Cancellation.hpp"
+#include "RawMap.hpp"
+#include "ThreadPool.hpp"
+#include "TileScheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace Noise {
+
+    // ---------------------------------------------------------
+    // Job factories
+    // ---------------------------------------------------------
+    static BatchJob make_job(BatchNoise kind, int width, int height, int seed, const std::string& filename) {
+        BatchJob job;
+        job.kind = kind;
+        job.width = width;
+        job.height = height;
+        job.seed = seed;
+        job.filename = filename;
+        return job;
+    }
+
+    BatchJob BatchJob::white(int width, int height, int seed, const std::string& filename) {
+        return make_job(BatchNoise::White, width, height, seed, filename);
+    }
+
+    BatchJob BatchJob::perlin(int width, int height, int seed, const PerlinParams& params, const std::string& filename) {
+        BatchJob job = make_job(BatchNoise::Perlin, width, height, seed, filename);
+        job.perlinParams = params;
+        return job;
+    }
+
+    BatchJob BatchJob::simplex(int width, int height, int seed, const SimplexParams& params, const std::string& filename) {
+        BatchJob job = make_job(BatchNoise::Simplex, width, height, seed, filename);
+        job.simplexParams = params;
+        return job;
+    }
+
+    BatchJob BatchJob::pink(int width, int height, int seed, const PinkParams& params, const std::string& filename) {
+        BatchJob job = make_job(BatchNoise::Pink, width, height, seed, filename);
+        job.pinkParams = params;
+        return job;
+    }
+
+    // ---------------------------------------------------------
+    // Shared setup
+    // ---------------------------------------------------------
+    // One generator per distinct seed >= 0, built in parallel before any job runs
+    template <typename Generator>
+    class GeneratorTable {
+    public:
+        void build(const std::vector<BatchJob>& jobs, BatchNoise kind, unsigned threads, ThreadPool* pool) {
+            std::vector<int> seeds;
+            for (const BatchJob& job : jobs) {
+                if (job.kind == kind && job.seed >= 0 && index_.emplace(job.seed, seeds.size()).second)
+                    seeds.push_back(job.seed);
+            }
+            generators_.resize(seeds.size());
+            parallel_for_tiles(static_cast<int>(seeds.size()), 1, 1, 1, threads, pool, [&](const Tile& t) {
+                generators_[static_cast<std::size_t>(t.x)] = std::make_unique<Generator>(seeds[static_cast<std::size_t>(t.x)]);
+            });
+        }
+
+        // The shared generator of `seed`, or nullptr (random seeds)
+        const Generator* find(int seed) const {
+            const auto it = index_.find(seed);
+            return it == index_.end() ? nullptr : generators_[it->second].get();
+        }
+
+    private:
+        std::unordered_map<int, std::size_t> index_;
+        std::vector<std::unique_ptr<Generator>> generators_;
+    };
+
+    // Scratch owned by one batch worker, reused by every job it runs
+    struct BatchWorker {
+        PinkWorkspace pinkWorkspace;
+        NoiseMap scratch; // image jobs whose map is not returned
+    };
+
+    static bool is_raw_file(const std::string& filename) {
+        std::string extension = std::filesystem::path(filename).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension == ".rnm";
+    }
+
+    // Throws the failure of job `index` as a BatchJobError with the job's
+    // exception nested
+    [[noreturn]] static void rethrow_job_error(std::exception_ptr error, std::size_t index) {
+        try {
+            std::rethrow_exception(error);
+        }
+        catch (const GenerationCancelled&) {
+            throw; // cancellation is the caller's request, not a failure of the job
+        }
+        catch (const std::exception& e) {
+            std::throw_with_nested(BatchJobError(index, e.what()));
+        }
+        catch (...) {
+            std::throw_with_nested(BatchJobError(index, "unknown exception"));
+        }
+    }
+
+    // ---------------------------------------------------------
+    // Batch runner
+    // ---------------------------------------------------------
+    std::vector<BatchResult> generate_batch(const std::vector<BatchJob>& jobs, const BatchOptions& options) {
+        // Sizes are checked before any work starts; parameter errors come from the job itself
+        for (std::size_t i = 0; i < jobs.size(); ++i) {
+            if (jobs[i].width <= 0 || jobs[i].height <= 0)
+                throw std::invalid_argument("batch job " + std::to_string(i) + ": width/height must be > 0, got: " +
+                    std::to_string(jobs[i].width) + "x" + std::to_string(jobs[i].height));
+        }
+
+        std::vector<BatchResult> results(jobs.size());
+        if (jobs.empty()) return results;
+
+        ThreadPool& pool = options.pool ? *options.pool : default_thread_pool();
+        GenerateOptions generate = options.generate;
+        generate.threads = options.threads;
+        generate.pool = &pool;
+        ImageSaveOptions image = options.image;
+        if (!image.pool) {
+            image.pool = &pool;
+            image.threads = options.threads;
+        }
+
+        GeneratorTable<PerlinNoise> perlinTable;
+        GeneratorTable<SimplexNoise> simplexTable;
+        perlinTable.build(jobs, BatchNoise::Perlin, options.threads, &pool);
+        simplexTable.build(jobs, BatchNoise::Simplex, options.threads, &pool);
+
+        // Largest jobs first, so the batch does not end on one big straggler
+        std::vector<std::size_t> order(jobs.size());
+        std::iota(order.begin(), order.end(), std::size_t{ 0 });
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return static_cast<long long>(jobs[a].width) * jobs[a].height > static_cast<long long>(jobs[b].width) * jobs[b].height;
+        });
+
+        auto fill = [&](const BatchJob& job, BatchWorker& worker, float* dst, std::size_t stride) {
+            switch (job.kind) {
+            case BatchNoise::White:
+                WhiteNoise::generate_into(dst, stride, job.width, job.height, job.seed, generate);
+                break;
+            case BatchNoise::Perlin: {
+                const PerlinParams& p = job.perlinParams;
+                const PerlinNoise* generator = perlinTable.find(job.seed);
+                std::unique_ptr<PerlinNoise> own; // random seed: a table of its own
+                if (!generator) generator = (own = std::make_unique<PerlinNoise>(job.seed)).get();
+                generate_perlin_into(*generator, dst, stride, job.width, job.height,
+                    p.scale, p.octaves, p.frequency, p.persistence, p.lacunarity, p.base, generate);
+                break;
+            }
+            case BatchNoise::Simplex: {
+                const SimplexParams& p = job.simplexParams;
+                const SimplexNoise* generator = simplexTable.find(job.seed);
+                std::unique_ptr<SimplexNoise> own;
+                if (!generator) generator = (own = std::make_unique<SimplexNoise>(job.seed)).get();
+                generate_simplex_into(*generator, dst, stride, job.width, job.height,
+                    p.scale, p.octaves, p.persistence, p.lacunarity, p.base, generate);
+                break;
+            }
+            case BatchNoise::Pink: {
+                const PinkParams& p = job.pinkParams;
+                generate_pink_into(worker.pinkWorkspace, dst, stride, job.width, job.height,
+                    p.octaves, p.alpha, p.sampleRate, p.amplitude, job.seed, generate);
+                break;
+            }
+            }
+        };
+
+        auto run_job = [&](const BatchJob& job, BatchWorker& worker, BatchResult& result) {
+            throw_if_cancelled();
+            if (job.filename.empty()) {
+                result.map = NoiseMap(job.width, job.height);
+                fill(job, worker, result.map.data(), result.map.stride());
+                return;
+            }
+            result.file = resolve_image_path(job.filename, job.outputDir);
+            if (is_raw_file(job.filename)) {
+                MappedRawMap mapped = MappedRawMap::generate(result.file, job.width, job.height, [&](float* dst, std::size_t stride) {
+                    fill(job, worker, dst, stride);
+                });
+                if (options.keepMaps) result.map = mapped.to_noisemap();
+                return;
+            }
+            NoiseMap& map = options.keepMaps ? result.map : worker.scratch;
+            if (map.width() != job.width || map.height() != job.height) map = NoiseMap(job.width, job.height);
+            fill(job, worker, map.data(), map.stride());
+            ImageSaveOptions saveOptions = image;
+            if (job.kind == BatchNoise::Pink && saveOptions.jpegQuality == 0) saveOptions.jpegQuality = 95;
+            save_noise_image(map, job.filename, job.outputDir, saveOptions);
+        };
+
+        // Workers claim jobs until none are left or one has failed
+        const unsigned participants = static_cast<unsigned>(std::min<std::size_t>(
+            std::min(resolve_thread_count(options.threads), pool.size()), jobs.size()));
+        std::vector<BatchWorker> workers(participants);
+        std::atomic<std::size_t> next{ 0 };
+        std::atomic<bool> failed{ false };
+        std::exception_ptr error;
+        std::size_t errorJob = 0;
+        std::mutex errorMutex;
+
+        pool.run(participants, [&](unsigned w) {
+            BatchWorker& worker = workers[w];
+            for (std::size_t k; !failed.load(std::memory_order_relaxed) && (k = next.fetch_add(1)) < order.size();) {
+                const std::size_t index = order[k];
+                try {
+                    run_job(jobs[index], worker, results[index]);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) {
+                        error = std::current_exception();
+                        errorJob = index;
+                    }
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+        });
+        if (error) rethrow_job_error(error, errorJob);
+        return results;
+    }
+
+} // namespace Noise
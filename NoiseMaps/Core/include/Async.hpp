@@ -0,0 +1,97 @@
+// Async.hpp
+// ---------
+// Non-blocking generation on the library's thread pool. generate_async queues
+// any generator call as a prioritized job of ThreadPool::post and returns at
+// once with a future for its result and a cancel() of its own. The job runs
+// under a CancelScope (Cancellation.hpp): cancelling it stops a queued job
+// before it starts and a running one before its next tile, and its get() then
+// throws GenerationCancelled. The call inside the job may still use the pool's
+// other workers for its tiles.
+//
+// Usage:
+//   Noise::AsyncResult<Noise::NoiseMap> chunk = Noise::generate_async(
+//       [&perlin, params, cx, cy] { return Noise::generate_perlin_chunk(perlin, params, cx, cy, 256); },
+//       { 10 });                              // priority 10
+//   ...
+//   if (player_left) chunk.cancel();          // stale request: stop wasting cores on it
+//   else send(chunk.get());                   // value, or the job's exception
+
+#pragma once
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "Cancellation.hpp"
+#include "ThreadPool.hpp"
+
+namespace Noise {
+
+    struct AsyncOptions {
+        int priority = 0;           // queued jobs with a higher priority start first
+        ThreadPool* pool = nullptr; // pool to queue on; nullptr = default_thread_pool()
+    };
+
+    template <typename T>
+    class AsyncResult {
+    public:
+        AsyncResult() = default;
+        AsyncResult(std::future<T> future, CancelToken token) : future_(std::move(future)), token_(std::move(token)) {}
+
+        // Waits for the job: its value, or its exception (GenerationCancelled once
+        // cancelled). Like std::future::get, callable once.
+        T get() { return future_.get(); }
+        void wait() const { future_.wait(); }
+        bool ready() const { return future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+        bool valid() const { return future_.valid(); }
+
+        // Asks the job to stop; it returns at its next tile boundary
+        void cancel() const noexcept { token_.cancel(); }
+        const CancelToken& token() const { return token_; }
+
+        std::future<T>& future() { return future_; }
+
+    private:
+        std::future<T> future_;
+        CancelToken token_;
+    };
+
+    namespace detail {
+        template <typename T, typename Fn>
+        void fulfil(std::promise<T>& promise, Fn& fn) { promise.set_value(fn()); }
+
+        template <typename Fn>
+        void fulfil(std::promise<void>& promise, Fn& fn) {
+            fn();
+            promise.set_value();
+        }
+    }
+
+    // Queues fn() on options.pool and returns its result handle. fn is moved into
+    // the job, so everything it references must outlive the job.
+    template <typename Fn>
+    AsyncResult<std::invoke_result_t<std::decay_t<Fn>&>> generate_async(Fn&& fn, const AsyncOptions& options = {}) {
+        using F = std::decay_t<Fn>;
+        using T = std::invoke_result_t<F&>;
+        // shared so the job stays copyable for std::function whatever fn captures
+        auto job = std::make_shared<F>(std::forward<Fn>(fn));
+        auto promise = std::make_shared<std::promise<T>>();
+        AsyncResult<T> result(promise->get_future(), CancelToken());
+        const CancelToken token = result.token();
+
+        ThreadPool& pool = options.pool ? *options.pool : default_thread_pool();
+        pool.post([job, promise, token] {
+            try {
+                if (token.cancelled()) throw GenerationCancelled();
+                const CancelScope scope(token);
+                detail::fulfil(*promise, *job);
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        }, options.priority);
+        return result;
+    }
+
+} // namespace Noise
@@ -0,0 +1,65 @@
+// Cancellation.hpp
+// ----------------
+// Cooperative cancellation of map generation. Generators called while a
+// CancelScope is active check its token before every tile, on every thread
+// they use, and between pink octaves; once the token is cancelled they throw
+// GenerationCancelled. The output of a cancelled call is incomplete.
+// generate_async (Async.hpp) installs the scope for its jobs.
+//
+// Usage:
+//   Noise::CancelToken token;                 // copies share the flag
+//   std::thread worker([token] {
+//       Noise::CancelScope scope(token);
+//       auto map = Noise::generate_perlin_chunk(perlin, params, cx, cy, 512);
+//   });
+//   token.cancel();                           // worker throws Noise::GenerationCancelled
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+namespace Noise {
+
+    class GenerationCancelled : public std::runtime_error {
+    public:
+        GenerationCancelled() : std::runtime_error("generation cancelled") {}
+    };
+
+    class CancelToken {
+    public:
+        CancelToken() : flag_(std::make_shared<std::atomic<bool>>(false)) {}
+
+        void cancel() const noexcept { flag_->store(true, std::memory_order_relaxed); }
+        bool cancelled() const noexcept { return flag_->load(std::memory_order_relaxed); }
+
+    private:
+        friend class CancelScope;
+        std::shared_ptr<std::atomic<bool>> flag_;
+    };
+
+    // Makes `token` the calling thread's token until destroyed (scopes nest)
+    class CancelScope {
+    public:
+        explicit CancelScope(const CancelToken& token);
+        ~CancelScope();
+
+        CancelScope(const CancelScope&) = delete;
+        CancelScope& operator=(const CancelScope&) = delete;
+
+    private:
+        std::shared_ptr<std::atomic<bool>> flag_;
+        const std::atomic<bool>* previous_;
+    };
+
+    // Throws GenerationCancelled if the calling thread's token is cancelled
+    void throw_if_cancelled();
+
+    namespace detail {
+        // The calling thread's flag (nullptr outside any scope); ThreadPool::run
+        // hands it to its workers with exchange_cancel_flag
+        const std::atomic<bool>* current_cancel_flag() noexcept;
+        const std::atomic<bool>* exchange_cancel_flag(const std::atomic<bool>* flag) noexcept;
+    }
+
+} // namespace Noise
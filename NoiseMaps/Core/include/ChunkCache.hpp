@@ -0,0 +1,115 @@
+// ChunkCache.hpp
+// --------------
+// Thread-safe, memory-bounded LRU cache for generated chunks. Entries are
+// shared_ptr<const NoiseMap>: a hit hands out the cached map itself (no copy),
+// and evicting an entry never invalidates maps that callers still hold.
+//
+// Usage:
+//   Noise::ChunkCache cache(256u << 20);                 // 256 MiB budget
+//   auto chunk = Noise::generate_perlin_chunk_cached(cache, 42, params, cx, cy, 256);
+//   auto s = cache.stats();                             // hits / misses / bytes ...
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include "NoiseMap.hpp"
+
+namespace Noise {
+
+    // Identifies one chunk: generator kind, seed, the exact parameter values and the
+    // chunk coordinates. Parameters are stored bit for bit (not just hashed), so two
+    // keys only compare equal when they would generate the same chunk.
+    struct ChunkKey {
+        std::uint32_t generator = 0;          // generator kind tag, see ChunkGenerator
+        std::int32_t seed = 0;
+        std::array<std::uint32_t, 8> params{}; // raw parameter bits, unused slots zero
+        std::int64_t chunkX = 0;
+        std::int64_t chunkY = 0;
+        std::int32_t chunkSize = 0;
+
+        // Stores params[slot] from a float (bit pattern) or an integer
+        void set_param(std::size_t slot, float value) { std::memcpy(&params[slot], &value, sizeof(value)); }
+        void set_param(std::size_t slot, std::int32_t value) { std::memcpy(&params[slot], &value, sizeof(value)); }
+
+        bool operator==(const ChunkKey& o) const {
+            return generator == o.generator && seed == o.seed && params == o.params &&
+                chunkX == o.chunkX && chunkY == o.chunkY && chunkSize == o.chunkSize;
+        }
+        bool operator!=(const ChunkKey& o) const { return !(*this == o); }
+    };
+
+    // Generator kind tags used in ChunkKey::generator
+    enum class ChunkGenerator : std::uint32_t {
+        Perlin = 1,
+        Simplex = 2
+    };
+
+    struct ChunkKeyHash {
+        std::size_t operator()(const ChunkKey& key) const noexcept;
+    };
+
+    class ChunkCache {
+    public:
+        using MapPtr = std::shared_ptr<const NoiseMap>;
+
+        struct Stats {
+            std::uint64_t hits = 0;
+            std::uint64_t misses = 0;
+            std::uint64_t evictions = 0;
+            std::size_t bytes = 0;   // NoiseMap storage currently held
+            std::size_t entries = 0;
+        };
+
+        // byteBudget bounds the summed NoiseMap::size_bytes() of cached entries
+        explicit ChunkCache(std::size_t byteBudget);
+
+        ChunkCache(const ChunkCache&) = delete;
+        ChunkCache& operator=(const ChunkCache&) = delete;
+
+        // Cached chunk or nullptr; a hit marks the entry most recently used
+        MapPtr find(const ChunkKey& key);
+
+        // Caches `map` under `key` (evicting least recently used entries to stay within
+        // the budget) and returns it. If the key is already cached the existing entry
+        // wins and is returned. Maps larger than the whole budget are returned uncached.
+        MapPtr insert(const ChunkKey& key, NoiseMap&& map);
+
+        // find(), or on a miss make() -> NoiseMap and insert(). make() runs without the
+        // cache lock held, so concurrent misses on one key may both generate; the
+        // first insert is kept.
+        template <typename Make>
+        MapPtr get_or_create(const ChunkKey& key, Make&& make) {
+            if (MapPtr hit = find(key)) return hit;
+            return insert(key, make());
+        }
+
+        void set_budget(std::size_t byteBudget);
+        std::size_t budget() const;
+
+        void clear();
+        Stats stats() const;
+        void reset_stats();
+
+    private:
+        struct Entry {
+            ChunkKey key;
+            MapPtr map;
+        };
+
+        void evict_to(std::size_t byteBudget);
+
+        mutable std::mutex mutex_;
+        std::list<Entry> lru_; // front = most recently used
+        std::unordered_map<ChunkKey, std::list<Entry>::iterator, ChunkKeyHash> index_;
+        std::size_t budget_ = 0;
+        Stats stats_;
+    };
+
+} // namespace Noise
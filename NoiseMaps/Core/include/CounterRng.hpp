@@ -0,0 +1,47 @@
+// CounterRng.hpp
+// --------------
+// Counter-based random numbers (Philox2x32-10, Salmon et al. 2011): the value at
+// pixel (x, y) for a seed is a pure function of (seed, x, y). No generator state
+// is carried from pixel to pixel, so any pixel, row or tile can be produced
+// independently, in parallel and with SIMD, and still match a serial run.
+//
+// Usage:
+//   float v = Noise::counter_uniform(seed, x, y);             // [0,1)
+//   Noise::counter_uniform_row(seed, y, 0, row, width);       // whole row at once
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Noise {
+
+    // Philox2x32 constants (Random123)
+    constexpr std::uint32_t kPhiloxM = 0xD256D193u;
+    constexpr std::uint32_t kPhiloxW = 0x9E3779B9u;
+    constexpr int kPhiloxRounds = 10;
+
+    // Philox2x32-10 block: encrypts the counter (c0, c1) under `key`, in place
+    inline void philox2x32(std::uint32_t& c0, std::uint32_t& c1, std::uint32_t key) noexcept {
+        for (int r = 0; r < kPhiloxRounds; ++r) {
+            const std::uint64_t prod = static_cast<std::uint64_t>(kPhiloxM) * c0;
+            const std::uint32_t hi = static_cast<std::uint32_t>(prod >> 32);
+            const std::uint32_t lo = static_cast<std::uint32_t>(prod);
+            c0 = hi ^ key ^ c1;
+            c1 = lo;
+            key += kPhiloxW;
+        }
+    }
+
+    // Uniform float in [0,1) (24 random bits) for pixel (x, y) under `seed`
+    inline float counter_uniform(std::uint32_t seed, std::uint32_t x, std::uint32_t y) noexcept {
+        std::uint32_t c0 = x;
+        std::uint32_t c1 = y;
+        philox2x32(c0, c1, seed);
+        return static_cast<float>(c0 >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // out[i] = counter_uniform(seed, x0 + i, y) for i < count; AVX2 / NEON kernels
+    // are picked at runtime and give the same values as the scalar path
+    void counter_uniform_row(std::uint32_t seed, std::uint32_t y, std::uint32_t x0, float* out, std::size_t count);
+
+} // namespace Noise
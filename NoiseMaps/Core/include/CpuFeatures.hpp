@@ -0,0 +1,118 @@
+// CpuFeatures.hpp
+// ---------------
+// Runtime CPU feature detection used to pick SIMD kernels at startup, so the
+// default (baseline ISA) build still runs AVX2 / AVX-512 / NEON code where the
+// host supports it, and never executes unsupported instructions where it doesn't.
+//
+// Every SIMD loop reaches its kernel through a KernelTable, which picks the
+// variant for the active ISA tier: the best one the host supports, lowered with
+// the RELNO_SIMD environment variable (scalar, sse2, avx2, avx512, neon) or
+// force_simd_isa(), e.g. to compare tiers in a benchmark. All tiers produce
+// bit-identical results.
+//
+// Usage:
+//   if (Noise::cpu_features().avx2) { ... }
+//   Noise::force_simd_isa(Noise::SimdIsa::SSE2);    // throws if unsupported
+//   std::cout << Noise::simd_isa_name(Noise::active_simd_isa());
+
+#pragma once
+#include <cstddef>
+
+// Architecture helpers
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RELNO_ARCH_X86 1
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define RELNO_ARCH_ARM64 1
+#endif
+
+// Per-function ISA targets: lets one translation unit, compiled for the baseline
+// ISA, contain SSE2 (not baseline on 32-bit x86) / AVX2 / AVX-512 kernels. MSVC
+// accepts the intrinsics without flags.
+#if defined(RELNO_ARCH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define RELNO_TARGET_SSE2 __attribute__((target("sse2")))
+#define RELNO_TARGET_AVX2 __attribute__((target("avx2")))
+#define RELNO_TARGET_AVX512 __attribute__((target("avx512f")))
+#define RELNO_TARGET_F16C __attribute__((target("avx,f16c")))
+#else
+#define RELNO_TARGET_SSE2
+#define RELNO_TARGET_AVX2
+#define RELNO_TARGET_AVX512
+#define RELNO_TARGET_F16C
+#endif
+
+namespace Noise {
+
+    struct CpuFeatures {
+        bool sse2 = false;
+        bool avx2 = false;    // includes OS support for the YMM state
+        bool avx512f = false; // includes OS support for the ZMM / opmask state
+        bool f16c = false;
+        bool fma = false;
+        bool neon = false;
+    };
+
+    // Detected once on first use; thread-safe
+    const CpuFeatures& cpu_features();
+
+    // ---------------------------------------------------------
+    // Kernel dispatch
+    // ---------------------------------------------------------
+    // Instruction set tiers, lowest first (NEON is the only tier above Scalar on ARM)
+    enum class SimdIsa {
+        Scalar,
+        SSE2,
+        AVX2,   // AVX2 kernels; the half-float kernels also need F16C
+        AVX512, // AVX-512F
+        NEON
+    };
+
+    // "scalar", "sse2", "avx2", "avx512", "neon"
+    const char* simd_isa_name(SimdIsa isa) noexcept;
+
+    // Highest tier the host supports
+    SimdIsa best_simd_isa();
+
+    bool simd_isa_supported(SimdIsa isa);
+
+    // Tier the kernels dispatch on: best_simd_isa(), or the RELNO_SIMD environment
+    // variable when it names a lower supported tier (read once, at first use)
+    SimdIsa active_simd_isa();
+
+    // Dispatches every kernel on `isa` from now on (best_simd_isa() restores the
+    // default). Throws std::invalid_argument when the host does not support it.
+    // Meant for benchmarks and tests: do not call while another thread generates.
+    void force_simd_isa(SimdIsa isa);
+
+    // One kernel in every variant a build has; nullptr marks a variant that was
+    // not compiled (or needs a feature beyond its tier the host lacks), and
+    // dispatch falls back to the next lower tier. A null `scalar` means the caller
+    // runs its own scalar loop when get() returns nullptr.
+    template <typename Fn>
+    struct KernelTable {
+        Fn scalar = nullptr;
+        Fn sse2 = nullptr;
+        Fn avx2 = nullptr;
+        Fn avx512 = nullptr;
+        Fn neon = nullptr;
+
+        Fn select(SimdIsa isa) const {
+            switch (isa) {
+            case SimdIsa::AVX512: if (avx512) return avx512; [[fallthrough]];
+            case SimdIsa::AVX2: if (avx2) return avx2; [[fallthrough]];
+            case SimdIsa::SSE2: if (sse2) return sse2; break;
+            case SimdIsa::NEON: if (neon) return neon; break;
+            case SimdIsa::Scalar: break;
+            }
+            return scalar;
+        }
+
+        // Kernel for the active tier
+        Fn get() const { return select(active_simd_isa()); }
+    };
+
+    // Per-core L2 data cache size in bytes, queried once from the OS
+    // (falls back to 1 MiB when the OS does not report it)
+    std::size_t l2_cache_bytes();
+
+} // namespace Noise
@@ -0,0 +1,215 @@
+// FractalNoise.hpp
+// ----------------
+// Compile-time specialized fractal (multi-octave) sums over a base noise. The
+// octave count and the persistence / lacunarity preset are template arguments,
+// so the amplitude table and its total are constants and the octave loop is
+// unrolled around the base's SIMD batch kernel. Results are bit-identical to the
+// runtime generate_perlin_* / generate_simplex_* loops with the same values;
+// those dispatch here on their own when the arguments match a built-in preset
+// (1..8 octaves at persistence 0.5, lacunarity 2).
+//
+// Gains are a type because float template arguments need C++20. Code built
+// outside the library should also use -ffp-contract=off (as NoiseMaps does) to
+// stay bit-identical: a contracted multiply-add rounds differently.
+//
+// Usage:
+//   Noise::PerlinNoise perlin(42);
+//   Noise::FractalNoise<Noise::PerlinNoise, 6> fbm(perlin);
+//   fbm.generate_into(dst, stride, 0, 0, width, height, 40.0f, 1.0f, 0.0f);
+//
+//   struct Rough { static constexpr float persistence = 0.7f, lacunarity = 2.5f; };
+//   Noise::NoiseMap map = Noise::FractalNoise<Noise::SimplexNoise, 4, Rough>(simplex).generate(512, 512, 40.0f);
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "GenerateOptions.hpp"
+#include "NoiseMap.hpp"
+#include "TileScheduler.hpp"
+
+namespace Noise {
+
+    // How a base noise is sampled and normalized; specialized next to each base
+    // (PerlinNoise.hpp, SimplexNoise.hpp) with
+    //   static void noise_batch(const Base&, const float* x, const float* y, float* out, std::size_t count);
+    //   static float normalize(float sum, float maxAmplitude);   // octave sum -> [0, 1]
+    template <typename Base>
+    struct FractalTraits;
+
+    // Persistence 0.5, lacunarity 2 (each octave half as strong, twice as fine)
+    struct DefaultFractalGains {
+        static constexpr float persistence = 0.5f;
+        static constexpr float lacunarity = 2.0f;
+    };
+
+    // Amplitude of every octave and their sum, accumulated in the same order (and
+    // so with the same rounding) as the runtime loops
+    template <int Octaves, typename Gains = DefaultFractalGains>
+    struct FractalSpectrum {
+        static_assert(Octaves >= 1, "Octaves must be >= 1");
+        static_assert(Gains::persistence >= 0.0f && Gains::persistence <= 1.0f, "persistence must be in [0, 1]");
+        static_assert(Gains::lacunarity > 0.0f, "lacunarity must be > 0");
+
+        static constexpr std::array<float, Octaves> amplitudes() {
+            std::array<float, Octaves> a{};
+            float amplitude = 1.0f;
+            for (int o = 0; o < Octaves; ++o) {
+                a[static_cast<std::size_t>(o)] = amplitude;
+                amplitude *= Gains::persistence;
+            }
+            return a;
+        }
+
+        static constexpr float max_amplitude() {
+            float sum = 0.0f;
+            for (float a : amplitudes()) sum += a;
+            return sum;
+        }
+    };
+
+    template <typename Base, int Octaves, typename Gains = DefaultFractalGains>
+    class FractalNoise {
+    public:
+        using Spectrum = FractalSpectrum<Octaves, Gains>;
+
+        // `noise` must outlive this object
+        explicit FractalNoise(const Base& noise) : noise_(noise) {}
+
+        // Window of the fractal plane with top-left world pixel (originX, originY):
+        // octave o samples ((world + base) / scale) * frequency * lacunarity^o
+        void generate_into(
+            float* dst,
+            std::size_t stride,
+            std::int64_t originX,
+            std::int64_t originY,
+            int width,
+            int height,
+            float scale,
+            float frequency = 1.0f,
+            float base = 0.0f,
+            const GenerateOptions& options = {}
+        ) const {
+            if (width <= 0 || height <= 0)
+                throw std::invalid_argument("width/height must be > 0, got: " + std::to_string(width) + "x" + std::to_string(height));
+            if (scale <= 0.0f)
+                throw std::invalid_argument("scale must be > 0, got: " + std::to_string(scale));
+            if (frequency <= 0.0f)
+                throw std::invalid_argument("frequency must be > 0, got: " + std::to_string(frequency));
+            if (!dst)
+                throw std::invalid_argument("dst must not be null");
+            if (stride < static_cast<std::size_t>(width))
+                throw std::invalid_argument("stride must be >= width, got: " + std::to_string(stride));
+
+            // Same running product as the runtime loops (frequency is a call argument)
+            std::array<float, Octaves> frequencies{};
+            float freq = frequency;
+            for (int o = 0; o < Octaves; ++o) {
+                frequencies[static_cast<std::size_t>(o)] = freq;
+                freq *= Gains::lacunarity;
+            }
+
+            parallel_for_tiles(width, height, options.tileSize, options.tileSize, options.threads, options.pool, [&](const Tile& tile) {
+                for (int y = tile.y; y < tile.y + tile.height; ++y) {
+                    // (world + base) / scale does not depend on the octave: divide once
+                    const float ty = (static_cast<float>(originY + y) + base) / scale;
+                    float* row = dst + static_cast<std::size_t>(y) * stride;
+                    for (int x0 = tile.x; x0 < tile.x + tile.width; x0 += kChunk) {
+                        const int n = std::min(kChunk, tile.x + tile.width - x0);
+                        fill_chunk(row + x0, originX + x0, n, ty, frequencies, base, scale, std::make_integer_sequence<int, Octaves>{});
+                    }
+                }
+            });
+        }
+
+        NoiseMap generate(
+            int width,
+            int height,
+            float scale,
+            float frequency = 1.0f,
+            float base = 0.0f,
+            const GenerateOptions& options = {}
+        ) const {
+            NoiseMap map(width, height);
+            generate_into(map.data(), map.stride(), 0, 0, width, height, scale, frequency, base, options);
+            return map;
+        }
+
+    private:
+        static constexpr int kChunk = 64;
+
+        template <int... O>
+        void fill_chunk(float* out, std::int64_t worldX, int n, float ty, const std::array<float, Octaves>& frequencies,
+            float base, float scale, std::integer_sequence<int, O...>) const {
+            static constexpr std::array<float, Octaves> amplitudes = Spectrum::amplitudes();
+            alignas(64) float tx[kChunk];
+            alignas(64) float xs[kChunk * Octaves];
+            alignas(64) float ys[kChunk * Octaves];
+            alignas(64) float vals[kChunk * Octaves];
+            alignas(64) float acc[kChunk];
+            // A short tail chunk still fills all kChunk lanes (the pixels after it);
+            // lanes are independent and only the first n are stored
+            for (int i = 0; i < kChunk; ++i) {
+                tx[i] = (static_cast<float>(worldX + i) + base) / scale;
+                acc[i] = 0.0f;
+            }
+            // Every octave of the chunk goes through one kernel call
+            auto place = [&](int o, float freq) {
+                float* x = xs + o * kChunk;
+                float* y = ys + o * kChunk;
+                for (int i = 0; i < kChunk; ++i) {
+                    x[i] = tx[i] * freq;
+                    y[i] = ty * freq;
+                }
+            };
+            (place(O, frequencies[O]), ...);
+            FractalTraits<Base>::noise_batch(noise_, xs, ys, vals, static_cast<std::size_t>(kChunk) * Octaves);
+            auto accumulate = [&](int o, float amplitude) {
+                const float* v = vals + o * kChunk;
+                for (int i = 0; i < kChunk; ++i)
+                    acc[i] += v[i] * amplitude;
+            };
+            (accumulate(O, amplitudes[O]), ...); // unrolled, octave 0 first
+            constexpr float maxAmplitude = Spectrum::max_amplitude();
+            for (int i = 0; i < n; ++i)
+                out[i] = FractalTraits<Base>::normalize(acc[i], maxAmplitude);
+        }
+
+        const Base& noise_;
+    };
+
+    // Signature of a FractalNoise<Base, N, Gains>::generate_into specialization
+    template <typename Base>
+    using FractalPresetFn = void (*)(const Base& noise, float* dst, std::size_t stride, std::int64_t originX, std::int64_t originY,
+        int width, int height, float scale, float frequency, float base, const GenerateOptions& options);
+
+    namespace detail {
+        template <typename Base, int Octaves>
+        void run_fractal_preset(const Base& noise, float* dst, std::size_t stride, std::int64_t originX, std::int64_t originY,
+            int width, int height, float scale, float frequency, float base, const GenerateOptions& options) {
+            FractalNoise<Base, Octaves>(noise).generate_into(dst, stride, originX, originY, width, height, scale, frequency, base, options);
+        }
+
+        template <typename Base, int... O>
+        constexpr std::array<FractalPresetFn<Base>, sizeof...(O)> fractal_preset_table(std::integer_sequence<int, O...>) {
+            return { &run_fractal_preset<Base, O + 1>... };
+        }
+    }
+
+    constexpr int kMaxFractalPresetOctaves = 8;
+
+    // The built-in specialization for (octaves, persistence, lacunarity), or nullptr
+    // when the runtime loop has to be used
+    template <typename Base>
+    FractalPresetFn<Base> find_fractal_preset(int octaves, float persistence, float lacunarity) {
+        static constexpr auto table = detail::fractal_preset_table<Base>(std::make_integer_sequence<int, kMaxFractalPresetOctaves>{});
+        if (persistence != DefaultFractalGains::persistence || lacunarity != DefaultFractalGains::lacunarity) return nullptr;
+        if (octaves < 1 || octaves > kMaxFractalPresetOctaves) return nullptr;
+        return table[static_cast<std::size_t>(octaves - 1)];
+    }
+
+} // namespace Noise
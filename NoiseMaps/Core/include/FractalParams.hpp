@@ -0,0 +1,63 @@
+// FractalParams.hpp
+// -----------------
+// Runtime fractal settings shared by the front ends built on the generators
+// (NoiseGraph, ProgressiveNoise, GpuNoise): one place for argument validation,
+// the amplitude total and the Simplex -> Perlin parameter mapping. Templates,
+// because the parameter structs live with their generators (PerlinParams in
+// PerlinNoise.hpp, SimplexParams in SimplexNoise.hpp) and Core cannot see them.
+//
+// Usage:
+//   Noise::validate_fractal_params(perlinParams);                        // throws std::invalid_argument
+//   const float maxAmplitude = Noise::max_amplitude(perlinParams);
+//   const Noise::PerlinParams p = Noise::as_fractal_params<Noise::PerlinParams>(simplexParams);
+
+#pragma once
+#include <stdexcept>
+#include <string>
+
+namespace Noise {
+
+    // Same checks and messages as the generators; Fractal has the PerlinParams
+    // fields (scale, octaves, frequency, persistence, lacunarity)
+    template <typename Fractal>
+    void validate_fractal_params(const Fractal& p) {
+        if (p.scale <= 0.0f)
+            throw std::invalid_argument("scale must be > 0, got: " + std::to_string(p.scale));
+        if (p.octaves < 1)
+            throw std::invalid_argument("octaves must be >= 1, got: " + std::to_string(p.octaves));
+        if (p.frequency <= 0.0f)
+            throw std::invalid_argument("frequency must be > 0, got: " + std::to_string(p.frequency));
+        if (p.persistence < 0.0f || p.persistence > 1.0f)
+            throw std::invalid_argument("persistence must be in [0,1], got: " + std::to_string(p.persistence));
+        if (p.lacunarity <= 0.0f)
+            throw std::invalid_argument("lacunarity must be > 0, got: " + std::to_string(p.lacunarity));
+    }
+
+    // Sum of the octave amplitudes, accumulated in the same order (and so with the
+    // same rounding) as the generators' normalization
+    template <typename Fractal>
+    float max_amplitude(const Fractal& p) {
+        float maxAmplitude = 0.0f;
+        float amplitude = 1.0f;
+        for (int o = 0; o < p.octaves; ++o) {
+            maxAmplitude += amplitude;
+            amplitude *= p.persistence;
+        }
+        return maxAmplitude;
+    }
+
+    // SimplexParams as PerlinParams: the Simplex generators start every map at
+    // frequency 1
+    template <typename Fractal, typename Params>
+    Fractal as_fractal_params(const Params& params) {
+        Fractal p;
+        p.scale = params.scale;
+        p.octaves = params.octaves;
+        p.frequency = 1.0f;
+        p.persistence = params.persistence;
+        p.lacunarity = params.lacunarity;
+        p.base = params.base;
+        return p;
+    }
+
+} // namespace Noise
@@ -0,0 +1,61 @@
+// GenerateOptions.hpp
+// -------------------
+// Optional execution settings accepted by the map generators. Defaults reproduce
+// the plain calls; apart from `rng` and `pinkStorage`, none of these settings
+// change the values.
+//
+// Usage:
+//   Noise::GenerateOptions opts;
+//   opts.threads = 4;
+//   auto map = Noise::generate_perlin_noisemap(4096, 4096, 40.0f, 6, 1.0f, 0.5f, 2.0f, 0.0f, 42, opts);
+
+#pragma once
+
+namespace Noise {
+
+    class ThreadPool;
+
+    // How multi-octave generators walk memory. Outside Layered, the built-in
+    // FractalNoise presets (FractalNoise.hpp) are used when the parameters match one.
+    enum class OctaveMode {
+        Auto,    // Fused when a layered pass (one tile) is larger than the L2 cache
+        Layered, // one pass per octave over each tile, then a normalization pass
+        Fused    // all octaves of a pixel run back to back; each pixel is written once
+    };
+
+    // Random source of white-noise pixels (WhiteNoise, PinkNoise white layers)
+    enum class RngBackend {
+        Mt19937, // one std::mt19937 stream in row-major order (the original output; serial)
+        Counter  // Philox2x32 keyed by (seed, x, y): parallel / SIMD, different values
+    };
+
+    // How PinkNoise reduces each octave's white layer to block means (same values either way)
+    enum class PinkEngine {
+        Auto,     // BlockGrid for octaves with blocks of 2+ pixels, Integral for 1-pixel blocks
+        Integral, // full-resolution layer, summed-area table and per-pixel box averages
+        BlockGrid // table columns at block corners only; block means splatted into the output
+    };
+
+    // What PinkNoise keeps its intermediate values in
+    enum class PinkStorage {
+        Float32, // float white layers, summed-area tables and full-map accumulator (the original output)
+        Compact  // 16-bit fixed-point white values and exact integer block sums, octaves summed
+                 // row by row: ~3.3 bytes per pixel besides the output instead of up to 12;
+                 // values differ by the float tables' rounding (see generate_pink_half_into)
+    };
+
+    struct GenerateOptions {
+        unsigned threads = 0;       // worker count; 0 = library default (see set_thread_count)
+        int tileSize = 64;          // edge of the square tiles handed to workers, in pixels
+        ThreadPool* pool = nullptr; // workers to run on; nullptr = default_thread_pool()
+        OctaveMode octaveMode = OctaveMode::Auto;
+        RngBackend rng = RngBackend::Mt19937;
+        PinkEngine pinkEngine = PinkEngine::Auto;
+        PinkStorage pinkStorage = PinkStorage::Float32;
+    };
+
+    // True when a width x height map cut into tileSize tiles should use the fused
+    // octave loop under `mode`
+    bool use_fused_octaves(OctaveMode mode, int width, int height, int tileSize);
+
+} // namespace Noise
@@ -0,0 +1,176 @@
+// NoiseMap.hpp
+// ------------
+// Contiguous, 64-byte aligned 2D storage shared by every noise generator.
+// One allocation per map (instead of one per row) and every row starts on a
+// 64-byte boundary, so rows can be handed straight to SIMD loops.
+//
+// Usage:
+//   Noise::NoiseMap map = Noise::generate_perlin_noisemap(512, 512, 40.0f, 5, 1.0f, 0.5f, 2.0f, 0.0f, 42);
+//   float v = map(x, y);
+//   for (float& px : map.row(y)) px *= 0.5f;
+
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "NoiseStats.hpp"
+
+namespace Noise {
+
+    // Raw aligned allocation helpers (defined in NoiseMap.cpp).
+    // aligned_allocate throws std::bad_alloc on failure; alignment must be a power of two.
+    void* aligned_allocate(std::size_t bytes, std::size_t alignment = 64);
+    void aligned_free(void* ptr) noexcept;
+
+    // Running totals of aligned_allocate calls (process-wide, relaxed counters);
+    // used by the benchmarks to report bytes allocated per generated map
+    struct AllocationStats {
+        std::uint64_t allocations = 0;
+        std::uint64_t bytes = 0;
+    };
+    AllocationStats aligned_allocation_stats() noexcept;
+
+    // Bytes aligned_allocate has handed out on the calling thread (NoiseStats
+    // attributes allocations to stages with it)
+    std::uint64_t thread_allocated_bytes() noexcept;
+
+    // aligned buffer RAII wrapper: `size` elements of T, zero initialized, 64-byte aligned
+    template <typename T>
+    struct BasicAlignedBuffer {
+        T* data = nullptr;
+        std::size_t size = 0; // number of elements
+
+        BasicAlignedBuffer() = default;
+        BasicAlignedBuffer(std::size_t n) : size(n) {
+            if (n == 0) return;
+            data = static_cast<T*>(aligned_allocate(n * sizeof(T)));
+            // zero initialize the usable bytes (not the padding)
+            std::memset(static_cast<void*>(data), 0, n * sizeof(T));
+        }
+        ~BasicAlignedBuffer() { aligned_free(data); }
+
+        BasicAlignedBuffer(const BasicAlignedBuffer&) = delete;
+        BasicAlignedBuffer& operator=(const BasicAlignedBuffer&) = delete;
+
+        BasicAlignedBuffer(BasicAlignedBuffer&& other) noexcept
+            : data(other.data), size(other.size) {
+            other.data = nullptr;
+            other.size = 0;
+        }
+
+        BasicAlignedBuffer& operator=(BasicAlignedBuffer&& other) noexcept {
+            if (this != &other) {
+                aligned_free(data);
+                // Steal ownership
+                data = other.data;
+                size = other.size;
+                other.data = nullptr;
+                other.size = 0;
+            }
+            return *this;
+        }
+
+        T* get() noexcept { return data; }
+        const T* get() const noexcept { return data; }
+    };
+
+    using AlignedBuffer = BasicAlignedBuffer<float>;
+
+    // Non-owning view of one map row (C++17 stand-in for std::span)
+    template <typename T>
+    struct RowSpan {
+        T* ptr = nullptr;
+        std::size_t count = 0;
+
+        T* data() const noexcept { return ptr; }
+        std::size_t size() const noexcept { return count; }
+        T* begin() const noexcept { return ptr; }
+        T* end() const noexcept { return ptr + count; }
+        T& operator[](std::size_t i) const noexcept { return ptr[i]; }
+    };
+
+    // Row-major 2D map. `stride` (in elements) is >= width and rounded up so
+    // that every row is 64-byte aligned; padding elements are zero.
+    template <typename T>
+    class BasicNoiseMap {
+    public:
+        static constexpr std::size_t alignment = 64;
+
+        BasicNoiseMap() = default;
+        BasicNoiseMap(int width, int height) {
+            if (width < 0 || height < 0)
+                throw std::invalid_argument("NoiseMap dimensions must be >= 0, got: " +
+                    std::to_string(width) + "x" + std::to_string(height));
+            width_ = width;
+            height_ = height;
+            stride_ = aligned_stride(width);
+            buffer_ = BasicAlignedBuffer<T>(stride_ * static_cast<std::size_t>(height));
+        }
+
+        // Row stride (in elements) that keeps every row of a `width` wide map 64-byte aligned
+        static std::size_t aligned_stride(int width) noexcept {
+            const std::size_t perLine = alignment / sizeof(T);
+            const std::size_t w = width > 0 ? static_cast<std::size_t>(width) : 0;
+            return (w + perLine - 1) / perLine * perLine;
+        }
+
+        int width() const noexcept { return width_; }
+        int height() const noexcept { return height_; }
+        std::size_t stride() const noexcept { return stride_; }
+        bool empty() const noexcept { return width_ == 0 || height_ == 0; }
+        std::size_t size_bytes() const noexcept { return buffer_.size * sizeof(T); }
+
+        T* data() noexcept { return buffer_.data; }
+        const T* data() const noexcept { return buffer_.data; }
+
+        RowSpan<T> row(int y) noexcept {
+            return { buffer_.data + static_cast<std::size_t>(y) * stride_, static_cast<std::size_t>(width_) };
+        }
+        RowSpan<const T> row(int y) const noexcept {
+            return { buffer_.data + static_cast<std::size_t>(y) * stride_, static_cast<std::size_t>(width_) };
+        }
+
+        T& operator()(int x, int y) noexcept { return buffer_.data[static_cast<std::size_t>(y) * stride_ + x]; }
+        const T& operator()(int x, int y) const noexcept { return buffer_.data[static_cast<std::size_t>(y) * stride_ + x]; }
+
+        // Copy into the legacy nested-vector layout ([height][width])
+        std::vector<std::vector<T>> to_vector() const {
+            const std::uint64_t pixels = static_cast<std::uint64_t>(width_) * static_cast<std::uint64_t>(height_);
+            const StageTimer timer(StatsStage::Convert, "map", pixels, 1, nullptr,
+                pixels * sizeof(T) + static_cast<std::uint64_t>(height_) * sizeof(std::vector<T>));
+            std::vector<std::vector<T>> out(height_, std::vector<T>(width_));
+            for (int y = 0; y < height_; ++y)
+                std::memcpy(out[y].data(), row(y).data(), sizeof(T) * static_cast<std::size_t>(width_));
+            return out;
+        }
+
+        // Copy from the legacy nested-vector layout; all rows must have the same length
+        static BasicNoiseMap from_vector(const std::vector<std::vector<T>>& rows) {
+            int height = static_cast<int>(rows.size());
+            int width = rows.empty() ? 0 : static_cast<int>(rows[0].size());
+            const StageTimer timer(StatsStage::Convert, "map", static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height));
+            BasicNoiseMap map(width, height);
+            for (int y = 0; y < height; ++y) {
+                if (static_cast<int>(rows[y].size()) != width)
+                    throw std::invalid_argument("NoiseMap::from_vector requires rows of equal length");
+                std::memcpy(map.row(y).data(), rows[y].data(), sizeof(T) * static_cast<std::size_t>(width));
+            }
+            return map;
+        }
+
+    private:
+        int width_ = 0;
+        int height_ = 0;
+        std::size_t stride_ = 0;
+        BasicAlignedBuffer<T> buffer_;
+    };
+
+    using NoiseMap = BasicNoiseMap<float>;
+
+    // IEEE binary16 samples (conversions in HalfFloat.hpp): half the memory of a NoiseMap
+    using HalfMap = BasicNoiseMap<std::uint16_t>;
+
+} // namespace Noise
@@ -0,0 +1,188 @@
+// NoiseStats.hpp
+// --------------
+// Optional instrumentation: per-stage wall time, pixels, bytes allocated and
+// worker count for every generator and export call, delivered to a StatsSink.
+// Nothing is measured while no sink is installed (the default); each stage then
+// costs one pointer check. Also holds the stream the save functions log their
+// "[OK] ... saved at" lines to, which can be redirected or silenced.
+//
+// Usage:
+//   Noise::StatsCollector stats;
+//   Noise::set_stats_sink(&stats);                 // every thread
+//   Noise::create_pinknoise(2048, 2048, 6, 1.0f, 44100, 1.0f, 7);
+//   double integral = stats.totals(Noise::StatsStage::Integral).seconds;
+//
+//   Noise::StatsCallback metrics([](const Noise::StageRecord& r) { export_metric(r); });
+//   Noise::ScopedStatsSink scope(metrics);         // this thread only, for one job
+//
+//   Noise::set_log_stream(nullptr);                // no "[OK] ... saved" lines
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <mutex>
+#include <utility>
+
+namespace Noise {
+
+    class ThreadPool;
+
+    enum class StatsStage {
+        Setup,      // generator / permutation setup, output and workspace allocation
+        Evaluate,   // noise evaluation: Perlin / Simplex octaves, white pixels, pink white layers, noise graphs
+        Integral,   // pink summed-area table (BlockGrid: corner columns, white values drawn on the fly)
+        BoxAverage, // pink block means (BlockGrid: splatted into the output with their weight)
+        Accumulate, // pink weighted octave sum, progressive / cached layer composition
+        Normalize,  // pink normalization and clamping
+        Convert,    // NoiseMap <-> nested std::vector copies
+        Quantize,   // float -> 8 / 16-bit samples
+        Encode,     // image / raw file encoding and writing (streamed exports: the whole pipeline)
+        Count
+    };
+
+    constexpr std::size_t kStatsStageCount = static_cast<std::size_t>(StatsStage::Count);
+
+    // "setup", "evaluate", "integral", ...
+    const char* stats_stage_name(StatsStage stage) noexcept;
+
+    // One finished stage of one call
+    struct StageRecord {
+        StatsStage stage = StatsStage::Setup;
+        const char* generator = "";     // "white", "perlin", "simplex", "pink", "progressive", "layers", "graph", "gpu", "map", "image" or "raw"
+        double seconds = 0.0;           // wall time
+        std::uint64_t pixels = 0;       // pixels the stage processed
+        std::uint64_t bytesAllocated = 0; // heap bytes the stage allocated
+        unsigned threads = 1;           // workers the stage could run on
+    };
+
+    // Receives records on the thread that made the call (generate_batch jobs: on
+    // the pool worker running the job), so a sink shared by several threads must
+    // be thread-safe. record() must not throw.
+    class StatsSink {
+    public:
+        virtual ~StatsSink() = default;
+        virtual void record(const StageRecord& stage) = 0;
+    };
+
+    // Forwards every record to a callback (e.g. a metrics exporter)
+    class StatsCallback : public StatsSink {
+    public:
+        explicit StatsCallback(std::function<void(const StageRecord&)> fn) : fn_(std::move(fn)) {}
+        void record(const StageRecord& stage) override { fn_(stage); }
+
+    private:
+        std::function<void(const StageRecord&)> fn_;
+    };
+
+    // Thread-safe running totals per stage
+    class StatsCollector : public StatsSink {
+    public:
+        struct Totals {
+            double seconds = 0.0;
+            std::uint64_t pixels = 0;
+            std::uint64_t bytesAllocated = 0;
+            std::uint64_t records = 0;
+            unsigned maxThreads = 0;
+        };
+
+        void record(const StageRecord& stage) override;
+        Totals totals(StatsStage stage) const;
+        std::array<Totals, kStatsStageCount> snapshot() const;
+        void reset();
+
+    private:
+        mutable std::mutex mutex_;
+        std::array<Totals, kStatsStageCount> totals_{};
+    };
+
+    // Process-wide sink (nullptr, the default, turns instrumentation off). The
+    // sink must stay alive until it is replaced.
+    void set_stats_sink(StatsSink* sink) noexcept;
+
+    // Installs `sink` for calls made on the current thread while in scope; it takes
+    // precedence over the process-wide sink. Scopes nest.
+    class ScopedStatsSink {
+    public:
+        explicit ScopedStatsSink(StatsSink& sink) noexcept;
+        ~ScopedStatsSink();
+        ScopedStatsSink(const ScopedStatsSink&) = delete;
+        ScopedStatsSink& operator=(const ScopedStatsSink&) = delete;
+
+    private:
+        StatsSink* previous_;
+    };
+
+    namespace detail {
+        extern std::atomic<StatsSink*> g_statsSink;
+        extern thread_local StatsSink* t_statsSink;
+    }
+
+    // The sink records of the current thread go to, or nullptr
+    inline StatsSink* stats_sink() noexcept {
+        if (StatsSink* local = detail::t_statsSink) return local;
+        return detail::g_statsSink.load(std::memory_order_acquire);
+    }
+
+    // Workers a call with (threads, pool) runs on, as parallel_for_tiles picks them
+    unsigned stats_thread_count(unsigned threads, ThreadPool* pool);
+
+    // Times one stage from construction to destruction and reports it to the
+    // current sink; does nothing (not even read the clock) without one. Bytes are
+    // the NoiseMap / aligned buffers allocated on this thread meanwhile, plus
+    // `bytesAllocated` and add_bytes() for other allocations. Stages left by an
+    // exception are not reported.
+    class StageTimer {
+    public:
+        StageTimer(StatsStage stage, const char* generator, std::uint64_t pixels,
+            unsigned threads = 1, ThreadPool* pool = nullptr, std::uint64_t bytesAllocated = 0) noexcept
+            : sink_(stats_sink()) {
+            if (!sink_) return;
+            start(stage, generator, pixels, threads, pool, bytesAllocated);
+        }
+
+        ~StageTimer() {
+            if (sink_) finish();
+        }
+
+        StageTimer(const StageTimer&) = delete;
+        StageTimer& operator=(const StageTimer&) = delete;
+
+        // Reports the stage now instead of at destruction
+        void stop() noexcept {
+            if (sink_) finish();
+            sink_ = nullptr;
+        }
+
+        bool active() const noexcept { return sink_ != nullptr; }
+        void add_bytes(std::uint64_t bytes) noexcept { record_.bytesAllocated += bytes; }
+
+    private:
+        void start(StatsStage stage, const char* generator, std::uint64_t pixels,
+            unsigned threads, ThreadPool* pool, std::uint64_t bytesAllocated) noexcept;
+        void finish() noexcept;
+
+        StatsSink* sink_;
+        StageRecord record_;
+        std::chrono::steady_clock::time_point start_{};
+        std::uint64_t allocatedAtStart_ = 0;
+        int uncaught_ = 0;
+    };
+
+    // Reports a stage measured by other means (no-op without a sink)
+    void record_stage(const StageRecord& stage) noexcept;
+
+    // ---------------------------------------------------------
+    // Log output
+    // ---------------------------------------------------------
+    // Stream of the save functions' "[OK] ... saved at: <path>" lines: std::cout by
+    // default, nullptr for none. The stream must outlive its use; writes from
+    // several threads are only as safe as the stream itself.
+    void set_log_stream(std::ostream* stream) noexcept;
+    std::ostream* log_stream() noexcept;
+
+} // namespace Noise
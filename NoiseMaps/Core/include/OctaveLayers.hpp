@@ -0,0 +1,156 @@
+// OctaveLayers.hpp
+// ----------------
+// Cached octave layers of a Perlin / Simplex fractal map. A layer only depends
+// on the seed, scale, frequency, lacunarity and base; persistence and the octave
+// count merely weight and select layers. Keeping every raw layer turns a change
+// of those two into one SIMD weighted sum over the layers, with no noise
+// evaluated. compose() equals the generate_perlin_* / generate_simplex_* maps
+// with the same arguments bit for bit. The pink equivalent is PinkLayers
+// (PinkNoise.hpp).
+//
+// Usage:
+//   Noise::PerlinNoise perlin(42);
+//   Noise::OctaveLayers<Noise::PerlinNoise> layers(perlin, 1024, 1024, 8, 40.0f);
+//   for (float p = 0.3f; p <= 0.8f; p += 0.01f)
+//       consume(layers.compose(p));         // == generate_perlin_noisemap(1024, 1024, 40, 8, 1, p, 2, 0, 42)
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "FractalNoise.hpp"
+#include "GenerateOptions.hpp"
+#include "NoiseMap.hpp"
+#include "NoiseStats.hpp"
+#include "TileScheduler.hpp"
+
+namespace Noise {
+
+    // dst[i] = ((0 + layers[0][i] * weights[0]) + layers[1][i] * weights[1]) + ...,
+    // i.e. the octave loops' accumulation, one pass over dst (SIMD, every tier
+    // bit-identical)
+    void weighted_sum(float* dst, const float* const* layers, const float* weights, std::size_t layerCount, std::size_t count);
+
+    template <typename Base>
+    class OctaveLayers {
+    public:
+        // Evaluates `octaves` raw layers: octave o samples ((x + base) / scale) *
+        // frequency * lacunarity^o, as the map generators do (Simplex maps start
+        // at frequency 1). `noise` is only used here.
+        OctaveLayers(
+            const Base& noise,
+            int width,
+            int height,
+            int octaves,
+            float scale,
+            float frequency = 1.0f,
+            float lacunarity = 2.0f,
+            float base = 0.0f,
+            const GenerateOptions& options = {}
+        ) {
+            if (width <= 0 || height <= 0)
+                throw std::invalid_argument("width/height must be > 0, got: " + std::to_string(width) + "x" + std::to_string(height));
+            if (octaves < 1)
+                throw std::invalid_argument("octaves must be >= 1, got: " + std::to_string(octaves));
+            if (scale <= 0.0f)
+                throw std::invalid_argument("scale must be > 0, got: " + std::to_string(scale));
+            if (frequency <= 0.0f)
+                throw std::invalid_argument("frequency must be > 0, got: " + std::to_string(frequency));
+            if (lacunarity <= 0.0f)
+                throw std::invalid_argument("lacunarity must be > 0, got: " + std::to_string(lacunarity));
+
+            {
+                const StageTimer timer(StatsStage::Setup, "layers", 0);
+                layers_.reserve(static_cast<std::size_t>(octaves));
+                for (int o = 0; o < octaves; ++o) layers_.emplace_back(width, height);
+            }
+            const StageTimer timer(StatsStage::Evaluate, "layers",
+                static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height) * static_cast<std::uint64_t>(octaves),
+                options.threads, options.pool);
+
+            parallel_for_tiles(width, height, options.tileSize, options.tileSize, options.threads, options.pool, [&](const Tile& tile) {
+                constexpr int chunk = 64;
+                alignas(64) float xs[chunk];
+                alignas(64) float ys[chunk];
+                const int xEnd = tile.x + tile.width;
+                float freq = frequency;
+                for (int o = 0; o < octaves; ++o) {
+                    NoiseMap& layer = layers_[static_cast<std::size_t>(o)];
+                    for (int y = tile.y; y < tile.y + tile.height; ++y) {
+                        std::fill(ys, ys + chunk, (static_cast<float>(y) + base) / scale * freq);
+                        float* row = layer.row(y).data();
+                        for (int x0 = tile.x; x0 < xEnd; x0 += chunk) {
+                            const int n = std::min(chunk, xEnd - x0);
+                            for (int i = 0; i < n; ++i)
+                                xs[i] = (static_cast<float>(x0 + i) + base) / scale * freq;
+                            FractalTraits<Base>::noise_batch(noise, xs, ys, row + x0, static_cast<std::size_t>(n));
+                        }
+                    }
+                    freq *= lacunarity;
+                }
+            });
+        }
+
+        int width() const { return layers_.front().width(); }
+        int height() const { return layers_.front().height(); }
+        int octaves() const { return static_cast<int>(layers_.size()); }
+        const NoiseMap& layer(int octave) const { return layers_.at(static_cast<std::size_t>(octave)); }
+
+        std::size_t size_bytes() const {
+            std::size_t bytes = 0;
+            for (const NoiseMap& layer : layers_) bytes += layer.size_bytes();
+            return bytes;
+        }
+
+        // The fractal map of the first `octaves` layers (0 = all) at `persistence`
+        void compose_into(float* dst, std::size_t stride, float persistence, int octaves = 0, const GenerateOptions& options = {}) const {
+            if (persistence < 0.0f || persistence > 1.0f)
+                throw std::invalid_argument("persistence must be in [0,1], got: " + std::to_string(persistence));
+            if (octaves < 0 || octaves > this->octaves())
+                throw std::invalid_argument("octaves must be in [0," + std::to_string(this->octaves()) + "], got: " + std::to_string(octaves));
+            if (!dst)
+                throw std::invalid_argument("dst must not be null");
+            if (stride < static_cast<std::size_t>(width()))
+                throw std::invalid_argument("stride must be >= width, got: " + std::to_string(stride));
+            const std::size_t count = octaves == 0 ? layers_.size() : static_cast<std::size_t>(octaves);
+
+            // Same running products and sum as the generators
+            std::vector<float> amplitudes(count);
+            float maxAmplitude = 0.0f;
+            float amplitude = 1.0f;
+            for (std::size_t o = 0; o < count; ++o) {
+                amplitudes[o] = amplitude;
+                maxAmplitude += amplitude;
+                amplitude *= persistence;
+            }
+
+            const int w = width();
+            const int h = height();
+            const StageTimer timer(StatsStage::Accumulate, "layers",
+                static_cast<std::uint64_t>(w) * static_cast<std::uint64_t>(h), options.threads, options.pool);
+            parallel_for_tiles(w, h, options.tileSize, options.tileSize, options.threads, options.pool, [&](const Tile& tile) {
+                std::vector<const float*> rows(count);
+                for (int y = tile.y; y < tile.y + tile.height; ++y) {
+                    for (std::size_t o = 0; o < count; ++o) rows[o] = layers_[o].row(y).data() + tile.x;
+                    float* out = dst + static_cast<std::size_t>(y) * stride + tile.x;
+                    weighted_sum(out, rows.data(), amplitudes.data(), count, static_cast<std::size_t>(tile.width));
+                    for (int i = 0; i < tile.width; ++i)
+                        out[i] = FractalTraits<Base>::normalize(out[i], maxAmplitude);
+                }
+            });
+        }
+
+        NoiseMap compose(float persistence, int octaves = 0, const GenerateOptions& options = {}) const {
+            NoiseMap map(width(), height());
+            compose_into(map.data(), map.stride(), persistence, octaves, options);
+            return map;
+        }
+
+    private:
+        std::vector<NoiseMap> layers_;
+    };
+
+} // namespace Noise
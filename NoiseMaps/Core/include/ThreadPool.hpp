@@ -0,0 +1,91 @@
+// ThreadPool.hpp
+// --------------
+// Persistent worker pool shared by all generators. Workers are started once and
+// reused, so a parallel call costs a wake-up instead of thread creation. The
+// calling thread always takes part in its own job, which keeps nested calls
+// and concurrent callers (e.g. several request handlers) deadlock-free.
+// post() queues detached tasks (see generate_async in Async.hpp).
+//
+// Usage:
+//   Noise::ThreadPool pool(16);                  // or Noise::default_thread_pool()
+//   pool.run(4, [&](unsigned worker) { ... });   // worker 0 is the caller
+//   pool.post([] { ... }, 5);                    // runs later on a worker, priority 5
+//
+//   Noise::set_default_thread_pool(&pool);       // route every generator through it
+
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Noise {
+
+    class ThreadPool {
+    public:
+        using TaskFn = void (*)(void* ctx, unsigned worker);
+
+        // threads = total concurrency including the calling thread
+        // (0 = std::thread::hardware_concurrency()); threads - 1 workers are started
+        explicit ThreadPool(unsigned threads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Total concurrency (background workers + the calling thread)
+        unsigned size() const;
+
+        // Grows the pool to at least `threads` (never shrinks)
+        void reserve(unsigned threads);
+
+        // Runs fn(ctx, w) for w in [0, participants): w == 0 on the calling thread,
+        // the rest on idle workers. Returns once every started call has returned.
+        // Indices no worker picked up before the caller finished are skipped, so fn
+        // must be written so that any participant can finish the whole job (as the
+        // tile scheduler's work stealing does). Exceptions must not escape fn.
+        // Workers run fn under the caller's cancellation token (Cancellation.hpp).
+        void run(unsigned participants, TaskFn fn, void* ctx);
+
+        template <typename Fn>
+        void run(unsigned participants, Fn&& fn) {
+            using F = std::remove_reference_t<Fn>;
+            run(participants,
+                [](void* ctx, unsigned worker) { (*static_cast<F*>(ctx))(worker); },
+                const_cast<void*>(static_cast<const void*>(&fn)));
+        }
+
+        // Queues task to run once on a worker and returns at once. Higher priorities
+        // start first, equal ones in submission order; idle workers join running
+        // run() jobs before starting a task. A pool without workers starts one.
+        // Tasks not started when the pool is destroyed are destroyed unrun.
+        // Exceptions must not escape task.
+        void post(std::function<void()> task, int priority = 0);
+
+    private:
+        struct Job;
+
+        void worker_loop();
+
+        mutable std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        std::vector<Job*> queue_; // oldest first; keeps its capacity, so run() does not allocate
+        std::multimap<int, std::function<void()>, std::greater<int>> tasks_; // by priority, FIFO within one
+        std::vector<std::thread> workers_;
+        bool stopping_ = false;
+    };
+
+    // Pool used by generators that are not handed one explicitly. Until a pool is
+    // injected this is a built-in pool sized to the machine, started on first use.
+    ThreadPool& default_thread_pool();
+
+    // Installs a caller-owned pool as the default (nullptr restores the built-in
+    // one). The pool must outlive every generator call that can use it.
+    void set_default_thread_pool(ThreadPool* pool);
+
+} // namespace Noise
@@ -0,0 +1,62 @@
+// TileScheduler.hpp
+// -----------------
+// Shared parallel scheduler for map generation. A width x height map is cut into
+// tiles; each worker owns a contiguous run of tiles and, once it runs dry, steals
+// from the runs of the other workers. Workers come from a persistent ThreadPool.
+// Generators only ever write disjoint tiles, so output does not depend on thread
+// count or scheduling order.
+//
+// Usage:
+//   Noise::parallel_for_tiles(width, height, 64, 64, 0, [&](const Noise::Tile& t) {
+//       for (int y = t.y; y < t.y + t.height; ++y) ...
+//   });
+
+#pragma once
+#include <type_traits>
+#include <utility>
+#include "ThreadPool.hpp"
+
+namespace Noise {
+
+    // Half-open pixel rectangle [x, x + width) x [y, y + height)
+    struct Tile {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    // Library-wide default worker count used when a call passes threads == 0.
+    // 0 (the initial value) means std::thread::hardware_concurrency(). Calls never
+    // use more workers than their pool has threads.
+    void set_thread_count(unsigned threads);
+
+    // Effective worker count (>= 1) for a call requesting `requested` threads
+    unsigned resolve_thread_count(unsigned requested = 0);
+
+    namespace detail {
+        using TileFn = void (*)(void* ctx, const Tile& tile);
+        void run_tiles(int width, int height, int tileWidth, int tileHeight, unsigned threads, ThreadPool* pool, TileFn fn, void* ctx);
+    }
+
+    // Calls fn(tile) once for every tile of the grid, from up to `threads` workers
+    // (0 = library default; the calling thread is one of them) of `pool`
+    // (nullptr = default_thread_pool()). Single-tile grids and threads == 1 run
+    // inline. The first exception thrown by fn is rethrown here after all workers
+    // have stopped. Inside a CancelScope (Cancellation.hpp), tiles are not started
+    // once its token is cancelled: GenerationCancelled is thrown instead, and the
+    // workers run fn under the caller's token.
+    template <typename Fn>
+    void parallel_for_tiles(int width, int height, int tileWidth, int tileHeight, unsigned threads, ThreadPool* pool, Fn&& fn) {
+        using F = std::remove_reference_t<Fn>;
+        detail::run_tiles(width, height, tileWidth, tileHeight, threads, pool,
+            [](void* ctx, const Tile& tile) { (*static_cast<F*>(ctx))(tile); },
+            const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+    template <typename Fn>
+    void parallel_for_tiles(int width, int height, int tileWidth, int tileHeight, unsigned threads, Fn&& fn) {
+        parallel_for_tiles(width, height, tileWidth, tileHeight, threads, nullptr, std::forward<Fn>(fn));
+    }
+
+} // namespace Noise
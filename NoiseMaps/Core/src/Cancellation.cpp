@@ -0,0 +1,34 @@
+// Cancellation.cpp
+#include "Cancellation.hpp"
+
+namespace Noise {
+
+    static thread_local const std::atomic<bool>* t_cancelFlag = nullptr;
+
+    namespace detail {
+
+        const std::atomic<bool>* current_cancel_flag() noexcept {
+            return t_cancelFlag;
+        }
+
+        const std::atomic<bool>* exchange_cancel_flag(const std::atomic<bool>* flag) noexcept {
+            const std::atomic<bool>* previous = t_cancelFlag;
+            t_cancelFlag = flag;
+            return previous;
+        }
+
+    } // namespace detail
+
+    CancelScope::CancelScope(const CancelToken& token)
+        : flag_(token.flag_), previous_(detail::exchange_cancel_flag(flag_.get())) {}
+
+    CancelScope::~CancelScope() {
+        detail::exchange_cancel_flag(previous_);
+    }
+
+    void throw_if_cancelled() {
+        if (t_cancelFlag && t_cancelFlag->load(std::memory_order_relaxed))
+            throw GenerationCancelled();
+    }
+
+} // namespace Noise
@@ -0,0 +1,105 @@
+// ChunkCache.cpp
+#include "ChunkCache.hpp"
+
+namespace Noise {
+
+    // FNV-1a over the key fields, finished with the murmur3 fmix64 avalanche
+    static std::uint64_t mix(std::uint64_t h, std::uint64_t v) {
+        h ^= v;
+        h *= 0x100000001B3ull;
+        return h;
+    }
+
+    std::size_t ChunkKeyHash::operator()(const ChunkKey& key) const noexcept {
+        std::uint64_t h = 0xCBF29CE484222325ull;
+        h = mix(h, key.generator);
+        h = mix(h, static_cast<std::uint32_t>(key.seed));
+        for (std::uint32_t p : key.params) h = mix(h, p);
+        h = mix(h, static_cast<std::uint64_t>(key.chunkX));
+        h = mix(h, static_cast<std::uint64_t>(key.chunkY));
+        h = mix(h, static_cast<std::uint32_t>(key.chunkSize));
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return static_cast<std::size_t>(h);
+    }
+
+    ChunkCache::ChunkCache(std::size_t byteBudget) : budget_(byteBudget) {}
+
+    ChunkCache::MapPtr ChunkCache::find(const ChunkKey& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++stats_.misses;
+            return nullptr;
+        }
+        ++stats_.hits;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->map;
+    }
+
+    ChunkCache::MapPtr ChunkCache::insert(const ChunkKey& key, NoiseMap&& map) {
+        const std::size_t bytes = map.size_bytes();
+        MapPtr ptr = std::make_shared<const NoiseMap>(std::move(map));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->map;
+        }
+        if (bytes > budget_) return ptr;
+
+        evict_to(budget_ - bytes);
+        lru_.push_front(Entry{ key, ptr });
+        index_.emplace(key, lru_.begin());
+        stats_.bytes += bytes;
+        stats_.entries = lru_.size();
+        return ptr;
+    }
+
+    void ChunkCache::evict_to(std::size_t byteBudget) {
+        while (stats_.bytes > byteBudget && !lru_.empty()) {
+            Entry& victim = lru_.back();
+            stats_.bytes -= victim.map->size_bytes();
+            index_.erase(victim.key);
+            lru_.pop_back();
+            ++stats_.evictions;
+        }
+        stats_.entries = lru_.size();
+    }
+
+    void ChunkCache::set_budget(std::size_t byteBudget) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budget_ = byteBudget;
+        evict_to(budget_);
+    }
+
+    std::size_t ChunkCache::budget() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return budget_;
+    }
+
+    void ChunkCache::clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        index_.clear();
+        lru_.clear();
+        stats_.bytes = 0;
+        stats_.entries = 0;
+    }
+
+    ChunkCache::Stats ChunkCache::stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    void ChunkCache::reset_stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.hits = 0;
+        stats_.misses = 0;
+        stats_.evictions = 0;
+    }
+
+} // namespace Noise
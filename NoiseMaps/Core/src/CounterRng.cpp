@@ -0,0 +1,129 @@
+// CounterRng.cpp
+#include "CounterRng.hpp"
+#include "CpuFeatures.hpp"
+
+#if defined(RELNO_ARCH_X86)
+#include <immintrin.h>
+#elif defined(RELNO_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace Noise {
+
+    using CounterRowKernel = void (*)(std::uint32_t seed, std::uint32_t y, std::uint32_t x0, float* out, std::size_t count);
+
+    // ---------------------------------------------------------
+    // SIMD kernels: the same Philox rounds on 8 / 4 counters at once.
+    // Integer arithmetic and the exact 24-bit int -> float conversion keep
+    // every lane bit-identical to counter_uniform().
+    // ---------------------------------------------------------
+#if defined(RELNO_ARCH_X86)
+    RELNO_TARGET_AVX2
+    static void counter_row_avx2(std::uint32_t seed, std::uint32_t y, std::uint32_t x0, float* out, std::size_t count) {
+        const __m256i m = _mm256_set1_epi32(static_cast<int>(kPhiloxM));
+        const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256 scale = _mm256_set1_ps(1.0f / 16777216.0f);
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(x0 + static_cast<std::uint32_t>(i))), lane);
+            __m256i c1 = _mm256_set1_epi32(static_cast<int>(y));
+            std::uint32_t key = seed;
+            for (int r = 0; r < kPhiloxRounds; ++r) {
+                // 32x32 -> 64 products of the even and the odd lanes
+                const __m256i even = _mm256_mul_epu32(c0, m);
+                const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(c0, 32), m);
+                const __m256i hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+                const __m256i lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+                c0 = _mm256_xor_si256(_mm256_xor_si256(hi, _mm256_set1_epi32(static_cast<int>(key))), c1);
+                c1 = lo;
+                key += kPhiloxW;
+            }
+            const __m256 v = _mm256_cvtepi32_ps(_mm256_srli_epi32(c0, 8));
+            _mm256_storeu_ps(out + i, _mm256_mul_ps(v, scale));
+        }
+        for (; i < count; ++i)
+            out[i] = counter_uniform(seed, x0 + static_cast<std::uint32_t>(i), y);
+    }
+
+    RELNO_TARGET_SSE2
+    static void counter_row_sse2(std::uint32_t seed, std::uint32_t y, std::uint32_t x0, float* out, std::size_t count) {
+        const __m128i m = _mm_set1_epi32(static_cast<int>(kPhiloxM));
+        const __m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+        // odd 32-bit lanes (the high halves of the 64-bit products); SSE2 has no blend
+        const __m128i oddLanes = _mm_setr_epi32(0, -1, 0, -1);
+        const __m128 scale = _mm_set1_ps(1.0f / 16777216.0f);
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i c0 = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(x0 + static_cast<std::uint32_t>(i))), lane);
+            __m128i c1 = _mm_set1_epi32(static_cast<int>(y));
+            std::uint32_t key = seed;
+            for (int r = 0; r < kPhiloxRounds; ++r) {
+                const __m128i even = _mm_mul_epu32(c0, m);
+                const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(c0, 32), m);
+                const __m128i hi = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_and_si128(odd, oddLanes));
+                const __m128i lo = _mm_or_si128(_mm_andnot_si128(oddLanes, even), _mm_slli_epi64(odd, 32));
+                c0 = _mm_xor_si128(_mm_xor_si128(hi, _mm_set1_epi32(static_cast<int>(key))), c1);
+                c1 = lo;
+                key += kPhiloxW;
+            }
+            const __m128 v = _mm_cvtepi32_ps(_mm_srli_epi32(c0, 8));
+            _mm_storeu_ps(out + i, _mm_mul_ps(v, scale));
+        }
+        for (; i < count; ++i)
+            out[i] = counter_uniform(seed, x0 + static_cast<std::uint32_t>(i), y);
+    }
+#endif // RELNO_ARCH_X86
+
+#if defined(RELNO_ARCH_ARM64)
+    static void counter_row_neon(std::uint32_t seed, std::uint32_t y, std::uint32_t x0, float* out, std::size_t count) {
+        const uint32x2_t m = vdup_n_u32(kPhiloxM);
+        const uint32_t laneInit[4] = { 0, 1, 2, 3 };
+        const uint32x4_t lane = vld1q_u32(laneInit);
+        const float32x4_t scale = vdupq_n_f32(1.0f / 16777216.0f);
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            uint32x4_t c0 = vaddq_u32(vdupq_n_u32(x0 + static_cast<std::uint32_t>(i)), lane);
+            uint32x4_t c1 = vdupq_n_u32(y);
+            std::uint32_t key = seed;
+            for (int r = 0; r < kPhiloxRounds; ++r) {
+                const uint64x2_t p0 = vmull_u32(vget_low_u32(c0), m);
+                const uint64x2_t p1 = vmull_u32(vget_high_u32(c0), m);
+                const uint32x4_t hi = vcombine_u32(vshrn_n_u64(p0, 32), vshrn_n_u64(p1, 32));
+                const uint32x4_t lo = vcombine_u32(vmovn_u64(p0), vmovn_u64(p1));
+                c0 = veorq_u32(veorq_u32(hi, vdupq_n_u32(key)), c1);
+                c1 = lo;
+                key += kPhiloxW;
+            }
+            const float32x4_t v = vcvtq_f32_u32(vshrq_n_u32(c0, 8));
+            vst1q_f32(out + i, vmulq_f32(v, scale));
+        }
+        for (; i < count; ++i)
+            out[i] = counter_uniform(seed, x0 + static_cast<std::uint32_t>(i), y);
+    }
+#endif // RELNO_ARCH_ARM64
+
+    static const KernelTable<CounterRowKernel> kCounterKernels = [] {
+        KernelTable<CounterRowKernel> t;
+#if defined(RELNO_ARCH_X86)
+        t.sse2 = counter_row_sse2;
+        t.avx2 = counter_row_avx2;
+#elif defined(RELNO_ARCH_ARM64)
+        t.neon = counter_row_neon;
+#endif
+        return t;
+    }();
+
+    void counter_uniform_row(std::uint32_t seed, std::uint32_t y, std::uint32_t x0, float* out, std::size_t count) {
+        const CounterRowKernel kernel = kCounterKernels.get();
+        if (kernel) {
+            kernel(seed, y, x0, out, count);
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] = counter_uniform(seed, x0 + static_cast<std::uint32_t>(i), y);
+    }
+
+} // namespace Noise
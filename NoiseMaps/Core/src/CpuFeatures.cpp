@@ -0,0 +1,173 @@
+// CpuFeatures.cpp
+#include "CpuFeatures.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(RELNO_ARCH_X86) && defined(_MSC_VER)
+#include <intrin.h>    // __cpuid, __cpuidex
+#include <immintrin.h> // _xgetbv
+#endif
+
+#if defined(_WIN32)
+#include <vector>
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <cstdint>
+#include <sys/sysctl.h>
+#elif defined(__unix__)
+#include <unistd.h>
+#endif
+
+namespace Noise {
+
+    static CpuFeatures detect_cpu_features() {
+        CpuFeatures f;
+
+#if defined(RELNO_ARCH_X86) && defined(_MSC_VER)
+        int info[4] = { 0, 0, 0, 0 };
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        f.sse2 = (info[3] & (1 << 26)) != 0;
+        f.fma = (info[2] & (1 << 12)) != 0;
+        f.f16c = (info[2] & (1 << 29)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+
+        // The OS must save the YMM (bits 1-2) / ZMM + opmask (bits 5-7) registers
+        unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+        const bool ymmState = (xcr0 & 0x6) == 0x6;
+        const bool zmmState = (xcr0 & 0xE6) == 0xE6;
+
+        f.fma = f.fma && avx && ymmState;
+        f.f16c = f.f16c && avx && ymmState;
+        if (maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            f.avx2 = avx && ymmState && (info[1] & (1 << 5)) != 0;
+            f.avx512f = zmmState && (info[1] & (1 << 16)) != 0;
+        }
+#elif defined(RELNO_ARCH_X86) && (defined(__GNUC__) || defined(__clang__))
+        // __builtin_cpu_supports also checks that the OS enabled the register state
+        __builtin_cpu_init();
+        f.sse2 = __builtin_cpu_supports("sse2");
+        f.avx2 = __builtin_cpu_supports("avx2");
+        f.avx512f = __builtin_cpu_supports("avx512f");
+        f.fma = __builtin_cpu_supports("fma");
+#if defined(__clang__)
+        // clang has no "f16c" key for __builtin_cpu_supports; every AVX2 CPU has F16C
+        f.f16c = f.avx2;
+#else
+        f.f16c = __builtin_cpu_supports("f16c");
+#endif
+#elif defined(RELNO_ARCH_ARM64)
+        // Advanced SIMD is mandatory on AArch64
+        f.neon = true;
+#endif
+
+        return f;
+    }
+
+    const CpuFeatures& cpu_features() {
+        static const CpuFeatures features = detect_cpu_features();
+        return features;
+    }
+
+    // ---------------------------------------------------------
+    // Kernel dispatch
+    // ---------------------------------------------------------
+    const char* simd_isa_name(SimdIsa isa) noexcept {
+        switch (isa) {
+        case SimdIsa::Scalar: return "scalar";
+        case SimdIsa::SSE2: return "sse2";
+        case SimdIsa::AVX2: return "avx2";
+        case SimdIsa::AVX512: return "avx512";
+        case SimdIsa::NEON: return "neon";
+        }
+        return "unknown";
+    }
+
+    bool simd_isa_supported(SimdIsa isa) {
+        const CpuFeatures& cpu = cpu_features();
+        switch (isa) {
+        case SimdIsa::Scalar: return true;
+        case SimdIsa::SSE2: return cpu.sse2;
+        case SimdIsa::AVX2: return cpu.avx2;
+        case SimdIsa::AVX512: return cpu.avx512f && cpu.avx2;
+        case SimdIsa::NEON: return cpu.neon;
+        }
+        return false;
+    }
+
+    SimdIsa best_simd_isa() {
+        static const SimdIsa best = [] {
+            for (SimdIsa isa : { SimdIsa::NEON, SimdIsa::AVX512, SimdIsa::AVX2, SimdIsa::SSE2 })
+                if (simd_isa_supported(isa)) return isa;
+            return SimdIsa::Scalar;
+        }();
+        return best;
+    }
+
+    // RELNO_SIMD=<tier> lowers the default; unknown or unsupported names are ignored
+    static SimdIsa initial_simd_isa() {
+        const SimdIsa best = best_simd_isa();
+        const char* env = std::getenv("RELNO_SIMD");
+        if (!env) return best;
+        for (SimdIsa isa : { SimdIsa::Scalar, SimdIsa::SSE2, SimdIsa::AVX2, SimdIsa::AVX512, SimdIsa::NEON }) {
+            if (std::strcmp(env, simd_isa_name(isa)) == 0 && simd_isa_supported(isa))
+                return isa;
+        }
+        return best;
+    }
+
+    static std::atomic<SimdIsa>& active_isa_slot() {
+        static std::atomic<SimdIsa> active{ initial_simd_isa() };
+        return active;
+    }
+
+    SimdIsa active_simd_isa() {
+        return active_isa_slot().load(std::memory_order_relaxed);
+    }
+
+    void force_simd_isa(SimdIsa isa) {
+        if (!simd_isa_supported(isa))
+            throw std::invalid_argument(std::string("SIMD tier not supported by this CPU: ") + simd_isa_name(isa));
+        active_isa_slot().store(isa, std::memory_order_relaxed);
+    }
+
+    static std::size_t detect_l2_cache_bytes() {
+        std::size_t bytes = 0;
+#if defined(_WIN32)
+        DWORD length = 0;
+        GetLogicalProcessorInformation(nullptr, &length);
+        std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+        if (!info.empty() && GetLogicalProcessorInformation(info.data(), &length)) {
+            for (const auto& entry : info) {
+                if (entry.Relationship == RelationCache && entry.Cache.Level == 2) {
+                    bytes = entry.Cache.Size;
+                    break;
+                }
+            }
+        }
+#elif defined(__APPLE__)
+        std::uint64_t value = 0;
+        std::size_t size = sizeof(value);
+        if (sysctlbyname("hw.l2cachesize", &value, &size, nullptr, 0) == 0)
+            bytes = static_cast<std::size_t>(value);
+#elif defined(_SC_LEVEL2_CACHE_SIZE)
+        long value = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        if (value > 0) bytes = static_cast<std::size_t>(value);
+#endif
+        return bytes > 0 ? bytes : std::size_t(1) << 20;
+    }
+
+    std::size_t l2_cache_bytes() {
+        static const std::size_t bytes = detect_l2_cache_bytes();
+        return bytes;
+    }
+
+} // namespace Noise
@@ -0,0 +1,26 @@
+// GenerateOptions.cpp
+#include "GenerateOptions.hpp"
+#include "CpuFeatures.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace Noise {
+
+    bool use_fused_octaves(OctaveMode mode, int width, int height, int tileSize) {
+        switch (mode) {
+        case OctaveMode::Layered:
+            return false;
+        case OctaveMode::Fused:
+            return true;
+        case OctaveMode::Auto:
+            break;
+        }
+        // Layered generation re-reads each tile once per octave; that only stays
+        // cheap while the tile is still in cache when the next octave starts
+        const std::size_t tileW = static_cast<std::size_t>(std::max(1, std::min(tileSize, width)));
+        const std::size_t tileH = static_cast<std::size_t>(std::max(1, std::min(tileSize, height)));
+        return tileW * tileH * sizeof(float) > l2_cache_bytes();
+    }
+
+} // namespace Noise
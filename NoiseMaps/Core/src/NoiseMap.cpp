@@ -0,0 +1,80 @@
+// NoiseMap.cpp
+#include "NoiseMap.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstdint> // for std::uintptr_t
+#include <new>     // for std::bad_alloc
+
+#if defined(_MSC_VER)
+#include <malloc.h> // _aligned_malloc / _aligned_free
+#endif
+
+namespace Noise {
+
+    // -----------------------------
+    // Aligned allocation helpers
+    // -----------------------------
+    static std::atomic<std::uint64_t> g_allocations{ 0 };
+    static std::atomic<std::uint64_t> g_allocatedBytes{ 0 };
+    static thread_local std::uint64_t t_allocatedBytes = 0;
+
+    AllocationStats aligned_allocation_stats() noexcept {
+        AllocationStats stats;
+        stats.allocations = g_allocations.load(std::memory_order_relaxed);
+        stats.bytes = g_allocatedBytes.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    std::uint64_t thread_allocated_bytes() noexcept {
+        return t_allocatedBytes;
+    }
+
+    void* aligned_allocate(std::size_t bytes, std::size_t alignment) {
+        if (bytes == 0) return nullptr;
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+        t_allocatedBytes += bytes;
+
+#if defined(_MSC_VER)
+        // Windows (MSVC): use _aligned_malloc / _aligned_free
+        void* ptr = _aligned_malloc(bytes, alignment);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+#else
+        // Portable manual alignment for all other compilers (MinGW, Linux, macOS, etc.)
+
+        // We allocate extra space to:
+        //  - guarantee we can align to `alignment`
+        //  - store the original pointer just before the aligned block
+        std::size_t total = bytes + alignment - 1 + sizeof(void*);
+        void* raw = std::malloc(total);
+        if (!raw) {
+            throw std::bad_alloc();
+        }
+
+        // Find an aligned address inside the allocated block
+        std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+        std::uintptr_t aligned = (start + alignment - 1) & ~(alignment - 1);
+        void* alignedPtr = reinterpret_cast<void*>(aligned);
+
+        // Store the original pointer immediately before the aligned block
+        reinterpret_cast<void**>(alignedPtr)[-1] = raw;
+        return alignedPtr;
+#endif
+    }
+
+    void aligned_free(void* ptr) noexcept {
+        if (!ptr) return;
+#if defined(_MSC_VER)
+        _aligned_free(ptr);
+#else
+        // Recover the original pointer we stashed just before `ptr`
+        void* raw = reinterpret_cast<void**>(ptr)[-1];
+        std::free(raw);
+#endif
+    }
+
+} // namespace Noise
@@ -0,0 +1,131 @@
+// NoiseStats.cpp
+#include "NoiseStats.hpp"
+#include "NoiseMap.hpp"
+#include "ThreadPool.hpp"
+#include "TileScheduler.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+namespace Noise {
+
+    namespace detail {
+        std::atomic<StatsSink*> g_statsSink{ nullptr };
+        thread_local StatsSink* t_statsSink = nullptr;
+    }
+
+    static std::atomic<std::ostream*> g_logStream{ &std::cout };
+
+    const char* stats_stage_name(StatsStage stage) noexcept {
+        switch (stage) {
+        case StatsStage::Setup: return "setup";
+        case StatsStage::Evaluate: return "evaluate";
+        case StatsStage::Integral: return "integral";
+        case StatsStage::BoxAverage: return "box_average";
+        case StatsStage::Accumulate: return "accumulate";
+        case StatsStage::Normalize: return "normalize";
+        case StatsStage::Convert: return "convert";
+        case StatsStage::Quantize: return "quantize";
+        case StatsStage::Encode: return "encode";
+        case StatsStage::Count: break;
+        }
+        return "unknown";
+    }
+
+    // ---------------------------------------------------------
+    // StatsCollector
+    // ---------------------------------------------------------
+    void StatsCollector::record(const StageRecord& stage) {
+        const std::size_t index = static_cast<std::size_t>(stage.stage);
+        if (index >= kStatsStageCount) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        Totals& t = totals_[index];
+        t.seconds += stage.seconds;
+        t.pixels += stage.pixels;
+        t.bytesAllocated += stage.bytesAllocated;
+        t.records += 1;
+        t.maxThreads = std::max(t.maxThreads, stage.threads);
+    }
+
+    StatsCollector::Totals StatsCollector::totals(StatsStage stage) const {
+        const std::size_t index = static_cast<std::size_t>(stage);
+        if (index >= kStatsStageCount) return {};
+        std::lock_guard<std::mutex> lock(mutex_);
+        return totals_[index];
+    }
+
+    std::array<StatsCollector::Totals, kStatsStageCount> StatsCollector::snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return totals_;
+    }
+
+    void StatsCollector::reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        totals_ = {};
+    }
+
+    // ---------------------------------------------------------
+    // Sinks
+    // ---------------------------------------------------------
+    void set_stats_sink(StatsSink* sink) noexcept {
+        detail::g_statsSink.store(sink, std::memory_order_release);
+    }
+
+    ScopedStatsSink::ScopedStatsSink(StatsSink& sink) noexcept : previous_(detail::t_statsSink) {
+        detail::t_statsSink = &sink;
+    }
+
+    ScopedStatsSink::~ScopedStatsSink() {
+        detail::t_statsSink = previous_;
+    }
+
+    unsigned stats_thread_count(unsigned threads, ThreadPool* pool) {
+        const unsigned requested = resolve_thread_count(threads);
+        return std::max(1u, std::min(requested, (pool ? *pool : default_thread_pool()).size()));
+    }
+
+    // ---------------------------------------------------------
+    // StageTimer
+    // ---------------------------------------------------------
+    void StageTimer::start(StatsStage stage, const char* generator, std::uint64_t pixels,
+        unsigned threads, ThreadPool* pool, std::uint64_t bytesAllocated) noexcept {
+        record_.stage = stage;
+        record_.generator = generator;
+        record_.pixels = pixels;
+        record_.bytesAllocated = bytesAllocated;
+        // threads == 1 marks serial stages; anything else is resolved like parallel_for_tiles
+        try {
+            record_.threads = threads == 1 ? 1 : stats_thread_count(threads, pool);
+        }
+        catch (...) {
+            record_.threads = resolve_thread_count(threads);
+        }
+        uncaught_ = std::uncaught_exceptions();
+        allocatedAtStart_ = thread_allocated_bytes();
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    void StageTimer::finish() noexcept {
+        if (std::uncaught_exceptions() > uncaught_) return;
+        record_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        record_.bytesAllocated += thread_allocated_bytes() - allocatedAtStart_;
+        sink_->record(record_);
+    }
+
+    void record_stage(const StageRecord& stage) noexcept {
+        if (StatsSink* sink = stats_sink()) sink->record(stage);
+    }
+
+    // ---------------------------------------------------------
+    // Log output
+    // ---------------------------------------------------------
+    void set_log_stream(std::ostream* stream) noexcept {
+        g_logStream.store(stream, std::memory_order_release);
+    }
+
+    std::ostream* log_stream() noexcept {
+        return g_logStream.load(std::memory_order_acquire);
+    }
+
+} // namespace Noise
@@ -0,0 +1,131 @@
+// OctaveLayers.cpp
+#include "OctaveLayers.hpp"
+#include "CpuFeatures.hpp"
+
+#if defined(RELNO_ARCH_X86)
+#include <immintrin.h>
+#elif defined(RELNO_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace Noise {
+
+    using WeightedSumKernel = void (*)(float* dst, const float* const* layers, const float* weights, std::size_t layerCount, std::size_t count);
+
+    // ---------------------------------------------------------
+    // Weighted layer sum kernels: the sum of a block of pixels stays in
+    // registers across all layers. Separate multiply and add in layer order keep
+    // every tier bit-identical to the scalar loop.
+    // ---------------------------------------------------------
+    // Pixels [i, count); also the tail of the SIMD kernels
+    static void weighted_sum_tail(float* dst, const float* const* layers, const float* weights, std::size_t layerCount,
+        std::size_t i, std::size_t count) {
+        for (; i < count; ++i) {
+            float acc = 0.0f;
+            for (std::size_t l = 0; l < layerCount; ++l) acc += layers[l][i] * weights[l];
+            dst[i] = acc;
+        }
+    }
+
+    static void weighted_sum_scalar(float* dst, const float* const* layers, const float* weights, std::size_t layerCount, std::size_t count) {
+        weighted_sum_tail(dst, layers, weights, layerCount, 0, count);
+    }
+
+#if defined(RELNO_ARCH_X86)
+    RELNO_TARGET_SSE2
+    static void weighted_sum_sse2(float* dst, const float* const* layers, const float* weights, std::size_t layerCount, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m128 a0 = _mm_setzero_ps();
+            __m128 a1 = _mm_setzero_ps();
+            for (std::size_t l = 0; l < layerCount; ++l) {
+                const __m128 w = _mm_set1_ps(weights[l]);
+                a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(layers[l] + i), w));
+                a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_loadu_ps(layers[l] + i + 4), w));
+            }
+            _mm_storeu_ps(dst + i, a0);
+            _mm_storeu_ps(dst + i + 4, a1);
+        }
+        weighted_sum_tail(dst, layers, weights, layerCount, i, count);
+    }
+
+    RELNO_TARGET_AVX2
+    static void weighted_sum_avx2(float* dst, const float* const* layers, const float* weights, std::size_t layerCount, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m256 a0 = _mm256_setzero_ps();
+            __m256 a1 = _mm256_setzero_ps();
+            for (std::size_t l = 0; l < layerCount; ++l) {
+                const __m256 w = _mm256_set1_ps(weights[l]);
+                a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_loadu_ps(layers[l] + i), w));
+                a1 = _mm256_add_ps(a1, _mm256_mul_ps(_mm256_loadu_ps(layers[l] + i + 8), w));
+            }
+            _mm256_storeu_ps(dst + i, a0);
+            _mm256_storeu_ps(dst + i + 8, a1);
+        }
+        weighted_sum_tail(dst, layers, weights, layerCount, i, count);
+    }
+
+    RELNO_TARGET_AVX512
+    static void weighted_sum_avx512(float* dst, const float* const* layers, const float* weights, std::size_t layerCount, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 32 <= count; i += 32) {
+            __m512 a0 = _mm512_setzero_ps();
+            __m512 a1 = _mm512_setzero_ps();
+            for (std::size_t l = 0; l < layerCount; ++l) {
+                const __m512 w = _mm512_set1_ps(weights[l]);
+                a0 = _mm512_add_ps(a0, _mm512_mul_ps(_mm512_loadu_ps(layers[l] + i), w));
+                a1 = _mm512_add_ps(a1, _mm512_mul_ps(_mm512_loadu_ps(layers[l] + i + 16), w));
+            }
+            _mm512_storeu_ps(dst + i, a0);
+            _mm512_storeu_ps(dst + i + 16, a1);
+        }
+        // masked tail, 16 pixels at a time
+        for (; i < count; i += 16) {
+            const std::size_t n = count - i < 16 ? count - i : 16;
+            const __mmask16 m = static_cast<__mmask16>((1u << n) - 1u);
+            __m512 a = _mm512_setzero_ps();
+            for (std::size_t l = 0; l < layerCount; ++l)
+                a = _mm512_add_ps(a, _mm512_mul_ps(_mm512_maskz_loadu_ps(m, layers[l] + i), _mm512_set1_ps(weights[l])));
+            _mm512_mask_storeu_ps(dst + i, m, a);
+        }
+    }
+#endif // RELNO_ARCH_X86
+
+#if defined(RELNO_ARCH_ARM64)
+    static void weighted_sum_neon(float* dst, const float* const* layers, const float* weights, std::size_t layerCount, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            float32x4_t a0 = vdupq_n_f32(0.0f);
+            float32x4_t a1 = vdupq_n_f32(0.0f);
+            for (std::size_t l = 0; l < layerCount; ++l) {
+                const float32x4_t w = vdupq_n_f32(weights[l]);
+                // vmul + vadd, not the fused vmla / vfma
+                a0 = vaddq_f32(a0, vmulq_f32(vld1q_f32(layers[l] + i), w));
+                a1 = vaddq_f32(a1, vmulq_f32(vld1q_f32(layers[l] + i + 4), w));
+            }
+            vst1q_f32(dst + i, a0);
+            vst1q_f32(dst + i + 4, a1);
+        }
+        weighted_sum_tail(dst, layers, weights, layerCount, i, count);
+    }
+#endif // RELNO_ARCH_ARM64
+
+    static const KernelTable<WeightedSumKernel> kWeightedSumKernels = [] {
+        KernelTable<WeightedSumKernel> t;
+        t.scalar = weighted_sum_scalar;
+#if defined(RELNO_ARCH_X86)
+        t.sse2 = weighted_sum_sse2;
+        t.avx2 = weighted_sum_avx2;
+        t.avx512 = weighted_sum_avx512;
+#elif defined(RELNO_ARCH_ARM64)
+        t.neon = weighted_sum_neon;
+#endif
+        return t;
+    }();
+
+    void weighted_sum(float* dst, const float* const* layers, const float* weights, std::size_t layerCount, std::size_t count) {
+        kWeightedSumKernels.get()(dst, layers, weights, layerCount, count);
+    }
+
+} // namespace Noise
@@ -0,0 +1,143 @@
+// ThreadPool.cpp
+#include "ThreadPool.hpp"
+#include "Cancellation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace Noise {
+
+    // One run() call. Lives on the caller's stack; workers claim participant
+    // indices from it while it is queued.
+    struct ThreadPool::Job {
+        TaskFn fn = nullptr;
+        void* ctx = nullptr;
+        unsigned nextWorker = 1; // index 0 belongs to the caller
+        unsigned participants = 1;
+        unsigned active = 0;     // workers currently inside fn
+        const std::atomic<bool>* cancel = nullptr; // the caller's cancellation flag
+    };
+
+    ThreadPool::ThreadPool(unsigned threads) {
+        reserve(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& th : workers_) th.join();
+    }
+
+    unsigned ThreadPool::size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return static_cast<unsigned>(workers_.size()) + 1;
+    }
+
+    void ThreadPool::reserve(unsigned threads) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (workers_.size() + 1 < threads)
+            workers_.emplace_back(&ThreadPool::worker_loop, this);
+    }
+
+    void ThreadPool::run(unsigned participants, TaskFn fn, void* ctx) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (workers_.empty()) participants = 1;
+        }
+        if (participants <= 1) {
+            fn(ctx, 0);
+            return;
+        }
+
+        Job job;
+        job.fn = fn;
+        job.ctx = ctx;
+        job.participants = participants;
+        job.cancel = detail::current_cancel_flag();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(&job);
+        }
+        for (unsigned i = 1; i < participants; ++i) wake_.notify_one();
+
+        std::exception_ptr error;
+        try {
+            fn(ctx, 0);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        // Withdraw the unclaimed indices, then wait for the workers still inside fn
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = std::find(queue_.begin(), queue_.end(), &job);
+        if (it != queue_.end()) queue_.erase(it);
+        done_.wait(lock, [&] { return job.active == 0; });
+        lock.unlock();
+
+        if (error) std::rethrow_exception(error);
+    }
+
+    void ThreadPool::post(std::function<void()> task, int priority) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (workers_.empty()) workers_.emplace_back(&ThreadPool::worker_loop, this);
+            tasks_.emplace(priority, std::move(task));
+        }
+        wake_.notify_one();
+    }
+
+    void ThreadPool::worker_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [&] { return stopping_ || !queue_.empty() || !tasks_.empty(); });
+            if (stopping_) return;
+
+            if (queue_.empty()) {
+                auto next = tasks_.begin();
+                std::function<void()> task = std::move(next->second);
+                tasks_.erase(next);
+                lock.unlock();
+                task();
+                task = nullptr; // release its captures outside the lock
+                lock.lock();
+                continue;
+            }
+
+            Job* job = queue_.front();
+            unsigned worker = job->nextWorker++;
+            if (job->nextWorker == job->participants) queue_.erase(queue_.begin());
+            ++job->active;
+
+            lock.unlock();
+            // generator calls inside fn see the caller's token, as on the caller
+            const std::atomic<bool>* previous = detail::exchange_cancel_flag(job->cancel);
+            job->fn(job->ctx, worker);
+            detail::exchange_cancel_flag(previous);
+            lock.lock();
+
+            if (--job->active == 0) done_.notify_all();
+        }
+    }
+
+    // -----------------------------
+    // Default pool
+    // -----------------------------
+    static std::atomic<ThreadPool*> g_defaultPool{ nullptr };
+
+    ThreadPool& default_thread_pool() {
+        if (ThreadPool* injected = g_defaultPool.load(std::memory_order_acquire))
+            return *injected;
+        static ThreadPool builtin;
+        return builtin;
+    }
+
+    void set_default_thread_pool(ThreadPool* pool) {
+        g_defaultPool.store(pool, std::memory_order_release);
+    }
+
+} // namespace Noise
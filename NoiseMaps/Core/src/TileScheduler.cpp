@@ -0,0 +1,145 @@
+// TileScheduler.cpp
+#include "TileScheduler.hpp"
+#include "Cancellation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Noise {
+
+    static std::atomic<unsigned> g_threadCount{ 0 };
+
+    void set_thread_count(unsigned threads) {
+        g_threadCount.store(threads, std::memory_order_relaxed);
+    }
+
+    unsigned resolve_thread_count(unsigned requested) {
+        if (requested > 0) return requested;
+        unsigned configured = g_threadCount.load(std::memory_order_relaxed);
+        if (configured > 0) return configured;
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    namespace detail {
+
+        // One worker's run of tile indices. Owner and thieves both claim tiles with
+        // fetch_add, so a run is drained from the front by whoever gets there first.
+        struct alignas(64) TileRange {
+            std::atomic<int> next{ 0 };
+            int end = 0;
+        };
+
+        // Range arrays of the calling thread, one per nesting level of run_tiles (a
+        // tile may run a parallel call itself). They only grow, so steady-state
+        // multithreaded generation allocates nothing.
+        class TileRangeStack {
+        public:
+            class Lease {
+            public:
+                Lease(TileRangeStack& stack, unsigned count) : stack_(stack) {
+                    Level& level = stack.depth_ < stack.levels_.size() ? stack.levels_[stack.depth_] : stack.levels_.emplace_back();
+                    if (level.capacity < count) {
+                        level.ranges.reset(new TileRange[count]);
+                        level.capacity = count;
+                    }
+                    ranges_ = level.ranges.get();
+                    ++stack.depth_;
+                }
+                ~Lease() { --stack_.depth_; }
+                Lease(const Lease&) = delete;
+                Lease& operator=(const Lease&) = delete;
+
+                TileRange& operator[](unsigned w) const { return ranges_[w]; }
+
+            private:
+                TileRangeStack& stack_;
+                TileRange* ranges_;
+            };
+
+        private:
+            struct Level {
+                std::unique_ptr<TileRange[]> ranges;
+                unsigned capacity = 0;
+            };
+            std::deque<Level> levels_; // deque: growing keeps outer levels in place
+            std::size_t depth_ = 0;
+        };
+
+        static thread_local TileRangeStack t_tileRanges;
+
+        void run_tiles(int width, int height, int tileWidth, int tileHeight, unsigned threads, ThreadPool* pool, TileFn fn, void* ctx) {
+            if (width <= 0 || height <= 0) return;
+            tileWidth = std::max(1, std::min(tileWidth, width));
+            tileHeight = std::max(1, std::min(tileHeight, height));
+
+            const int tilesX = (width + tileWidth - 1) / tileWidth;
+            const int tilesY = (height + tileHeight - 1) / tileHeight;
+            const int total = tilesX * tilesY;
+
+            auto tileAt = [&](int index) {
+                Tile t;
+                t.x = (index % tilesX) * tileWidth;
+                t.y = (index / tilesX) * tileHeight;
+                t.width = std::min(tileWidth, width - t.x);
+                t.height = std::min(tileHeight, height - t.y);
+                return t;
+            };
+
+            // the caller's cancellation token is checked before every tile
+            const std::atomic<bool>* cancel = current_cancel_flag();
+
+            ThreadPool& workerPool = pool ? *pool : default_thread_pool();
+            unsigned workers = std::min({ resolve_thread_count(threads), workerPool.size(), static_cast<unsigned>(total) });
+            if (workers <= 1) {
+                for (int i = 0; i < total; ++i) {
+                    if (cancel && cancel->load(std::memory_order_relaxed)) throw GenerationCancelled();
+                    fn(ctx, tileAt(i));
+                }
+                return;
+            }
+
+            // Contiguous runs in row-major tile order keep each worker's tiles adjacent
+            const TileRangeStack::Lease ranges(t_tileRanges, workers);
+            for (unsigned w = 0; w < workers; ++w) {
+                ranges[w].next.store(static_cast<int>(static_cast<long long>(total) * w / workers), std::memory_order_relaxed);
+                ranges[w].end = static_cast<int>(static_cast<long long>(total) * (w + 1) / workers);
+            }
+
+            std::atomic<bool> failed{ false };
+            std::exception_ptr error;
+            std::mutex errorMutex;
+
+            auto work = [&](unsigned self) {
+                // own run first, then steal from the others in ring order
+                for (unsigned k = 0; k < workers && !failed.load(std::memory_order_relaxed); ++k) {
+                    TileRange& range = ranges[(self + k) % workers];
+                    int index;
+                    while (!failed.load(std::memory_order_relaxed) &&
+                        (index = range.next.fetch_add(1, std::memory_order_relaxed)) < range.end) {
+                        try {
+                            if (cancel && cancel->load(std::memory_order_relaxed)) throw GenerationCancelled();
+                            fn(ctx, tileAt(index));
+                        }
+                        catch (...) {
+                            std::lock_guard<std::mutex> lock(errorMutex);
+                            if (!error) error = std::current_exception();
+                            failed.store(true, std::memory_order_relaxed);
+                        }
+                    }
+                }
+            };
+
+            // calling thread is worker 0; runs that no pool thread picks up get stolen
+            workerPool.run(workers, work);
+
+            if (error) std::rethrow_exception(error);
+        }
+
+    } // namespace detail
+
+} // namespace Noise
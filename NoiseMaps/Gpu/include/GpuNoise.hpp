@@ -0,0 +1,145 @@
+// GpuNoise.hpp
+// ------------
+// Optional OpenCL backend for the Perlin and Simplex region generators
+// (library NoiseGpu, built with -DBUILD_GPU=ON). A generator uploads its
+// permutation table once; every map is then evaluated on the device, one
+// work-item per pixel with the whole octave loop fused, into a device-resident
+// GpuMap. Maps stay on the device until downloaded, and their buffers can be
+// handed to further OpenCL work on the same context and queue.
+//
+// Pixel positions are computed on the host exactly as the CPU generators do,
+// and the kernels are built without contraction. Perlin's per-octave
+// (n + 1) / 2 is a multiply by 0.5 on the device (exact, as the CPU divide is),
+// so the only difference from generate_*_region can come from the final divide
+// by the total amplitude (OpenCL allows 2.5 ulp), in both kernels, and from
+// devices flushing denormals. Maps are identical on devices with correctly
+// rounded division and denormals (bit_exact()), and within |gpu - cpu| <= 2e-7
+// elsewhere (tests/gpu_tests.cpp checks both on the first device).
+//
+// A context, and the generators and maps built on it, must be used by one
+// thread at a time. The context must outlive them.
+//
+// Usage:
+//   Noise::GpuContext gpu;                              // first GPU device
+//   Noise::PerlinNoise perlin(42);
+//   Noise::GpuPerlin gpuPerlin(gpu, perlin);            // uploads the table
+//   Noise::GpuMap map = gpuPerlin.generate_region(params, 0, 0, 4096, 4096);
+//   Noise::NoiseMap result = map.download();            // == generate_perlin_region(perlin, params, 0, 0, 4096, 4096)
+
+#pragma once
+#ifndef CL_TARGET_OPENCL_VERSION
+#define CL_TARGET_OPENCL_VERSION 120
+#endif
+#if defined(__APPLE__)
+#include <OpenCL/cl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Noise.hpp"
+#include "NoiseMap.hpp"
+
+namespace Noise {
+
+    class GpuContext {
+    public:
+        // "platform: device" of every OpenCL device, GPUs first; the index selects
+        // the device of a GpuContext
+        static std::vector<std::string> devices();
+
+        explicit GpuContext(int device = 0);
+        ~GpuContext();
+        GpuContext(const GpuContext&) = delete;
+        GpuContext& operator=(const GpuContext&) = delete;
+
+        const std::string& device_name() const { return name_; }
+        // Maps equal the CPU generators bit for bit (see above)
+        bool bit_exact() const { return bitExact_; }
+
+        // Native handles, for running further OpenCL work on GpuMap buffers
+        cl_device_id device() const { return device_; }
+        cl_context context() const { return context_; }
+        cl_command_queue queue() const { return queue_; }
+
+    private:
+        friend class GpuPerlin;
+        friend class GpuSimplex;
+
+        void release();
+
+        cl_device_id device_ = nullptr;
+        cl_context context_ = nullptr;
+        cl_command_queue queue_ = nullptr;
+        cl_program program_ = nullptr;
+        cl_kernel perlinKernel_ = nullptr;
+        cl_kernel simplexKernel_ = nullptr;
+        std::string name_;
+        bool bitExact_ = false;
+    };
+
+    // Device-resident float map: row y starts at float y * width() of buffer()
+    class GpuMap {
+    public:
+        GpuMap() = default;
+        GpuMap(const GpuContext& context, int width, int height);
+        ~GpuMap();
+        GpuMap(GpuMap&& other) noexcept;
+        GpuMap& operator=(GpuMap&& other) noexcept;
+        GpuMap(const GpuMap&) = delete;
+        GpuMap& operator=(const GpuMap&) = delete;
+
+        int width() const { return width_; }
+        int height() const { return height_; }
+        bool empty() const { return buffer_ == nullptr; }
+        cl_mem buffer() const { return buffer_; }
+
+        // Waits for the map's kernels and copies it to the host
+        void download_into(float* dst, std::size_t stride) const;
+        NoiseMap download() const;
+
+    private:
+        const GpuContext* context_ = nullptr;
+        cl_mem buffer_ = nullptr;
+        int width_ = 0;
+        int height_ = 0;
+    };
+
+    class GpuPerlin {
+    public:
+        GpuPerlin(const GpuContext& context, const PerlinNoise& generator);
+        ~GpuPerlin();
+        GpuPerlin(const GpuPerlin&) = delete;
+        GpuPerlin& operator=(const GpuPerlin&) = delete;
+
+        // generate_perlin_region on the device, at map's size; returns once the
+        // kernel is queued
+        void generate_region_into(GpuMap& map, const PerlinParams& params, std::int64_t originX, std::int64_t originY) const;
+        GpuMap generate_region(const PerlinParams& params, std::int64_t originX, std::int64_t originY, int width, int height) const;
+
+    private:
+        const GpuContext* context_;
+        cl_mem permutation_ = nullptr;
+    };
+
+    class GpuSimplex {
+    public:
+        GpuSimplex(const GpuContext& context, const SimplexNoise& generator);
+        ~GpuSimplex();
+        GpuSimplex(const GpuSimplex&) = delete;
+        GpuSimplex& operator=(const GpuSimplex&) = delete;
+
+        // generate_simplex_region on the device, at map's size; returns once the
+        // kernel is queued
+        void generate_region_into(GpuMap& map, const SimplexParams& params, std::int64_t originX, std::int64_t originY) const;
+        GpuMap generate_region(const SimplexParams& params, std::int64_t originX, std::int64_t originY, int width, int height) const;
+
+    private:
+        const GpuContext* context_;
+        cl_mem permutation_ = nullptr;
+    };
+
+} // namespace Noise
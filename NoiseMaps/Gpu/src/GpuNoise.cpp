@@ -0,0 +1,436 @@
+// GpuNoise.cpp
+#include "GpuNoise.hpp"
+#include "FractalParams.hpp"
+#include "NoiseStats.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace Noise {
+
+    // ---------------------------------------------------------
+    // Device kernels: noise() / noise2D() and the fused octave loop, with the
+    // CPU code's operation order. Positions come precomputed per octave
+    // (xs: octaves x width, ys: octaves x height) so the device only adds,
+    // multiplies and floors, which OpenCL rounds exactly; contraction into
+    // mad / fma is disabled.
+    // ---------------------------------------------------------
+    static const char* const kKernelSource = R"CLC(
+#pragma OPENCL FP_CONTRACT OFF
+
+float perlin_fade(float t) {
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+float perlin_lerp(float a, float b, float t) {
+    return a + t * (b - a);
+}
+
+float perlin_grad(int hash, float x, float y) {
+    int h = hash & 3;
+    float u = (h < 2) ? x : y;
+    float v = (h < 2) ? y : x;
+    return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+}
+
+float perlin_noise(__global const uchar* p, float x, float y) {
+    int X = (int)floor(x) & 255;
+    int Y = (int)floor(y) & 255;
+
+    float xf = x - floor(x);
+    float yf = y - floor(y);
+
+    float u = perlin_fade(xf);
+    float v = perlin_fade(yf);
+
+    int aa = p[p[X] + Y];
+    int ab = p[p[X] + Y + 1];
+    int ba = p[p[X + 1] + Y];
+    int bb = p[p[X + 1] + Y + 1];
+
+    float x1 = perlin_lerp(perlin_grad(aa, xf, yf), perlin_grad(ba, xf - 1.0f, yf), u);
+    float x2 = perlin_lerp(perlin_grad(ab, xf, yf - 1.0f), perlin_grad(bb, xf - 1.0f, yf - 1.0f), u);
+    // * 0.5f: exact like the CPU's / 2.0f, where an OpenCL divide may be off by 2.5 ulp
+    return (perlin_lerp(x1, x2, v) + 1.0f) * 0.5f;
+}
+
+__constant float kGrad3[8][2] = {
+    {1, 1}, {-1, 1}, {1, -1}, {-1, -1},
+    {1, 0}, {-1, 0}, {0, 1}, {0, -1}
+};
+
+float simplex_noise(__global const uchar* perm, float xin, float yin) {
+    const float F2 = 0.36602540378f;
+    const float G2 = 0.2113248654f;
+    float s = (xin + yin) * F2;
+    int i = (int)floor(xin + s);
+    int j = (int)floor(yin + s);
+
+    float t = (float)(i + j) * G2;
+    float X0 = (float)i - t;
+    float Y0 = (float)j - t;
+    float x0 = xin - X0;
+    float y0 = yin - Y0;
+
+    int i1 = (x0 > y0) ? 1 : 0;
+    int j1 = 1 - i1;
+
+    float x1 = x0 - (float)i1 + G2;
+    float y1 = y0 - (float)j1 + G2;
+    float x2 = x0 - 1.0f + 2.0f * G2;
+    float y2 = y0 - 1.0f + 2.0f * G2;
+
+    int ii = i & 255;
+    int jj = j & 255;
+    int gi0 = perm[ii + perm[jj]] & 7;
+    int gi1 = perm[ii + i1 + perm[jj + j1]] & 7;
+    int gi2 = perm[ii + 1 + perm[jj + 1]] & 7;
+
+    float t0 = 0.5f - x0 * x0 - y0 * y0;
+    float t0sq = t0 * t0;
+    float n0 = (t0 >= 0.0f) ? t0sq * t0sq * (kGrad3[gi0][0] * x0 + kGrad3[gi0][1] * y0) : 0.0f;
+
+    float t1 = 0.5f - x1 * x1 - y1 * y1;
+    float t1sq = t1 * t1;
+    float n1 = (t1 >= 0.0f) ? t1sq * t1sq * (kGrad3[gi1][0] * x1 + kGrad3[gi1][1] * y1) : 0.0f;
+
+    float t2 = 0.5f - x2 * x2 - y2 * y2;
+    float t2sq = t2 * t2;
+    float n2 = (t2 >= 0.0f) ? t2sq * t2sq * (kGrad3[gi2][0] * x2 + kGrad3[gi2][1] * y2) : 0.0f;
+
+    return 70.0f * (n0 + n1 + n2);
+}
+
+__kernel void perlin_fractal(__global const uchar* perm, __global const float* xs, __global const float* ys,
+    __global const float* amplitudes, int octaves, float maxAmplitude, int width, int height, __global float* out) {
+    const int x = (int)get_global_id(0);
+    const int y = (int)get_global_id(1);
+    if (x >= width || y >= height) return;
+    float acc = 0.0f;
+    for (int o = 0; o < octaves; ++o)
+        acc += perlin_noise(perm, xs[o * width + x], ys[o * height + y]) * amplitudes[o];
+    out[y * width + x] = acc / maxAmplitude;
+}
+
+__kernel void simplex_fractal(__global const uchar* perm, __global const float* xs, __global const float* ys,
+    __global const float* amplitudes, int octaves, float maxAmplitude, int width, int height, __global float* out) {
+    const int x = (int)get_global_id(0);
+    const int y = (int)get_global_id(1);
+    if (x >= width || y >= height) return;
+    float acc = 0.0f;
+    for (int o = 0; o < octaves; ++o)
+        acc += simplex_noise(perm, xs[o * width + x], ys[o * height + y]) * amplitudes[o];
+    out[y * width + x] = (acc / maxAmplitude) * 0.5f + 0.5f;
+}
+)CLC";
+
+    // ---------------------------------------------------------
+    // Errors and device discovery
+    // ---------------------------------------------------------
+    static void check(cl_int status, const char* call) {
+        if (status != CL_SUCCESS)
+            throw std::runtime_error(std::string("OpenCL: ") + call + " failed with error " + std::to_string(status));
+    }
+
+    static std::string platform_info(cl_platform_id platform, cl_platform_info what) {
+        std::size_t size = 0;
+        check(clGetPlatformInfo(platform, what, 0, nullptr, &size), "clGetPlatformInfo");
+        std::string value(size, '\0');
+        check(clGetPlatformInfo(platform, what, size, &value[0], nullptr), "clGetPlatformInfo");
+        if (!value.empty() && value.back() == '\0') value.pop_back();
+        return value;
+    }
+
+    static std::string device_info(cl_device_id device, cl_device_info what) {
+        std::size_t size = 0;
+        check(clGetDeviceInfo(device, what, 0, nullptr, &size), "clGetDeviceInfo");
+        std::string value(size, '\0');
+        check(clGetDeviceInfo(device, what, size, &value[0], nullptr), "clGetDeviceInfo");
+        if (!value.empty() && value.back() == '\0') value.pop_back();
+        return value;
+    }
+
+    struct DeviceEntry {
+        cl_device_id device;
+        std::string name;       // "platform: device"
+    };
+
+    // CL_PLATFORM_NOT_FOUND_KHR: the ICD loader found no platform
+    static constexpr cl_int kPlatformNotFound = -1001;
+
+    // Every device of every platform, GPUs first
+    static std::vector<DeviceEntry> list_devices() {
+        cl_uint platformCount = 0;
+        const cl_int status = clGetPlatformIDs(0, nullptr, &platformCount);
+        if (status == kPlatformNotFound || platformCount == 0) return {};
+        check(status, "clGetPlatformIDs");
+        std::vector<cl_platform_id> platforms(platformCount);
+        check(clGetPlatformIDs(platformCount, platforms.data(), nullptr), "clGetPlatformIDs");
+
+        std::vector<DeviceEntry> gpus;
+        std::vector<DeviceEntry> others;
+        for (cl_platform_id platform : platforms) {
+            cl_uint deviceCount = 0;
+            if (clGetDeviceIDs(platform, CL_DEVICE_TYPE_ALL, 0, nullptr, &deviceCount) != CL_SUCCESS || deviceCount == 0) continue;
+            std::vector<cl_device_id> devices(deviceCount);
+            check(clGetDeviceIDs(platform, CL_DEVICE_TYPE_ALL, deviceCount, devices.data(), nullptr), "clGetDeviceIDs");
+            const std::string platformName = platform_info(platform, CL_PLATFORM_NAME);
+            for (cl_device_id device : devices) {
+                cl_device_type type = 0;
+                check(clGetDeviceInfo(device, CL_DEVICE_TYPE, sizeof(type), &type, nullptr), "clGetDeviceInfo");
+                DeviceEntry entry{ device, platformName + ": " + device_info(device, CL_DEVICE_NAME) };
+                ((type & CL_DEVICE_TYPE_GPU) ? gpus : others).push_back(std::move(entry));
+            }
+        }
+        gpus.insert(gpus.end(), others.begin(), others.end());
+        return gpus;
+    }
+
+    std::vector<std::string> GpuContext::devices() {
+        std::vector<std::string> names;
+        for (const DeviceEntry& entry : list_devices()) names.push_back(entry.name);
+        return names;
+    }
+
+    // ---------------------------------------------------------
+    // Context
+    // ---------------------------------------------------------
+    GpuContext::GpuContext(int device) {
+        const std::vector<DeviceEntry> devices = list_devices();
+        if (devices.empty())
+            throw std::runtime_error("OpenCL: no platform with a device found");
+        if (device < 0 || device >= static_cast<int>(devices.size()))
+            throw std::out_of_range("device must be in [0," + std::to_string(devices.size() - 1) + "], got: " + std::to_string(device));
+        device_ = devices[static_cast<std::size_t>(device)].device;
+        name_ = devices[static_cast<std::size_t>(device)].name;
+
+        cl_device_fp_config fp = 0;
+        check(clGetDeviceInfo(device_, CL_DEVICE_SINGLE_FP_CONFIG, sizeof(fp), &fp, nullptr), "clGetDeviceInfo");
+        const bool exactDivide = (fp & CL_FP_CORRECTLY_ROUNDED_DIVIDE_SQRT) != 0;
+        bitExact_ = exactDivide && (fp & CL_FP_DENORM) != 0;
+
+        try {
+            cl_int status = CL_SUCCESS;
+            context_ = clCreateContext(nullptr, 1, &device_, nullptr, nullptr, &status);
+            check(status, "clCreateContext");
+            queue_ = clCreateCommandQueue(context_, device_, 0, &status);
+            check(status, "clCreateCommandQueue");
+
+            const char* source = kKernelSource;
+            program_ = clCreateProgramWithSource(context_, 1, &source, nullptr, &status);
+            check(status, "clCreateProgramWithSource");
+            const std::string buildOptions = exactDivide ? "-cl-std=CL1.2 -cl-fp32-correctly-rounded-divide-sqrt" : "-cl-std=CL1.2";
+            status = clBuildProgram(program_, 1, &device_, buildOptions.c_str(), nullptr, nullptr);
+            if (status == CL_BUILD_PROGRAM_FAILURE) {
+                std::size_t size = 0;
+                clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &size);
+                std::string log(size, '\0');
+                clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, size, &log[0], nullptr);
+                throw std::runtime_error("OpenCL: kernel build failed on " + name_ + ":\n" + log);
+            }
+            check(status, "clBuildProgram");
+
+            perlinKernel_ = clCreateKernel(program_, "perlin_fractal", &status);
+            check(status, "clCreateKernel");
+            simplexKernel_ = clCreateKernel(program_, "simplex_fractal", &status);
+            check(status, "clCreateKernel");
+        }
+        catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    GpuContext::~GpuContext() {
+        release();
+    }
+
+    void GpuContext::release() {
+        if (simplexKernel_) clReleaseKernel(simplexKernel_);
+        if (perlinKernel_) clReleaseKernel(perlinKernel_);
+        if (program_) clReleaseProgram(program_);
+        if (queue_) clReleaseCommandQueue(queue_);
+        if (context_) clReleaseContext(context_);
+        simplexKernel_ = nullptr;
+        perlinKernel_ = nullptr;
+        program_ = nullptr;
+        queue_ = nullptr;
+        context_ = nullptr;
+    }
+
+    // ---------------------------------------------------------
+    // Device maps
+    // ---------------------------------------------------------
+    GpuMap::GpuMap(const GpuContext& context, int width, int height)
+        : context_(&context), width_(width), height_(height) {
+        if (width <= 0 || height <= 0)
+            throw std::invalid_argument("width/height must be > 0, got: " + std::to_string(width) + "x" + std::to_string(height));
+        cl_int status = CL_SUCCESS;
+        buffer_ = clCreateBuffer(context.context(), CL_MEM_READ_WRITE,
+            sizeof(float) * static_cast<std::size_t>(width) * static_cast<std::size_t>(height), nullptr, &status);
+        check(status, "clCreateBuffer");
+    }
+
+    GpuMap::~GpuMap() {
+        if (buffer_) clReleaseMemObject(buffer_);
+    }
+
+    GpuMap::GpuMap(GpuMap&& other) noexcept
+        : context_(other.context_), buffer_(std::exchange(other.buffer_, nullptr)),
+          width_(std::exchange(other.width_, 0)), height_(std::exchange(other.height_, 0)) {}
+
+    GpuMap& GpuMap::operator=(GpuMap&& other) noexcept {
+        if (this != &other) {
+            if (buffer_) clReleaseMemObject(buffer_);
+            context_ = other.context_;
+            buffer_ = std::exchange(other.buffer_, nullptr);
+            width_ = std::exchange(other.width_, 0);
+            height_ = std::exchange(other.height_, 0);
+        }
+        return *this;
+    }
+
+    void GpuMap::download_into(float* dst, std::size_t stride) const {
+        if (empty())
+            throw std::logic_error("download_into: empty GpuMap");
+        if (!dst)
+            throw std::invalid_argument("dst must not be null");
+        if (stride < static_cast<std::size_t>(width_))
+            throw std::invalid_argument("stride must be >= width, got: " + std::to_string(stride));
+        // waits for the queued kernels: device evaluation plus the copy
+        const StageTimer timer(StatsStage::Evaluate, "gpu",
+            static_cast<std::uint64_t>(width_) * static_cast<std::uint64_t>(height_));
+        const std::size_t origin[3] = { 0, 0, 0 };
+        const std::size_t region[3] = { sizeof(float) * static_cast<std::size_t>(width_), static_cast<std::size_t>(height_), 1 };
+        check(clEnqueueReadBufferRect(context_->queue(), buffer_, CL_TRUE, origin, origin, region,
+            sizeof(float) * static_cast<std::size_t>(width_), 0, sizeof(float) * stride, 0, dst, 0, nullptr, nullptr),
+            "clEnqueueReadBufferRect");
+    }
+
+    NoiseMap GpuMap::download() const {
+        NoiseMap map = [&] {
+            const StageTimer timer(StatsStage::Setup, "gpu", 0);
+            return NoiseMap(width_, height_);
+        }();
+        download_into(map.data(), map.stride());
+        return map;
+    }
+
+    // ---------------------------------------------------------
+    // Generators
+    // ---------------------------------------------------------
+    static cl_mem upload_permutation(const GpuContext& context, const std::uint8_t* table) {
+        cl_int status = CL_SUCCESS;
+        cl_mem buffer = clCreateBuffer(context.context(), CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, 512,
+            const_cast<std::uint8_t*>(table), &status);
+        check(status, "clCreateBuffer");
+        return buffer;
+    }
+
+    // Queues the fractal kernel on map. Positions and amplitudes are the CPU
+    // generators' running products, computed here in the same order.
+    static void run_fractal(const GpuContext& context, cl_kernel kernel, cl_mem permutation, const char* generator,
+        const PerlinParams& p, std::int64_t originX, std::int64_t originY, GpuMap& map) {
+        validate_fractal_params(p);
+        if (map.empty())
+            throw std::invalid_argument("generate_region_into: empty GpuMap");
+        const int width = map.width();
+        const int height = map.height();
+        // host side only: the kernel runs asynchronously (GpuMap::download)
+        const StageTimer timer(StatsStage::Setup, generator, 0);
+
+        std::vector<float> xs(static_cast<std::size_t>(p.octaves) * static_cast<std::size_t>(width));
+        std::vector<float> ys(static_cast<std::size_t>(p.octaves) * static_cast<std::size_t>(height));
+        std::vector<float> amplitudes(static_cast<std::size_t>(p.octaves));
+        float maxAmplitude = 0.0f;
+        float amplitude = 1.0f;
+        float freq = p.frequency;
+        for (int o = 0; o < p.octaves; ++o) {
+            float* xo = xs.data() + static_cast<std::size_t>(o) * static_cast<std::size_t>(width);
+            float* yo = ys.data() + static_cast<std::size_t>(o) * static_cast<std::size_t>(height);
+            for (int x = 0; x < width; ++x) xo[x] = (static_cast<float>(originX + x) + p.base) / p.scale * freq;
+            for (int y = 0; y < height; ++y) yo[y] = (static_cast<float>(originY + y) + p.base) / p.scale * freq;
+            amplitudes[static_cast<std::size_t>(o)] = amplitude;
+            maxAmplitude += amplitude;
+            amplitude *= p.persistence;
+            freq *= p.lacunarity;
+        }
+
+        // The tables go with the queued kernel: OpenCL frees them once it has run
+        cl_int status = CL_SUCCESS;
+        cl_mem xsBuffer = clCreateBuffer(context.context(), CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+            sizeof(float) * xs.size(), xs.data(), &status);
+        check(status, "clCreateBuffer");
+        cl_mem ysBuffer = clCreateBuffer(context.context(), CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+            sizeof(float) * ys.size(), ys.data(), &status);
+        if (status != CL_SUCCESS) clReleaseMemObject(xsBuffer);
+        check(status, "clCreateBuffer");
+        cl_mem amplitudeBuffer = clCreateBuffer(context.context(), CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+            sizeof(float) * amplitudes.size(), amplitudes.data(), &status);
+        if (status != CL_SUCCESS) {
+            clReleaseMemObject(ysBuffer);
+            clReleaseMemObject(xsBuffer);
+        }
+        check(status, "clCreateBuffer");
+
+        const cl_int octaves = p.octaves;
+        const cl_int w = width;
+        const cl_int h = height;
+        const cl_mem out = map.buffer();
+        status = clSetKernelArg(kernel, 0, sizeof(cl_mem), &permutation);
+        if (status == CL_SUCCESS) status = clSetKernelArg(kernel, 1, sizeof(cl_mem), &xsBuffer);
+        if (status == CL_SUCCESS) status = clSetKernelArg(kernel, 2, sizeof(cl_mem), &ysBuffer);
+        if (status == CL_SUCCESS) status = clSetKernelArg(kernel, 3, sizeof(cl_mem), &amplitudeBuffer);
+        if (status == CL_SUCCESS) status = clSetKernelArg(kernel, 4, sizeof(cl_int), &octaves);
+        if (status == CL_SUCCESS) status = clSetKernelArg(kernel, 5, sizeof(float), &maxAmplitude);
+        if (status == CL_SUCCESS) status = clSetKernelArg(kernel, 6, sizeof(cl_int), &w);
+        if (status == CL_SUCCESS) status = clSetKernelArg(kernel, 7, sizeof(cl_int), &h);
+        if (status == CL_SUCCESS) status = clSetKernelArg(kernel, 8, sizeof(cl_mem), &out);
+        if (status == CL_SUCCESS) {
+            const std::size_t global[2] = { static_cast<std::size_t>(width), static_cast<std::size_t>(height) };
+            status = clEnqueueNDRangeKernel(context.queue(), kernel, 2, nullptr, global, nullptr, 0, nullptr, nullptr);
+        }
+        clReleaseMemObject(amplitudeBuffer);
+        clReleaseMemObject(ysBuffer);
+        clReleaseMemObject(xsBuffer);
+        check(status, "clEnqueueNDRangeKernel");
+    }
+
+    GpuPerlin::GpuPerlin(const GpuContext& context, const PerlinNoise& generator)
+        : context_(&context), permutation_(upload_permutation(context, generator.permutation())) {}
+
+    GpuPerlin::~GpuPerlin() {
+        clReleaseMemObject(permutation_);
+    }
+
+    void GpuPerlin::generate_region_into(GpuMap& map, const PerlinParams& params, std::int64_t originX, std::int64_t originY) const {
+        run_fractal(*context_, context_->perlinKernel_, permutation_, "perlin", params, originX, originY, map);
+    }
+
+    GpuMap GpuPerlin::generate_region(const PerlinParams& params, std::int64_t originX, std::int64_t originY, int width, int height) const {
+        validate_fractal_params(params);
+        GpuMap map(*context_, width, height);
+        generate_region_into(map, params, originX, originY);
+        return map;
+    }
+
+    GpuSimplex::GpuSimplex(const GpuContext& context, const SimplexNoise& generator)
+        : context_(&context), permutation_(upload_permutation(context, generator.permutation())) {}
+
+    GpuSimplex::~GpuSimplex() {
+        clReleaseMemObject(permutation_);
+    }
+
+    void GpuSimplex::generate_region_into(GpuMap& map, const SimplexParams& params, std::int64_t originX, std::int64_t originY) const {
+        run_fractal(*context_, context_->simplexKernel_, permutation_, "simplex", as_fractal_params<PerlinParams>(params), originX, originY, map);
+    }
+
+    GpuMap GpuSimplex::generate_region(const SimplexParams& params, std::int64_t originX, std::int64_t originY, int width, int height) const {
+        validate_fractal_params(as_fractal_params<PerlinParams>(params));
+        GpuMap map(*context_, width, height);
+        generate_region_into(map, params, originX, originY);
+        return map;
+    }
+
+} // namespace Noise
@@ -0,0 +1,107 @@
+// NoiseGraph.hpp
+// --------------
+// Composable noise pipelines: sources (Perlin, Simplex, pink, constants) feed
+// warps, transforms and combinations, and the output node is evaluated per
+// tile in one fused pass. Every pixel runs the whole graph on chunks of 64
+// pixels held in small per-node scratch buffers, through the batched SIMD
+// noise kernels, so no intermediate map is ever built. A graph is immutable
+// once built; generate() is const and may run concurrently for any number of
+// regions or chunks. The generators it references must outlive it.
+//
+// Usage:
+//   Noise::PerlinNoise perlin(42);
+//   Noise::SimplexNoise simplex(7);
+//   Noise::NoiseGraph g;
+//   auto dx = g.simplex(simplex, warpParams);
+//   auto dy = g.simplex(simplex, warpParamsShifted);
+//   auto terrain = g.warp(g.perlin(perlin, params), dx, dy, 40.0f);   // up to +-20 px
+//   auto ridges = g.ridged(g.perlin(perlin, ridgeParams));
+//   g.set_output(g.normalize(g.blend(terrain, ridges, 0.3f), 0.1f, 0.9f));
+//   Noise::NoiseMap chunk = g.generate_chunk(cx, cy, 256);
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Noise.hpp"
+#include "NoiseMap.hpp"
+#include "GenerateOptions.hpp"
+
+namespace Noise {
+
+    class NoiseGraph {
+    public:
+        // Handle of a node of this graph
+        struct Node {
+            int id = -1;
+        };
+
+        // Sources at world pixel (x, y), warped coordinates included. Perlin and
+        // Simplex nodes sample exactly as generate_perlin_region /
+        // generate_simplex_region do, so an unwarped source node equals those maps
+        // bit for bit.
+        Node perlin(const PerlinNoise& generator, const PerlinParams& params);
+        Node simplex(const SimplexNoise& generator, const SimplexParams& params);
+        // Pixels of the mapWidth x mapHeight pink map of generate_pink_region_into
+        // (Counter RNG, compact storage; seed >= 0). Pink noise only exists at
+        // whole pixels inside that map: it cannot be warped, and generated
+        // regions must lie inside the map.
+        Node pink(int mapWidth, int mapHeight, const PinkParams& params, int seed);
+        Node constant(float value);
+
+        // `source` sampled at (x + strength * (dx - 0.5), y + strength * (dy - 0.5)),
+        // dx and dy evaluated at (x, y): [0, 1] offset sources move a pixel by up
+        // to strength / 2 in either direction. Warps nest.
+        Node warp(Node source, Node dx, Node dy, float strength);
+
+        Node ridged(Node a);                                // 1 - |2a - 1|
+        Node scale_bias(Node a, float scale, float bias);   // a * scale + bias
+        Node add(Node a, Node b);
+        Node multiply(Node a, Node b);
+        Node blend(Node a, Node b, float t);                // a + (b - a) * t
+        Node blend(Node a, Node b, Node mask);              // per pixel t = mask
+        // (a - low) / (high - low), clamped to [0, 1]; high != low
+        Node normalize(Node a, float low = 0.0f, float high = 1.0f);
+
+        // Node that generate() evaluates; defaults to the last node added
+        void set_output(Node node);
+        Node output() const;
+        int node_count() const { return static_cast<int>(nodes_.size()); }
+
+        // The width x height window at world pixel (originX, originY), tiles of
+        // options.tileSize on options.threads workers of options.pool
+        void generate_into(float* dst, std::size_t stride, std::int64_t originX, std::int64_t originY,
+            int width, int height, const GenerateOptions& options = {}) const;
+        NoiseMap generate(std::int64_t originX, std::int64_t originY, int width, int height,
+            const GenerateOptions& options = {}) const;
+        // Square chunk (chunkX, chunkY): the region at (chunkX * chunkSize, chunkY * chunkSize)
+        NoiseMap generate_chunk(std::int64_t chunkX, std::int64_t chunkY, int chunkSize,
+            const GenerateOptions& options = {}) const;
+
+    private:
+        enum class Op { Perlin, Simplex, Pink, Constant, Warp, Ridged, ScaleBias, Add, Multiply, Blend, BlendMask, Normalize };
+
+        struct NodeData {
+            Op op = Op::Constant;
+            int a = -1, b = -1, c = -1;         // inputs
+            float p0 = 0.0f, p1 = 0.0f;         // op parameters
+            const PerlinNoise* perlin = nullptr;
+            const SimplexNoise* simplex = nullptr;
+            PerlinParams params;                // Perlin / Simplex (Simplex: frequency 1)
+            PinkParams pink;
+            int pinkWidth = 0, pinkHeight = 0, pinkSeed = 0;
+            int pinkSlot = -1;                  // index of the node's per-tile pink buffer
+            bool hasPink = false;               // pink source in this node's inputs (or itself)
+        };
+
+        class Evaluator;
+
+        Node push(NodeData node);
+        const NodeData& input(Node node, const char* what) const;
+
+        std::vector<NodeData> nodes_;
+        int pinkCount_ = 0;
+        int output_ = -1;
+    };
+
+} // namespace Noise
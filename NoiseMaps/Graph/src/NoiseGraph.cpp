@@ -0,0 +1,412 @@
+// NoiseGraph.cpp
+#include "NoiseGraph.hpp"
+#include "FractalNoise.hpp"
+#include "FractalParams.hpp"
+#include "NoiseStats.hpp"
+#include "TileScheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace Noise {
+
+    // pixels evaluated per pass through the graph
+    static constexpr int kChunk = 64;
+    // scratch chunks per node: result plus three working buffers
+    static constexpr std::size_t kNodeScratch = 4 * kChunk;
+
+    // ---------------------------------------------------------
+    // Building
+    // ---------------------------------------------------------
+    NoiseGraph::Node NoiseGraph::push(NodeData node) {
+        for (int in : { node.a, node.b, node.c }) {
+            if (in >= 0 && nodes_[static_cast<std::size_t>(in)].hasPink) node.hasPink = true;
+        }
+        nodes_.push_back(std::move(node));
+        output_ = static_cast<int>(nodes_.size()) - 1;
+        return Node{ output_ };
+    }
+
+    const NoiseGraph::NodeData& NoiseGraph::input(Node node, const char* what) const {
+        if (node.id < 0 || node.id >= static_cast<int>(nodes_.size()))
+            throw std::invalid_argument(std::string("NoiseGraph::") + what + ": node " + std::to_string(node.id) + " is not part of this graph");
+        return nodes_[static_cast<std::size_t>(node.id)];
+    }
+
+    NoiseGraph::Node NoiseGraph::perlin(const PerlinNoise& generator, const PerlinParams& params) {
+        validate_fractal_params(params);
+        NodeData node;
+        node.op = Op::Perlin;
+        node.perlin = &generator;
+        node.params = params;
+        node.p0 = max_amplitude(params);
+        return push(std::move(node));
+    }
+
+    NoiseGraph::Node NoiseGraph::simplex(const SimplexNoise& generator, const SimplexParams& params) {
+        NodeData node;
+        node.op = Op::Simplex;
+        node.simplex = &generator;
+        node.params = as_fractal_params<PerlinParams>(params);
+        validate_fractal_params(node.params);
+        node.p0 = max_amplitude(node.params);
+        return push(std::move(node));
+    }
+
+    NoiseGraph::Node NoiseGraph::pink(int mapWidth, int mapHeight, const PinkParams& params, int seed) {
+        if (mapWidth <= 0 || mapHeight <= 0)
+            throw std::invalid_argument("mapWidth/mapHeight must be > 0, got: " + std::to_string(mapWidth) + "x" + std::to_string(mapHeight));
+        if (params.octaves < 1)
+            throw std::invalid_argument("octaves must be >= 1, got: " + std::to_string(params.octaves));
+        if (seed < 0)
+            throw std::invalid_argument("seed must be >= 0 for pink sources, got: " + std::to_string(seed));
+        NodeData node;
+        node.op = Op::Pink;
+        node.pink = params;
+        node.pinkWidth = mapWidth;
+        node.pinkHeight = mapHeight;
+        node.pinkSeed = seed;
+        node.pinkSlot = pinkCount_++;
+        node.hasPink = true;
+        return push(std::move(node));
+    }
+
+    NoiseGraph::Node NoiseGraph::constant(float value) {
+        NodeData node;
+        node.op = Op::Constant;
+        node.p0 = value;
+        return push(std::move(node));
+    }
+
+    NoiseGraph::Node NoiseGraph::warp(Node source, Node dx, Node dy, float strength) {
+        if (input(source, "warp").hasPink)
+            throw std::invalid_argument("NoiseGraph::warp: pink noise is only defined at whole pixels and cannot be warped");
+        input(dx, "warp");
+        input(dy, "warp");
+        NodeData node;
+        node.op = Op::Warp;
+        node.a = source.id;
+        node.b = dx.id;
+        node.c = dy.id;
+        node.p0 = strength;
+        return push(std::move(node));
+    }
+
+    NoiseGraph::Node NoiseGraph::ridged(Node a) {
+        input(a, "ridged");
+        NodeData node;
+        node.op = Op::Ridged;
+        node.a = a.id;
+        return push(std::move(node));
+    }
+
+    NoiseGraph::Node NoiseGraph::scale_bias(Node a, float scale, float bias) {
+        input(a, "scale_bias");
+        NodeData node;
+        node.op = Op::ScaleBias;
+        node.a = a.id;
+        node.p0 = scale;
+        node.p1 = bias;
+        return push(std::move(node));
+    }
+
+    NoiseGraph::Node NoiseGraph::add(Node a, Node b) {
+        input(a, "add");
+        input(b, "add");
+        NodeData node;
+        node.op = Op::Add;
+        node.a = a.id;
+        node.b = b.id;
+        return push(std::move(node));
+    }
+
+    NoiseGraph::Node NoiseGraph::multiply(Node a, Node b) {
+        input(a, "multiply");
+        input(b, "multiply");
+        NodeData node;
+        node.op = Op::Multiply;
+        node.a = a.id;
+        node.b = b.id;
+        return push(std::move(node));
+    }
+
+    NoiseGraph::Node NoiseGraph::blend(Node a, Node b, float t) {
+        input(a, "blend");
+        input(b, "blend");
+        NodeData node;
+        node.op = Op::Blend;
+        node.a = a.id;
+        node.b = b.id;
+        node.p0 = t;
+        return push(std::move(node));
+    }
+
+    NoiseGraph::Node NoiseGraph::blend(Node a, Node b, Node mask) {
+        input(a, "blend");
+        input(b, "blend");
+        input(mask, "blend");
+        NodeData node;
+        node.op = Op::BlendMask;
+        node.a = a.id;
+        node.b = b.id;
+        node.c = mask.id;
+        return push(std::move(node));
+    }
+
+    NoiseGraph::Node NoiseGraph::normalize(Node a, float low, float high) {
+        input(a, "normalize");
+        if (!(high != low))
+            throw std::invalid_argument("NoiseGraph::normalize: high must differ from low, got: " + std::to_string(low));
+        NodeData node;
+        node.op = Op::Normalize;
+        node.a = a.id;
+        node.p0 = low;
+        node.p1 = high;
+        return push(std::move(node));
+    }
+
+    void NoiseGraph::set_output(Node node) {
+        input(node, "set_output");
+        output_ = node.id;
+    }
+
+    NoiseGraph::Node NoiseGraph::output() const {
+        return Node{ output_ };
+    }
+
+    // ---------------------------------------------------------
+    // Evaluation
+    // ---------------------------------------------------------
+    // One per tile task. Every node owns four scratch chunks, so a node's result
+    // stays valid until that node is evaluated again. A node used several times
+    // at the chunk's own pixels is evaluated once per chunk. Combining nodes copy
+    // their first input before evaluating the next one: a shared input may be
+    // re-evaluated at other (warped) coordinates in between.
+    class NoiseGraph::Evaluator {
+    public:
+        explicit Evaluator(const NoiseGraph& graph)
+            : graph_(graph), scratch_(graph.nodes_.size() * kNodeScratch),
+              stamps_(graph.nodes_.size(), 0), pink_(static_cast<std::size_t>(graph.pinkCount_)) {}
+
+        // Pink pixels of the nodes in `used`, for world pixels `region`
+        void prepare(const Tile& region, const std::vector<bool>& used, const GenerateOptions& options) {
+            for (std::size_t id = 0; id < graph_.nodes_.size(); ++id) {
+                const NodeData& node = graph_.nodes_[id];
+                if (node.op != Op::Pink || !used[id]) continue;
+                NoiseMap& tile = pink_[static_cast<std::size_t>(node.pinkSlot)];
+                if (tile.width() != region.width || tile.height() != region.height) tile = NoiseMap(region.width, region.height);
+                generate_pink_region_into(tile.data(), tile.stride(), node.pinkWidth, node.pinkHeight, region.x, region.y,
+                    region.width, region.height, node.pink.octaves, node.pink.alpha, node.pink.sampleRate, node.pink.amplitude,
+                    node.pinkSeed, options);
+            }
+        }
+
+        // Node `id` for the next chunk: the n pixels (xs, ys); (row, column):
+        // position of the chunk in the prepared region, for pink lookups
+        const float* evaluate(int id, const float* xs, const float* ys, int row, int column, int n) {
+            ++chunk_;
+            chunkXs_ = xs;
+            chunkYs_ = ys;
+            return eval(id, xs, ys, row, column, n);
+        }
+
+    private:
+        // Node `id` at the n world positions (xs, ys)
+        const float* eval(int id, const float* xs, const float* ys, int row, int column, int n) {
+            const NodeData& node = graph_.nodes_[static_cast<std::size_t>(id)];
+            // pink reads its prepared tile; a warp returns its source's buffer
+            if (node.op == Op::Pink || node.op == Op::Warp) return compute(id, node, xs, ys, row, column, n);
+            std::uint64_t& stamp = stamps_[static_cast<std::size_t>(id)];
+            const bool chunkPixels = xs == chunkXs_ && ys == chunkYs_;
+            if (chunkPixels && stamp == chunk_) return scratch_.get() + static_cast<std::size_t>(id) * kNodeScratch;
+            const float* result = compute(id, node, xs, ys, row, column, n);
+            stamp = chunkPixels ? chunk_ : 0;
+            return result;
+        }
+
+        const float* compute(int id, const NodeData& node, const float* xs, const float* ys, int row, int column, int n) {
+            float* out = scratch_.get() + static_cast<std::size_t>(id) * kNodeScratch;
+            float* t0 = out + kChunk;
+            float* t1 = t0 + kChunk;
+            float* t2 = t1 + kChunk;
+
+            switch (node.op) {
+            case Op::Perlin:
+                fractal(*node.perlin, node, xs, ys, n, out, t0, t1, t2);
+                return out;
+            case Op::Simplex:
+                fractal(*node.simplex, node, xs, ys, n, out, t0, t1, t2);
+                return out;
+            case Op::Pink:
+                return pink_[static_cast<std::size_t>(node.pinkSlot)].row(row).data() + column;
+            case Op::Constant:
+                std::fill(out, out + n, node.p0);
+                return out;
+            case Op::Warp: {
+                const float strength = node.p0;
+                const float* dx = eval(node.b, xs, ys, row, column, n);
+                for (int i = 0; i < n; ++i) t0[i] = xs[i] + (dx[i] - 0.5f) * strength;
+                const float* dy = eval(node.c, xs, ys, row, column, n);
+                for (int i = 0; i < n; ++i) t1[i] = ys[i] + (dy[i] - 0.5f) * strength;
+                return eval(node.a, t0, t1, row, column, n);
+            }
+            case Op::Ridged: {
+                const float* a = eval(node.a, xs, ys, row, column, n);
+                for (int i = 0; i < n; ++i) out[i] = 1.0f - std::fabs(a[i] * 2.0f - 1.0f);
+                return out;
+            }
+            case Op::ScaleBias: {
+                const float* a = eval(node.a, xs, ys, row, column, n);
+                for (int i = 0; i < n; ++i) out[i] = a[i] * node.p0 + node.p1;
+                return out;
+            }
+            case Op::Add:
+            case Op::Multiply:
+            case Op::Blend: {
+                const float* a = eval(node.a, xs, ys, row, column, n);
+                std::copy(a, a + n, out);
+                const float* b = eval(node.b, xs, ys, row, column, n);
+                if (node.op == Op::Add) {
+                    for (int i = 0; i < n; ++i) out[i] += b[i];
+                }
+                else if (node.op == Op::Multiply) {
+                    for (int i = 0; i < n; ++i) out[i] *= b[i];
+                }
+                else {
+                    for (int i = 0; i < n; ++i) out[i] += (b[i] - out[i]) * node.p0;
+                }
+                return out;
+            }
+            case Op::BlendMask: {
+                const float* a = eval(node.a, xs, ys, row, column, n);
+                std::copy(a, a + n, out);
+                const float* b = eval(node.b, xs, ys, row, column, n);
+                std::copy(b, b + n, t0);
+                const float* mask = eval(node.c, xs, ys, row, column, n);
+                for (int i = 0; i < n; ++i) out[i] += (t0[i] - out[i]) * mask[i];
+                return out;
+            }
+            case Op::Normalize: {
+                const float* a = eval(node.a, xs, ys, row, column, n);
+                const float range = node.p1 - node.p0;
+                for (int i = 0; i < n; ++i) {
+                    float v = (a[i] - node.p0) / range;
+                    v = v > 0.0f ? v : 0.0f;
+                    out[i] = v < 1.0f ? v : 1.0f;
+                }
+                return out;
+            }
+            }
+            return out;
+        }
+
+        // The region generators' octave loop with the node's pixel positions:
+        // (x + base) / scale * frequency per octave, then their normalization
+        template <typename Base>
+        static void fractal(const Base& noise, const NodeData& node, const float* xs, const float* ys, int n,
+            float* out, float* ox, float* oy, float* vals) {
+            const PerlinParams& p = node.params;
+            std::fill(out, out + n, 0.0f);
+            float amplitude = 1.0f;
+            float freq = p.frequency;
+            for (int o = 0; o < p.octaves; ++o) {
+                for (int i = 0; i < n; ++i) {
+                    ox[i] = (xs[i] + p.base) / p.scale * freq;
+                    oy[i] = (ys[i] + p.base) / p.scale * freq;
+                }
+                FractalTraits<Base>::noise_batch(noise, ox, oy, vals, static_cast<std::size_t>(n));
+                for (int i = 0; i < n; ++i)
+                    out[i] += vals[i] * amplitude;
+                amplitude *= p.persistence;
+                freq *= p.lacunarity;
+            }
+            for (int i = 0; i < n; ++i)
+                out[i] = FractalTraits<Base>::normalize(out[i], node.p0);
+        }
+
+        const NoiseGraph& graph_;
+        AlignedBuffer scratch_;
+        std::vector<std::uint64_t> stamps_;     // chunk whose pixels a node's buffer holds (0: none)
+        std::uint64_t chunk_ = 0;
+        const float* chunkXs_ = nullptr;
+        const float* chunkYs_ = nullptr;
+        std::vector<NoiseMap> pink_;
+    };
+
+    void NoiseGraph::generate_into(float* dst, std::size_t stride, std::int64_t originX, std::int64_t originY,
+        int width, int height, const GenerateOptions& options) const {
+        if (output_ < 0)
+            throw std::logic_error("NoiseGraph: the graph has no nodes");
+        if (width <= 0 || height <= 0)
+            throw std::invalid_argument("width/height must be > 0, got: " + std::to_string(width) + "x" + std::to_string(height));
+        if (!dst)
+            throw std::invalid_argument("dst must not be null");
+        if (stride < static_cast<std::size_t>(width))
+            throw std::invalid_argument("stride must be >= width, got: " + std::to_string(stride));
+
+        // Nodes the output depends on; inputs always precede their users
+        std::vector<bool> used(nodes_.size(), false);
+        used[static_cast<std::size_t>(output_)] = true;
+        for (int id = output_; id >= 0; --id) {
+            if (!used[static_cast<std::size_t>(id)]) continue;
+            const NodeData& node = nodes_[static_cast<std::size_t>(id)];
+            for (int in : { node.a, node.b, node.c }) {
+                if (in >= 0) used[static_cast<std::size_t>(in)] = true;
+            }
+            if (node.op == Op::Pink && (originX < 0 || originY < 0 || originX + width > node.pinkWidth || originY + height > node.pinkHeight))
+                throw std::out_of_range("NoiseGraph: region (" + std::to_string(originX) + ", " + std::to_string(originY) + ") " +
+                    std::to_string(width) + "x" + std::to_string(height) + " leaves the " + std::to_string(node.pinkWidth) + "x" +
+                    std::to_string(node.pinkHeight) + " pink map");
+        }
+
+        const StageTimer timer(StatsStage::Evaluate, "graph",
+            static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height), options.threads, options.pool);
+        // tiles are the parallel work; pink regions inside a tile run on its thread
+        GenerateOptions tileOptions = options;
+        tileOptions.threads = 1;
+        parallel_for_tiles(width, height, options.tileSize, options.tileSize, options.threads, options.pool, [&](const Tile& tile) {
+            Evaluator evaluator(*this);
+            if (pinkCount_ > 0) {
+                evaluator.prepare(Tile{ static_cast<int>(originX + tile.x), static_cast<int>(originY + tile.y), tile.width, tile.height },
+                    used, tileOptions);
+            }
+            alignas(64) float xs[kChunk];
+            alignas(64) float ys[kChunk];
+            const int xEnd = tile.x + tile.width;
+            for (int y = tile.y; y < tile.y + tile.height; ++y) {
+                std::fill(ys, ys + kChunk, static_cast<float>(originY + y));
+                float* row = dst + static_cast<std::size_t>(y) * stride;
+                for (int x0 = tile.x; x0 < xEnd; x0 += kChunk) {
+                    const int n = std::min(kChunk, xEnd - x0);
+                    for (int i = 0; i < n; ++i) xs[i] = static_cast<float>(originX + x0 + i);
+                    const float* values = evaluator.evaluate(output_, xs, ys, y - tile.y, x0 - tile.x, n);
+                    std::memcpy(row + x0, values, static_cast<std::size_t>(n) * sizeof(float));
+                }
+            }
+        });
+    }
+
+    NoiseMap NoiseGraph::generate(std::int64_t originX, std::int64_t originY, int width, int height,
+        const GenerateOptions& options) const {
+        if (width <= 0 || height <= 0)
+            throw std::invalid_argument("width/height must be > 0, got: " + std::to_string(width) + "x" + std::to_string(height));
+        NoiseMap map = [&] {
+            const StageTimer timer(StatsStage::Setup, "graph", 0);
+            return NoiseMap(width, height);
+        }();
+        generate_into(map.data(), map.stride(), originX, originY, width, height, options);
+        return map;
+    }
+
+    NoiseMap NoiseGraph::generate_chunk(std::int64_t chunkX, std::int64_t chunkY, int chunkSize,
+        const GenerateOptions& options) const {
+        if (chunkSize <= 0)
+            throw std::invalid_argument("chunkSize must be > 0, got: " + std::to_string(chunkSize));
+        return generate(chunkX * chunkSize, chunkY * chunkSize, chunkSize, chunkSize, options);
+    }
+
+} // namespace Noise
@@ -0,0 +1,98 @@
+// Deflate.hpp
+// -----------
+// Streaming DEFLATE (RFC 1951) compressor plus the zlib / PNG checksums. Input
+// can be fed in pieces of any size; the 32 KiB match window carries over from
+// one call to the next, so a stream compressed band by band is as small as one
+// compressed in a single call, while only the window is ever kept in memory.
+//
+// Usage:
+//   Noise::Deflater deflater(6);                         // level 0 (stored) .. 9
+//   std::vector<std::uint8_t> out;
+//   deflater.write(band, bandBytes, Noise::Deflater::Flush::None, out);
+//   deflater.write(nullptr, 0, Noise::Deflater::Flush::Finish, out);
+//
+//   Noise::Deflater chunk(6);                            // parallel: one per chunk
+//   chunk.set_dictionary(previousTail, 32768);
+//   chunk.write(data, size, Noise::Deflater::Flush::Sync, chunkOut);
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Noise {
+
+    // Running Adler-32 (zlib trailer); start from 1
+    std::uint32_t adler32(std::uint32_t adler, const std::uint8_t* data, std::size_t size);
+
+    // Running CRC-32 (PNG chunks); start from 0
+    std::uint32_t crc32(std::uint32_t crc, const std::uint8_t* data, std::size_t size);
+
+    class Deflater {
+    public:
+        enum class Flush {
+            None,   // buffer freely; output may lag behind the input
+            Sync,   // emit everything so far and byte-align (empty stored block)
+            Finish  // emit everything and close the stream with a final block
+        };
+
+        // level 0 = stored blocks only, 1 = fastest ... 9 = smallest
+        explicit Deflater(int level = 6);
+
+        // Compresses `size` bytes and appends the raw deflate bytes produced so far to `out`
+        void write(const std::uint8_t* data, std::size_t size, Flush flush, std::vector<std::uint8_t>& out);
+
+        // Primes the match window with up to 32 KiB of data that precedes this stream in
+        // the decoded output (before the first write). Streams compressed in parallel
+        // with their predecessor's tail as dictionary and ended with Flush::Sync can be
+        // concatenated into one valid deflate stream.
+        void set_dictionary(const std::uint8_t* data, std::size_t size);
+
+        // Starts a new, empty stream at the same level, keeping the allocated buffers
+        void reset();
+
+        int level() const noexcept { return level_; }
+        bool finished() const noexcept { return finished_; }
+
+    private:
+        struct Token {
+            std::uint16_t length;   // 0 = literal
+            std::uint16_t value;    // literal byte or match distance
+        };
+
+        void tokenize(bool flushAll, std::vector<std::uint8_t>& out);
+        void emit_block(bool final, std::vector<std::uint8_t>& out);
+        void emit_stored(const std::uint8_t* data, std::size_t size, bool final, std::vector<std::uint8_t>& out);
+        void put_bits(std::uint32_t bits, int count, std::vector<std::uint8_t>& out);
+        void align_to_byte(std::vector<std::uint8_t>& out);
+        void slide_window();
+        void insert_hash(std::size_t pos);
+        int longest_match(std::size_t pos, int& distance) const;
+
+        int level_;
+        bool lazy_ = false;  // levels 4+: a match may be dropped for a longer one a byte later
+        int maxChain_ = 0;   // hash chain links followed per match search
+        int goodLength_ = 0; // after a match this long, search a quarter of the chain
+        int niceLength_ = 0; // a match this long ends the search
+        int lazyLength_ = 0; // lazy: no search after a match this long; greedy: longest match whose positions are all hashed
+        bool finished_ = false;
+
+        // lazy matching: the byte at pos_ - 1 is pending, with the match found there
+        bool matchAvailable_ = false;
+        int prevLength_ = 0;
+        int prevDistance_ = 0;
+
+        // up to 32 KiB of history followed by the input not yet tokenized
+        std::vector<std::uint8_t> window_;
+        std::size_t pos_ = 0;          // next byte to tokenize
+        std::size_t blockStart_ = 0;   // first byte of the pending block (stored fallback)
+        std::vector<std::int32_t> head_;
+        std::vector<std::int32_t> prev_;
+
+        std::vector<Token> tokens_;
+
+        std::uint64_t bitBuffer_ = 0;
+        int bitCount_ = 0;
+    };
+
+} // namespace Noise
@@ -0,0 +1,85 @@
+// ExrWriter.hpp
+// -------------
+// Streaming OpenEXR writer for single-channel half-float maps: one luminance
+// channel "Y" (HALF), scanline storage without compression. Every scanline block
+// has the same size, so the offset table is written up front and rows go straight
+// to the file as they arrive; memory use does not depend on the image size.
+//
+// Usage:
+//   Noise::ExrStreamWriter exr("height.exr", width, height);
+//   exr.write_rows(map.data(), map.stride(), rows);      // top to bottom, floats or binary16 words
+//   exr.finish();
+//
+//   // or let the writer pull float bands and convert them (F16C / NEON)
+//   Noise::write_exr_streamed("height.exr", width, height,
+//       [&](float* band, std::size_t stride, int y0, int rows) { ... });
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <vector>
+
+namespace Noise {
+
+    class ThreadPool;
+
+    struct ExrStreamOptions {
+        int bandRows = 64;          // rows per band handed to produce() (write_exr_streamed)
+        unsigned threads = 0;       // float -> half workers (0 = library default; see set_thread_count)
+        ThreadPool* pool = nullptr; // nullptr = default_thread_pool()
+    };
+
+    class ExrStreamWriter {
+    public:
+        // Opens `file` and writes the header and the scanline offset table
+        // (options.bandRows is not used here)
+        ExrStreamWriter(const std::filesystem::path& file, int width, int height, const ExrStreamOptions& options = {});
+
+        ExrStreamWriter(const ExrStreamWriter&) = delete;
+        ExrStreamWriter& operator=(const ExrStreamWriter&) = delete;
+
+        // Appends `rows` rows of binary16 samples (row r at halves + r * stride words)
+        void write_rows(const std::uint16_t* halves, std::size_t stride, int rows);
+
+        // Appends `rows` rows of floats (row r at src + r * stride), rounded to half
+        // in parallel row blocks
+        void write_rows(const float* src, std::size_t stride, int rows);
+
+        // Closes the file; all `height` rows must be written
+        void finish();
+
+        // Closes the file without finishing the image (before removing it after an error)
+        void close() noexcept;
+
+        int rows_written() const noexcept { return rowsWritten_; }
+
+    private:
+        std::ofstream file_;
+        std::filesystem::path path_;
+        int width_;
+        int height_;
+        int rowsWritten_ = 0;
+        bool finished_ = false;
+        unsigned threads_;
+        ThreadPool* pool_;
+        std::vector<std::uint8_t> block_;   // scanline block: y, byte count, samples
+        std::vector<std::uint16_t> halves_; // rows of write_rows(const float*) after conversion
+    };
+
+    // Fills rows [y0, y0 + rows) of the image, row r at band + r * stride floats
+    using ExrBandFn = std::function<void(float* band, std::size_t stride, int y0, int rows)>;
+
+    // Writes a width x height half-float EXR from float bands pulled from produce(),
+    // top to bottom; peak memory is one float band and its half copy
+    void write_exr_streamed(
+        const std::filesystem::path& file,
+        int width,
+        int height,
+        const ExrBandFn& produce,
+        const ExrStreamOptions& options = {}
+    );
+
+} // namespace Noise
@@ -0,0 +1,25 @@
+// HalfFloat.hpp
+// -------------
+// IEEE 754 binary16 conversions for 16-bit map storage. Rounding is to nearest
+// even; infinities and NaNs are preserved (NaNs come back quiet). The row
+// versions use F16C / NEON when the CPU has them and give the same bits as
+// the scalar ones.
+//
+// Usage:
+//   std::uint16_t h = Noise::float_to_half(0.5f);
+//   Noise::floats_to_halves(row, halves, width);
+//   Noise::halves_to_floats(halves, row, width);
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Noise {
+
+    std::uint16_t float_to_half(float value) noexcept;
+    float half_to_float(std::uint16_t half) noexcept;
+
+    void floats_to_halves(const float* src, std::uint16_t* dst, std::size_t count);
+    void halves_to_floats(const std::uint16_t* src, float* dst, std::size_t count);
+
+} // namespace Noise
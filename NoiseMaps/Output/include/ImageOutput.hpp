@@ -0,0 +1,81 @@
+// ImageOutput.hpp
+// ---------------
+// Image export shared by every generator: clamped float -> 8/16-bit quantization
+// (SIMD, picked at runtime), output path resolution and grayscale PNG / JPEG /
+// EXR writing. PNGs (8 or 16 bits) are streamed through PngStreamWriter, whose
+// deflate runs on several workers; half-float EXRs through ExrStreamWriter;
+// JPEGs go through stb_image_write.
+//
+// Usage:
+//   Noise::ImageSaveOptions opts;
+//   opts.compressionLevel = 1;                            // fastest PNG
+//   auto file = Noise::save_noise_image(map, "terrain.png", "", opts);
+//
+//   opts.bitDepth = 16;                                   // 65536 height levels
+//   Noise::save_noise_image(map, "terrain16.png", "", opts);
+//   Noise::save_noise_image(map, "terrain.exr");          // half float, unclamped
+//
+//   // PNG from float bands produced on demand (no full map in memory)
+//   Noise::save_noise_image_bands("huge.png", "", width, height,
+//       [&](float* band, std::size_t stride, int y0, int rows) { ... });
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include "NoiseMap.hpp"
+
+namespace Noise {
+
+    class ThreadPool;
+
+    struct ImageSaveOptions {
+        int compressionLevel = 4;   // PNG deflate level: 0 = stored (fastest) ... 9 = smallest
+        int jpegQuality = 0;        // 1..100; 0 = the generator's default (90, pink noise 95)
+        int bitDepth = 8;           // PNG sample depth, 8 or 16 (JPEG is 8-bit only, EXR half float)
+        unsigned threads = 0;       // encoder workers (0 = library default; see set_thread_count)
+        ThreadPool* pool = nullptr; // nullptr = default_thread_pool()
+    };
+
+    // dst[i] = uint8(clamp(src[i], 0, 1) * 255), truncating; NaN maps to 0
+    void quantize_unorm8(const float* src, std::uint8_t* dst, std::size_t count);
+
+    // dst[i] = uint16(clamp(src[i], 0, 1) * 65535 + 0.5), i.e. rounded; NaN maps to 0
+    void quantize_unorm16(const float* src, std::uint16_t* dst, std::size_t count);
+
+    // outputDir / filename, where an empty outputDir means <parent of the working
+    // directory>/ImageOutput; the directory is created if missing
+    std::filesystem::path resolve_image_path(const std::string& filename, const std::string& outputDir);
+
+    // dst[2i], dst[2i + 1] = quantize_unorm16(src[i]) as big-endian bytes (PNG sample order)
+    void quantize_unorm16_be(const float* src, std::uint8_t* dst, std::size_t count);
+
+    // Saves `map` as a grayscale image. The format follows the extension: .jpg / .jpeg
+    // write 8-bit JPEG, .exr half-float OpenEXR (values kept as they are, not clamped),
+    // anything else PNG with options.bitDepth bits (clamped to [0, 1]). Returns the file written.
+    std::filesystem::path save_noise_image(
+        const NoiseMap& map,
+        const std::string& filename,
+        const std::string& outputDir = "",
+        const ImageSaveOptions& options = {}
+    );
+
+    // Fills rows [y0, y0 + rows) of the image, row r at band + r * stride floats
+    using FloatBandFn = std::function<void(float* band, std::size_t stride, int y0, int rows)>;
+
+    // Writes a width x height PNG (options.bitDepth bits) or .exr from float bands
+    // pulled from produce(), top to bottom; for PNG, band k+1 is produced while band
+    // k is encoded (see write_png_streamed). produce() calls never overlap. Throws
+    // std::invalid_argument for other extensions.
+    std::filesystem::path save_noise_image_bands(
+        const std::string& filename,
+        const std::string& outputDir,
+        int width,
+        int height,
+        const FloatBandFn& produce,
+        const ImageSaveOptions& options = {}
+    );
+
+} // namespace Noise
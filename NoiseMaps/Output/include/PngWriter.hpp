@@ -0,0 +1,107 @@
+// PngWriter.hpp
+// -------------
+// Streaming 8- or 16-bit grayscale PNG encoder. Rows are filtered, deflated and written
+// to the file as they arrive, so memory use is bounded by a few compression
+// chunks per worker and one IDAT chunk, never by the image size.
+//
+// Deflate runs in parallel: the filtered stream is cut into fixed row chunks,
+// each compressed on its own with the 32 KiB before it as preset dictionary and
+// joined at byte-aligned sync points. Chunk boundaries depend only on the image
+// width, so the file is identical for every thread count and band size.
+//
+// Usage:
+//   Noise::PngStreamWriter png("out.png", width, height);
+//   png.write_rows(band, width, bandRows);               // top to bottom, any band size
+//   png.finish();
+//
+//   // or let the pipeline pull bands (band k+1 is produced while band k is encoded)
+//   Noise::write_png_streamed("out.png", width, height,
+//       [&](std::uint8_t* band, std::size_t stride, int y0, int rows) { ... });
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <vector>
+#include "Deflate.hpp"
+
+namespace Noise {
+
+    class ThreadPool;
+
+    struct PngStreamOptions {
+        int bandRows = 64;          // rows per band handed to produce() (write_png_streamed)
+        int compressionLevel = 4;   // Deflater level, 0..9 (4: lazy matching, short chains)
+        int bitDepth = 8;           // 8 or 16; 16-bit samples are 2 bytes each, big-endian
+        unsigned threads = 0;       // deflate workers (0 = library default; see set_thread_count)
+        ThreadPool* pool = nullptr; // nullptr = default_thread_pool()
+    };
+
+    class PngStreamWriter {
+    public:
+        // Opens `file` and writes the PNG header (options.bandRows is not used here)
+        PngStreamWriter(const std::filesystem::path& file, int width, int height, const PngStreamOptions& options = {});
+
+        PngStreamWriter(const PngStreamWriter&) = delete;
+        PngStreamWriter& operator=(const PngStreamWriter&) = delete;
+
+        // Appends `rows` rows (row r at pixels + r * stride bytes, width * bitDepth / 8 bytes each)
+        void write_rows(const std::uint8_t* pixels, std::size_t stride, int rows);
+
+        // Flushes the image data and writes IEND; all `height` rows must be written
+        void finish();
+
+        // Closes the file without finishing the image (before removing it after an error)
+        void close() noexcept;
+
+        int rows_written() const noexcept { return rowsWritten_; }
+
+    private:
+        void encode_pending();
+        void write_chunk(const char type[4], const std::uint8_t* data, std::size_t size);
+        void flush_idat(bool all);
+
+        std::ofstream file_;
+        std::filesystem::path path_;
+        int width_;
+        int height_;
+        int bitDepth_;
+        std::size_t rowBytes_;
+        int rowsWritten_ = 0;
+        bool finished_ = false;
+
+        int level_;
+        unsigned threads_;
+        ThreadPool* pool_;
+        int chunkRows_;   // rows per independently compressed chunk
+        int groupRows_;   // rows buffered before they are encoded (a whole number of chunks)
+
+        std::uint32_t adler_ = 1;
+        std::vector<std::uint8_t> pending_;  // raw rows not yet encoded
+        int pendingRows_ = 0;
+        std::vector<std::uint8_t> prevRow_;  // raw row above pending_ (zeros before the first)
+        std::vector<std::uint8_t> filtered_; // filter byte + filtered row, one line per pending row
+        std::vector<std::uint8_t> history_;  // last 32 KiB of filtered lines before filtered_
+        std::vector<Deflater> deflaters_;                 // one per chunk of a group, reset per use
+        std::vector<std::vector<std::uint8_t>> chunkOut_; // compressed chunks of the group
+        std::vector<std::uint8_t> idat_;     // compressed bytes not yet written
+    };
+
+    // Fills rows [y0, y0 + rows) of the image, row r at band + r * stride bytes
+    // (width * bitDepth / 8 bytes per row)
+    using PngBandFn = std::function<void(std::uint8_t* band, std::size_t stride, int y0, int rows)>;
+
+    // Writes a width x height grayscale PNG from bands pulled from produce(), top to
+    // bottom. Two band buffers alternate: band k+1 is produced while band k is
+    // compressed and written, so peak memory is two bands plus the encoder state.
+    void write_png_streamed(
+        const std::filesystem::path& file,
+        int width,
+        int height,
+        const PngBandFn& produce,
+        const PngStreamOptions& options = {}
+    );
+
+} // namespace Noise
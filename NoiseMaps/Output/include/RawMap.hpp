@@ -0,0 +1,182 @@
+// RawMap.hpp
+// ----------
+// Full-precision map files (.rnm): a 64-byte header followed by the samples,
+// row by row without padding. Files are written through a memory mapping, so
+// generators can fill them in place, and are read back by mapping them, so
+// downstream tools open even multi-gigabyte heightfields with zero copy.
+//
+// Layout (header fields little-endian, samples in host order, which is
+// little-endian on every supported target):
+//   0   char[4]   magic "RNMP"
+//   4   uint16    version (1: row-major, 2: tiled)
+//   6   uint16    sample format (RawFormat)
+//   8   uint32    width
+//   12  uint32    height
+//   16  uint64    offset of the first sample in bytes (64)
+//   24  uint32    tile width (version 2; reserved in version 1)
+//   28  uint32    tile height (version 2; reserved in version 1)
+//   32  reserved, zero up to the data offset
+// Tiled files hold the tiles in row-major tile order, each one tile width x
+// tile height samples without padding between rows; edge tiles are zero-padded
+// to the full tile size.
+//
+// Usage:
+//   Noise::save_raw_map(map, "height.rnm");                         // float32
+//   Noise::save_raw_map(map, "height16.rnm", Noise::RawFormat::Float16);
+//
+//   auto file = Noise::MappedRawMap::create("big.rnm", 16384, 16384);
+//   Noise::generate_perlin_into(file.data_f32(), file.stride(), 16384, 16384, ...);
+//
+//   auto view = Noise::MappedRawMap::open("big.rnm");              // zero copy
+//   float h = view.sample(x, y);
+//
+//   Noise::write_tiled_raw_map("huge.rnm", 65536, 65536,           // out of core
+//       [&](float* dst, std::size_t stride, const Noise::Tile& tile) { ... });
+//   Noise::NoiseMap window = Noise::MappedRawMap::open("huge.rnm").read_region(x, y, 1024, 1024);
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <system_error>
+#include "GenerateOptions.hpp"
+#include "NoiseMap.hpp"
+#include "TileScheduler.hpp"
+
+namespace Noise {
+
+    enum class RawFormat : std::uint16_t {
+        Float32 = 1, // IEEE binary32, exact
+        Float16 = 2, // IEEE binary16, rounded to nearest even
+        UNorm16 = 3  // clamp(v, 0, 1) * 65535, rounded
+    };
+
+    // Bytes per sample of `format`
+    std::size_t raw_sample_bytes(RawFormat format);
+
+    class MappedRawMap {
+    public:
+        MappedRawMap() = default;
+        ~MappedRawMap();
+
+        MappedRawMap(MappedRawMap&& other) noexcept;
+        MappedRawMap& operator=(MappedRawMap&& other) noexcept;
+        MappedRawMap(const MappedRawMap&) = delete;
+        MappedRawMap& operator=(const MappedRawMap&) = delete;
+
+        // Maps an existing file, row-major or tiled; throws std::runtime_error if it
+        // is not a valid map file
+        static MappedRawMap open(const std::filesystem::path& file, bool writable = false);
+
+        // Creates (or truncates) `file` at its full size with a zeroed payload and
+        // maps it writable, ready to be filled in place
+        static MappedRawMap create(const std::filesystem::path& file, int width, int height, RawFormat format = RawFormat::Float32);
+
+        // create() a float32 file and fill(float* data, std::size_t stride) it in place;
+        // the file is removed again if fill throws (e.g. on invalid parameters)
+        template <typename Fill>
+        static MappedRawMap generate(const std::filesystem::path& file, int width, int height, Fill&& fill) {
+            MappedRawMap map = create(file, width, height);
+            try {
+                fill(map.data_f32(), map.stride());
+            }
+            catch (...) {
+                map.close();
+                std::error_code ec;
+                std::filesystem::remove(file, ec);
+                throw;
+            }
+            return map;
+        }
+
+        int width() const noexcept { return width_; }
+        int height() const noexcept { return height_; }
+        RawFormat format() const noexcept { return format_; }
+        bool writable() const noexcept { return writable_; }
+        bool empty() const noexcept { return base_ == nullptr; }
+        // Row stride in samples of row-major files (rows are stored without padding)
+        std::size_t stride() const noexcept { return static_cast<std::size_t>(width_); }
+
+        // Tile layout: a row-major file is a single width x height tile
+        bool tiled() const noexcept { return tiled_; }
+        int tile_width() const noexcept { return tileWidth_; }
+        int tile_height() const noexcept { return tileHeight_; }
+        int tiles_x() const noexcept { return tileWidth_ > 0 ? (width_ + tileWidth_ - 1) / tileWidth_ : 0; }
+        int tiles_y() const noexcept { return tileHeight_ > 0 ? (height_ + tileHeight_ - 1) / tileHeight_ : 0; }
+
+        // Samples of tile (tileX, tileY), tile_width() per row, file format; zero copy
+        const void* tile_samples(int tileX, int tileY) const;
+
+        const void* samples() const noexcept { return base_ ? static_cast<const std::uint8_t*>(base_) + dataOffset_ : nullptr; }
+        void* samples();
+
+        // Typed access to a row-major file; throws std::logic_error if the format
+        // does not match or the file is tiled. The non-const overloads also throw
+        // on read-only mappings (read through a const&).
+        float* data_f32();
+        const float* data_f32() const;
+        std::uint16_t* data_u16();             // Float16 or UNorm16 words
+        const std::uint16_t* data_u16() const;
+
+        // One sample decoded to float (UNorm16 as v / 65535)
+        float sample(int x, int y) const;
+
+        // Copy of the whole map as float32
+        NoiseMap to_noisemap() const;
+
+        // Copy of the width x height window at (x, y) as float32, any layout; only
+        // the pages of the tiles it touches are read
+        NoiseMap read_region(int x, int y, int width, int height) const;
+
+        // Blocks until the written pages are on disk. Not needed for other readers:
+        // they see the data as soon as it is written (and after close()).
+        void flush();
+        void close() noexcept;
+
+    private:
+        const std::uint8_t* sample_address(int x, int y) const noexcept;
+
+        void* base_ = nullptr;
+        std::size_t bytes_ = 0;
+        std::size_t dataOffset_ = 0;
+        int width_ = 0;
+        int height_ = 0;
+        int tileWidth_ = 0;
+        int tileHeight_ = 0;
+        bool tiled_ = false;
+        RawFormat format_ = RawFormat::Float32;
+        bool writable_ = false;
+        std::filesystem::path path_;
+    };
+
+    struct RawTileOptions {
+        int tileWidth = 256;
+        int tileHeight = 256;
+        RawFormat format = RawFormat::Float32;
+    };
+
+    // Fills one tile of the map: tile.width x tile.height floats, row r at dst + r * stride
+    using RawTileFn = std::function<void(float* dst, std::size_t stride, const Tile& tile)>;
+
+    // Writes a width x height tiled .rnm file (version 2) without ever holding the
+    // map: tiles are filled by fill() on up to options.threads workers of
+    // options.pool, converted to rawOptions.format and written at their file offset
+    // as soon as they are done. Peak memory is one tile per worker, whatever the
+    // map size. fill() runs concurrently for distinct tiles and should not spread
+    // its own work over the pool. The file is removed again if fill throws.
+    void write_tiled_raw_map(const std::filesystem::path& file, int width, int height, const RawTileFn& fill,
+        const RawTileOptions& rawOptions = {}, const GenerateOptions& options = {});
+
+    // Writes `map` as a .rnm file, converting rows in parallel straight into the mapped file
+    void save_raw_map(const NoiseMap& map, const std::filesystem::path& file, RawFormat format = RawFormat::Float32);
+
+    // Reads any .rnm file into a float32 map
+    NoiseMap load_raw_map(const std::filesystem::path& file);
+
+    // resolve_image_path() for map files: image extensions (.png, .jpg, .jpeg, .exr) are
+    // replaced with .rnm, so the create_* defaults work for OutputMode::Raw / Mmap
+    std::filesystem::path resolve_raw_path(const std::string& filename, const std::string& outputDir);
+
+} // namespace Noise
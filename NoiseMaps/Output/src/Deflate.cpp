@@ -0,0 +1,559 @@
+// Deflate.cpp
+#include "Deflate.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+
+namespace Noise {
+
+    // ---------------------------------------------------------
+    // Checksums
+    // ---------------------------------------------------------
+    std::uint32_t adler32(std::uint32_t adler, const std::uint8_t* data, std::size_t size) {
+        constexpr std::uint32_t kBase = 65521;
+        constexpr std::size_t kMaxRun = 5552; // largest n with no 32-bit overflow before the modulo
+        std::uint32_t a = adler & 0xFFFF;
+        std::uint32_t b = adler >> 16;
+        while (size > 0) {
+            const std::size_t n = std::min(size, kMaxRun);
+            for (std::size_t i = 0; i < n; ++i) {
+                a += data[i];
+                b += a;
+            }
+            a %= kBase;
+            b %= kBase;
+            data += n;
+            size -= n;
+        }
+        return (b << 16) | a;
+    }
+
+    std::uint32_t crc32(std::uint32_t crc, const std::uint8_t* data, std::size_t size) {
+        static const std::array<std::uint32_t, 256> table = [] {
+            std::array<std::uint32_t, 256> t{};
+            for (std::uint32_t n = 0; n < 256; ++n) {
+                std::uint32_t c = n;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[n] = c;
+            }
+            return t;
+        }();
+        crc = ~crc;
+        for (std::size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    // ---------------------------------------------------------
+    // Deflate tables (RFC 1951, 3.2.5)
+    // ---------------------------------------------------------
+    static constexpr int kWindowSize = 32768;
+    static constexpr int kMinMatch = 3;
+    static constexpr int kMaxMatch = 258;
+    static constexpr int kHashBits = 15;
+    static constexpr std::size_t kMaxTokens = 16384; // tokens per block
+    static constexpr std::size_t kMaxStored = 65535; // bytes per stored block
+
+    static constexpr int kLiteralCodes = 286;
+    static constexpr int kDistanceCodes = 30;
+    static constexpr int kCodeLengthCodes = 19;
+    static constexpr int kEndOfBlock = 256;
+
+    static constexpr std::uint16_t kLengthBase[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static constexpr std::uint8_t kLengthExtra[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static constexpr std::uint16_t kDistanceBase[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    static constexpr std::uint8_t kDistanceExtra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+    static constexpr std::uint8_t kCodeLengthOrder[19] = {
+        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    // length 3..258 -> index into kLengthBase
+    static int length_code(int length) {
+        static const std::array<std::uint8_t, kMaxMatch + 1> table = [] {
+            std::array<std::uint8_t, kMaxMatch + 1> t{};
+            int code = 0;
+            for (int len = kMinMatch; len <= kMaxMatch; ++len) {
+                while (code < 28 && len >= kLengthBase[code + 1]) ++code;
+                t[len] = static_cast<std::uint8_t>(code);
+            }
+            return t;
+        }();
+        return table[length];
+    }
+
+    // distance 1..32768 -> index into kDistanceBase; codes 16+ cover whole multiples
+    // of 128, so two small tables suffice (as in zlib)
+    static int distance_code(int distance) {
+        static const std::array<std::uint8_t, 512> table = [] {
+            std::array<std::uint8_t, 512> t{};
+            auto code = [](int d) {
+                return static_cast<std::uint8_t>(std::upper_bound(std::begin(kDistanceBase), std::end(kDistanceBase), d) - std::begin(kDistanceBase) - 1);
+            };
+            for (int d = 1; d <= 256; ++d) t[d - 1] = code(d);
+            for (int i = 2; i < 256; ++i) t[256 + i] = code((i << 7) + 1);
+            return t;
+        }();
+        return distance <= 256 ? table[distance - 1] : table[256 + ((distance - 1) >> 7)];
+    }
+
+    // hash of the 3 bytes at p (multiplicative; residual bytes are mostly small values)
+    static inline std::uint32_t hash3(const std::uint8_t* p) {
+        const std::uint32_t v = static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) | (static_cast<std::uint32_t>(p[2]) << 16);
+        return (v * 2654435761u) >> (32 - kHashBits);
+    }
+
+    // ---------------------------------------------------------
+    // Huffman codes
+    // ---------------------------------------------------------
+    // Code lengths of an optimal prefix code for `freq`, at most maxBits long.
+    // Over-long trees are rebuilt from halved frequencies (rare; costs a few bits).
+    static void build_lengths(const std::uint32_t* freq, int count, int maxBits, std::uint8_t* lengths) {
+        std::fill(lengths, lengths + count, std::uint8_t{ 0 });
+        std::vector<std::uint32_t> weights(freq, freq + count);
+
+        while (true) {
+            std::vector<int> leaves;
+            for (int s = 0; s < count; ++s)
+                if (weights[s] > 0) leaves.push_back(s);
+            if (leaves.empty()) return;
+            if (leaves.size() == 1) {
+                lengths[leaves[0]] = 1;
+                return;
+            }
+            std::stable_sort(leaves.begin(), leaves.end(), [&](int a, int b) { return weights[a] < weights[b]; });
+
+            // Two-queue construction: leaves in weight order, internal nodes in creation order
+            const std::size_t n = leaves.size();
+            std::vector<std::uint64_t> nodeWeight(2 * n - 1);
+            std::vector<int> parent(2 * n - 1, -1);
+            for (std::size_t i = 0; i < n; ++i) nodeWeight[i] = weights[leaves[i]];
+            std::size_t nextLeaf = 0, nextInner = n, created = n;
+            auto pick = [&]() {
+                if (nextLeaf < n && (nextInner >= created || nodeWeight[nextLeaf] <= nodeWeight[nextInner])) return nextLeaf++;
+                return nextInner++;
+            };
+            while (created < 2 * n - 1) {
+                const std::size_t a = pick();
+                const std::size_t b = pick();
+                nodeWeight[created] = nodeWeight[a] + nodeWeight[b];
+                parent[a] = parent[b] = static_cast<int>(created);
+                ++created;
+            }
+
+            // Depths top-down: parents are always created after their children
+            std::vector<int> depth(2 * n - 1, 0);
+            int maxDepth = 0;
+            for (std::size_t i = 2 * n - 1; i-- > 0;) {
+                if (parent[i] >= 0) depth[i] = depth[parent[i]] + 1;
+                if (i < n) maxDepth = std::max(maxDepth, depth[i]);
+            }
+            if (maxDepth <= maxBits) {
+                for (std::size_t i = 0; i < n; ++i) lengths[leaves[i]] = static_cast<std::uint8_t>(depth[i]);
+                return;
+            }
+            for (auto& w : weights)
+                if (w > 0) w = (w + 1) / 2;
+        }
+    }
+
+    // Canonical codes for `lengths` (RFC 1951, 3.2.2), bit-reversed for LSB-first output
+    static void build_codes(const std::uint8_t* lengths, int count, std::uint16_t* codes) {
+        int lengthCount[16] = {};
+        for (int s = 0; s < count; ++s) ++lengthCount[lengths[s]];
+        lengthCount[0] = 0;
+        int next[16] = {};
+        int code = 0;
+        for (int bits = 1; bits < 16; ++bits) {
+            code = (code + lengthCount[bits - 1]) << 1;
+            next[bits] = code;
+        }
+        for (int s = 0; s < count; ++s) {
+            const int len = lengths[s];
+            if (len == 0) {
+                codes[s] = 0;
+                continue;
+            }
+            int c = next[len]++;
+            int reversed = 0;
+            for (int b = 0; b < len; ++b) {
+                reversed = (reversed << 1) | (c & 1);
+                c >>= 1;
+            }
+            codes[s] = static_cast<std::uint16_t>(reversed);
+        }
+    }
+
+    // ---------------------------------------------------------
+    // Deflater
+    // ---------------------------------------------------------
+    Deflater::Deflater(int level) : level_(level) {
+        if (level < 0 || level > 9) throw std::invalid_argument("compression level must be in [0, 9], got: " + std::to_string(level));
+
+        // zlib's settings per level:   0  1  2   3   4   5    6    7     8     9
+        static constexpr int kGood[10] = { 0, 4, 4, 4, 4, 8, 8, 8, 32, 32 };
+        static constexpr int kLazy[10] = { 0, 4, 5, 6, 4, 16, 16, 32, 128, 258 };
+        static constexpr int kNice[10] = { 0, 8, 16, 32, 16, 32, 128, 128, 258, 258 };
+        static constexpr int kChain[10] = { 0, 4, 8, 32, 16, 32, 128, 256, 1024, 4096 };
+        lazy_ = level >= 4;
+        goodLength_ = kGood[level];
+        lazyLength_ = kLazy[level];
+        niceLength_ = kNice[level];
+        maxChain_ = kChain[level];
+
+        if (level > 0) {
+            head_.assign(std::size_t{ 1 } << kHashBits, -1);
+            prev_.assign(kWindowSize, -1);
+            window_.reserve(2 * kWindowSize);
+            tokens_.reserve(kMaxTokens);
+        }
+    }
+
+    void Deflater::write(const std::uint8_t* data, std::size_t size, Flush flush, std::vector<std::uint8_t>& out) {
+        if (finished_) throw std::runtime_error("Deflater: write after Flush::Finish");
+
+        if (level_ == 0) {
+            // Stored blocks need no lookahead: emit the input as it comes
+            while (size > kMaxStored || (size > 0 && flush != Flush::Finish)) {
+                const std::size_t n = std::min(size, kMaxStored);
+                emit_stored(data, n, false, out);
+                data += n;
+                size -= n;
+            }
+            if (flush == Flush::Sync) emit_stored(nullptr, 0, false, out);
+            if (flush == Flush::Finish) {
+                emit_stored(data, size, true, out);
+                finished_ = true;
+            }
+            return;
+        }
+
+        while (size > 0) {
+            if (window_.size() >= 2 * static_cast<std::size_t>(kWindowSize)) slide_window();
+            const std::size_t n = std::min(size, 2 * static_cast<std::size_t>(kWindowSize) - window_.size());
+            window_.insert(window_.end(), data, data + n);
+            data += n;
+            size -= n;
+            tokenize(false, out);
+        }
+
+        if (flush == Flush::None) return;
+        tokenize(true, out);
+        if (flush == Flush::Sync) {
+            if (!tokens_.empty()) emit_block(false, out);
+            emit_stored(nullptr, 0, false, out);
+            return;
+        }
+        emit_block(true, out);
+        align_to_byte(out);
+        finished_ = true;
+    }
+
+    void Deflater::reset() {
+        finished_ = false;
+        matchAvailable_ = false;
+        prevLength_ = 0;
+        prevDistance_ = 0;
+        window_.clear();
+        pos_ = 0;
+        blockStart_ = 0;
+        std::fill(head_.begin(), head_.end(), -1);
+        std::fill(prev_.begin(), prev_.end(), -1);
+        tokens_.clear();
+        bitBuffer_ = 0;
+        bitCount_ = 0;
+    }
+
+    void Deflater::set_dictionary(const std::uint8_t* data, std::size_t size) {
+        if (!window_.empty() || finished_ || bitCount_ != 0)
+            throw std::logic_error("Deflater: set_dictionary must precede the first write");
+        if (level_ == 0 || size == 0) return; // stored blocks never reference earlier data
+        if (size > static_cast<std::size_t>(kWindowSize)) {
+            data += size - kWindowSize;
+            size = kWindowSize;
+        }
+        window_.assign(data, data + size);
+        for (std::size_t p = 0; p < size; ++p) insert_hash(p);
+        pos_ = size;
+        blockStart_ = size;
+    }
+
+    void Deflater::put_bits(std::uint32_t bits, int count, std::vector<std::uint8_t>& out) {
+        bitBuffer_ |= static_cast<std::uint64_t>(bits) << bitCount_;
+        bitCount_ += count;
+        while (bitCount_ >= 8) {
+            out.push_back(static_cast<std::uint8_t>(bitBuffer_));
+            bitBuffer_ >>= 8;
+            bitCount_ -= 8;
+        }
+    }
+
+    void Deflater::align_to_byte(std::vector<std::uint8_t>& out) {
+        if (bitCount_ > 0) put_bits(0, 8 - bitCount_, out);
+    }
+
+    void Deflater::emit_stored(const std::uint8_t* data, std::size_t size, bool final, std::vector<std::uint8_t>& out) {
+        put_bits(final ? 1u : 0u, 1, out);
+        put_bits(0, 2, out); // BTYPE 00
+        align_to_byte(out);
+        const std::uint16_t len = static_cast<std::uint16_t>(size);
+        const std::uint16_t nlen = static_cast<std::uint16_t>(~len);
+        out.push_back(static_cast<std::uint8_t>(len));
+        out.push_back(static_cast<std::uint8_t>(len >> 8));
+        out.push_back(static_cast<std::uint8_t>(nlen));
+        out.push_back(static_cast<std::uint8_t>(nlen >> 8));
+        if (size > 0) out.insert(out.end(), data, data + size);
+    }
+
+    // Keeps the last 32 KiB before pos_; hash positions are rebased (too old -> -1)
+    void Deflater::slide_window() {
+        const std::size_t shift = pos_ - kWindowSize;
+        window_.erase(window_.begin(), window_.begin() + static_cast<std::ptrdiff_t>(shift));
+        pos_ -= shift;
+        blockStart_ -= shift;
+        const std::int32_t s = static_cast<std::int32_t>(shift);
+        for (auto& h : head_) h = h >= s ? h - s : -1;
+        for (auto& p : prev_) p = p >= s ? p - s : -1;
+    }
+
+    void Deflater::insert_hash(std::size_t pos) {
+        if (pos + kMinMatch > window_.size()) return;
+        const std::uint32_t h = hash3(window_.data() + pos);
+        prev_[pos & (kWindowSize - 1)] = head_[h];
+        head_[h] = static_cast<std::int32_t>(pos);
+    }
+
+    // Longest earlier match for the bytes at `pos` (0 if shorter than kMinMatch)
+    int Deflater::longest_match(std::size_t pos, int& distance) const {
+        const std::size_t avail = window_.size() - pos;
+        if (avail < static_cast<std::size_t>(kMinMatch)) return 0;
+        const int maxLen = static_cast<int>(std::min<std::size_t>(avail, kMaxMatch));
+        const std::uint8_t* cur = window_.data() + pos;
+
+        std::int32_t cand = head_[hash3(cur)];
+        int best = kMinMatch - 1;
+        int chain = prevLength_ >= goodLength_ ? maxChain_ >> 2 : maxChain_;
+        while (cand >= 0 && chain-- > 0) {
+            const std::size_t dist = pos - static_cast<std::size_t>(cand);
+            if (dist == 0 || dist > static_cast<std::size_t>(kWindowSize)) break;
+            const std::uint8_t* ref = window_.data() + cand;
+            if (ref[best] == cur[best] && ref[0] == cur[0] && ref[1] == cur[1]) {
+                int len = 2;
+                while (len < maxLen && ref[len] == cur[len]) ++len;
+                if (len > best) {
+                    best = len;
+                    distance = static_cast<int>(dist);
+                    if (len >= niceLength_ || len >= maxLen) break;
+                }
+            }
+            const std::int32_t next = prev_[static_cast<std::size_t>(cand) & (kWindowSize - 1)];
+            if (next >= cand) break; // slot reused by a newer position
+            cand = next;
+        }
+        return best >= kMinMatch ? best : 0;
+    }
+
+    // Turns window_ bytes into tokens. Without flushAll the last kMaxMatch bytes are
+    // kept back so that matches can still extend into the next write.
+    void Deflater::tokenize(bool flushAll, std::vector<std::uint8_t>& out) {
+        const std::size_t end = flushAll ? window_.size()
+            : (window_.size() > static_cast<std::size_t>(kMaxMatch) ? window_.size() - kMaxMatch : 0);
+        while (pos_ < end) {
+            int distance = 0;
+            if (!lazy_) {
+                // Greedy: take the longest match at pos_ (zlib's deflate_fast)
+                const int length = longest_match(pos_, distance);
+                if (length > 0) {
+                    tokens_.push_back(Token{ static_cast<std::uint16_t>(length), static_cast<std::uint16_t>(distance) });
+                    insert_hash(pos_);
+                    if (length <= lazyLength_)
+                        for (std::size_t p = pos_ + 1; p < pos_ + static_cast<std::size_t>(length); ++p) insert_hash(p);
+                    pos_ += static_cast<std::size_t>(length);
+                }
+                else {
+                    tokens_.push_back(Token{ 0, window_[pos_] });
+                    insert_hash(pos_);
+                    ++pos_;
+                }
+            }
+            else {
+                // Lazy: the match at pos_ - 1 is kept unless pos_ has a longer one
+                // (zlib's deflate_slow); each position is searched once
+                const int length = prevLength_ < lazyLength_ ? longest_match(pos_, distance) : 0;
+                insert_hash(pos_);
+                if (prevLength_ >= kMinMatch && length <= prevLength_) {
+                    tokens_.push_back(Token{ static_cast<std::uint16_t>(prevLength_), static_cast<std::uint16_t>(prevDistance_) });
+                    const std::size_t matchEnd = pos_ - 1 + static_cast<std::size_t>(prevLength_);
+                    for (std::size_t p = pos_ + 1; p < matchEnd; ++p) insert_hash(p);
+                    pos_ = matchEnd;
+                    matchAvailable_ = false;
+                    prevLength_ = 0;
+                }
+                else {
+                    if (matchAvailable_) tokens_.push_back(Token{ 0, window_[pos_ - 1] });
+                    matchAvailable_ = true;
+                    prevLength_ = length;
+                    prevDistance_ = distance;
+                    ++pos_;
+                }
+            }
+
+            // blocks never span more input than the window keeps (stored fallback)
+            if (tokens_.size() >= kMaxTokens || pos_ - blockStart_ >= static_cast<std::size_t>(kWindowSize))
+                emit_block(false, out);
+        }
+
+        if (flushAll && matchAvailable_) {
+            tokens_.push_back(Token{ 0, window_[pos_ - 1] });
+            matchAvailable_ = false;
+            prevLength_ = 0;
+        }
+    }
+
+    // Emits the pending tokens as one block: dynamic Huffman, fixed Huffman or
+    // stored, whichever is smallest
+    void Deflater::emit_block(bool final, std::vector<std::uint8_t>& out) {
+        std::uint32_t litFreq[kLiteralCodes] = {};
+        std::uint32_t distFreq[kDistanceCodes] = {};
+        for (const Token& t : tokens_) {
+            if (t.length == 0) ++litFreq[t.value];
+            else {
+                ++litFreq[257 + length_code(t.length)];
+                ++distFreq[distance_code(t.value)];
+            }
+        }
+        litFreq[kEndOfBlock] = 1;
+
+        std::uint8_t litLen[kLiteralCodes];
+        std::uint8_t distLen[kDistanceCodes];
+        build_lengths(litFreq, kLiteralCodes, 15, litLen);
+        build_lengths(distFreq, kDistanceCodes, 15, distLen);
+        if (std::all_of(distLen, distLen + kDistanceCodes, [](std::uint8_t l) { return l == 0; }))
+            distLen[0] = 1; // a dynamic block needs at least one distance code
+
+        int hlit = kLiteralCodes;
+        while (hlit > 257 && litLen[hlit - 1] == 0) --hlit;
+        int hdist = kDistanceCodes;
+        while (hdist > 1 && distLen[hdist - 1] == 0) --hdist;
+
+        // Run-length encode the code lengths (symbols 16 / 17 / 18)
+        std::uint8_t lengths[kLiteralCodes + kDistanceCodes];
+        std::copy(litLen, litLen + hlit, lengths);
+        std::copy(distLen, distLen + hdist, lengths + hlit);
+        const int total = hlit + hdist;
+        struct LengthSymbol { std::uint8_t symbol, extra; };
+        std::vector<LengthSymbol> rle;
+        for (int i = 0; i < total;) {
+            const std::uint8_t len = lengths[i];
+            int run = 1;
+            while (i + run < total && lengths[i + run] == len) ++run;
+            int left = run;
+            if (len == 0) {
+                while (left >= 11) { const int n = std::min(left, 138); rle.push_back({ 18, static_cast<std::uint8_t>(n - 11) }); left -= n; }
+                if (left >= 3) { rle.push_back({ 17, static_cast<std::uint8_t>(left - 3) }); left = 0; }
+            }
+            else if (left >= 4) {
+                rle.push_back({ len, 0 });
+                --left;
+                while (left >= 3) { const int n = std::min(left, 6); rle.push_back({ 16, static_cast<std::uint8_t>(n - 3) }); left -= n; }
+            }
+            while (left-- > 0) rle.push_back({ len, 0 });
+            i += run;
+        }
+
+        std::uint32_t clFreq[kCodeLengthCodes] = {};
+        for (const LengthSymbol& s : rle) ++clFreq[s.symbol];
+        std::uint8_t clLen[kCodeLengthCodes];
+        build_lengths(clFreq, kCodeLengthCodes, 7, clLen);
+        int hclen = kCodeLengthCodes;
+        while (hclen > 4 && clLen[kCodeLengthOrder[hclen - 1]] == 0) --hclen;
+
+        // Fixed code lengths (RFC 1951, 3.2.6)
+        std::uint8_t fixedLit[288];
+        std::uint8_t fixedDist[kDistanceCodes];
+        for (int s = 0; s < 288; ++s) fixedLit[s] = s < 144 ? 8 : s < 256 ? 9 : s < 280 ? 7 : 8;
+        std::fill(fixedDist, fixedDist + kDistanceCodes, std::uint8_t{ 5 });
+
+        // Extra bits are the same under both codes and left out of the comparison
+        std::uint64_t dynamicBits = 14 + 3 * static_cast<std::uint64_t>(hclen);
+        std::uint64_t fixedBits = 0;
+        for (int s = 0; s < kLiteralCodes; ++s) {
+            dynamicBits += static_cast<std::uint64_t>(litFreq[s]) * litLen[s];
+            fixedBits += static_cast<std::uint64_t>(litFreq[s]) * fixedLit[s];
+        }
+        for (int s = 0; s < kDistanceCodes; ++s) {
+            dynamicBits += static_cast<std::uint64_t>(distFreq[s]) * distLen[s];
+            fixedBits += static_cast<std::uint64_t>(distFreq[s]) * fixedDist[s];
+        }
+        for (const LengthSymbol& s : rle)
+            dynamicBits += clLen[s.symbol] + (s.symbol == 16 ? 2 : s.symbol == 17 ? 3 : s.symbol == 18 ? 7 : 0);
+        std::uint64_t extraBits = 0;
+        for (const Token& t : tokens_) {
+            if (t.length == 0) continue;
+            extraBits += kLengthExtra[length_code(t.length)] + kDistanceExtra[distance_code(t.value)];
+        }
+
+        // Stored: header, padding to a byte and LEN/NLEN, then the raw bytes
+        const std::size_t blockEnd = pos_ - (matchAvailable_ ? 1 : 0); // a pending byte belongs to the next block
+        const std::size_t rawBytes = blockEnd - blockStart_;
+        const std::uint64_t storedBits = 3 + 7 + 32 + 8 * static_cast<std::uint64_t>(rawBytes);
+        if (storedBits < std::min(fixedBits, dynamicBits) + extraBits) {
+            emit_stored(window_.data() + blockStart_, rawBytes, final, out);
+            tokens_.clear();
+            blockStart_ = blockEnd;
+            return;
+        }
+        const bool useFixed = fixedBits <= dynamicBits;
+
+        std::uint16_t litCode[288];
+        std::uint16_t distCode[kDistanceCodes];
+        const std::uint8_t* litBits = useFixed ? fixedLit : litLen;
+        const std::uint8_t* distBits = useFixed ? fixedDist : distLen;
+        build_codes(litBits, useFixed ? 288 : kLiteralCodes, litCode);
+        build_codes(distBits, kDistanceCodes, distCode);
+
+        put_bits(final ? 1u : 0u, 1, out);
+        if (useFixed) {
+            put_bits(1, 2, out);
+        }
+        else {
+            put_bits(2, 2, out);
+            put_bits(static_cast<std::uint32_t>(hlit - 257), 5, out);
+            put_bits(static_cast<std::uint32_t>(hdist - 1), 5, out);
+            put_bits(static_cast<std::uint32_t>(hclen - 4), 4, out);
+            for (int i = 0; i < hclen; ++i) put_bits(clLen[kCodeLengthOrder[i]], 3, out);
+            std::uint16_t clCode[kCodeLengthCodes];
+            build_codes(clLen, kCodeLengthCodes, clCode);
+            for (const LengthSymbol& s : rle) {
+                put_bits(clCode[s.symbol], clLen[s.symbol], out);
+                if (s.symbol == 16) put_bits(s.extra, 2, out);
+                else if (s.symbol == 17) put_bits(s.extra, 3, out);
+                else if (s.symbol == 18) put_bits(s.extra, 7, out);
+            }
+        }
+
+        for (const Token& t : tokens_) {
+            if (t.length == 0) {
+                put_bits(litCode[t.value], litBits[t.value], out);
+                continue;
+            }
+            const int lc = length_code(t.length);
+            put_bits(litCode[257 + lc], litBits[257 + lc], out);
+            put_bits(static_cast<std::uint32_t>(t.length - kLengthBase[lc]), kLengthExtra[lc], out);
+            const int dc = distance_code(t.value);
+            put_bits(distCode[dc], distBits[dc], out);
+            put_bits(static_cast<std::uint32_t>(t.value - kDistanceBase[dc]), kDistanceExtra[dc], out);
+        }
+        put_bits(litCode[kEndOfBlock], litBits[kEndOfBlock], out);
+        tokens_.clear();
+        blockStart_ = blockEnd;
+    }
+
+} // namespace Noise
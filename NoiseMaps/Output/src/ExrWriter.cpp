@@ -0,0 +1,185 @@
+// ExrWriter.cpp
+#include "ExrWriter.hpp"
+#include "HalfFloat.hpp"
+#include "NoiseMap.hpp"
+#include "TileScheduler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace Noise {
+
+    // rows converted to half per task
+    static constexpr int kConvertRows = 16;
+    // rows converted per batch by write_rows(const float*)
+    static constexpr int kBatchRows = 64;
+
+    static void put_u32_le(std::vector<std::uint8_t>& out, std::uint32_t v) {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+    }
+
+    static void put_u64_le(std::vector<std::uint8_t>& out, std::uint64_t v) {
+        for (int i = 0; i < 8; ++i) out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+    }
+
+    static void put_f32_le(std::vector<std::uint8_t>& out, float v) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        put_u32_le(out, bits);
+    }
+
+    static void put_string(std::vector<std::uint8_t>& out, const char* s) {
+        out.insert(out.end(), s, s + std::strlen(s) + 1);
+    }
+
+    // name, type, byte size; the value follows
+    static void put_attribute(std::vector<std::uint8_t>& out, const char* name, const char* type, std::uint32_t size) {
+        put_string(out, name);
+        put_string(out, type);
+        put_u32_le(out, size);
+    }
+
+    // ---------------------------------------------------------
+    // ExrStreamWriter
+    // ---------------------------------------------------------
+    ExrStreamWriter::ExrStreamWriter(const std::filesystem::path& file, int width, int height, const ExrStreamOptions& options)
+        : path_(file), width_(width), height_(height), threads_(options.threads), pool_(options.pool) {
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+
+        std::vector<std::uint8_t> header;
+        static const std::uint8_t magic[4] = { 0x76, 0x2F, 0x31, 0x01 };
+        header.insert(header.end(), magic, magic + 4);
+        put_u32_le(header, 2); // version 2, single-part scanline file
+
+        // Attributes in the order OpenEXR itself writes them (sorted by name)
+        put_attribute(header, "channels", "chlist", 2 + 16 + 1);
+        put_string(header, "Y");
+        put_u32_le(header, 1); // HALF
+        put_u32_le(header, 0); // pLinear + reserved
+        put_u32_le(header, 1); // xSampling
+        put_u32_le(header, 1); // ySampling
+        header.push_back(0);   // end of channel list
+
+        put_attribute(header, "compression", "compression", 1);
+        header.push_back(0); // NO_COMPRESSION
+
+        for (const char* window : { "dataWindow", "displayWindow" }) {
+            put_attribute(header, window, "box2i", 16);
+            put_u32_le(header, 0);
+            put_u32_le(header, 0);
+            put_u32_le(header, static_cast<std::uint32_t>(width - 1));
+            put_u32_le(header, static_cast<std::uint32_t>(height - 1));
+        }
+
+        put_attribute(header, "lineOrder", "lineOrder", 1);
+        header.push_back(0); // INCREASING_Y
+
+        put_attribute(header, "pixelAspectRatio", "float", 4);
+        put_f32_le(header, 1.0f);
+        put_attribute(header, "screenWindowCenter", "v2f", 8);
+        put_f32_le(header, 0.0f);
+        put_f32_le(header, 0.0f);
+        put_attribute(header, "screenWindowWidth", "float", 4);
+        put_f32_le(header, 1.0f);
+        header.push_back(0); // end of header
+
+        // One scanline per block, all of the same size, so every offset is known now
+        const std::uint64_t blockBytes = 8 + 2 * static_cast<std::uint64_t>(width);
+        const std::uint64_t firstBlock = header.size() + 8 * static_cast<std::uint64_t>(height);
+        header.reserve(static_cast<std::size_t>(firstBlock));
+        for (int y = 0; y < height; ++y)
+            put_u64_le(header, firstBlock + static_cast<std::uint64_t>(y) * blockBytes);
+
+        file_.open(file, std::ios::binary | std::ios::trunc);
+        if (!file_) throw std::runtime_error("Failed to open image file for writing: " + file.string());
+        file_.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        if (!file_) throw std::runtime_error("Failed to write image file: " + path_.string());
+
+        block_.resize(static_cast<std::size_t>(blockBytes));
+    }
+
+    void ExrStreamWriter::write_rows(const std::uint16_t* halves, std::size_t stride, int rows) {
+        if (finished_) throw std::runtime_error("ExrStreamWriter: write after finish()");
+        if (rows < 0 || rows > height_ - rowsWritten_)
+            throw std::invalid_argument("rows must be in [0, " + std::to_string(height_ - rowsWritten_) + "], got: " + std::to_string(rows));
+        const std::size_t w = static_cast<std::size_t>(width_);
+        const std::uint32_t dataBytes = static_cast<std::uint32_t>(2 * w);
+        for (int r = 0; r < rows; ++r) {
+            const std::uint32_t y = static_cast<std::uint32_t>(rowsWritten_ + r);
+            for (int i = 0; i < 4; ++i) {
+                block_[i] = static_cast<std::uint8_t>(y >> (8 * i));
+                block_[4 + i] = static_cast<std::uint8_t>(dataBytes >> (8 * i));
+            }
+            // samples are little-endian in the file, as on every supported target
+            std::memcpy(block_.data() + 8, halves + static_cast<std::size_t>(r) * stride, dataBytes);
+            file_.write(reinterpret_cast<const char*>(block_.data()), static_cast<std::streamsize>(block_.size()));
+        }
+        if (!file_) throw std::runtime_error("Failed to write image file: " + path_.string());
+        rowsWritten_ += rows;
+    }
+
+    void ExrStreamWriter::write_rows(const float* src, std::size_t stride, int rows) {
+        if (rows < 0 || rows > height_ - rowsWritten_)
+            throw std::invalid_argument("rows must be in [0, " + std::to_string(height_ - rowsWritten_) + "], got: " + std::to_string(rows));
+        const std::size_t w = static_cast<std::size_t>(width_);
+        const int batchRows = std::min(kBatchRows, height_);
+        halves_.resize(w * batchRows);
+        for (int r0 = 0; r0 < rows; r0 += batchRows) {
+            const int count = std::min(batchRows, rows - r0);
+            parallel_for_tiles(1, count, 1, kConvertRows, threads_, pool_, [&](const Tile& t) {
+                for (int r = t.y; r < t.y + t.height; ++r)
+                    floats_to_halves(src + static_cast<std::size_t>(r0 + r) * stride, halves_.data() + static_cast<std::size_t>(r) * w, w);
+            });
+            write_rows(halves_.data(), w, count);
+        }
+    }
+
+    void ExrStreamWriter::finish() {
+        if (finished_) return;
+        if (rowsWritten_ != height_)
+            throw std::runtime_error("ExrStreamWriter: " + std::to_string(rowsWritten_) + " of " + std::to_string(height_) + " rows written");
+        file_.close();
+        if (!file_) throw std::runtime_error("Failed to write image file: " + path_.string());
+        finished_ = true;
+    }
+
+    void ExrStreamWriter::close() noexcept {
+        if (file_.is_open()) file_.close();
+    }
+
+    // ---------------------------------------------------------
+    // Band pipeline
+    // ---------------------------------------------------------
+    void write_exr_streamed(
+        const std::filesystem::path& file,
+        int width,
+        int height,
+        const ExrBandFn& produce,
+        const ExrStreamOptions& options
+    ) {
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+        if (options.bandRows < 1) throw std::invalid_argument("bandRows must be >= 1, got: " + std::to_string(options.bandRows));
+
+        ExrStreamWriter exr(file, width, height, options);
+        const int bandRows = std::min(options.bandRows, height);
+        NoiseMap band(width, bandRows);
+        try {
+            for (int y0 = 0; y0 < height; y0 += bandRows) {
+                const int rows = std::min(bandRows, height - y0);
+                produce(band.data(), band.stride(), y0, rows);
+                exr.write_rows(band.data(), band.stride(), rows);
+            }
+            exr.finish();
+        }
+        catch (...) {
+            // a failed or cancelled export leaves no partial file
+            exr.close();
+            std::error_code ec;
+            std::filesystem::remove(file, ec);
+            throw;
+        }
+    }
+
+} // namespace Noise
@@ -0,0 +1,158 @@
+// HalfFloat.cpp
+#include "HalfFloat.hpp"
+#include "CpuFeatures.hpp"
+
+#include <cstring>
+
+#if defined(RELNO_ARCH_X86)
+#include <immintrin.h>
+#elif defined(RELNO_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace Noise {
+
+    using ToHalfKernel = void (*)(const float* src, std::uint16_t* dst, std::size_t count);
+    using ToFloatKernel = void (*)(const std::uint16_t* src, float* dst, std::size_t count);
+
+    // ---------------------------------------------------------
+    // Scalar conversions
+    // ---------------------------------------------------------
+    std::uint16_t float_to_half(float value) noexcept {
+        std::uint32_t f;
+        std::memcpy(&f, &value, sizeof(f));
+        const std::uint32_t sign = (f >> 16) & 0x8000u;
+        const std::uint32_t absf = f & 0x7FFFFFFFu;
+
+        if (absf >= 0x7F800000u) { // Inf / NaN (quieted, top payload bits kept)
+            const std::uint32_t nan = absf > 0x7F800000u ? 0x0200u | ((absf >> 13) & 0x03FFu) : 0u;
+            return static_cast<std::uint16_t>(sign | 0x7C00u | nan);
+        }
+        if (absf >= 0x477FF000u) // >= 65520 rounds past the largest half (65504)
+            return static_cast<std::uint16_t>(sign | 0x7C00u);
+        if (absf < 0x38800000u) { // below 2^-14: subnormal half or zero
+            if (absf < 0x33000000u) return static_cast<std::uint16_t>(sign); // < 2^-25
+            const std::uint32_t mantissa = (absf & 0x007FFFFFu) | 0x00800000u;
+            const std::uint32_t shift = 126u - (absf >> 23);
+            std::uint32_t h = mantissa >> shift;
+            const std::uint32_t rest = mantissa & ((1u << shift) - 1u);
+            const std::uint32_t halfway = 1u << (shift - 1u);
+            if (rest > halfway || (rest == halfway && (h & 1u))) ++h; // may carry into the smallest normal
+            return static_cast<std::uint16_t>(sign | h);
+        }
+        std::uint32_t h = (absf - 0x38000000u) >> 13; // rebias the exponent from 127 to 15
+        const std::uint32_t rest = absf & 0x1FFFu;
+        if (rest > 0x1000u || (rest == 0x1000u && (h & 1u))) ++h;
+        return static_cast<std::uint16_t>(sign | h);
+    }
+
+    float half_to_float(std::uint16_t half) noexcept {
+        const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000u) << 16;
+        const std::uint32_t exponent = (half >> 10) & 0x1Fu;
+        std::uint32_t mantissa = half & 0x03FFu;
+        std::uint32_t f;
+        if (exponent == 0) {
+            if (mantissa == 0) {
+                f = sign;
+            }
+            else { // subnormal: normalize
+                std::uint32_t e = 113;
+                while (!(mantissa & 0x0400u)) {
+                    mantissa <<= 1;
+                    --e;
+                }
+                f = sign | (e << 23) | ((mantissa & 0x03FFu) << 13);
+            }
+        }
+        else if (exponent == 0x1Fu) {
+            f = sign | 0x7F800000u | (mantissa << 13) | (mantissa ? 0x00400000u : 0u);
+        }
+        else {
+            f = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+        }
+        float value;
+        std::memcpy(&value, &f, sizeof(value));
+        return value;
+    }
+
+    // ---------------------------------------------------------
+    // SIMD kernels
+    // ---------------------------------------------------------
+#if defined(RELNO_ARCH_X86)
+    RELNO_TARGET_F16C
+    static void floats_to_halves_f16c(const float* src, std::uint16_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+        }
+        for (; i < count; ++i) dst[i] = float_to_half(src[i]);
+    }
+
+    RELNO_TARGET_F16C
+    static void halves_to_floats_f16c(const std::uint16_t* src, float* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+        }
+        for (; i < count; ++i) dst[i] = half_to_float(src[i]);
+    }
+#endif // RELNO_ARCH_X86
+
+#if defined(RELNO_ARCH_ARM64)
+    static void floats_to_halves_neon(const float* src, std::uint16_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+            vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+        for (; i < count; ++i) dst[i] = float_to_half(src[i]);
+    }
+
+    static void halves_to_floats_neon(const std::uint16_t* src, float* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+        for (; i < count; ++i) dst[i] = half_to_float(src[i]);
+    }
+#endif // RELNO_ARCH_ARM64
+
+    // F16C kernels sit in the AVX2 tier, filled only when the host has F16C
+    static const KernelTable<ToHalfKernel> kToHalfKernels = [] {
+        KernelTable<ToHalfKernel> t;
+#if defined(RELNO_ARCH_X86)
+        if (cpu_features().f16c) t.avx2 = floats_to_halves_f16c;
+#elif defined(RELNO_ARCH_ARM64)
+        t.neon = floats_to_halves_neon;
+#endif
+        return t;
+    }();
+
+    static const KernelTable<ToFloatKernel> kToFloatKernels = [] {
+        KernelTable<ToFloatKernel> t;
+#if defined(RELNO_ARCH_X86)
+        if (cpu_features().f16c) t.avx2 = halves_to_floats_f16c;
+#elif defined(RELNO_ARCH_ARM64)
+        t.neon = halves_to_floats_neon;
+#endif
+        return t;
+    }();
+
+    void floats_to_halves(const float* src, std::uint16_t* dst, std::size_t count) {
+        const ToHalfKernel kernel = kToHalfKernels.get();
+        if (kernel) {
+            kernel(src, dst, count);
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i) dst[i] = float_to_half(src[i]);
+    }
+
+    void halves_to_floats(const std::uint16_t* src, float* dst, std::size_t count) {
+        const ToFloatKernel kernel = kToFloatKernels.get();
+        if (kernel) {
+            kernel(src, dst, count);
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i) dst[i] = half_to_float(src[i]);
+    }
+
+} // namespace Noise
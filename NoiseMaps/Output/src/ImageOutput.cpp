@@ -0,0 +1,461 @@
+// ImageOutput.cpp
+#include "ImageOutput.hpp"
+#include "PngWriter.hpp"
+#include "ExrWriter.hpp"
+#include "CpuFeatures.hpp"
+#include "NoiseStats.hpp"
+#include "TileScheduler.hpp"
+#include "stb_image_write.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#if defined(RELNO_ARCH_X86)
+#include <immintrin.h>
+#elif defined(RELNO_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace Noise {
+
+    using Unorm8Kernel = void (*)(const float* src, std::uint8_t* dst, std::size_t count);
+    using Unorm16Kernel = void (*)(const float* src, std::uint16_t* dst, std::size_t count);
+    using Unorm16BeKernel = void (*)(const float* src, std::uint8_t* dst, std::size_t count);
+
+    // rows quantized per task when a whole map is converted for JPEG
+    static constexpr int kQuantizeRows = 64;
+    // rows per band of save_noise_image_bands
+    static constexpr int kBandRows = 64;
+
+    static inline std::uint8_t quantize_unorm8_scalar(float v) {
+        v = v > 0.0f ? v : 0.0f; // also maps NaN to 0
+        v = v < 1.0f ? v : 1.0f;
+        return static_cast<std::uint8_t>(v * 255.0f);
+    }
+
+    static inline std::uint16_t quantize_unorm16_scalar(float v) {
+        v = v > 0.0f ? v : 0.0f;
+        v = v < 1.0f ? v : 1.0f;
+        return static_cast<std::uint16_t>(v * 65535.0f + 0.5f);
+    }
+
+    // ---------------------------------------------------------
+    // SIMD kernels: max(v, 0) takes the zero operand for NaN lanes, and every
+    // clamped value converts to the same integer as the scalar path
+    // ---------------------------------------------------------
+#if defined(RELNO_ARCH_X86)
+    RELNO_TARGET_AVX2
+    static inline __m256i quantize8_avx2(const float* src) {
+        __m256 v = _mm256_max_ps(_mm256_loadu_ps(src), _mm256_setzero_ps());
+        v = _mm256_min_ps(v, _mm256_set1_ps(1.0f));
+        return _mm256_cvttps_epi32(_mm256_mul_ps(v, _mm256_set1_ps(255.0f)));
+    }
+
+    RELNO_TARGET_AVX2
+    static void quantize_unorm8_avx2(const float* src, std::uint8_t* dst, std::size_t count) {
+        // packs work per 128-bit lane; the permute restores element order
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        std::size_t i = 0;
+        for (; i + 32 <= count; i += 32) {
+            const __m256i ab = _mm256_packus_epi32(quantize8_avx2(src + i), quantize8_avx2(src + i + 8));
+            const __m256i cd = _mm256_packus_epi32(quantize8_avx2(src + i + 16), quantize8_avx2(src + i + 24));
+            const __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(ab, cd), order);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), bytes);
+        }
+        for (; i < count; ++i) dst[i] = quantize_unorm8_scalar(src[i]);
+    }
+
+    RELNO_TARGET_AVX2
+    static inline __m256i quantize16_avx2(const float* src) {
+        __m256 v = _mm256_max_ps(_mm256_loadu_ps(src), _mm256_setzero_ps());
+        v = _mm256_min_ps(v, _mm256_set1_ps(1.0f));
+        v = _mm256_add_ps(_mm256_mul_ps(v, _mm256_set1_ps(65535.0f)), _mm256_set1_ps(0.5f));
+        return _mm256_cvttps_epi32(v);
+    }
+
+    RELNO_TARGET_AVX2
+    static void quantize_unorm16_avx2(const float* src, std::uint16_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            const __m256i words = _mm256_packus_epi32(quantize16_avx2(src + i), quantize16_avx2(src + i + 8));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permute4x64_epi64(words, 0xD8));
+        }
+        for (; i < count; ++i) dst[i] = quantize_unorm16_scalar(src[i]);
+    }
+
+    RELNO_TARGET_AVX2
+    static void quantize_unorm16_be_avx2(const float* src, std::uint8_t* dst, std::size_t count) {
+        // byte swap within every 16-bit word (PNG samples are big-endian)
+        const __m256i swap = _mm256_setr_epi8(
+            1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+            1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m256i words = _mm256_packus_epi32(quantize16_avx2(src + i), quantize16_avx2(src + i + 8));
+            words = _mm256_shuffle_epi8(_mm256_permute4x64_epi64(words, 0xD8), swap);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i), words);
+        }
+        for (; i < count; ++i) {
+            const std::uint16_t v = quantize_unorm16_scalar(src[i]);
+            dst[2 * i] = static_cast<std::uint8_t>(v >> 8);
+            dst[2 * i + 1] = static_cast<std::uint8_t>(v);
+        }
+    }
+
+    RELNO_TARGET_SSE2
+    static inline __m128i quantize4_sse2(const float* src, float scale, float bias) {
+        __m128 v = _mm_max_ps(_mm_loadu_ps(src), _mm_setzero_ps());
+        v = _mm_min_ps(v, _mm_set1_ps(1.0f));
+        return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(scale)), _mm_set1_ps(bias)));
+    }
+
+    RELNO_TARGET_SSE2
+    static void quantize_unorm8_sse2(const float* src, std::uint8_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            // values are in [0, 255], so the signed 32 -> 16 pack cannot saturate
+            // (adding the 0 bias leaves v * 255 unchanged)
+            const __m128i ab = _mm_packs_epi32(quantize4_sse2(src + i, 255.0f, 0.0f), quantize4_sse2(src + i + 4, 255.0f, 0.0f));
+            const __m128i cd = _mm_packs_epi32(quantize4_sse2(src + i + 8, 255.0f, 0.0f), quantize4_sse2(src + i + 12, 255.0f, 0.0f));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(ab, cd));
+        }
+        for (; i < count; ++i) dst[i] = quantize_unorm8_scalar(src[i]);
+    }
+
+    // Eight unorm16 words: SSE2 only packs with signed saturation, so the values
+    // are shifted into int16 range and back
+    RELNO_TARGET_SSE2
+    static inline __m128i quantize16x8_sse2(const float* src) {
+        const __m128i offset = _mm_set1_epi32(32768);
+        const __m128i lo = _mm_sub_epi32(quantize4_sse2(src, 65535.0f, 0.5f), offset);
+        const __m128i hi = _mm_sub_epi32(quantize4_sse2(src + 4, 65535.0f, 0.5f), offset);
+        return _mm_xor_si128(_mm_packs_epi32(lo, hi), _mm_set1_epi16(static_cast<short>(0x8000)));
+    }
+
+    RELNO_TARGET_SSE2
+    static void quantize_unorm16_sse2(const float* src, std::uint16_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), quantize16x8_sse2(src + i));
+        for (; i < count; ++i) dst[i] = quantize_unorm16_scalar(src[i]);
+    }
+
+    RELNO_TARGET_SSE2
+    static void quantize_unorm16_be_sse2(const float* src, std::uint8_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m128i words = quantize16x8_sse2(src + i);
+            const __m128i swapped = _mm_or_si128(_mm_slli_epi16(words, 8), _mm_srli_epi16(words, 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), swapped);
+        }
+        for (; i < count; ++i) {
+            const std::uint16_t v = quantize_unorm16_scalar(src[i]);
+            dst[2 * i] = static_cast<std::uint8_t>(v >> 8);
+            dst[2 * i + 1] = static_cast<std::uint8_t>(v);
+        }
+    }
+#endif // RELNO_ARCH_X86
+
+#if defined(RELNO_ARCH_ARM64)
+    static inline uint32x4_t quantize4_neon(const float* src) {
+        float32x4_t v = vmaxnmq_f32(vld1q_f32(src), vdupq_n_f32(0.0f));
+        v = vminq_f32(v, vdupq_n_f32(1.0f));
+        return vcvtq_u32_f32(vmulq_f32(v, vdupq_n_f32(255.0f)));
+    }
+
+    static void quantize_unorm8_neon(const float* src, std::uint8_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            const uint16x8_t lo = vcombine_u16(vmovn_u32(quantize4_neon(src + i)), vmovn_u32(quantize4_neon(src + i + 4)));
+            const uint16x8_t hi = vcombine_u16(vmovn_u32(quantize4_neon(src + i + 8)), vmovn_u32(quantize4_neon(src + i + 12)));
+            vst1q_u8(dst + i, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+        }
+        for (; i < count; ++i) dst[i] = quantize_unorm8_scalar(src[i]);
+    }
+
+    static void quantize_unorm16_neon(const float* src, std::uint16_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            float32x4_t v = vmaxnmq_f32(vld1q_f32(src + i), vdupq_n_f32(0.0f));
+            v = vminq_f32(v, vdupq_n_f32(1.0f));
+            v = vaddq_f32(vmulq_f32(v, vdupq_n_f32(65535.0f)), vdupq_n_f32(0.5f));
+            vst1_u16(dst + i, vmovn_u32(vcvtq_u32_f32(v)));
+        }
+        for (; i < count; ++i) dst[i] = quantize_unorm16_scalar(src[i]);
+    }
+
+    static void quantize_unorm16_be_neon(const float* src, std::uint8_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            uint32x4_t q[2];
+            for (int k = 0; k < 2; ++k) {
+                float32x4_t v = vmaxnmq_f32(vld1q_f32(src + i + 4 * k), vdupq_n_f32(0.0f));
+                v = vminq_f32(v, vdupq_n_f32(1.0f));
+                q[k] = vcvtq_u32_f32(vaddq_f32(vmulq_f32(v, vdupq_n_f32(65535.0f)), vdupq_n_f32(0.5f)));
+            }
+            const uint16x8_t words = vcombine_u16(vmovn_u32(q[0]), vmovn_u32(q[1]));
+            vst1q_u8(dst + 2 * i, vrev16q_u8(vreinterpretq_u8_u16(words)));
+        }
+        for (; i < count; ++i) {
+            const std::uint16_t v = quantize_unorm16_scalar(src[i]);
+            dst[2 * i] = static_cast<std::uint8_t>(v >> 8);
+            dst[2 * i + 1] = static_cast<std::uint8_t>(v);
+        }
+    }
+#endif // RELNO_ARCH_ARM64
+
+    // Scalar slots are null: the callers below run the scalar loop themselves
+    static const KernelTable<Unorm8Kernel> kUnorm8Kernels = [] {
+        KernelTable<Unorm8Kernel> t;
+#if defined(RELNO_ARCH_X86)
+        t.sse2 = quantize_unorm8_sse2;
+        t.avx2 = quantize_unorm8_avx2;
+#elif defined(RELNO_ARCH_ARM64)
+        t.neon = quantize_unorm8_neon;
+#endif
+        return t;
+    }();
+
+    static const KernelTable<Unorm16Kernel> kUnorm16Kernels = [] {
+        KernelTable<Unorm16Kernel> t;
+#if defined(RELNO_ARCH_X86)
+        t.sse2 = quantize_unorm16_sse2;
+        t.avx2 = quantize_unorm16_avx2;
+#elif defined(RELNO_ARCH_ARM64)
+        t.neon = quantize_unorm16_neon;
+#endif
+        return t;
+    }();
+
+    static const KernelTable<Unorm16BeKernel> kUnorm16BeKernels = [] {
+        KernelTable<Unorm16BeKernel> t;
+#if defined(RELNO_ARCH_X86)
+        t.sse2 = quantize_unorm16_be_sse2;
+        t.avx2 = quantize_unorm16_be_avx2;
+#elif defined(RELNO_ARCH_ARM64)
+        t.neon = quantize_unorm16_be_neon;
+#endif
+        return t;
+    }();
+
+    void quantize_unorm8(const float* src, std::uint8_t* dst, std::size_t count) {
+        const Unorm8Kernel kernel = kUnorm8Kernels.get();
+        if (kernel) {
+            kernel(src, dst, count);
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i) dst[i] = quantize_unorm8_scalar(src[i]);
+    }
+
+    void quantize_unorm16(const float* src, std::uint16_t* dst, std::size_t count) {
+        const Unorm16Kernel kernel = kUnorm16Kernels.get();
+        if (kernel) {
+            kernel(src, dst, count);
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i) dst[i] = quantize_unorm16_scalar(src[i]);
+    }
+
+    void quantize_unorm16_be(const float* src, std::uint8_t* dst, std::size_t count) {
+        const Unorm16BeKernel kernel = kUnorm16BeKernels.get();
+        if (kernel) {
+            kernel(src, dst, count);
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::uint16_t v = quantize_unorm16_scalar(src[i]);
+            dst[2 * i] = static_cast<std::uint8_t>(v >> 8);
+            dst[2 * i + 1] = static_cast<std::uint8_t>(v);
+        }
+    }
+
+    // PNG sample rows of `bitDepth` bits (8, or 16 big-endian); dstStride in bytes
+    static void quantize_rows(const float* src, std::size_t srcStride, std::uint8_t* dst, std::size_t dstStride, int width, int rows, int bitDepth = 8) {
+        const auto quantize = bitDepth == 16 ? quantize_unorm16_be : quantize_unorm8;
+        for (int y = 0; y < rows; ++y)
+            quantize(src + static_cast<std::size_t>(y) * srcStride, dst + static_cast<std::size_t>(y) * dstStride, static_cast<std::size_t>(width));
+    }
+
+    // ---------------------------------------------------------
+    // Paths and formats
+    // ---------------------------------------------------------
+    std::filesystem::path resolve_image_path(const std::string& filename, const std::string& outputDir) {
+        std::filesystem::path outDir;
+        if (outputDir.empty()) {
+            outDir = std::filesystem::current_path().parent_path() / "ImageOutput";
+        }
+        else {
+            outDir = outputDir;
+        }
+        std::filesystem::create_directories(outDir);
+        return outDir / filename;
+    }
+
+    static std::string lower_extension(const std::filesystem::path& file) {
+        std::string extension = file.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension;
+    }
+
+    static PngStreamOptions png_options(const ImageSaveOptions& options) {
+        PngStreamOptions png;
+        png.compressionLevel = options.compressionLevel;
+        png.bitDepth = options.bitDepth;
+        png.threads = options.threads;
+        png.pool = options.pool;
+        return png;
+    }
+
+    static ExrStreamOptions exr_options(const ImageSaveOptions& options) {
+        ExrStreamOptions exr;
+        exr.bandRows = kBandRows;
+        exr.threads = options.threads;
+        exr.pool = options.pool;
+        return exr;
+    }
+
+    static void check_bit_depth(const ImageSaveOptions& options) {
+        if (options.bitDepth != 8 && options.bitDepth != 16)
+            throw std::invalid_argument("bitDepth must be 8 or 16, got: " + std::to_string(options.bitDepth));
+    }
+
+    // ---------------------------------------------------------
+    // Saving
+    // ---------------------------------------------------------
+    // Quantize time of a streamed PNG. The band calls overlap the encoder (and
+    // never each other), so they are summed and reported as one record once the
+    // file is written; the encode stage contains them too.
+    class BandQuantizeClock {
+    public:
+        explicit BandQuantizeClock(std::uint64_t pixels) noexcept : measure_(stats_sink() != nullptr), pixels_(pixels) {}
+
+        template <typename Fn>
+        void time(Fn&& fn) {
+            if (!measure_) {
+                fn();
+                return;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            seconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        void report() const noexcept {
+            if (!measure_) return;
+            StageRecord record;
+            record.stage = StatsStage::Quantize;
+            record.generator = "image";
+            record.seconds = seconds_;
+            record.pixels = pixels_;
+            record_stage(record);
+        }
+
+    private:
+        bool measure_;
+        std::uint64_t pixels_;
+        double seconds_ = 0.0;
+    };
+
+    std::filesystem::path save_noise_image(
+        const NoiseMap& map,
+        const std::string& filename,
+        const std::string& outputDir,
+        const ImageSaveOptions& options
+    ) {
+        if (map.empty()) throw std::invalid_argument("Cannot save empty noise map.");
+        const int quality = options.jpegQuality == 0 ? 90 : options.jpegQuality;
+        if (quality < 1 || quality > 100)
+            throw std::invalid_argument("jpegQuality must be in [1, 100] (or 0 for the default), got: " + std::to_string(options.jpegQuality));
+        check_bit_depth(options);
+
+        const int width = map.width();
+        const int height = map.height();
+        const std::uint64_t pixels = static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height);
+        const std::filesystem::path file = resolve_image_path(filename, outputDir);
+        const std::string extension = lower_extension(file);
+
+        if (extension == ".jpg" || extension == ".jpeg") {
+            if (options.bitDepth != 8)
+                throw std::invalid_argument("JPEG is 8-bit only; save as .png or .exr for more precision, got bitDepth: " + std::to_string(options.bitDepth));
+            // stb needs the whole 8-bit image; convert it in parallel row blocks
+            StageTimer quantizeTimer(StatsStage::Quantize, "image", pixels, options.threads, options.pool, pixels);
+            std::vector<std::uint8_t> samples(static_cast<std::size_t>(pixels));
+            parallel_for_tiles(1, height, 1, kQuantizeRows, options.threads, options.pool, [&](const Tile& t) {
+                quantize_rows(map.row(t.y).data(), map.stride(), samples.data() + static_cast<std::size_t>(t.y) * width, width, width, t.height);
+            });
+            quantizeTimer.stop();
+            const StageTimer timer(StatsStage::Encode, "image", pixels);
+            if (stbi_write_jpg(file.string().c_str(), width, height, 1, samples.data(), quality) == 0)
+                throw std::runtime_error("Failed to write image file: " + file.string());
+        }
+        else if (extension == ".exr") {
+            // half float, converted row block by row block straight from the map
+            const StageTimer timer(StatsStage::Encode, "image", pixels, options.threads, options.pool);
+            ExrStreamWriter exr(file, width, height, exr_options(options));
+            try {
+                exr.write_rows(map.data(), map.stride(), height);
+                exr.finish();
+            }
+            catch (...) {
+                exr.close();
+                std::error_code ec;
+                std::filesystem::remove(file, ec);
+                throw;
+            }
+        }
+        else {
+            // PNG (the default): quantized and compressed band by band, no full 8-bit copy
+            BandQuantizeClock quantizeClock(pixels);
+            StageTimer timer(StatsStage::Encode, "image", pixels, options.threads, options.pool);
+            write_png_streamed(file, width, height, [&](std::uint8_t* band, std::size_t stride, int y0, int rows) {
+                quantizeClock.time([&] { quantize_rows(map.row(y0).data(), map.stride(), band, stride, width, rows, options.bitDepth); });
+            }, png_options(options));
+            timer.stop();
+            quantizeClock.report();
+        }
+        return file;
+    }
+
+    std::filesystem::path save_noise_image_bands(
+        const std::string& filename,
+        const std::string& outputDir,
+        int width,
+        int height,
+        const FloatBandFn& produce,
+        const ImageSaveOptions& options
+    ) {
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+        check_bit_depth(options);
+        const std::filesystem::path file = resolve_image_path(filename, outputDir);
+        const std::string extension = lower_extension(file);
+        // The encode stage spans the whole pipeline, produce() included
+        const std::uint64_t pixels = static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height);
+        if (extension == ".exr") {
+            const StageTimer timer(StatsStage::Encode, "image", pixels, options.threads, options.pool);
+            write_exr_streamed(file, width, height, produce, exr_options(options));
+            return file;
+        }
+        if (extension != ".png")
+            throw std::invalid_argument("Band-wise export writes PNG or EXR only, got: " + file.filename().string());
+
+        PngStreamOptions png = png_options(options);
+        png.bandRows = kBandRows;
+
+        // produce() calls never overlap each other, so one float band is enough
+        NoiseMap band(width, std::min(kBandRows, height));
+        BandQuantizeClock quantizeClock(pixels);
+        StageTimer timer(StatsStage::Encode, "image", pixels, options.threads, options.pool);
+        write_png_streamed(file, width, height, [&](std::uint8_t* samples, std::size_t stride, int y0, int rows) {
+            produce(band.data(), band.stride(), y0, rows);
+            quantizeClock.time([&] { quantize_rows(band.data(), band.stride(), samples, stride, width, rows, options.bitDepth); });
+        }, png);
+        timer.stop();
+        quantizeClock.report();
+        return file;
+    }
+
+} // namespace Noise
@@ -0,0 +1,329 @@
+// PngWriter.cpp
+#include "PngWriter.hpp"
+#include "ThreadPool.hpp"
+#include "TileScheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace Noise {
+
+    // compressed bytes collected before they are written out as one IDAT chunk
+    static constexpr std::size_t kIdatChunkBytes = 64 * 1024;
+    // filtered bytes per independently compressed chunk (at least one row)
+    static constexpr std::size_t kDeflateChunkBytes = 256 * 1024;
+    // deflate match window, i.e. the preset dictionary handed to each chunk
+    static constexpr std::size_t kDictionaryBytes = 32 * 1024;
+
+    static void put_u32_be(std::uint8_t* p, std::uint32_t v) {
+        p[0] = static_cast<std::uint8_t>(v >> 24);
+        p[1] = static_cast<std::uint8_t>(v >> 16);
+        p[2] = static_cast<std::uint8_t>(v >> 8);
+        p[3] = static_cast<std::uint8_t>(v);
+    }
+
+    static inline int paeth(int a, int b, int c) {
+        const int p = a + b - c;
+        const int pa = std::abs(p - a);
+        const int pb = std::abs(p - b);
+        const int pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc) return a;
+        return pb <= pc ? b : c;
+    }
+
+    // Tries all five PNG filters on the w-byte `row` (candidates side by side in
+    // `scratch`, 5 * (w + 1) bytes) and copies the one with the smallest sum of
+    // absolute (signed) residuals to `out` (the libpng / stb heuristic). Bpp is the
+    // byte distance to the left neighbour: 1 for 8-bit, 2 for 16-bit samples.
+    template <std::size_t Bpp>
+    static void filter_line(const std::uint8_t* row, const std::uint8_t* up, std::size_t w, std::uint8_t* scratch, std::uint8_t* out) {
+        const std::size_t lineBytes = w + 1;
+        std::size_t best = 0;
+        std::uint64_t bestCost = ~std::uint64_t{ 0 };
+        for (std::size_t type = 0; type < 5; ++type) {
+            std::uint8_t* line = scratch + type * lineBytes;
+            line[0] = static_cast<std::uint8_t>(type);
+            std::uint8_t* f = line + 1;
+            switch (type) {
+            case 0:
+                std::copy(row, row + w, f);
+                break;
+            case 1:
+                std::copy(row, row + Bpp, f);
+                for (std::size_t x = Bpp; x < w; ++x) f[x] = static_cast<std::uint8_t>(row[x] - row[x - Bpp]);
+                break;
+            case 2:
+                for (std::size_t x = 0; x < w; ++x) f[x] = static_cast<std::uint8_t>(row[x] - up[x]);
+                break;
+            case 3:
+                for (std::size_t x = 0; x < Bpp; ++x) f[x] = static_cast<std::uint8_t>(row[x] - (up[x] >> 1));
+                for (std::size_t x = Bpp; x < w; ++x) f[x] = static_cast<std::uint8_t>(row[x] - ((row[x - Bpp] + up[x]) >> 1));
+                break;
+            default:
+                for (std::size_t x = 0; x < Bpp; ++x) f[x] = static_cast<std::uint8_t>(row[x] - up[x]);
+                for (std::size_t x = Bpp; x < w; ++x) f[x] = static_cast<std::uint8_t>(row[x] - paeth(row[x - Bpp], up[x], up[x - Bpp]));
+                break;
+            }
+            std::uint64_t cost = 0;
+            for (std::size_t x = 0; x < w; ++x) cost += static_cast<std::uint64_t>(std::abs(static_cast<int>(static_cast<std::int8_t>(f[x]))));
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = type;
+            }
+        }
+        const std::uint8_t* line = scratch + best * lineBytes;
+        std::copy(line, line + lineBytes, out);
+    }
+
+    // ---------------------------------------------------------
+    // PngStreamWriter
+    // ---------------------------------------------------------
+    PngStreamWriter::PngStreamWriter(const std::filesystem::path& file, int width, int height, const PngStreamOptions& options)
+        : path_(file), width_(width), height_(height), bitDepth_(options.bitDepth),
+          level_(options.compressionLevel), threads_(options.threads), pool_(options.pool) {
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+        if (bitDepth_ != 8 && bitDepth_ != 16) throw std::invalid_argument("bitDepth must be 8 or 16, got: " + std::to_string(bitDepth_));
+        if (level_ < 0 || level_ > 9) throw std::invalid_argument("compression level must be in [0, 9], got: " + std::to_string(level_));
+
+        rowBytes_ = static_cast<std::size_t>(width) * static_cast<std::size_t>(bitDepth_ / 8);
+        const std::size_t lineBytes = rowBytes_ + 1;
+        chunkRows_ = static_cast<int>(std::max<std::size_t>(1, kDeflateChunkBytes / lineBytes));
+        chunkRows_ = std::min(chunkRows_, height);
+        // One chunk per worker per group; the grouping never changes the output
+        ThreadPool& pool = pool_ ? *pool_ : default_thread_pool();
+        const int workers = static_cast<int>(std::min(resolve_thread_count(threads_), pool.size()));
+        groupRows_ = static_cast<int>(std::min<long long>(static_cast<long long>(chunkRows_) * std::max(1, workers), height));
+
+        file_.open(file, std::ios::binary | std::ios::trunc);
+        if (!file_) throw std::runtime_error("Failed to open image file for writing: " + file.string());
+
+        static const std::uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        file_.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+        std::uint8_t ihdr[13];
+        put_u32_be(ihdr, static_cast<std::uint32_t>(width));
+        put_u32_be(ihdr + 4, static_cast<std::uint32_t>(height));
+        ihdr[8] = static_cast<std::uint8_t>(bitDepth_);
+        ihdr[9] = 0;  // grayscale
+        ihdr[10] = 0; // deflate
+        ihdr[11] = 0; // adaptive filtering
+        ihdr[12] = 0; // no interlace
+        write_chunk("IHDR", ihdr, sizeof(ihdr));
+
+        // zlib header: deflate, 32 KiB window, FLEVEL hint, FCHECK
+        const int flevel = level_ < 2 ? 0 : level_ < 6 ? 1 : level_ == 6 ? 2 : 3;
+        const std::uint8_t cmf = 0x78;
+        std::uint8_t flg = static_cast<std::uint8_t>(flevel << 6);
+        flg = static_cast<std::uint8_t>(flg + (31 - (cmf * 256 + flg) % 31) % 31);
+        idat_.push_back(cmf);
+        idat_.push_back(flg);
+
+        pending_.resize(rowBytes_ * groupRows_);
+        prevRow_.assign(rowBytes_, 0);
+        filtered_.resize(lineBytes * groupRows_);
+        const std::size_t groupChunks = static_cast<std::size_t>((groupRows_ + chunkRows_ - 1) / chunkRows_);
+        deflaters_.assign(groupChunks, Deflater(level_));
+        chunkOut_.resize(groupChunks);
+    }
+
+    void PngStreamWriter::write_chunk(const char type[4], const std::uint8_t* data, std::size_t size) {
+        std::uint8_t header[8];
+        put_u32_be(header, static_cast<std::uint32_t>(size));
+        std::copy(type, type + 4, header + 4);
+        std::uint32_t crc = crc32(0, header + 4, 4);
+        crc = crc32(crc, data, size);
+        std::uint8_t trailer[4];
+        put_u32_be(trailer, crc);
+
+        file_.write(reinterpret_cast<const char*>(header), sizeof(header));
+        if (size > 0) file_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        file_.write(reinterpret_cast<const char*>(trailer), sizeof(trailer));
+        if (!file_) throw std::runtime_error("Failed to write image file: " + path_.string());
+    }
+
+    void PngStreamWriter::flush_idat(bool all) {
+        if (idat_.empty() || (!all && idat_.size() < kIdatChunkBytes)) return;
+        write_chunk("IDAT", idat_.data(), idat_.size());
+        idat_.clear();
+    }
+
+    // Filters and compresses the pending rows, one task per chunk, and appends the
+    // chunks in order. Every chunk ends on a sync point, so their concatenation is
+    // one deflate stream.
+    void PngStreamWriter::encode_pending() {
+        const int rows = pendingRows_;
+        if (rows == 0) return;
+        const std::size_t w = rowBytes_;
+        const std::size_t lineBytes = w + 1;
+        const int chunks = (rows + chunkRows_ - 1) / chunkRows_;
+        const auto filter = bitDepth_ == 16 ? filter_line<2> : filter_line<1>;
+
+        parallel_for_tiles(chunks, 1, 1, 1, threads_, pool_, [&](const Tile& t) {
+            const int r0 = t.x * chunkRows_;
+            const int r1 = std::min(rows, r0 + chunkRows_);
+            std::vector<std::uint8_t> scratch(5 * lineBytes);
+            for (int r = r0; r < r1; ++r) {
+                const std::uint8_t* row = pending_.data() + static_cast<std::size_t>(r) * w;
+                const std::uint8_t* up = r > 0 ? row - w : prevRow_.data();
+                filter(row, up, w, scratch.data(), filtered_.data() + static_cast<std::size_t>(r) * lineBytes);
+            }
+        });
+
+        parallel_for_tiles(chunks, 1, 1, 1, threads_, pool_, [&](const Tile& t) {
+            const std::size_t begin = static_cast<std::size_t>(t.x) * chunkRows_ * lineBytes;
+            const std::size_t end = static_cast<std::size_t>(std::min(rows, (t.x + 1) * chunkRows_)) * lineBytes;
+            Deflater& deflater = deflaters_[static_cast<std::size_t>(t.x)];
+            deflater.reset();
+            if (begin >= kDictionaryBytes) {
+                deflater.set_dictionary(filtered_.data() + begin - kDictionaryBytes, kDictionaryBytes);
+            }
+            else {
+                // the window reaches back into the previous group
+                std::vector<std::uint8_t> dictionary(history_);
+                dictionary.insert(dictionary.end(), filtered_.begin(), filtered_.begin() + static_cast<std::ptrdiff_t>(begin));
+                deflater.set_dictionary(dictionary.data(), dictionary.size());
+            }
+            std::vector<std::uint8_t>& out = chunkOut_[static_cast<std::size_t>(t.x)];
+            out.clear();
+            deflater.write(filtered_.data() + begin, end - begin, Deflater::Flush::Sync, out);
+        });
+
+        const std::size_t bytes = static_cast<std::size_t>(rows) * lineBytes;
+        adler_ = adler32(adler_, filtered_.data(), bytes);
+        for (int c = 0; c < chunks; ++c) {
+            idat_.insert(idat_.end(), chunkOut_[c].begin(), chunkOut_[c].end());
+            flush_idat(false);
+        }
+
+        if (bytes >= kDictionaryBytes) {
+            history_.assign(filtered_.begin() + static_cast<std::ptrdiff_t>(bytes - kDictionaryBytes), filtered_.begin() + static_cast<std::ptrdiff_t>(bytes));
+        }
+        else {
+            history_.insert(history_.end(), filtered_.begin(), filtered_.begin() + static_cast<std::ptrdiff_t>(bytes));
+            if (history_.size() > kDictionaryBytes)
+                history_.erase(history_.begin(), history_.end() - static_cast<std::ptrdiff_t>(kDictionaryBytes));
+        }
+        std::copy(pending_.begin() + static_cast<std::ptrdiff_t>((rows - 1) * w), pending_.begin() + static_cast<std::ptrdiff_t>(rows * w), prevRow_.begin());
+        pendingRows_ = 0;
+    }
+
+    void PngStreamWriter::write_rows(const std::uint8_t* pixels, std::size_t stride, int rows) {
+        if (finished_) throw std::runtime_error("PngStreamWriter: write after finish()");
+        if (rows < 0 || rows > height_ - rowsWritten_)
+            throw std::invalid_argument("rows must be in [0, " + std::to_string(height_ - rowsWritten_) + "], got: " + std::to_string(rows));
+        const std::size_t w = rowBytes_;
+        for (int r = 0; r < rows; ++r) {
+            const std::uint8_t* row = pixels + static_cast<std::size_t>(r) * stride;
+            std::copy(row, row + w, pending_.begin() + static_cast<std::ptrdiff_t>(pendingRows_ * w));
+            if (++pendingRows_ == groupRows_) encode_pending();
+        }
+        rowsWritten_ += rows;
+    }
+
+    void PngStreamWriter::finish() {
+        if (finished_) return;
+        if (rowsWritten_ != height_)
+            throw std::runtime_error("PngStreamWriter: " + std::to_string(rowsWritten_) + " of " + std::to_string(height_) + " rows written");
+
+        encode_pending();
+        Deflater closing(level_); // the empty final block
+        closing.write(nullptr, 0, Deflater::Flush::Finish, idat_);
+        std::uint8_t adler[4];
+        put_u32_be(adler, adler_);
+        idat_.insert(idat_.end(), adler, adler + 4);
+        flush_idat(true);
+        write_chunk("IEND", nullptr, 0);
+
+        file_.close();
+        if (!file_) throw std::runtime_error("Failed to write image file: " + path_.string());
+        finished_ = true;
+    }
+
+    void PngStreamWriter::close() noexcept {
+        if (file_.is_open()) file_.close();
+    }
+
+    // ---------------------------------------------------------
+    // Band pipeline
+    // ---------------------------------------------------------
+    // Produces band k+1 while band k is encoded, until every row is in `png`
+    static void stream_bands(PngStreamWriter& png, int width, int height, const PngBandFn& produce, const PngStreamOptions& options) {
+        ThreadPool& pool = options.pool ? *options.pool : default_thread_pool();
+
+        const int bandRows = std::min(options.bandRows, height);
+        const int bandCount = (height + bandRows - 1) / bandRows;
+        const std::size_t stride = static_cast<std::size_t>(width) * static_cast<std::size_t>(options.bitDepth / 8);
+        std::vector<std::uint8_t> bands[2] = {
+            std::vector<std::uint8_t>(stride * bandRows),
+            std::vector<std::uint8_t>(stride * bandRows)
+        };
+        auto rowsOf = [&](int band) { return std::min(bandRows, height - band * bandRows); };
+
+        produce(bands[0].data(), stride, 0, rowsOf(0));
+        for (int b = 0; b < bandCount; ++b) {
+            std::uint8_t* current = bands[b & 1].data();
+            std::uint8_t* next = bands[(b + 1) & 1].data();
+            auto encode = [&] { png.write_rows(current, stride, rowsOf(b)); };
+            auto produceNext = [&] { produce(next, stride, (b + 1) * bandRows, rowsOf(b + 1)); };
+
+            if (b + 1 == bandCount) {
+                encode();
+                break;
+            }
+            if (pool.size() < 2) {
+                encode();
+                produceNext();
+                continue;
+            }
+
+            // Two tasks, claimed by whichever participant is free (the pool may run both
+            // on the caller); produce() may itself fan out on the same pool
+            std::atomic<int> nextTask{ 0 };
+            std::exception_ptr error;
+            std::mutex errorMutex;
+            pool.run(2, [&](unsigned) {
+                for (int task; (task = nextTask.fetch_add(1)) < 2;) {
+                    try {
+                        if (task == 0) encode();
+                        else produceNext();
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> lock(errorMutex);
+                        if (!error) error = std::current_exception();
+                    }
+                }
+            });
+            if (error) std::rethrow_exception(error);
+        }
+    }
+
+    void write_png_streamed(
+        const std::filesystem::path& file,
+        int width,
+        int height,
+        const PngBandFn& produce,
+        const PngStreamOptions& options
+    ) {
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+        if (options.bandRows < 1) throw std::invalid_argument("bandRows must be >= 1, got: " + std::to_string(options.bandRows));
+
+        PngStreamWriter png(file, width, height, options);
+        try {
+            stream_bands(png, width, height, produce, options);
+            png.finish();
+        }
+        catch (...) {
+            // a failed or cancelled export leaves no partial file
+            png.close();
+            std::error_code ec;
+            std::filesystem::remove(file, ec);
+            throw;
+        }
+    }
+
+} // namespace Noise
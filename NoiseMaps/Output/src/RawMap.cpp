@@ -0,0 +1,526 @@
+// RawMap.cpp
+#include "RawMap.hpp"
+#include "HalfFloat.hpp"
+#include "ImageOutput.hpp"
+#include "NoiseStats.hpp"
+#include "TileScheduler.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Noise {
+
+    static constexpr char kMagic[4] = { 'R', 'N', 'M', 'P' };
+    static constexpr std::uint16_t kVersionRowMajor = 1;
+    static constexpr std::uint16_t kVersionTiled = 2;
+    static constexpr std::size_t kHeaderBytes = 64;
+    // rows converted per task by save_raw_map / read_region
+    static constexpr int kConvertRows = 64;
+
+    static void put_u16_le(std::uint8_t* p, std::uint16_t v) {
+        p[0] = static_cast<std::uint8_t>(v);
+        p[1] = static_cast<std::uint8_t>(v >> 8);
+    }
+    static void put_u32_le(std::uint8_t* p, std::uint32_t v) {
+        for (int i = 0; i < 4; ++i) p[i] = static_cast<std::uint8_t>(v >> (8 * i));
+    }
+    static void put_u64_le(std::uint8_t* p, std::uint64_t v) {
+        for (int i = 0; i < 8; ++i) p[i] = static_cast<std::uint8_t>(v >> (8 * i));
+    }
+    static std::uint16_t get_u16_le(const std::uint8_t* p) {
+        return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+    }
+    static std::uint32_t get_u32_le(const std::uint8_t* p) {
+        std::uint32_t v = 0;
+        for (int i = 3; i >= 0; --i) v = (v << 8) | p[i];
+        return v;
+    }
+    static std::uint64_t get_u64_le(const std::uint8_t* p) {
+        std::uint64_t v = 0;
+        for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+        return v;
+    }
+
+    std::size_t raw_sample_bytes(RawFormat format) {
+        switch (format) {
+        case RawFormat::Float32: return 4;
+        case RawFormat::Float16: return 2;
+        case RawFormat::UNorm16: return 2;
+        }
+        throw std::invalid_argument("unknown RawFormat: " + std::to_string(static_cast<unsigned>(format)));
+    }
+
+    // ---------------------------------------------------------
+    // Platform mapping
+    // ---------------------------------------------------------
+#if defined(_WIN32)
+    static void* map_file(const std::filesystem::path& file, std::size_t& bytes, bool create, bool writable) {
+        HANDLE handle = CreateFileW(file.c_str(), writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+            FILE_SHARE_READ, nullptr, create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) throw std::runtime_error("Failed to open map file: " + file.string());
+        if (!create) {
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(handle, &size)) {
+                CloseHandle(handle);
+                throw std::runtime_error("Failed to stat map file: " + file.string());
+            }
+            bytes = static_cast<std::size_t>(size.QuadPart);
+        }
+        if (bytes == 0) {
+            CloseHandle(handle);
+            throw std::runtime_error("Map file is empty: " + file.string());
+        }
+        const std::uint64_t size = bytes;
+        HANDLE mapping = CreateFileMappingW(handle, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+            static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+        CloseHandle(handle);
+        if (!mapping) throw std::runtime_error("Failed to map file: " + file.string());
+        void* base = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, bytes);
+        CloseHandle(mapping); // the view keeps the mapping alive
+        if (!base) throw std::runtime_error("Failed to map file: " + file.string());
+        return base;
+    }
+
+    static void unmap_file(void* base, std::size_t) noexcept { UnmapViewOfFile(base); }
+
+    static bool flush_file(void* base, std::size_t bytes) noexcept { return FlushViewOfFile(base, bytes) != 0; }
+
+    // File of a fixed size written at explicit offsets, from any number of threads
+    class PositionalFile {
+    public:
+        PositionalFile(const std::filesystem::path& file, std::uint64_t bytes) : path_(file) {
+            handle_ = CreateFileW(file.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (handle_ == INVALID_HANDLE_VALUE) throw std::runtime_error("Failed to open map file: " + file.string());
+            LARGE_INTEGER size;
+            size.QuadPart = static_cast<LONGLONG>(bytes);
+            if (!SetFilePointerEx(handle_, size, nullptr, FILE_BEGIN) || !SetEndOfFile(handle_)) {
+                close();
+                throw std::runtime_error("Failed to size map file: " + file.string());
+            }
+        }
+        ~PositionalFile() { close(); }
+        PositionalFile(const PositionalFile&) = delete;
+        PositionalFile& operator=(const PositionalFile&) = delete;
+
+        void write_at(std::uint64_t offset, const void* data, std::size_t bytes) {
+            const auto* p = static_cast<const std::uint8_t*>(data);
+            while (bytes > 0) {
+                OVERLAPPED at = {};
+                at.Offset = static_cast<DWORD>(offset);
+                at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                const DWORD chunk = static_cast<DWORD>(std::min<std::size_t>(bytes, 1u << 30));
+                DWORD written = 0;
+                if (!WriteFile(handle_, p, chunk, &written, &at) || written == 0)
+                    throw std::runtime_error("Failed to write map file: " + path_.string());
+                p += written;
+                offset += written;
+                bytes -= written;
+            }
+        }
+
+        void close() noexcept {
+            if (handle_ != INVALID_HANDLE_VALUE) CloseHandle(handle_);
+            handle_ = INVALID_HANDLE_VALUE;
+        }
+
+    private:
+        HANDLE handle_ = INVALID_HANDLE_VALUE;
+        std::filesystem::path path_;
+    };
+#else
+    static void* map_file(const std::filesystem::path& file, std::size_t& bytes, bool create, bool writable) {
+        const int flags = create ? (O_RDWR | O_CREAT | O_TRUNC) : (writable ? O_RDWR : O_RDONLY);
+        const int fd = ::open(file.c_str(), flags, 0644);
+        if (fd < 0) throw std::runtime_error("Failed to open map file: " + file.string() + " (" + std::strerror(errno) + ")");
+        if (create) {
+            if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                const int error = errno;
+                ::close(fd);
+                throw std::runtime_error("Failed to size map file: " + file.string() + " (" + std::strerror(error) + ")");
+            }
+        }
+        else {
+            struct stat st;
+            if (::fstat(fd, &st) != 0) {
+                ::close(fd);
+                throw std::runtime_error("Failed to stat map file: " + file.string());
+            }
+            bytes = static_cast<std::size_t>(st.st_size);
+        }
+        if (bytes == 0) {
+            ::close(fd);
+            throw std::runtime_error("Map file is empty: " + file.string());
+        }
+        void* base = ::mmap(nullptr, bytes, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // the mapping keeps the file open
+        if (base == MAP_FAILED) throw std::runtime_error("Failed to map file: " + file.string() + " (" + std::strerror(errno) + ")");
+        return base;
+    }
+
+    static void unmap_file(void* base, std::size_t bytes) noexcept { ::munmap(base, bytes); }
+
+    static bool flush_file(void* base, std::size_t bytes) noexcept { return ::msync(base, bytes, MS_SYNC) == 0; }
+
+    // File of a fixed size written at explicit offsets, from any number of threads
+    class PositionalFile {
+    public:
+        PositionalFile(const std::filesystem::path& file, std::uint64_t bytes) : path_(file) {
+            fd_ = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd_ < 0) throw std::runtime_error("Failed to open map file: " + file.string() + " (" + std::strerror(errno) + ")");
+            if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+                const int error = errno;
+                close();
+                throw std::runtime_error("Failed to size map file: " + file.string() + " (" + std::strerror(error) + ")");
+            }
+        }
+        ~PositionalFile() { close(); }
+        PositionalFile(const PositionalFile&) = delete;
+        PositionalFile& operator=(const PositionalFile&) = delete;
+
+        void write_at(std::uint64_t offset, const void* data, std::size_t bytes) {
+            const auto* p = static_cast<const std::uint8_t*>(data);
+            while (bytes > 0) {
+                const ssize_t written = ::pwrite(fd_, p, bytes, static_cast<off_t>(offset));
+                if (written < 0 && errno == EINTR) continue;
+                if (written <= 0)
+                    throw std::runtime_error("Failed to write map file: " + path_.string() + " (" + std::strerror(errno) + ")");
+                p += written;
+                offset += static_cast<std::uint64_t>(written);
+                bytes -= static_cast<std::size_t>(written);
+            }
+        }
+
+        void close() noexcept {
+            if (fd_ >= 0) ::close(fd_);
+            fd_ = -1;
+        }
+
+    private:
+        int fd_ = -1;
+        std::filesystem::path path_;
+    };
+#endif
+
+    static void write_header(std::uint8_t* header, RawFormat format, int width, int height, int tileWidth, int tileHeight) {
+        std::memset(header, 0, kHeaderBytes);
+        std::memcpy(header, kMagic, sizeof(kMagic));
+        put_u16_le(header + 4, tileWidth > 0 ? kVersionTiled : kVersionRowMajor);
+        put_u16_le(header + 6, static_cast<std::uint16_t>(format));
+        put_u32_le(header + 8, static_cast<std::uint32_t>(width));
+        put_u32_le(header + 12, static_cast<std::uint32_t>(height));
+        put_u64_le(header + 16, kHeaderBytes);
+        if (tileWidth > 0) {
+            put_u32_le(header + 24, static_cast<std::uint32_t>(tileWidth));
+            put_u32_le(header + 28, static_cast<std::uint32_t>(tileHeight));
+        }
+    }
+
+    // count samples of `format` at src to float
+    static void decode_samples(RawFormat format, const void* src, float* dst, std::size_t count) {
+        switch (format) {
+        case RawFormat::Float32:
+            std::memcpy(dst, src, count * sizeof(float));
+            break;
+        case RawFormat::Float16:
+            halves_to_floats(static_cast<const std::uint16_t*>(src), dst, count);
+            break;
+        case RawFormat::UNorm16: {
+            const auto* words = static_cast<const std::uint16_t*>(src);
+            for (std::size_t x = 0; x < count; ++x) dst[x] = static_cast<float>(words[x]) / 65535.0f;
+            break;
+        }
+        }
+    }
+
+    // count floats at src to samples of `format`
+    static void encode_samples(RawFormat format, const float* src, void* dst, std::size_t count) {
+        switch (format) {
+        case RawFormat::Float32:
+            std::memcpy(dst, src, count * sizeof(float));
+            break;
+        case RawFormat::Float16:
+            floats_to_halves(src, static_cast<std::uint16_t*>(dst), count);
+            break;
+        case RawFormat::UNorm16:
+            quantize_unorm16(src, static_cast<std::uint16_t*>(dst), count);
+            break;
+        }
+    }
+
+    // ---------------------------------------------------------
+    // MappedRawMap
+    // ---------------------------------------------------------
+    MappedRawMap::~MappedRawMap() { close(); }
+
+    MappedRawMap::MappedRawMap(MappedRawMap&& other) noexcept { *this = std::move(other); }
+
+    MappedRawMap& MappedRawMap::operator=(MappedRawMap&& other) noexcept {
+        if (this != &other) {
+            close();
+            base_ = other.base_;
+            bytes_ = other.bytes_;
+            dataOffset_ = other.dataOffset_;
+            width_ = other.width_;
+            height_ = other.height_;
+            tileWidth_ = other.tileWidth_;
+            tileHeight_ = other.tileHeight_;
+            tiled_ = other.tiled_;
+            format_ = other.format_;
+            writable_ = other.writable_;
+            path_ = std::move(other.path_);
+            other.base_ = nullptr;
+            other.bytes_ = 0;
+            other.width_ = other.height_ = 0;
+            other.tileWidth_ = other.tileHeight_ = 0;
+        }
+        return *this;
+    }
+
+    void MappedRawMap::close() noexcept {
+        if (base_) unmap_file(base_, bytes_);
+        base_ = nullptr;
+        bytes_ = 0;
+        width_ = height_ = 0;
+        tileWidth_ = tileHeight_ = 0;
+    }
+
+    MappedRawMap MappedRawMap::open(const std::filesystem::path& file, bool writable) {
+        MappedRawMap map;
+        map.base_ = map_file(file, map.bytes_, false, writable);
+        map.writable_ = writable;
+        map.path_ = file;
+
+        const auto* header = static_cast<const std::uint8_t*>(map.base_);
+        auto invalid = [&](const std::string& why) {
+            return std::runtime_error("Not a valid map file (" + why + "): " + file.string());
+        };
+        if (map.bytes_ < kHeaderBytes || std::memcmp(header, kMagic, sizeof(kMagic)) != 0) throw invalid("bad magic");
+        const std::uint16_t version = get_u16_le(header + 4);
+        if (version != kVersionRowMajor && version != kVersionTiled) throw invalid("unsupported version " + std::to_string(version));
+        const std::uint16_t format = get_u16_le(header + 6);
+        if (format < 1 || format > 3) throw invalid("unknown sample format " + std::to_string(format));
+        map.format_ = static_cast<RawFormat>(format);
+        const std::uint32_t width = get_u32_le(header + 8);
+        const std::uint32_t height = get_u32_le(header + 12);
+        const std::uint64_t offset = get_u64_le(header + 16);
+        if (width == 0 || height == 0 || width > 0x7FFFFFFFu || height > 0x7FFFFFFFu) throw invalid("bad dimensions");
+        const bool tiled = version == kVersionTiled;
+        const std::uint32_t tileWidth = tiled ? get_u32_le(header + 24) : width;
+        const std::uint32_t tileHeight = tiled ? get_u32_le(header + 28) : height;
+        if (tileWidth == 0 || tileHeight == 0 || tileWidth > width || tileHeight > height) throw invalid("bad tile size");
+        const std::uint64_t tiles = static_cast<std::uint64_t>((width + tileWidth - 1) / tileWidth) * ((height + tileHeight - 1) / tileHeight);
+        const std::uint64_t sampleBytes = raw_sample_bytes(map.format_);
+        if (offset < kHeaderBytes || offset % sampleBytes != 0 || offset > map.bytes_) throw invalid("truncated");
+        // tiles * tileWidth * tileHeight * sampleBytes can wrap for a crafted header:
+        // divide the bytes after the offset by each factor instead of multiplying
+        if (tiles > (map.bytes_ - offset) / sampleBytes / tileHeight / tileWidth) throw invalid("truncated");
+        map.width_ = static_cast<int>(width);
+        map.height_ = static_cast<int>(height);
+        map.tileWidth_ = static_cast<int>(tileWidth);
+        map.tileHeight_ = static_cast<int>(tileHeight);
+        map.tiled_ = tiled;
+        map.dataOffset_ = static_cast<std::size_t>(offset);
+        return map;
+    }
+
+    MappedRawMap MappedRawMap::create(const std::filesystem::path& file, int width, int height, RawFormat format) {
+        if (width <= 0 || height <= 0)
+            throw std::invalid_argument("width/height must be > 0, got: " + std::to_string(width) + "x" + std::to_string(height));
+
+        MappedRawMap map;
+        map.bytes_ = kHeaderBytes + static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * raw_sample_bytes(format);
+        map.base_ = map_file(file, map.bytes_, true, true);
+        map.writable_ = true;
+        map.path_ = file;
+        map.width_ = width;
+        map.height_ = height;
+        map.tileWidth_ = width;
+        map.tileHeight_ = height;
+        map.format_ = format;
+        map.dataOffset_ = kHeaderBytes;
+
+        write_header(static_cast<std::uint8_t*>(map.base_), format, width, height, 0, 0); // the payload is already zero
+        return map;
+    }
+
+    void* MappedRawMap::samples() {
+        if (base_ && !writable_) throw std::logic_error("MappedRawMap: file is mapped read-only: " + path_.string());
+        return base_ ? static_cast<std::uint8_t*>(base_) + dataOffset_ : nullptr;
+    }
+
+    float* MappedRawMap::data_f32() {
+        if (tiled_) throw std::logic_error("MappedRawMap: file is tiled: " + path_.string());
+        if (format_ != RawFormat::Float32) throw std::logic_error("MappedRawMap: samples are not float32: " + path_.string());
+        return static_cast<float*>(samples());
+    }
+
+    const float* MappedRawMap::data_f32() const {
+        if (tiled_) throw std::logic_error("MappedRawMap: file is tiled: " + path_.string());
+        if (format_ != RawFormat::Float32) throw std::logic_error("MappedRawMap: samples are not float32: " + path_.string());
+        return static_cast<const float*>(samples());
+    }
+
+    std::uint16_t* MappedRawMap::data_u16() {
+        if (tiled_) throw std::logic_error("MappedRawMap: file is tiled: " + path_.string());
+        if (format_ == RawFormat::Float32) throw std::logic_error("MappedRawMap: samples are not 16-bit: " + path_.string());
+        return static_cast<std::uint16_t*>(samples());
+    }
+
+    const std::uint16_t* MappedRawMap::data_u16() const {
+        if (tiled_) throw std::logic_error("MappedRawMap: file is tiled: " + path_.string());
+        if (format_ == RawFormat::Float32) throw std::logic_error("MappedRawMap: samples are not 16-bit: " + path_.string());
+        return static_cast<const std::uint16_t*>(samples());
+    }
+
+    // Row-major files are a single tile, so one formula covers both layouts
+    const std::uint8_t* MappedRawMap::sample_address(int x, int y) const noexcept {
+        const std::size_t tile = static_cast<std::size_t>(y / tileHeight_) * static_cast<std::size_t>(tiles_x()) +
+            static_cast<std::size_t>(x / tileWidth_);
+        const std::size_t inTile = static_cast<std::size_t>(y % tileHeight_) * static_cast<std::size_t>(tileWidth_) +
+            static_cast<std::size_t>(x % tileWidth_);
+        const std::size_t tileSamples = static_cast<std::size_t>(tileWidth_) * static_cast<std::size_t>(tileHeight_);
+        return static_cast<const std::uint8_t*>(samples()) + (tile * tileSamples + inTile) * raw_sample_bytes(format_);
+    }
+
+    const void* MappedRawMap::tile_samples(int tileX, int tileY) const {
+        if (tileX < 0 || tileY < 0 || tileX >= tiles_x() || tileY >= tiles_y())
+            throw std::out_of_range("MappedRawMap: tile (" + std::to_string(tileX) + ", " + std::to_string(tileY) +
+                ") outside the " + std::to_string(tiles_x()) + "x" + std::to_string(tiles_y()) + " grid");
+        return sample_address(tileX * tileWidth_, tileY * tileHeight_);
+    }
+
+    float MappedRawMap::sample(int x, int y) const {
+        float value = 0.0f;
+        decode_samples(format_, sample_address(x, y), &value, 1);
+        return value;
+    }
+
+    NoiseMap MappedRawMap::to_noisemap() const {
+        if (empty()) return NoiseMap();
+        return read_region(0, 0, width_, height_);
+    }
+
+    NoiseMap MappedRawMap::read_region(int x, int y, int width, int height) const {
+        if (width <= 0 || height <= 0)
+            throw std::invalid_argument("width/height must be > 0, got: " + std::to_string(width) + "x" + std::to_string(height));
+        if (x < 0 || y < 0 || x > width_ - width || y > height_ - height)
+            throw std::out_of_range("MappedRawMap: region (" + std::to_string(x) + ", " + std::to_string(y) + ") " +
+                std::to_string(width) + "x" + std::to_string(height) + " outside the " +
+                std::to_string(width_) + "x" + std::to_string(height_) + " map");
+        NoiseMap out(width, height);
+        parallel_for_tiles(1, height, 1, kConvertRows, 0, [&](const Tile& t) {
+            for (int r = t.y; r < t.y + t.height; ++r) {
+                float* dst = out.row(r).data();
+                // one run per tile the row crosses
+                for (int sx = x; sx < x + width;) {
+                    const int n = std::min(x + width, (sx / tileWidth_ + 1) * tileWidth_) - sx;
+                    decode_samples(format_, sample_address(sx, y + r), dst + (sx - x), static_cast<std::size_t>(n));
+                    sx += n;
+                }
+            }
+        });
+        return out;
+    }
+
+    void MappedRawMap::flush() {
+        if (base_ && writable_ && !flush_file(base_, bytes_))
+            throw std::runtime_error("Failed to flush map file: " + path_.string());
+    }
+
+    // ---------------------------------------------------------
+    // Convenience
+    // ---------------------------------------------------------
+    void save_raw_map(const NoiseMap& map, const std::filesystem::path& file, RawFormat format) {
+        if (map.empty()) throw std::invalid_argument("Cannot save empty noise map.");
+        const StageTimer timer(StatsStage::Encode, "raw",
+            static_cast<std::uint64_t>(map.width()) * static_cast<std::uint64_t>(map.height()), 0);
+        MappedRawMap out = MappedRawMap::create(file, map.width(), map.height(), format);
+        const std::size_t w = out.stride();
+        const std::size_t rowBytes = w * raw_sample_bytes(format);
+        auto* samples = static_cast<std::uint8_t*>(out.samples());
+        parallel_for_tiles(1, map.height(), 1, kConvertRows, 0, [&](const Tile& t) {
+            for (int y = t.y; y < t.y + t.height; ++y)
+                encode_samples(format, map.row(y).data(), samples + static_cast<std::size_t>(y) * rowBytes, w);
+        });
+    }
+
+    void write_tiled_raw_map(const std::filesystem::path& file, int width, int height, const RawTileFn& fill,
+        const RawTileOptions& rawOptions, const GenerateOptions& options) {
+        if (width <= 0 || height <= 0)
+            throw std::invalid_argument("width/height must be > 0, got: " + std::to_string(width) + "x" + std::to_string(height));
+        if (rawOptions.tileWidth <= 0 || rawOptions.tileHeight <= 0)
+            throw std::invalid_argument("tile size must be > 0, got: " + std::to_string(rawOptions.tileWidth) + "x" +
+                std::to_string(rawOptions.tileHeight));
+        if (!fill) throw std::invalid_argument("fill must not be empty");
+
+        // tiles larger than the map are clipped to it
+        const int tileWidth = std::min(rawOptions.tileWidth, width);
+        const int tileHeight = std::min(rawOptions.tileHeight, height);
+        const int tilesX = (width + tileWidth - 1) / tileWidth;
+        const int tilesY = (height + tileHeight - 1) / tileHeight;
+        const std::size_t sampleBytes = raw_sample_bytes(rawOptions.format);
+        const std::size_t tileSamples = static_cast<std::size_t>(tileWidth) * static_cast<std::size_t>(tileHeight);
+        const std::uint64_t bytes = kHeaderBytes + static_cast<std::uint64_t>(tilesX) * static_cast<std::uint64_t>(tilesY) *
+            tileSamples * sampleBytes;
+
+        const std::uint64_t pixels = static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height);
+        const StageTimer timer(StatsStage::Encode, "raw", pixels, options.threads, options.pool);
+        PositionalFile out(file, bytes);
+        try {
+            std::uint8_t header[kHeaderBytes];
+            write_header(header, rawOptions.format, width, height, tileWidth, tileHeight);
+            out.write_at(0, header, kHeaderBytes);
+
+            parallel_for_tiles(width, height, tileWidth, tileHeight, options.threads, options.pool, [&](const Tile& tile) {
+                // zeroed, so the padding of edge tiles is written as zeros
+                NoiseMap pixels(tileWidth, tileHeight);
+                std::vector<std::uint8_t> encoded(tileSamples * sampleBytes);
+                fill(pixels.data(), pixels.stride(), tile);
+                for (int r = 0; r < tileHeight; ++r)
+                    encode_samples(rawOptions.format, pixels.row(r).data(),
+                        encoded.data() + static_cast<std::size_t>(r) * tileWidth * sampleBytes, static_cast<std::size_t>(tileWidth));
+                const std::uint64_t index = static_cast<std::uint64_t>(tile.y / tileHeight) * tilesX + tile.x / tileWidth;
+                out.write_at(kHeaderBytes + index * tileSamples * sampleBytes, encoded.data(), encoded.size());
+            });
+        }
+        catch (...) {
+            out.close();
+            std::error_code ec;
+            std::filesystem::remove(file, ec);
+            throw;
+        }
+    }
+
+    NoiseMap load_raw_map(const std::filesystem::path& file) {
+        return MappedRawMap::open(file).to_noisemap();
+    }
+
+    std::filesystem::path resolve_raw_path(const std::string& filename, const std::string& outputDir) {
+        std::filesystem::path file = resolve_image_path(filename, outputDir);
+        std::string extension = file.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".exr") file.replace_extension(".rnm");
+        return file;
+    }
+
+} // namespace Noise
@@ -7,17 +7,46 @@
 //  auto map = Noise::create_perlinnoise(256, 256, 40.0f, 5, 1.0f, 0.5f, 2.0f, 0.0f, 42, "image", "perlin_noise.png");
 
 #pragma once
+#include <array>
 #include <vector>
 #include <string>
+#include <cstddef>
+#include <cstdint>
+#include "NoiseMap.hpp"
+#include "GenerateOptions.hpp"
+#include "ChunkCache.hpp"
+#include "FractalNoise.hpp"
+#include "ImageOutput.hpp"
+#include "RawMap.hpp"
 
 namespace Noise {
 
     // Forward declare OutputMode (from Noise.hpp)
     enum class OutputMode;
 
+    // Lattice columns (or rows) of one periodic axis, precomputed so the periodic
+    // kernels never take a modulo: entry k is the permutation index of lattice
+    // cell (k + shift) mod period. Covers window coordinates in [0, extent].
+    class PerlinWrapTable {
+    public:
+        PerlinWrapTable(int period, std::int64_t shift, int extent);
+
+        int period() const { return period_; }
+        int extent() const { return extent_; }
+        const std::int32_t* data() const { return cells_.data(); }
+
+    private:
+        int period_;
+        int extent_;
+        std::vector<std::int32_t> cells_;
+    };
+
     class PerlinNoise {
     private:
-        std::vector<int> p; // permutation table
+        // Permutation table stored inline: 256 shuffled bytes repeated twice, so
+        // p[p[X] + Y + 1] never needs a wrap. The 4 trailing bytes let 32-bit
+        // gathers read the last entry without going past the array.
+        alignas(64) std::array<std::uint8_t, 512 + 4> p{};
 
     public:
         explicit PerlinNoise(int seed = -1);
@@ -26,8 +55,91 @@ namespace Noise {
         static float grad(int hash, float x, float y);
         // Core 2D Perlin noise function: returns [0,1]
         float noise(float x, float y) const;
+
+        // The 512-entry permutation table (256 shuffled bytes repeated twice), e.g.
+        // for uploading to a device
+        const std::uint8_t* permutation() const { return p.data(); }
+
+        // Batched noise(): out[i] = noise(x[i], y[i]) for i < count, bit-for-bit identical
+        // to the scalar path. Runs 16 / 8 / 4 lanes at a time with AVX-512 / AVX2 / NEON
+        // when the CPU supports them (detected at runtime), scalar otherwise.
+        void noise_batch(const float* x, const float* y, float* out, std::size_t count) const;
+
+        // Fixed-width convenience wrapper for 8 samples
+        void noise8(const float x[8], const float y[8], float out[8]) const;
+
+        // noise() on a lattice that repeats every periodX x periodY cells (periods
+        // >= 1), so noise_periodic(x + periodX, y, ...) == noise_periodic(x, y, ...).
+        // Periods of 256 give noise() itself.
+        float noise_periodic(float x, float y, int periodX, int periodY) const;
+
+        // Batched periodic noise over a window: out[i] = noise_periodic(x[i] + shiftX,
+        // y[i] + shiftY, periodX, periodY) with the tables' shifts and periods, up to
+        // the rounding of that sum. x[i] / y[i] must lie in [0, extent] of their table.
+        void noise_periodic_batch(const PerlinWrapTable& wrapX, const PerlinWrapTable& wrapY,
+            const float* x, const float* y, float* out, std::size_t count) const;
     };
 
+    // FractalNoise<PerlinNoise, N>: noise() is already in [0, 1], so the octave sum
+    // is only divided by the total amplitude
+    template <>
+    struct FractalTraits<PerlinNoise> {
+        static void noise_batch(const PerlinNoise& noise, const float* x, const float* y, float* out, std::size_t count) {
+            noise.noise_batch(x, y, out, count);
+        }
+        static float normalize(float sum, float maxAmplitude) { return sum / maxAmplitude; }
+    };
+
+    // Multi-octave generator writing into a caller-provided buffer: row y starts at
+    // dst + y * stride (stride in floats, >= width). The buffer is not reallocated, so
+    // it can be regenerated repeatedly. Work is split into tiles across
+    // options.threads workers; the output is identical for any thread count.
+    void generate_perlin_into(
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed = -1,
+        const GenerateOptions& options = {}
+    );
+
+    // Same as above with a prebuilt generator (skips rebuilding the permutation table)
+    void generate_perlin_into(
+        const PerlinNoise& generator,
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        const GenerateOptions& options = {}
+    );
+
+    // Multi-octave map generator (contiguous, 64-byte aligned result)
+    NoiseMap generate_perlin_noisemap(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed = -1,
+        const GenerateOptions& options = {}
+    );
+
+    // Same as generate_perlin_noisemap, copied into a nested vector
     std::vector<std::vector<float>> generate_perlin_map(
         int width,
         int height,
@@ -40,11 +152,149 @@ namespace Noise {
         int seed = -1
     );
 
-    // Save to grayscale PNG or JPEG (auto-detected from extension)
-    // If outputDir is empty, uses default ImageOutput/ directory
+    // Seamlessly tiling multi-octave map: the output repeats exactly at width x
+    // height, with no extra area generated. Octave o uses a lattice period of
+    // round(width / scale * frequency * lacunarity^o) x round(height / scale * ...)
+    // cells (at least 1), so features keep the size of generate_perlin_into to
+    // within that rounding; values differ from it. Throws std::invalid_argument for
+    // the same arguments as generate_perlin_into, or when a period exceeds 2^24.
+    void generate_perlin_tileable_into(
+        const PerlinNoise& generator,
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        const GenerateOptions& options = {}
+    );
+
+    NoiseMap generate_perlin_tileable_noisemap(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed = -1,
+        const GenerateOptions& options = {}
+    );
+
+    // Fractal settings for the region / chunk API (same meaning as the arguments of
+    // generate_perlin_noisemap)
+    struct PerlinParams {
+        float scale = 40.0f;
+        int octaves = 5;
+        float frequency = 1.0f;
+        float persistence = 0.5f;
+        float lacunarity = 2.0f;
+        float base = 0.0f;
+    };
+
+    // Generates the width x height window of the infinite noise plane whose top-left
+    // pixel is world pixel (originX, originY). Values depend only on the world pixel,
+    // so windows sharing pixels agree exactly and neighbouring windows join without
+    // seams. Origin (0, 0) reproduces generate_perlin_into.
+    void generate_perlin_region_into(
+        const PerlinNoise& generator,
+        const PerlinParams& params,
+        float* dst,
+        std::size_t stride,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const GenerateOptions& options = {}
+    );
+
+    NoiseMap generate_perlin_region(
+        const PerlinNoise& generator,
+        const PerlinParams& params,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const GenerateOptions& options = {}
+    );
+
+    // Square chunk (chunkX, chunkY) of a chunkSize grid over the world, i.e. the
+    // region at (chunkX * chunkSize, chunkY * chunkSize). Safe to call concurrently
+    // with one shared generator.
+    NoiseMap generate_perlin_chunk(
+        const PerlinNoise& generator,
+        const PerlinParams& params,
+        std::int64_t chunkX,
+        std::int64_t chunkY,
+        int chunkSize,
+        const GenerateOptions& options = {}
+    );
+
+    // Cache key of generate_perlin_chunk for PerlinNoise(seed) and `params`
+    ChunkKey perlin_chunk_key(int seed, const PerlinParams& params, std::int64_t chunkX, std::int64_t chunkY, int chunkSize);
+
+    // generate_perlin_chunk through `cache`: a hit returns the cached map without
+    // copying; a miss builds PerlinNoise(seed), generates and caches the chunk.
+    // seed must be >= 0 (random seeds are not reproducible, so not cacheable).
+    ChunkCache::MapPtr generate_perlin_chunk_cached(
+        ChunkCache& cache,
+        int seed,
+        const PerlinParams& params,
+        std::int64_t chunkX,
+        std::int64_t chunkY,
+        int chunkSize,
+        const GenerateOptions& options = {}
+    );
+
+    // Save to grayscale PNG, JPEG or half-float EXR (auto-detected from extension);
+    // PNG / JPEG values are clamped to [0, 1]. If outputDir is empty, uses default ImageOutput/ directory
+    void save_perlin_image(const NoiseMap& noise,
+        const std::string& filename = "perlin_noise.png",
+        const std::string& outputDir = "",
+        const ImageSaveOptions& imageOptions = {});
+
     void save_perlin_image(const std::vector<std::vector<float>>& noise,
         const std::string& filename = "perlin_noise.png",
-        const std::string& outputDir = "");
+        const std::string& outputDir = "",
+        const ImageSaveOptions& imageOptions = {});
+
+    // Generates a region band by band straight into a PNG: band k+1 is generated while
+    // band k is compressed and written, so huge exports never hold the whole map.
+    // The pixels equal save_perlin_image(generate_perlin_region(...)).
+    void save_perlin_region_image(
+        const PerlinNoise& generator,
+        const PerlinParams& params,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const std::string& filename = "perlin_noise.png",
+        const std::string& outputDir = "",
+        const GenerateOptions& options = {},
+        const ImageSaveOptions& imageOptions = {}
+    );
+
+    // Generates a region tile by tile into a tiled .rnm file (see write_tiled_raw_map):
+    // peak memory is one tile per worker, so the map may be far larger than RAM.
+    // Tiles run on options.threads workers of options.pool, each tile on one
+    // thread; the pixels equal generate_perlin_region(...).
+    void save_perlin_tiled_raw(
+        const PerlinNoise& generator,
+        const PerlinParams& params,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const std::string& filename = "perlin_noise.rnm",
+        const std::string& outputDir = "",
+        const RawTileOptions& rawOptions = {},
+        const GenerateOptions& options = {}
+    );
 
     /* Entry wrapper 
         - int width, height: output resolution
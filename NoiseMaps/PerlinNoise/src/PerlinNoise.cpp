@@ -1,11 +1,21 @@
 #include "Noise.hpp"  // full OutputMode definition
 #include "PerlinNoise.hpp"
 #include <random>
+#include <cstdint>
 #include <cmath>
 #include <iostream>
 #include <algorithm> // for std::shuffle
 #include <filesystem>
-#include "stb_image_write.h"
+#include "CpuFeatures.hpp"
+#include "NoiseStats.hpp"
+#include "TileScheduler.hpp"
+#include "RawMap.hpp"
+
+#if defined(RELNO_ARCH_X86)
+#include <immintrin.h>
+#elif defined(RELNO_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
 
 namespace Noise {
 
@@ -13,22 +23,21 @@ namespace Noise {
     // Constructor: initializes permutation table
     // ---------------------------------------------------------
     PerlinNoise::PerlinNoise(int seed) {
-        p.resize(256);
         for (int i = 0; i < 256; ++i)
-            p[i] = i;
+            p[i] = static_cast<std::uint8_t>(i);
 
         if (seed >= 0) {
             std::mt19937 rng(seed);
-            std::shuffle(p.begin(), p.end(), rng);
+            std::shuffle(p.begin(), p.begin() + 256, rng);
         }
         else {
             std::random_device rd;
             std::mt19937 rng(rd());
-            std::shuffle(p.begin(), p.end(), rng);
+            std::shuffle(p.begin(), p.begin() + 256, rng);
         }
 
         // duplicate for overflow safety
-        p.insert(p.end(), p.begin(), p.end());
+        std::copy(p.begin(), p.begin() + 256, p.begin() + 256);
     }
 
     // ---------------------------------------------------------
@@ -73,20 +82,433 @@ namespace Noise {
     }
 
     // ---------------------------------------------------------
-    // Multi-octave map generator
+    // Batched noise kernels
     // ---------------------------------------------------------
-    std::vector<std::vector<float>> generate_perlin_map(
+    // Every kernel performs exactly the scalar noise() operation sequence per lane
+    // (same floor / fade / grad / lerp order, no FMA contraction), so results are
+    // bit-for-bit identical to noise(). Permutation lookups use hardware gathers on
+    // x86 and lane-wise loads on NEON; grad() becomes a blend plus sign-bit flips.
+    using PerlinBatchKernel = void (*)(const std::uint8_t* perm, const float* xs, const float* ys, float* out, std::size_t count);
+
+#if defined(RELNO_ARCH_X86)
+    RELNO_TARGET_AVX2
+    static inline __m256 perlin_fade_avx2(__m256 t) {
+        // t * t * t * (t * (t * 6 - 15) + 10)
+        __m256 t3 = _mm256_mul_ps(_mm256_mul_ps(t, t), t);
+        __m256 inner = _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f));
+        inner = _mm256_add_ps(_mm256_mul_ps(t, inner), _mm256_set1_ps(10.0f));
+        return _mm256_mul_ps(t3, inner);
+    }
+
+    RELNO_TARGET_AVX2
+    static inline __m256 perlin_lerp_avx2(__m256 a, __m256 b, __m256 t) {
+        return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+    }
+
+    RELNO_TARGET_AVX2
+    static inline __m256 perlin_grad_avx2(__m256i hash, __m256 x, __m256 y) {
+        const __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(3));
+        // h < 2  <=>  (h & 2) == 0
+        const __m256 useX = _mm256_castsi256_ps(
+            _mm256_cmpeq_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+        __m256 u = _mm256_blendv_ps(y, x, useX);
+        __m256 v = _mm256_blendv_ps(x, y, useX);
+        // negate by flipping the sign bit: bit 0 of h -> u, bit 1 of h -> v
+        u = _mm256_xor_ps(u, _mm256_castsi256_ps(_mm256_slli_epi32(h, 31)));
+        v = _mm256_xor_ps(v, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_srli_epi32(h, 1), 31)));
+        return _mm256_add_ps(u, v);
+    }
+
+    // perm[idx] for 8 lanes: a 32-bit gather at byte offset idx, low byte kept
+    RELNO_TARGET_AVX2
+    static inline __m256i perlin_lookup_avx2(const std::uint8_t* perm, __m256i idx) {
+        return _mm256_and_si256(_mm256_i32gather_epi32(reinterpret_cast<const int*>(perm), idx, 1), _mm256_set1_epi32(255));
+    }
+
+    RELNO_TARGET_AVX2
+    static void perlin_noise_avx2(const std::uint8_t* perm, const float* xs, const float* ys, float* out, std::size_t count) {
+        const __m256i mask255 = _mm256_set1_epi32(255);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256 onef = _mm256_set1_ps(1.0f);
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m256 x = _mm256_loadu_ps(xs + i);
+            const __m256 y = _mm256_loadu_ps(ys + i);
+            const __m256 fx = _mm256_floor_ps(x);
+            const __m256 fy = _mm256_floor_ps(y);
+            const __m256i X = _mm256_and_si256(_mm256_cvttps_epi32(fx), mask255);
+            const __m256i Y = _mm256_and_si256(_mm256_cvttps_epi32(fy), mask255);
+
+            const __m256 xf = _mm256_sub_ps(x, fx);
+            const __m256 yf = _mm256_sub_ps(y, fy);
+            const __m256 u = perlin_fade_avx2(xf);
+            const __m256 v = perlin_fade_avx2(yf);
+
+            const __m256i pX = perlin_lookup_avx2(perm, X);
+            const __m256i pX1 = perlin_lookup_avx2(perm, _mm256_add_epi32(X, one));
+            const __m256i aIdx = _mm256_add_epi32(pX, Y);
+            const __m256i bIdx = _mm256_add_epi32(pX1, Y);
+            // grad() only reads the low 2 bits of the hash: the upper gathered bytes can stay
+            const __m256i aa = _mm256_i32gather_epi32(reinterpret_cast<const int*>(perm), aIdx, 1);
+            const __m256i ab = _mm256_i32gather_epi32(reinterpret_cast<const int*>(perm), _mm256_add_epi32(aIdx, one), 1);
+            const __m256i ba = _mm256_i32gather_epi32(reinterpret_cast<const int*>(perm), bIdx, 1);
+            const __m256i bb = _mm256_i32gather_epi32(reinterpret_cast<const int*>(perm), _mm256_add_epi32(bIdx, one), 1);
+
+            const __m256 xf1 = _mm256_sub_ps(xf, onef);
+            const __m256 yf1 = _mm256_sub_ps(yf, onef);
+            const __m256 x1 = perlin_lerp_avx2(perlin_grad_avx2(aa, xf, yf), perlin_grad_avx2(ba, xf1, yf), u);
+            const __m256 x2 = perlin_lerp_avx2(perlin_grad_avx2(ab, xf, yf1), perlin_grad_avx2(bb, xf1, yf1), u);
+            // * 0.5f is exact and identical to the scalar / 2.0f
+            const __m256 r = _mm256_mul_ps(_mm256_add_ps(perlin_lerp_avx2(x1, x2, v), onef), _mm256_set1_ps(0.5f));
+            _mm256_storeu_ps(out + i, r);
+        }
+    }
+
+    RELNO_TARGET_AVX512
+    static inline __m512 perlin_fade_avx512(__m512 t) {
+        __m512 t3 = _mm512_mul_ps(_mm512_mul_ps(t, t), t);
+        __m512 inner = _mm512_sub_ps(_mm512_mul_ps(t, _mm512_set1_ps(6.0f)), _mm512_set1_ps(15.0f));
+        inner = _mm512_add_ps(_mm512_mul_ps(t, inner), _mm512_set1_ps(10.0f));
+        return _mm512_mul_ps(t3, inner);
+    }
+
+    RELNO_TARGET_AVX512
+    static inline __m512 perlin_lerp_avx512(__m512 a, __m512 b, __m512 t) {
+        return _mm512_add_ps(a, _mm512_mul_ps(t, _mm512_sub_ps(b, a)));
+    }
+
+    RELNO_TARGET_AVX512
+    static inline __m512 perlin_grad_avx512(__m512i hash, __m512 x, __m512 y) {
+        const __m512i h = _mm512_and_si512(hash, _mm512_set1_epi32(3));
+        const __mmask16 useX = _mm512_testn_epi32_mask(h, _mm512_set1_epi32(2));
+        __m512i u = _mm512_castps_si512(_mm512_mask_blend_ps(useX, y, x));
+        __m512i v = _mm512_castps_si512(_mm512_mask_blend_ps(useX, x, y));
+        u = _mm512_xor_si512(u, _mm512_slli_epi32(h, 31));
+        v = _mm512_xor_si512(v, _mm512_slli_epi32(_mm512_srli_epi32(h, 1), 31));
+        return _mm512_add_ps(_mm512_castsi512_ps(u), _mm512_castsi512_ps(v));
+    }
+
+    RELNO_TARGET_AVX512
+    static inline __m512i perlin_lookup_avx512(const std::uint8_t* perm, __m512i idx) {
+        return _mm512_and_si512(_mm512_i32gather_epi32(idx, perm, 1), _mm512_set1_epi32(255));
+    }
+
+    RELNO_TARGET_AVX512
+    static void perlin_noise_avx512(const std::uint8_t* perm, const float* xs, const float* ys, float* out, std::size_t count) {
+        const __m512i mask255 = _mm512_set1_epi32(255);
+        const __m512i one = _mm512_set1_epi32(1);
+        const __m512 onef = _mm512_set1_ps(1.0f);
+
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            const __m512 x = _mm512_loadu_ps(xs + i);
+            const __m512 y = _mm512_loadu_ps(ys + i);
+            const __m512 fx = _mm512_roundscale_ps(x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+            const __m512 fy = _mm512_roundscale_ps(y, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+            const __m512i X = _mm512_and_si512(_mm512_cvttps_epi32(fx), mask255);
+            const __m512i Y = _mm512_and_si512(_mm512_cvttps_epi32(fy), mask255);
+
+            const __m512 xf = _mm512_sub_ps(x, fx);
+            const __m512 yf = _mm512_sub_ps(y, fy);
+            const __m512 u = perlin_fade_avx512(xf);
+            const __m512 v = perlin_fade_avx512(yf);
+
+            const __m512i pX = perlin_lookup_avx512(perm, X);
+            const __m512i pX1 = perlin_lookup_avx512(perm, _mm512_add_epi32(X, one));
+            const __m512i aIdx = _mm512_add_epi32(pX, Y);
+            const __m512i bIdx = _mm512_add_epi32(pX1, Y);
+            const __m512i aa = _mm512_i32gather_epi32(aIdx, perm, 1);
+            const __m512i ab = _mm512_i32gather_epi32(_mm512_add_epi32(aIdx, one), perm, 1);
+            const __m512i ba = _mm512_i32gather_epi32(bIdx, perm, 1);
+            const __m512i bb = _mm512_i32gather_epi32(_mm512_add_epi32(bIdx, one), perm, 1);
+
+            const __m512 xf1 = _mm512_sub_ps(xf, onef);
+            const __m512 yf1 = _mm512_sub_ps(yf, onef);
+            const __m512 x1 = perlin_lerp_avx512(perlin_grad_avx512(aa, xf, yf), perlin_grad_avx512(ba, xf1, yf), u);
+            const __m512 x2 = perlin_lerp_avx512(perlin_grad_avx512(ab, xf, yf1), perlin_grad_avx512(bb, xf1, yf1), u);
+            const __m512 r = _mm512_mul_ps(_mm512_add_ps(perlin_lerp_avx512(x1, x2, v), onef), _mm512_set1_ps(0.5f));
+            _mm512_storeu_ps(out + i, r);
+        }
+        // remaining 8-wide block (AVX-512F implies AVX2)
+        perlin_noise_avx2(perm, xs + i, ys + i, out + i, count - i);
+    }
+#endif // RELNO_ARCH_X86
+
+#if defined(RELNO_ARCH_ARM64)
+    static inline float32x4_t perlin_fade_neon(float32x4_t t) {
+        float32x4_t t3 = vmulq_f32(vmulq_f32(t, t), t);
+        float32x4_t inner = vsubq_f32(vmulq_f32(t, vdupq_n_f32(6.0f)), vdupq_n_f32(15.0f));
+        inner = vaddq_f32(vmulq_f32(t, inner), vdupq_n_f32(10.0f));
+        return vmulq_f32(t3, inner);
+    }
+
+    static inline float32x4_t perlin_lerp_neon(float32x4_t a, float32x4_t b, float32x4_t t) {
+        return vaddq_f32(a, vmulq_f32(t, vsubq_f32(b, a)));
+    }
+
+    static inline float32x4_t perlin_grad_neon(int32x4_t hash, float32x4_t x, float32x4_t y) {
+        const uint32x4_t h = vandq_u32(vreinterpretq_u32_s32(hash), vdupq_n_u32(3));
+        const uint32x4_t useX = vceqq_u32(vandq_u32(h, vdupq_n_u32(2)), vdupq_n_u32(0));
+        uint32x4_t u = vreinterpretq_u32_f32(vbslq_f32(useX, x, y));
+        uint32x4_t v = vreinterpretq_u32_f32(vbslq_f32(useX, y, x));
+        u = veorq_u32(u, vshlq_n_u32(h, 31));
+        v = veorq_u32(v, vshlq_n_u32(vshrq_n_u32(h, 1), 31));
+        return vaddq_f32(vreinterpretq_f32_u32(u), vreinterpretq_f32_u32(v));
+    }
+
+    // NEON has no gather: look the four lanes up individually
+    static inline int32x4_t perlin_lookup_neon(const std::uint8_t* perm, int32x4_t idx) {
+        int32_t lanes[4];
+        vst1q_s32(lanes, idx);
+        const int32_t vals[4] = { perm[lanes[0]], perm[lanes[1]], perm[lanes[2]], perm[lanes[3]] };
+        return vld1q_s32(vals);
+    }
+
+    static void perlin_noise_neon(const std::uint8_t* perm, const float* xs, const float* ys, float* out, std::size_t count) {
+        const int32x4_t mask255 = vdupq_n_s32(255);
+        const int32x4_t one = vdupq_n_s32(1);
+        const float32x4_t onef = vdupq_n_f32(1.0f);
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const float32x4_t x = vld1q_f32(xs + i);
+            const float32x4_t y = vld1q_f32(ys + i);
+            const float32x4_t fx = vrndmq_f32(x);
+            const float32x4_t fy = vrndmq_f32(y);
+            const int32x4_t X = vandq_s32(vcvtq_s32_f32(fx), mask255);
+            const int32x4_t Y = vandq_s32(vcvtq_s32_f32(fy), mask255);
+
+            const float32x4_t xf = vsubq_f32(x, fx);
+            const float32x4_t yf = vsubq_f32(y, fy);
+            const float32x4_t u = perlin_fade_neon(xf);
+            const float32x4_t v = perlin_fade_neon(yf);
+
+            const int32x4_t aIdx = vaddq_s32(perlin_lookup_neon(perm, X), Y);
+            const int32x4_t bIdx = vaddq_s32(perlin_lookup_neon(perm, vaddq_s32(X, one)), Y);
+            const int32x4_t aa = perlin_lookup_neon(perm, aIdx);
+            const int32x4_t ab = perlin_lookup_neon(perm, vaddq_s32(aIdx, one));
+            const int32x4_t ba = perlin_lookup_neon(perm, bIdx);
+            const int32x4_t bb = perlin_lookup_neon(perm, vaddq_s32(bIdx, one));
+
+            const float32x4_t xf1 = vsubq_f32(xf, onef);
+            const float32x4_t yf1 = vsubq_f32(yf, onef);
+            const float32x4_t x1 = perlin_lerp_neon(perlin_grad_neon(aa, xf, yf), perlin_grad_neon(ba, xf1, yf), u);
+            const float32x4_t x2 = perlin_lerp_neon(perlin_grad_neon(ab, xf, yf1), perlin_grad_neon(bb, xf1, yf1), u);
+            vst1q_f32(out + i, vmulq_f32(vaddq_f32(perlin_lerp_neon(x1, x2, v), onef), vdupq_n_f32(0.5f)));
+        }
+    }
+#endif // RELNO_ARCH_ARM64
+
+    // No SSE2 variant (it has no floor and no gathers) and a null scalar slot: the
+    // SSE2 and scalar tiers run the scalar loop
+    static const KernelTable<PerlinBatchKernel> kPerlinKernels = [] {
+        KernelTable<PerlinBatchKernel> t;
+#if defined(RELNO_ARCH_X86)
+        t.avx2 = perlin_noise_avx2;
+        t.avx512 = perlin_noise_avx512;
+#elif defined(RELNO_ARCH_ARM64)
+        t.neon = perlin_noise_neon;
+#endif
+        return t;
+    }();
+
+    void PerlinNoise::noise_batch(const float* x, const float* y, float* out, std::size_t count) const {
+        const PerlinBatchKernel kernel = kPerlinKernels.get();
+
+        // Vector kernels process whole SIMD blocks; the scalar loop finishes the tail
+        std::size_t done = 0;
+        if (kernel) {
+            std::size_t blocks = count & ~static_cast<std::size_t>(7);
+            kernel(p.data(), x, y, out, blocks);
+            done = blocks;
+        }
+        for (std::size_t i = done; i < count; ++i)
+            out[i] = noise(x[i], y[i]);
+    }
+
+    void PerlinNoise::noise8(const float x[8], const float y[8], float out[8]) const {
+        noise_batch(x, y, out, 8);
+    }
+
+    // ---------------------------------------------------------
+    // Periodic (tileable) noise
+    // ---------------------------------------------------------
+    // noise() with the lattice columns X0 / X1 = X0 + 1 and rows Y0 / Y1 wrapped at
+    // the period instead of & 255. With the wrapped indices looked up from a
+    // PerlinWrapTable, the kernels do the same work as noise() plus two gathers.
+    static int positive_mod(std::int64_t v, int m) {
+        const int r = static_cast<int>(v % m);
+        return r < 0 ? r + m : r;
+    }
+
+    PerlinWrapTable::PerlinWrapTable(int period, std::int64_t shift, int extent) : period_(period), extent_(extent) {
+        if (period < 1)
+            throw std::invalid_argument("period must be >= 1, got: " + std::to_string(period));
+        if (extent < 0)
+            throw std::invalid_argument("extent must be >= 0, got: " + std::to_string(extent));
+        // cells k and k + 1 for every k <= extent, plus one for coordinates rounded up to extent + 1
+        cells_.resize(static_cast<std::size_t>(extent) + 3);
+        int cell = positive_mod(shift, period);
+        for (std::int32_t& c : cells_) {
+            c = cell & 255;
+            if (++cell == period) cell = 0;
+        }
+    }
+
+    static inline float perlin_periodic_cell(const std::uint8_t* perm, int X0, int X1, int Y0, int Y1, float xf, float yf) {
+        float u = PerlinNoise::fade(xf);
+        float v = PerlinNoise::fade(yf);
+
+        int aa = perm[perm[X0] + Y0];
+        int ab = perm[perm[X0] + Y1];
+        int ba = perm[perm[X1] + Y0];
+        int bb = perm[perm[X1] + Y1];
+
+        float x1 = PerlinNoise::lerp(PerlinNoise::grad(aa, xf, yf), PerlinNoise::grad(ba, xf - 1, yf), u);
+        float x2 = PerlinNoise::lerp(PerlinNoise::grad(ab, xf, yf - 1), PerlinNoise::grad(bb, xf - 1, yf - 1), u);
+        return (PerlinNoise::lerp(x1, x2, v) + 1.0f) / 2.0f;
+    }
+
+    float PerlinNoise::noise_periodic(float x, float y, int periodX, int periodY) const {
+        if (periodX < 1 || periodY < 1)
+            throw std::invalid_argument("periods must be >= 1, got: " + std::to_string(periodX) + "x" + std::to_string(periodY));
+        const float fx = std::floor(x);
+        const float fy = std::floor(y);
+        const std::int64_t xi = static_cast<std::int64_t>(fx);
+        const std::int64_t yi = static_cast<std::int64_t>(fy);
+        return perlin_periodic_cell(p.data(),
+            positive_mod(xi, periodX) & 255, positive_mod(xi + 1, periodX) & 255,
+            positive_mod(yi, periodY) & 255, positive_mod(yi + 1, periodY) & 255,
+            x - fx, y - fy);
+    }
+
+    using PerlinPeriodicKernel = void (*)(const std::uint8_t* perm, const std::int32_t* wrapX, const std::int32_t* wrapY,
+        const float* xs, const float* ys, float* out, std::size_t count);
+
+    static void perlin_periodic_scalar(const std::uint8_t* perm, const std::int32_t* wrapX, const std::int32_t* wrapY,
+        const float* xs, const float* ys, float* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const float fx = std::floor(xs[i]);
+            const float fy = std::floor(ys[i]);
+            const int kx = static_cast<int>(fx);
+            const int ky = static_cast<int>(fy);
+            out[i] = perlin_periodic_cell(perm, wrapX[kx], wrapX[kx + 1], wrapY[ky], wrapY[ky + 1], xs[i] - fx, ys[i] - fy);
+        }
+    }
+
+#if defined(RELNO_ARCH_X86)
+    RELNO_TARGET_AVX2
+    static void perlin_periodic_avx2(const std::uint8_t* perm, const std::int32_t* wrapX, const std::int32_t* wrapY,
+        const float* xs, const float* ys, float* out, std::size_t count) {
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256 onef = _mm256_set1_ps(1.0f);
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m256 x = _mm256_loadu_ps(xs + i);
+            const __m256 y = _mm256_loadu_ps(ys + i);
+            const __m256 fx = _mm256_floor_ps(x);
+            const __m256 fy = _mm256_floor_ps(y);
+            const __m256i kx = _mm256_cvttps_epi32(fx);
+            const __m256i ky = _mm256_cvttps_epi32(fy);
+            const __m256i X0 = _mm256_i32gather_epi32(wrapX, kx, 4);
+            const __m256i X1 = _mm256_i32gather_epi32(wrapX, _mm256_add_epi32(kx, one), 4);
+            const __m256i Y0 = _mm256_i32gather_epi32(wrapY, ky, 4);
+            const __m256i Y1 = _mm256_i32gather_epi32(wrapY, _mm256_add_epi32(ky, one), 4);
+
+            const __m256 xf = _mm256_sub_ps(x, fx);
+            const __m256 yf = _mm256_sub_ps(y, fy);
+            const __m256 u = perlin_fade_avx2(xf);
+            const __m256 v = perlin_fade_avx2(yf);
+
+            const __m256i pX0 = perlin_lookup_avx2(perm, X0);
+            const __m256i pX1 = perlin_lookup_avx2(perm, X1);
+            const __m256i aa = _mm256_i32gather_epi32(reinterpret_cast<const int*>(perm), _mm256_add_epi32(pX0, Y0), 1);
+            const __m256i ab = _mm256_i32gather_epi32(reinterpret_cast<const int*>(perm), _mm256_add_epi32(pX0, Y1), 1);
+            const __m256i ba = _mm256_i32gather_epi32(reinterpret_cast<const int*>(perm), _mm256_add_epi32(pX1, Y0), 1);
+            const __m256i bb = _mm256_i32gather_epi32(reinterpret_cast<const int*>(perm), _mm256_add_epi32(pX1, Y1), 1);
+
+            const __m256 xf1 = _mm256_sub_ps(xf, onef);
+            const __m256 yf1 = _mm256_sub_ps(yf, onef);
+            const __m256 x1 = perlin_lerp_avx2(perlin_grad_avx2(aa, xf, yf), perlin_grad_avx2(ba, xf1, yf), u);
+            const __m256 x2 = perlin_lerp_avx2(perlin_grad_avx2(ab, xf, yf1), perlin_grad_avx2(bb, xf1, yf1), u);
+            const __m256 r = _mm256_mul_ps(_mm256_add_ps(perlin_lerp_avx2(x1, x2, v), onef), _mm256_set1_ps(0.5f));
+            _mm256_storeu_ps(out + i, r);
+        }
+        perlin_periodic_scalar(perm, wrapX, wrapY, xs + i, ys + i, out + i, count - i);
+    }
+
+    RELNO_TARGET_AVX512
+    static void perlin_periodic_avx512(const std::uint8_t* perm, const std::int32_t* wrapX, const std::int32_t* wrapY,
+        const float* xs, const float* ys, float* out, std::size_t count) {
+        const __m512i one = _mm512_set1_epi32(1);
+        const __m512 onef = _mm512_set1_ps(1.0f);
+
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            const __m512 x = _mm512_loadu_ps(xs + i);
+            const __m512 y = _mm512_loadu_ps(ys + i);
+            const __m512 fx = _mm512_roundscale_ps(x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+            const __m512 fy = _mm512_roundscale_ps(y, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+            const __m512i kx = _mm512_cvttps_epi32(fx);
+            const __m512i ky = _mm512_cvttps_epi32(fy);
+            const __m512i X0 = _mm512_i32gather_epi32(kx, wrapX, 4);
+            const __m512i X1 = _mm512_i32gather_epi32(_mm512_add_epi32(kx, one), wrapX, 4);
+            const __m512i Y0 = _mm512_i32gather_epi32(ky, wrapY, 4);
+            const __m512i Y1 = _mm512_i32gather_epi32(_mm512_add_epi32(ky, one), wrapY, 4);
+
+            const __m512 xf = _mm512_sub_ps(x, fx);
+            const __m512 yf = _mm512_sub_ps(y, fy);
+            const __m512 u = perlin_fade_avx512(xf);
+            const __m512 v = perlin_fade_avx512(yf);
+
+            const __m512i pX0 = perlin_lookup_avx512(perm, X0);
+            const __m512i pX1 = perlin_lookup_avx512(perm, X1);
+            const __m512i aa = _mm512_i32gather_epi32(_mm512_add_epi32(pX0, Y0), perm, 1);
+            const __m512i ab = _mm512_i32gather_epi32(_mm512_add_epi32(pX0, Y1), perm, 1);
+            const __m512i ba = _mm512_i32gather_epi32(_mm512_add_epi32(pX1, Y0), perm, 1);
+            const __m512i bb = _mm512_i32gather_epi32(_mm512_add_epi32(pX1, Y1), perm, 1);
+
+            const __m512 xf1 = _mm512_sub_ps(xf, onef);
+            const __m512 yf1 = _mm512_sub_ps(yf, onef);
+            const __m512 x1 = perlin_lerp_avx512(perlin_grad_avx512(aa, xf, yf), perlin_grad_avx512(ba, xf1, yf), u);
+            const __m512 x2 = perlin_lerp_avx512(perlin_grad_avx512(ab, xf, yf1), perlin_grad_avx512(bb, xf1, yf1), u);
+            const __m512 r = _mm512_mul_ps(_mm512_add_ps(perlin_lerp_avx512(x1, x2, v), onef), _mm512_set1_ps(0.5f));
+            _mm512_storeu_ps(out + i, r);
+        }
+        perlin_periodic_avx2(perm, wrapX, wrapY, xs + i, ys + i, out + i, count - i);
+    }
+#endif // RELNO_ARCH_X86
+
+    // NEON and SSE2 tiers run the scalar kernel
+    static const KernelTable<PerlinPeriodicKernel> kPerlinPeriodicKernels = [] {
+        KernelTable<PerlinPeriodicKernel> t;
+        t.scalar = perlin_periodic_scalar;
+#if defined(RELNO_ARCH_X86)
+        t.avx2 = perlin_periodic_avx2;
+        t.avx512 = perlin_periodic_avx512;
+#endif
+        return t;
+    }();
+
+    void PerlinNoise::noise_periodic_batch(const PerlinWrapTable& wrapX, const PerlinWrapTable& wrapY,
+        const float* x, const float* y, float* out, std::size_t count) const {
+        kPerlinPeriodicKernels.get()(p.data(), wrapX.data(), wrapY.data(), x, y, out, count);
+    }
+
+    // ---------------------------------------------------------
+    // Parameter validation shared by every map entry point
+    // ---------------------------------------------------------
+    static void validate_perlin_params(
         int width,
         int height,
         float scale,
         int octaves,
         float frequency,
         float persistence,
-        float lacunarity,
-        float base,
-        int seed
+        float lacunarity
     ) {
-        // Validate parameters
         if (width <= 0)
             throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
         if (height <= 0)
@@ -101,82 +523,490 @@ namespace Noise {
             throw std::invalid_argument("persistence must be in [0,1], got: " + std::to_string(persistence));
         if (lacunarity <= 0.0f)
             throw std::invalid_argument("lacunarity must be > 0, got: " + std::to_string(lacunarity));
+    }
 
-        PerlinNoise generator(seed);
-        std::vector<std::vector<float>> noise(height, std::vector<float>(width, 0.0f));
+    // ---------------------------------------------------------
+    // Multi-octave generator over a window of the infinite plane
+    // ---------------------------------------------------------
+    // dst pixel (x, y) is world pixel (originX + x, originY + y). Sample positions
+    // depend only on the integer world coordinate, so overlapping windows produce
+    // the same values bit for bit.
+    static void perlin_fractal_into(
+        const PerlinNoise& generator,
+        float* dst,
+        std::size_t stride,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        const GenerateOptions& options
+    ) {
+        validate_perlin_params(width, height, scale, octaves, frequency, persistence, lacunarity);
+        if (!dst)
+            throw std::invalid_argument("dst must not be null");
+        if (stride < static_cast<std::size_t>(width))
+            throw std::invalid_argument("stride must be >= width, got: " + std::to_string(stride));
 
-        float amplitude = 1.0f;
-        float maxAmplitude = 0.0f;
-        float freq = frequency;
+        const StageTimer timer(StatsStage::Evaluate, "perlin",
+            static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height), options.threads, options.pool);
 
-        for (int o = 0; o < octaves; ++o) {
-            for (int y = 0; y < height; ++y) {
-                for (int x = 0; x < width; ++x) {
-                    float nx = (x + base) / scale * freq;
-                    float ny = (y + base) / scale * freq;
-                    noise[y][x] += generator.noise(nx, ny) * amplitude;
-                }
+        // Common presets run a FractalNoise specialization: same values, constant
+        // octave table, all octaves of a chunk in one kernel call
+        if (options.octaveMode != OctaveMode::Layered) {
+            if (const FractalPresetFn<PerlinNoise> preset = find_fractal_preset<PerlinNoise>(octaves, persistence, lacunarity)) {
+                preset(generator, dst, stride, originX, originY, width, height, scale, frequency, base, options);
+                return;
             }
+        }
+
+        float maxAmplitude = 0.0f;
+        float amplitude = 1.0f;
+        for (int o = 0; o < octaves; ++o) {
             maxAmplitude += amplitude;
             amplitude *= persistence;
-            freq *= lacunarity;
         }
 
-        // Normalize to [0,1] - consistent with SimplexNoise approach
-        // Perlin noise() already returns [0,1], so just divide by max amplitude
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                noise[y][x] /= maxAmplitude;
+        const bool fused = use_fused_octaves(options.octaveMode, width, height, options.tileSize);
+
+        // Each tile runs every octave while it is hot in cache. A pixel only depends on
+        // its own coordinates and the per-pixel octave order is unchanged, so the result
+        // is identical to a serial pass regardless of threads, tile size or octave mode.
+        parallel_for_tiles(width, height, options.tileSize, options.tileSize, options.threads, options.pool, [&](const Tile& tile) {
+            // Rows are evaluated in fixed-size chunks through the batched kernel
+            constexpr int chunk = 64;
+            alignas(64) float xs[chunk];
+            alignas(64) float ys[chunk];
+            alignas(64) float vals[chunk];
+
+            const int xEnd = tile.x + tile.width;
+            const int yEnd = tile.y + tile.height;
+
+            if (fused) {
+                // Octave sum of one chunk stays in a local accumulator; dst is written once
+                alignas(64) float acc[chunk];
+                for (int y = tile.y; y < yEnd; ++y) {
+                    float* row = dst + y * stride;
+                    for (int x0 = tile.x; x0 < xEnd; x0 += chunk) {
+                        int n = std::min(chunk, xEnd - x0);
+                        std::fill(acc, acc + n, 0.0f);
+
+                        float amplitude = 1.0f;
+                        float freq = frequency;
+                        for (int o = 0; o < octaves; ++o) {
+                            float ny = (static_cast<float>(originY + y) + base) / scale * freq;
+                            std::fill(ys, ys + n, ny);
+                            for (int i = 0; i < n; ++i)
+                                xs[i] = (static_cast<float>(originX + x0 + i) + base) / scale * freq;
+                            generator.noise_batch(xs, ys, vals, static_cast<std::size_t>(n));
+                            for (int i = 0; i < n; ++i)
+                                acc[i] += vals[i] * amplitude;
+                            amplitude *= persistence;
+                            freq *= lacunarity;
+                        }
+
+                        for (int i = 0; i < n; ++i)
+                            row[x0 + i] = acc[i] / maxAmplitude;
+                    }
+                }
+                return;
+            }
+
+            for (int y = tile.y; y < yEnd; ++y)
+                std::fill(dst + y * stride + tile.x, dst + y * stride + xEnd, 0.0f);
+
+            float amplitude = 1.0f;
+            float freq = frequency;
+            for (int o = 0; o < octaves; ++o) {
+                for (int y = tile.y; y < yEnd; ++y) {
+                    float* row = dst + y * stride;
+                    float ny = (static_cast<float>(originY + y) + base) / scale * freq;
+                    std::fill(ys, ys + chunk, ny);
+                    for (int x0 = tile.x; x0 < xEnd; x0 += chunk) {
+                        int n = std::min(chunk, xEnd - x0);
+                        for (int i = 0; i < n; ++i)
+                            xs[i] = (static_cast<float>(originX + x0 + i) + base) / scale * freq;
+                        generator.noise_batch(xs, ys, vals, static_cast<std::size_t>(n));
+                        for (int i = 0; i < n; ++i)
+                            row[x0 + i] += vals[i] * amplitude;
+                    }
+                }
+                amplitude *= persistence;
+                freq *= lacunarity;
+            }
+
+            // Normalize to [0,1] - consistent with SimplexNoise approach
+            // Perlin noise() already returns [0,1], so just divide by max amplitude
+            for (int y = tile.y; y < yEnd; ++y) {
+                float* row = dst + y * stride;
+                for (int x = tile.x; x < xEnd; ++x)
+                    row[x] /= maxAmplitude;
+            }
+        });
+    }
+
+    // ---------------------------------------------------------
+    // Multi-octave generator into a caller-provided buffer
+    // ---------------------------------------------------------
+    void generate_perlin_into(
+        const PerlinNoise& generator,
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        const GenerateOptions& options
+    ) {
+        perlin_fractal_into(generator, dst, stride, 0, 0, width, height, scale, octaves, frequency, persistence, lacunarity, base, options);
+    }
+
+    void generate_perlin_into(
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        const GenerateOptions& options
+    ) {
+        validate_perlin_params(width, height, scale, octaves, frequency, persistence, lacunarity);
+        const PerlinNoise generator = [&] {
+            const StageTimer timer(StatsStage::Setup, "perlin", 0);
+            return PerlinNoise(seed);
+        }();
+        generate_perlin_into(generator, dst, stride, width, height, scale, octaves, frequency, persistence, lacunarity, base, options);
+    }
 
+    // ---------------------------------------------------------
+    // Multi-octave map generator
+    // ---------------------------------------------------------
+    NoiseMap generate_perlin_noisemap(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        const GenerateOptions& options
+    ) {
+        validate_perlin_params(width, height, scale, octaves, frequency, persistence, lacunarity);
+        NoiseMap noise = [&] {
+            const StageTimer timer(StatsStage::Setup, "perlin", 0);
+            return NoiseMap(width, height);
+        }();
+        generate_perlin_into(noise.data(), noise.stride(), width, height, scale, octaves, frequency, persistence, lacunarity, base, seed, options);
         return noise;
     }
 
+    std::vector<std::vector<float>> generate_perlin_map(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed
+    ) {
+        return generate_perlin_noisemap(width, height, scale, octaves, frequency, persistence, lacunarity, base, seed).to_vector();
+    }
+
     // ---------------------------------------------------------
-    // Save Perlin map to grayscale PNG or JPEG (auto-detected from extension)
+    // Tileable maps
     // ---------------------------------------------------------
-    void save_perlin_image(const std::vector<std::vector<float>>& noise, const std::string& filename, const std::string& outputDir) {
-        if (noise.empty() || noise[0].empty()) {
-            throw std::invalid_argument("Cannot save empty noise map.");
-        }
+    // Lattice period of one map axis: the cells the untiled map puts across
+    // `extent` pixels, rounded to a whole number
+    static int perlin_tile_period(int extent, double cellsPerPixel, int octave) {
+        const double cells = std::round(static_cast<double>(extent) * cellsPerPixel);
+        if (!(cells <= static_cast<double>(1 << 24)))
+            throw std::invalid_argument("octave " + std::to_string(octave) + " needs a lattice period above 2^24 cells, got: " + std::to_string(cells));
+        return std::max(1, static_cast<int>(cells));
+    }
+
+    // One octave of a tileable map: pixel (x, y) samples lattice coordinates
+    // (x * stepX + offsetX, y * stepY + offsetY) of the tables' window
+    struct PerlinTileOctave {
+        PerlinWrapTable wrapX;
+        PerlinWrapTable wrapY;
+        float stepX, stepY;
+        float offsetX, offsetY;
+    };
 
-        int height = noise.size();
-        int width = noise[0].size();
+    // Base shift of `period` cells per `extent` pixels: whole cells go into the
+    // wrap table, the fraction into the sample coordinates
+    static PerlinWrapTable perlin_tile_axis(int period, int extent, float base, float& step, float& offset) {
+        step = static_cast<float>(static_cast<double>(period) / extent);
+        const double shift = static_cast<double>(base) * period / extent;
+        const double whole = std::floor(shift);
+        offset = static_cast<float>(shift - whole);
+        return PerlinWrapTable(period, static_cast<std::int64_t>(std::fmod(whole, static_cast<double>(period))), period + 1);
+    }
 
-        std::vector<unsigned char> imgData(width * height);
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                imgData[y * width + x] = static_cast<unsigned char>(noise[y][x] * 255.0f);
+    void generate_perlin_tileable_into(
+        const PerlinNoise& generator,
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        const GenerateOptions& options
+    ) {
+        validate_perlin_params(width, height, scale, octaves, frequency, persistence, lacunarity);
+        if (!dst)
+            throw std::invalid_argument("dst must not be null");
+        if (stride < static_cast<std::size_t>(width))
+            throw std::invalid_argument("stride must be >= width, got: " + std::to_string(stride));
 
-        // Determine output directory: use custom or default
-        std::filesystem::path outDir;
-        if (outputDir.empty()) {
-            outDir = std::filesystem::current_path().parent_path() / "ImageOutput";
-        }
-        else {
-            outDir = outputDir;
+        std::vector<PerlinTileOctave> layers;
+        std::vector<float> amplitudes;
+        float maxAmplitude = 0.0f;
+        {
+            const StageTimer timer(StatsStage::Setup, "perlin", 0);
+            layers.reserve(static_cast<std::size_t>(octaves));
+            float amplitude = 1.0f;
+            float freq = frequency;
+            for (int o = 0; o < octaves; ++o) {
+                const double cellsPerPixel = static_cast<double>(freq) / scale;
+                const int periodX = perlin_tile_period(width, cellsPerPixel, o);
+                const int periodY = perlin_tile_period(height, cellsPerPixel, o);
+                float stepX, stepY, offsetX, offsetY;
+                PerlinWrapTable wrapX = perlin_tile_axis(periodX, width, base, stepX, offsetX);
+                PerlinWrapTable wrapY = perlin_tile_axis(periodY, height, base, stepY, offsetY);
+                layers.push_back({ std::move(wrapX), std::move(wrapY), stepX, stepY, offsetX, offsetY });
+                amplitudes.push_back(amplitude);
+                maxAmplitude += amplitude;
+                amplitude *= persistence;
+                freq *= lacunarity;
+            }
         }
-        std::filesystem::create_directories(outDir);
-        std::filesystem::path outFile = outDir / filename;
-        std::string extension = outFile.extension().string();
 
-        // Convert extension to lowercase for comparison
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        const StageTimer timer(StatsStage::Evaluate, "perlin",
+            static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height), options.threads, options.pool);
 
-        int result = 0;
-        if (extension == ".jpg" || extension == ".jpeg") {
-            // Save as JPEG with quality 90 (range: 1-100, higher = better quality)
-            result = stbi_write_jpg(outFile.string().c_str(), width, height, 1, imgData.data(), 90);
-        }
-        else {
-            // Default to PNG
-            result = stbi_write_png(outFile.string().c_str(), width, height, 1, imgData.data(), width);
-        }
+        // All octaves of a chunk run back to back (the wrap tables are small)
+        parallel_for_tiles(width, height, options.tileSize, options.tileSize, options.threads, options.pool, [&](const Tile& tile) {
+            constexpr int chunk = 64;
+            alignas(64) float xs[chunk];
+            alignas(64) float ys[chunk];
+            alignas(64) float vals[chunk];
+            alignas(64) float acc[chunk];
 
-        if (result == 0) {
-            throw std::runtime_error("Failed to write image file: " + outFile.string());
-        }
+            const int xEnd = tile.x + tile.width;
+            for (int y = tile.y; y < tile.y + tile.height; ++y) {
+                float* row = dst + y * stride;
+                for (int x0 = tile.x; x0 < xEnd; x0 += chunk) {
+                    const int n = std::min(chunk, xEnd - x0);
+                    std::fill(acc, acc + n, 0.0f);
+                    for (int o = 0; o < octaves; ++o) {
+                        const PerlinTileOctave& layer = layers[static_cast<std::size_t>(o)];
+                        std::fill(ys, ys + n, static_cast<float>(y) * layer.stepY + layer.offsetY);
+                        for (int i = 0; i < n; ++i)
+                            xs[i] = static_cast<float>(x0 + i) * layer.stepX + layer.offsetX;
+                        generator.noise_periodic_batch(layer.wrapX, layer.wrapY, xs, ys, vals, static_cast<std::size_t>(n));
+                        const float amplitude = amplitudes[static_cast<std::size_t>(o)];
+                        for (int i = 0; i < n; ++i)
+                            acc[i] += vals[i] * amplitude;
+                    }
+                    for (int i = 0; i < n; ++i)
+                        row[x0 + i] = acc[i] / maxAmplitude;
+                }
+            }
+        });
+    }
 
-        std::cout << "[OK] Perlin noise image saved at: " << outFile.string() << "\n";
+    NoiseMap generate_perlin_tileable_noisemap(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        const GenerateOptions& options
+    ) {
+        validate_perlin_params(width, height, scale, octaves, frequency, persistence, lacunarity);
+        NoiseMap noise = [&] {
+            const StageTimer timer(StatsStage::Setup, "perlin", 0);
+            return NoiseMap(width, height);
+        }();
+        const PerlinNoise generator = [&] {
+            const StageTimer timer(StatsStage::Setup, "perlin", 0);
+            return PerlinNoise(seed);
+        }();
+        generate_perlin_tileable_into(generator, noise.data(), noise.stride(), width, height, scale, octaves, frequency, persistence, lacunarity, base, options);
+        return noise;
+    }
+
+    // ---------------------------------------------------------
+    // World-space regions and chunks
+    // ---------------------------------------------------------
+    void generate_perlin_region_into(
+        const PerlinNoise& generator,
+        const PerlinParams& params,
+        float* dst,
+        std::size_t stride,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const GenerateOptions& options
+    ) {
+        perlin_fractal_into(generator, dst, stride, originX, originY, width, height,
+            params.scale, params.octaves, params.frequency, params.persistence, params.lacunarity, params.base, options);
+    }
+
+    NoiseMap generate_perlin_region(
+        const PerlinNoise& generator,
+        const PerlinParams& params,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const GenerateOptions& options
+    ) {
+        validate_perlin_params(width, height, params.scale, params.octaves, params.frequency, params.persistence, params.lacunarity);
+        NoiseMap noise = [&] {
+            const StageTimer timer(StatsStage::Setup, "perlin", 0);
+            return NoiseMap(width, height);
+        }();
+        generate_perlin_region_into(generator, params, noise.data(), noise.stride(), originX, originY, width, height, options);
+        return noise;
+    }
+
+    NoiseMap generate_perlin_chunk(
+        const PerlinNoise& generator,
+        const PerlinParams& params,
+        std::int64_t chunkX,
+        std::int64_t chunkY,
+        int chunkSize,
+        const GenerateOptions& options
+    ) {
+        if (chunkSize <= 0)
+            throw std::invalid_argument("chunkSize must be > 0, got: " + std::to_string(chunkSize));
+        return generate_perlin_region(generator, params, chunkX * chunkSize, chunkY * chunkSize, chunkSize, chunkSize, options);
+    }
+
+    ChunkKey perlin_chunk_key(int seed, const PerlinParams& params, std::int64_t chunkX, std::int64_t chunkY, int chunkSize) {
+        ChunkKey key;
+        key.generator = static_cast<std::uint32_t>(ChunkGenerator::Perlin);
+        key.seed = seed;
+        key.set_param(0, params.scale);
+        key.set_param(1, static_cast<std::int32_t>(params.octaves));
+        key.set_param(2, params.frequency);
+        key.set_param(3, params.persistence);
+        key.set_param(4, params.lacunarity);
+        key.set_param(5, params.base);
+        key.chunkX = chunkX;
+        key.chunkY = chunkY;
+        key.chunkSize = chunkSize;
+        return key;
+    }
+
+    ChunkCache::MapPtr generate_perlin_chunk_cached(
+        ChunkCache& cache,
+        int seed,
+        const PerlinParams& params,
+        std::int64_t chunkX,
+        std::int64_t chunkY,
+        int chunkSize,
+        const GenerateOptions& options
+    ) {
+        if (seed < 0)
+            throw std::invalid_argument("seed must be >= 0 for cached chunks, got: " + std::to_string(seed));
+        return cache.get_or_create(perlin_chunk_key(seed, params, chunkX, chunkY, chunkSize), [&] {
+            PerlinNoise generator(seed);
+            return generate_perlin_chunk(generator, params, chunkX, chunkY, chunkSize, options);
+        });
+    }
+
+    // ---------------------------------------------------------
+    // Save Perlin map to grayscale PNG, JPEG or EXR (auto-detected from extension)
+    // ---------------------------------------------------------
+    void save_perlin_image(const NoiseMap& noise, const std::string& filename, const std::string& outputDir, const ImageSaveOptions& imageOptions) {
+        std::filesystem::path outFile = save_noise_image(noise, filename, outputDir, imageOptions);
+        if (std::ostream* log = log_stream()) *log << "[OK] Perlin noise image saved at: " << outFile.string() << "\n";
+    }
+
+    void save_perlin_region_image(
+        const PerlinNoise& generator,
+        const PerlinParams& params,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const std::string& filename,
+        const std::string& outputDir,
+        const GenerateOptions& options,
+        const ImageSaveOptions& imageOptions
+    ) {
+        validate_perlin_params(width, height, params.scale, params.octaves, params.frequency, params.persistence, params.lacunarity);
+
+        ImageSaveOptions saveOptions = imageOptions;
+        if (!saveOptions.pool) saveOptions.pool = options.pool;
+        std::filesystem::path outFile = save_noise_image_bands(filename, outputDir, width, height,
+            [&](float* band, std::size_t stride, int y0, int rows) {
+                generate_perlin_region_into(generator, params, band, stride, originX, originY + y0, width, rows, options);
+            }, saveOptions);
+
+        if (std::ostream* log = log_stream()) *log << "[OK] Perlin noise image saved at: " << outFile.string() << "\n";
+    }
+
+    void save_perlin_tiled_raw(
+        const PerlinNoise& generator,
+        const PerlinParams& params,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const std::string& filename,
+        const std::string& outputDir,
+        const RawTileOptions& rawOptions,
+        const GenerateOptions& options
+    ) {
+        validate_perlin_params(width, height, params.scale, params.octaves, params.frequency, params.persistence, params.lacunarity);
+
+        // the tiles are the parallel work: each one runs on a single thread
+        GenerateOptions tileOptions = options;
+        tileOptions.threads = 1;
+        const std::filesystem::path file = resolve_raw_path(filename, outputDir);
+        write_tiled_raw_map(file, width, height, [&](float* dst, std::size_t stride, const Tile& tile) {
+            generate_perlin_region_into(generator, params, dst, stride, originX + tile.x, originY + tile.y, tile.width, tile.height, tileOptions);
+        }, rawOptions, options);
+
+        if (std::ostream* log = log_stream()) *log << "[OK] Perlin noise raw map saved at: " << file.string() << "\n";
+    }
+
+    void save_perlin_image(const std::vector<std::vector<float>>& noise, const std::string& filename, const std::string& outputDir, const ImageSaveOptions& imageOptions) {
+        if (noise.empty() || noise[0].empty()) {
+            throw std::invalid_argument("Cannot save empty noise map.");
+        }
+        save_perlin_image(NoiseMap::from_vector(noise), filename, outputDir, imageOptions);
     }
 
     // ---------------------------------------------------------
@@ -196,13 +1026,30 @@ namespace Noise {
         const std::string& filename,
         const std::string& outputDir
     ) {
-        auto noise = generate_perlin_map(width, height, scale, octaves, frequency, persistence, lacunarity, base, seed);
+        if (mode == OutputMode::Mmap) {
+            // Generated in place into the mapped file; the returned copy is read back from it
+            std::filesystem::path file = resolve_raw_path(filename, outputDir);
+            MappedRawMap mapped = MappedRawMap::generate(file, width, height, [&](float* dst, std::size_t stride) {
+                generate_perlin_into(dst, stride, width, height, scale, octaves, frequency, persistence, lacunarity, base, seed);
+            });
+            if (std::ostream* log = log_stream()) *log << "[OK] Perlin noise raw map saved at: " << file.string() << "\n";
+            return mapped.to_noisemap().to_vector();
+        }
+
+        auto noise = generate_perlin_noisemap(width, height, scale, octaves, frequency, persistence, lacunarity, base, seed);
 
         switch (mode) {
         case OutputMode::Image:
             save_perlin_image(noise, filename, outputDir);
             break;
+        case OutputMode::Raw: {
+            std::filesystem::path file = resolve_raw_path(filename, outputDir);
+            save_raw_map(noise, file);
+            if (std::ostream* log = log_stream()) *log << "[OK] Perlin noise raw map saved at: " << file.string() << "\n";
+            break;
+        }
         case OutputMode::None:
+        case OutputMode::Mmap:
             // Do nothing, just return the noise
             break;
         case OutputMode::Map:
@@ -211,7 +1058,7 @@ namespace Noise {
             break;
         }
 
-        return noise;
+        return noise.to_vector();
     }
 
 } // namespace Noise
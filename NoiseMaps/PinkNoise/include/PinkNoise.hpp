@@ -2,26 +2,17 @@
 #include <vector>
 #include <string>
 #include <cstddef>
+#include <cstdint>
 #include "Noise.hpp"
+#include "NoiseMap.hpp" // AlignedBuffer, NoiseMap
+#include "GenerateOptions.hpp"
+#include "ImageOutput.hpp"
+#include "RawMap.hpp"
 
 namespace Noise {
 
     enum class OutputMode; // forward declare (Noise.hpp provides def when included in compilation units)
 
-    // aligned buffer RAII wrapper (opaque here, defined in cpp)
-    struct AlignedBuffer {
-        float* data = nullptr;
-        std::size_t size = 0; // number of floats
-        AlignedBuffer() = default;
-        AlignedBuffer(std::size_t n);
-        ~AlignedBuffer();
-        AlignedBuffer(const AlignedBuffer&) = delete;
-        AlignedBuffer& operator=(const AlignedBuffer&) = delete;
-        AlignedBuffer(AlignedBuffer&& other) noexcept;
-        AlignedBuffer& operator=(AlignedBuffer&& other) noexcept;
-        float* get() noexcept { return data; }
-    };
-
     // PinkNoise generator class (lightweight)
     class PinkNoise {
     public:
@@ -30,11 +21,16 @@ namespace Noise {
 
         // low-level method: build single layer white noise into target (contiguously)
         // width*height sized target
-        void generate_white_layer(float* target, int width, int height, int octaveSeed) const;
+        // options.rng selects the RNG; RngBackend::Counter fills rows in parallel
+        void generate_white_layer(float* target, int width, int height, int octaveSeed,
+            const GenerateOptions& options = {}) const;
 
         // build integral image (summed-area table) from `src` (size w*h) into `dst` (size (w+1)*(h+1))
         // `dst` layout: (h+1) rows of (w+1) floats; row major
-        static void build_integral(const float* src, float* dst, int width, int height);
+        // Row prefix sums and the column pass both run on the worker pool with SIMD; the
+        // additions happen in the same order as a serial build, so the table is identical
+        static void build_integral(const float* src, float* dst, int width, int height,
+            const GenerateOptions& options = {});
 
         // compute box-averages using integral image and write into `out` (contiguous w*h)
         // box defined by integer blockSize (block width/height)
@@ -45,7 +41,79 @@ namespace Noise {
         int seed_;
     };
 
-    // High-level generator
+    // Reusable scratch buffers (white layer, integral image, box averages) for the
+    // pink pipeline. Reusing one workspace across generate_pink_into calls of the
+    // same size avoids re-allocating these buffers; they only ever grow.
+    class PinkWorkspace {
+    public:
+        PinkWorkspace() = default;
+        PinkWorkspace(int width, int height) { reserve(width, height); }
+
+        // ensure capacity for a width x height map (PinkEngine::Integral)
+        void reserve(int width, int height);
+        // ensure capacity for the corner columns of one PinkEngine::BlockGrid octave
+        void reserve_block_grid(int width, int height, int blockSize);
+        std::size_t size_bytes() const noexcept;
+
+        float* layer() noexcept { return layer_.get(); }       // w*h
+        float* integral() noexcept { return integral_.get(); } // (w+1)*(h+1)
+        float* average() noexcept { return average_.get(); }   // w*h
+        float* corners() noexcept { return corners_.get(); }   // h*(ceil(w/blockSize)+1)
+
+    private:
+        AlignedBuffer layer_;
+        AlignedBuffer integral_;
+        AlignedBuffer average_;
+        AlignedBuffer corners_;
+    };
+
+    // High-level generator into a caller-provided buffer (row y at dst + y * stride,
+    // stride in floats >= width), reusing `workspace` for all temporaries. The box
+    // averaging runs on options.pool (default_thread_pool() when null);
+    // options.pinkEngine picks how block means are computed. With
+    // options.pinkStorage == PinkStorage::Compact the workspace is unused and
+    // the map is built as in generate_pink_half_into, kept in float.
+    void generate_pink_into(
+        PinkWorkspace& workspace,
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        int octaves = 6,
+        float alpha = 1.0f,
+        int sampleRate = 44100,
+        float amplitude = 1.0f,
+        int seed = -1,
+        const GenerateOptions& options = {}
+    );
+
+    // Same as above with a temporary workspace
+    void generate_pink_into(
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        int octaves = 6,
+        float alpha = 1.0f,
+        int sampleRate = 44100,
+        float amplitude = 1.0f,
+        int seed = -1,
+        const GenerateOptions& options = {}
+    );
+
+    // High-level generator (contiguous, 64-byte aligned result)
+    NoiseMap generate_pink_noisemap(
+        int width,
+        int height,
+        int octaves = 6,
+        float alpha = 1.0f,
+        int sampleRate = 44100,
+        float amplitude = 1.0f,
+        int seed = -1,
+        const GenerateOptions& options = {}
+    );
+
+    // Same as generate_pink_noisemap, copied into a nested vector
     std::vector<std::vector<float>> generate_pink_map(
         int width,
         int height,
@@ -56,10 +124,145 @@ namespace Noise {
         int seed = -1
     );
 
+    // Pink map as IEEE half floats (row y at dst + y * stride, stride in halves),
+    // always built with PinkStorage::Compact: 16-bit fixed-point white layers and
+    // exact integer block sums, the octaves summed row by row and each row
+    // converted once. Besides dst that keeps ~2 bytes per pixel for each 1-pixel
+    // octave plus ~4/3 bytes for all the others, instead of the float pipeline's
+    // 12 (Integral) or ~4 (BlockGrid) bytes plus a float destination; dst can be
+    // MappedRawMap::create(file, w, h, RawFormat::Float16).data_u16(). Values
+    // differ from the Float32 storage by the white quantization (< 2^-16) and the
+    // float table's rounding, which Compact does not have, then by half rounding
+    // (relative 2^-11); options.pinkEngine is ignored.
+    void generate_pink_half_into(
+        std::uint16_t* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        int octaves = 6,
+        float alpha = 1.0f,
+        int sampleRate = 44100,
+        float amplitude = 1.0f,
+        int seed = -1,
+        const GenerateOptions& options = {}
+    );
+
+    HalfMap generate_pink_halfmap(
+        int width,
+        int height,
+        int octaves = 6,
+        float alpha = 1.0f,
+        int sampleRate = 44100,
+        float amplitude = 1.0f,
+        int seed = -1,
+        const GenerateOptions& options = {}
+    );
+
+    // The width x height window at (x, y) of the mapWidth x mapHeight pink map
+    // drawn with RngBackend::Counter and PinkStorage::Compact (options.rng and
+    // pinkStorage are ignored): the same pixels as that window of
+    // generate_pink_noisemap(mapWidth, mapHeight, ...) with both set. Every block
+    // the window touches is evaluated whole, so windows agree exactly with each
+    // other; seed must be >= 0.
+    void generate_pink_region_into(
+        float* dst,
+        std::size_t stride,
+        int mapWidth,
+        int mapHeight,
+        int x,
+        int y,
+        int width,
+        int height,
+        int octaves = 6,
+        float alpha = 1.0f,
+        int sampleRate = 44100,
+        float amplitude = 1.0f,
+        int seed = 0,
+        const GenerateOptions& options = {}
+    );
+
+    // Pink map tile by tile into a tiled .rnm file (see write_tiled_raw_map), for
+    // maps larger than RAM: peak memory is about one tile per worker. Tiles are
+    // only independent with per-pixel white values, so this always uses
+    // RngBackend::Counter and PinkStorage::Compact; the pixels equal
+    // generate_pink_noisemap(...) with both set. A tile evaluates the whole
+    // blocks it touches, white values outside it included, so blocks crossing
+    // tile edges come out exactly; tile sizes that are multiples of every
+    // octave's block size (2^o at 44.1 kHz) draw each white value only once.
+    // A negative seed is replaced by one random seed for all tiles.
+    void save_pink_tiled_raw(
+        int width,
+        int height,
+        int octaves = 6,
+        float alpha = 1.0f,
+        int sampleRate = 44100,
+        float amplitude = 1.0f,
+        int seed = -1,
+        const std::string& filename = "pink_noise.rnm",
+        const std::string& outputDir = "",
+        const RawTileOptions& rawOptions = {},
+        const GenerateOptions& options = {}
+    );
+
+    // Block means of every pink octave, kept so that alpha and amplitude changes
+    // only re-weight them: octave o depends on (seed + o, its block size) alone.
+    // Octave o with block size b holds ceil(width / b) x ceil(height / b) means,
+    // about 4/3 floats per pixel over all octaves. compose() equals
+    // generate_pink_noisemap(width, height, octaves, alpha, sampleRate, amplitude,
+    // seed, options) bit for bit, with options.rng as given here.
+    class PinkLayers {
+    public:
+        PinkLayers(
+            int width,
+            int height,
+            int octaves = 6,
+            int sampleRate = 44100,
+            int seed = -1,
+            const GenerateOptions& options = {}
+        );
+
+        int width() const { return width_; }
+        int height() const { return height_; }
+        int octaves() const { return static_cast<int>(means_.size()); }
+        int block_size(int octave) const { return blockSizes_.at(static_cast<std::size_t>(octave)); }
+        const NoiseMap& block_means(int octave) const { return means_.at(static_cast<std::size_t>(octave)); }
+        std::size_t size_bytes() const;
+
+        // Pink map of the first `octaves` octaves (0 = all), alpha and amplitude
+        // treated as in generate_pink_into
+        void compose_into(float* dst, std::size_t stride, float alpha = 1.0f, float amplitude = 1.0f,
+            int octaves = 0, const GenerateOptions& options = {}) const;
+        NoiseMap compose(float alpha = 1.0f, float amplitude = 1.0f, int octaves = 0, const GenerateOptions& options = {}) const;
+
+    private:
+        int width_;
+        int height_;
+        std::vector<int> blockSizes_;
+        std::vector<NoiseMap> means_;
+    };
+
+    // Pink settings as one struct (same meaning as the arguments of generate_pink_noisemap)
+    struct PinkParams {
+        int octaves = 6;
+        float alpha = 1.0f;
+        int sampleRate = 44100;
+        float amplitude = 1.0f;
+    };
+
+    // Grayscale PNG, JPEG or EXR (from the extension), PNG / JPEG values clamped to [0, 1];
+    // JPEG quality defaults to 95 here (imageOptions.jpegQuality == 0)
+    void save_pink_image(
+        const NoiseMap& noise,
+        const std::string& filename = "pink_noise.png",
+        const std::string& outputDir = "",
+        const ImageSaveOptions& imageOptions = {}
+    );
+
     void save_pink_image(
         const std::vector<std::vector<float>>& noise,
         const std::string& filename = "pink_noise.png",
-        const std::string& outputDir = ""
+        const std::string& outputDir = "",
+        const ImageSaveOptions& imageOptions = {}
     );
 
     std::vector<std::vector<float>> create_pinknoise(
@@ -1,160 +1,415 @@
 // PinkNoise.cpp
 #include "PinkNoise.hpp"
 #include "Noise.hpp" // for OutputMode definition
-#include "stb_image_write.h"
+#include "TileScheduler.hpp"
+#include "Cancellation.hpp"
+#include "CounterRng.hpp"
+#include "CpuFeatures.hpp"
+#include "NoiseStats.hpp"
+#include "RawMap.hpp"
+#include "HalfFloat.hpp"
 
+#include <optional>
 #include <random>
 #include <vector>
 #include <cmath>
 #include <algorithm>
 #include <filesystem>
 #include <iostream>
-#include <thread>
-#include <atomic>
 #include <cassert>
 #include <cstring>
-#include <cstdint> // for std::uintptr_t
 
-#if defined(_MSC_VER)
-#include <malloc.h> // _aligned_malloc / _aligned_free
-#else
-#include <stdlib.h> // posix_memalign, free
-#endif
-
-#if defined(__AVX2__)
+#if defined(RELNO_ARCH_X86)
 #include <immintrin.h>
+#elif defined(RELNO_ARCH_ARM64)
+#include <arm_neon.h>
 #endif
 
 namespace Noise {
 
+    // rows per task handed to the worker pool (white layers, integral rows, box averaging)
+    static constexpr int kBandRows = 8;
+
+    // columns per task of the integral image's column pass
+    static constexpr int kIntegralStripColumns = 512;
+
     // -----------------------------
-    // AlignedBuffer implementation
+    // PinkNoise methods
     // -----------------------------
-    AlignedBuffer::AlignedBuffer(std::size_t n) : data(nullptr), size(n) {
-        if (n == 0) return;
+    PinkNoise::PinkNoise(int seed) : seed_(seed) {}
 
-        std::size_t bytes = n * sizeof(float);
+    // RNG seed of one white layer: the octave seed, else the generator seed, else random
+    static unsigned int resolve_layer_seed(int octaveSeed, int seed) {
+        if (octaveSeed >= 0) return static_cast<unsigned int>(octaveSeed);
+        if (seed >= 0) return static_cast<unsigned int>(seed);
+        return std::random_device{}();
+    }
 
-#if defined(_MSC_VER)
-        // Windows (MSVC): use _aligned_malloc / _aligned_free
-        data = static_cast<float*>(_aligned_malloc(bytes, 64));
-        if (!data) {
-            throw std::bad_alloc();
-        }
-#else
-        // Portable manual alignment for all other compilers (MinGW, Linux, macOS, etc.)
-        const std::size_t alignment = 64;
-
-        // We allocate extra space to:
-        //  - guarantee we can align to `alignment`
-        //  - store the original pointer just before the aligned block
-        std::size_t total = bytes + alignment - 1 + sizeof(void*);
-        void* raw = std::malloc(total);
-        if (!raw) {
-            throw std::bad_alloc();
-        }
+    // Generate white noise into target (contiguous width*height), seeded by resolve_layer_seed.
+    void PinkNoise::generate_white_layer(float* target, int width, int height, int octaveSeed, const GenerateOptions& options) const {
+        const unsigned int layerSeed = resolve_layer_seed(octaveSeed, seed_);
 
-        // Find an aligned address inside the allocated block
-        std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
-        std::uintptr_t aligned = (start + alignment - 1) & ~(alignment - 1);
-        void* alignedPtr = reinterpret_cast<void*>(aligned);
+        if (options.rng == RngBackend::Counter) {
+            parallel_for_tiles(width, height, width, kBandRows, options.threads, options.pool, [&](const Tile& band) {
+                for (int y = band.y; y < band.y + band.height; ++y)
+                    counter_uniform_row(layerSeed, static_cast<std::uint32_t>(y), 0,
+                        target + static_cast<std::size_t>(y) * width, static_cast<std::size_t>(width));
+            });
+            return;
+        }
 
-        // Store the original pointer immediately before the aligned block
-        reinterpret_cast<void**>(alignedPtr)[-1] = raw;
+        std::mt19937 rng(layerSeed);
 
-        data = static_cast<float*>(alignedPtr);
-#endif
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
 
-        // zero initialize the usable bytes (not the padding)
-        std::memset(data, 0, bytes);
+        int N = width * height;
+        for (int i = 0; i < N; ++i) target[i] = dist(rng);
     }
 
-    AlignedBuffer::~AlignedBuffer() {
-#if defined(_MSC_VER)
-        if (data) {
-            _aligned_free(data);
-        }
-#else
-        if (data) {
-            // Recover the original pointer we stashed just before `data`
-            void* raw = reinterpret_cast<void**>(data)[-1];
-            std::free(raw);
+    // -----------------------------
+    // Summed-area table
+    // -----------------------------
+    // Built in two passes with the same float additions, in the same order, as the
+    // serial recurrence I(y,x) = I(y-1,x) + rowSum(y,x):
+    //   1) rows:    dst row y+1 = running prefix sum of src row y (rows independent)
+    //   2) columns: dst row y  += dst row y-1, top to bottom (columns independent)
+    // Rows are interleaved across SIMD lanes (8x8 / 4x4 transposes), so every lane
+    // still runs one row's sequential prefix sum and the table stays bit-identical.
+    using IntegralRowsKernel = void (*)(const float* src, float* dst, int width, int y0, int y1);
+
+    static void integral_rows_scalar(const float* src, float* dst, int width, int y0, int y1) {
+        const int iw = width + 1;
+        for (int y = y0; y < y1; ++y) {
+            const float* srcRow = src + static_cast<std::size_t>(y) * width;
+            float* dstRow = dst + static_cast<std::size_t>(y + 1) * iw;
+            float rowSum = 0.0f;
+            dstRow[0] = 0.0f; // first column
+            for (int x = 0; x < width; ++x) {
+                rowSum += srcRow[x];
+                dstRow[x + 1] = rowSum;
+            }
         }
-#endif
+    }
+
+#if defined(RELNO_ARCH_X86)
+    RELNO_TARGET_AVX2
+    static inline void transpose8x8_avx2(__m256 r[8]) {
+        const __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+        const __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+        const __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+        const __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+        const __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+        const __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+        const __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+        const __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+        const __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+        r[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+        r[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+        r[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+        r[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+        r[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+        r[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+        r[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+        r[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+    }
+
+    // 8 rows at a time, lane j = row y + j
+    RELNO_TARGET_AVX2
+    static void integral_rows_avx2(const float* src, float* dst, int width, int y0, int y1) {
+        const int iw = width + 1;
+        int y = y0;
+        for (; y + 8 <= y1; y += 8) {
+            __m256 acc = _mm256_setzero_ps();
+            int x = 0;
+            for (; x + 8 <= width; x += 8) {
+                __m256 block[8];
+                for (int j = 0; j < 8; ++j)
+                    block[j] = _mm256_loadu_ps(src + static_cast<std::size_t>(y + j) * width + x);
+                transpose8x8_avx2(block); // block[k] = column x + k of the 8 rows
+                for (int k = 0; k < 8; ++k) {
+                    acc = _mm256_add_ps(acc, block[k]);
+                    block[k] = acc;
+                }
+                transpose8x8_avx2(block);
+                for (int j = 0; j < 8; ++j)
+                    _mm256_storeu_ps(dst + static_cast<std::size_t>(y + 1 + j) * iw + 1 + x, block[j]);
+            }
 
-        data = nullptr;
-        size = 0;
+            alignas(32) float rowSums[8];
+            _mm256_store_ps(rowSums, acc);
+            for (int j = 0; j < 8; ++j) {
+                const float* srcRow = src + static_cast<std::size_t>(y + j) * width;
+                float* dstRow = dst + static_cast<std::size_t>(y + 1 + j) * iw;
+                float rowSum = rowSums[j];
+                dstRow[0] = 0.0f;
+                for (int xt = x; xt < width; ++xt) {
+                    rowSum += srcRow[xt];
+                    dstRow[xt + 1] = rowSum;
+                }
+            }
+        }
+        integral_rows_scalar(src, dst, width, y, y1);
     }
+#endif // RELNO_ARCH_X86
 
-    // Move constructor
-    AlignedBuffer::AlignedBuffer(AlignedBuffer&& other) noexcept {
-        data = other.data;
-        size = other.size;
-        other.data = nullptr;
-        other.size = 0;
+#if defined(RELNO_ARCH_ARM64)
+    static inline void transpose4x4_neon(float32x4_t r[4]) {
+        const float32x4x2_t p01 = vtrnq_f32(r[0], r[1]);
+        const float32x4x2_t p23 = vtrnq_f32(r[2], r[3]);
+        r[0] = vcombine_f32(vget_low_f32(p01.val[0]), vget_low_f32(p23.val[0]));
+        r[1] = vcombine_f32(vget_low_f32(p01.val[1]), vget_low_f32(p23.val[1]));
+        r[2] = vcombine_f32(vget_high_f32(p01.val[0]), vget_high_f32(p23.val[0]));
+        r[3] = vcombine_f32(vget_high_f32(p01.val[1]), vget_high_f32(p23.val[1]));
     }
 
-    // Move assignment
-    AlignedBuffer& AlignedBuffer::operator=(AlignedBuffer&& other) noexcept {
-        if (this != &other) {
-            // Free existing buffer
-#if defined(_MSC_VER)
-            if (data) {
-                _aligned_free(data);
+    // 4 rows at a time, lane j = row y + j
+    static void integral_rows_neon(const float* src, float* dst, int width, int y0, int y1) {
+        const int iw = width + 1;
+        int y = y0;
+        for (; y + 4 <= y1; y += 4) {
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            int x = 0;
+            for (; x + 4 <= width; x += 4) {
+                float32x4_t block[4];
+                for (int j = 0; j < 4; ++j)
+                    block[j] = vld1q_f32(src + static_cast<std::size_t>(y + j) * width + x);
+                transpose4x4_neon(block);
+                for (int k = 0; k < 4; ++k) {
+                    acc = vaddq_f32(acc, block[k]);
+                    block[k] = acc;
+                }
+                transpose4x4_neon(block);
+                for (int j = 0; j < 4; ++j)
+                    vst1q_f32(dst + static_cast<std::size_t>(y + 1 + j) * iw + 1 + x, block[j]);
             }
-#else
-            if (data) {
-                void* raw = reinterpret_cast<void**>(data)[-1];
-                std::free(raw);
+
+            float rowSums[4];
+            vst1q_f32(rowSums, acc);
+            for (int j = 0; j < 4; ++j) {
+                const float* srcRow = src + static_cast<std::size_t>(y + j) * width;
+                float* dstRow = dst + static_cast<std::size_t>(y + 1 + j) * iw;
+                float rowSum = rowSums[j];
+                dstRow[0] = 0.0f;
+                for (int xt = x; xt < width; ++xt) {
+                    rowSum += srcRow[xt];
+                    dstRow[xt + 1] = rowSum;
+                }
             }
+        }
+        integral_rows_scalar(src, dst, width, y, y1);
+    }
+#endif // RELNO_ARCH_ARM64
+
+    static const KernelTable<IntegralRowsKernel> kIntegralRowsKernels = [] {
+        KernelTable<IntegralRowsKernel> t;
+        t.scalar = integral_rows_scalar;
+#if defined(RELNO_ARCH_X86)
+        t.avx2 = integral_rows_avx2;
+#elif defined(RELNO_ARCH_ARM64)
+        t.neon = integral_rows_neon;
 #endif
-            // Steal ownership
-            data = other.data;
-            size = other.size;
-            other.data = nullptr;
-            other.size = 0;
+        return t;
+    }();
+
+    // ---------------------------------------------------------
+    // Octave accumulation and normalization kernels:
+    //   accumulate: acc[i] += src[i] * weight
+    //   normalize:  acc[i] = clamp(acc[i] / divisor * amplitude, 0, 1)
+    // Separate multiply / add / divide and max(0, v) before min(1, v) (which keep
+    // NaN and -0 lanes like the scalar comparisons) make every tier bit-identical.
+    // ---------------------------------------------------------
+    using AccumulateKernel = void (*)(float* acc, const float* src, float weight, std::size_t count);
+    using NormalizeKernel = void (*)(float* acc, float divisor, float amplitude, std::size_t count);
+
+    static void accumulate_scalar(float* acc, const float* src, float weight, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) acc[i] += src[i] * weight;
+    }
+
+    static void normalize_scalar(float* acc, float divisor, float amplitude, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            float val = acc[i] / divisor;
+            val = val * amplitude;
+            if (val < 0.0f) val = 0.0f;
+            if (val > 1.0f) val = 1.0f;
+            acc[i] = val;
         }
-        return *this;
     }
 
+#if defined(RELNO_ARCH_X86)
+    RELNO_TARGET_SSE2
+    static void accumulate_sse2(float* acc, const float* src, float weight, std::size_t count) {
+        const __m128 w = _mm_set1_ps(weight);
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(_mm_loadu_ps(src + i), w)));
+        accumulate_scalar(acc + i, src + i, weight, count - i);
+    }
 
-    // -----------------------------
-    // PinkNoise methods
-    // -----------------------------
-    PinkNoise::PinkNoise(int seed) : seed_(seed) {}
+    RELNO_TARGET_SSE2
+    static void normalize_sse2(float* acc, float divisor, float amplitude, std::size_t count) {
+        const __m128 d = _mm_set1_ps(divisor);
+        const __m128 a = _mm_set1_ps(amplitude);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 v = _mm_mul_ps(_mm_div_ps(_mm_loadu_ps(acc + i), d), a);
+            v = _mm_min_ps(one, _mm_max_ps(zero, v));
+            _mm_storeu_ps(acc + i, v);
+        }
+        normalize_scalar(acc + i, divisor, amplitude, count - i);
+    }
 
-    // Generate white noise into target (contiguous width*height). RNG seeded by octaveSeed.
-    void PinkNoise::generate_white_layer(float* target, int width, int height, int octaveSeed) const {
-        std::mt19937 rng;
-        if (octaveSeed >= 0) rng.seed(static_cast<unsigned int>(octaveSeed));
-        else if (seed_ >= 0) rng.seed(static_cast<unsigned int>(seed_));
-        else rng.seed(std::random_device{}());
+    RELNO_TARGET_AVX2
+    static void accumulate_avx2(float* acc, const float* src, float weight, std::size_t count) {
+        const __m256 w = _mm256_set1_ps(weight);
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), w)));
+        accumulate_scalar(acc + i, src + i, weight, count - i);
+    }
 
-        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    RELNO_TARGET_AVX2
+    static void normalize_avx2(float* acc, float divisor, float amplitude, std::size_t count) {
+        const __m256 d = _mm256_set1_ps(divisor);
+        const __m256 a = _mm256_set1_ps(amplitude);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 v = _mm256_mul_ps(_mm256_div_ps(_mm256_loadu_ps(acc + i), d), a);
+            v = _mm256_min_ps(one, _mm256_max_ps(zero, v));
+            _mm256_storeu_ps(acc + i, v);
+        }
+        normalize_scalar(acc + i, divisor, amplitude, count - i);
+    }
 
-        int N = width * height;
-        for (int i = 0; i < N; ++i) target[i] = dist(rng);
+    RELNO_TARGET_AVX512
+    static void accumulate_avx512(float* acc, const float* src, float weight, std::size_t count) {
+        const __m512 w = _mm512_set1_ps(weight);
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+            _mm512_storeu_ps(acc + i, _mm512_add_ps(_mm512_loadu_ps(acc + i), _mm512_mul_ps(_mm512_loadu_ps(src + i), w)));
+        // masked tail: the scalar multiply-add rounds the same per lane
+        if (i < count) {
+            const __mmask16 m = static_cast<__mmask16>((1u << (count - i)) - 1u);
+            const __m512 v = _mm512_add_ps(_mm512_maskz_loadu_ps(m, acc + i), _mm512_mul_ps(_mm512_maskz_loadu_ps(m, src + i), w));
+            _mm512_mask_storeu_ps(acc + i, m, v);
+        }
     }
 
-    // Build integral image: dst has dims (height+1) x (width+1). dst is contiguous and must be (width+1)*(height+1) floats.
-    // We keep row0 and col0 as zeros to simplify box sum queries.
-    void PinkNoise::build_integral(const float* src, float* dst, int width, int height) {
-        int iw = width + 1;
-        int ih = height + 1;
+    RELNO_TARGET_AVX512
+    static void normalize_avx512(float* acc, float divisor, float amplitude, std::size_t count) {
+        const __m512 d = _mm512_set1_ps(divisor);
+        const __m512 a = _mm512_set1_ps(amplitude);
+        const __m512 zero = _mm512_setzero_ps();
+        const __m512 one = _mm512_set1_ps(1.0f);
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m512 v = _mm512_mul_ps(_mm512_div_ps(_mm512_loadu_ps(acc + i), d), a);
+            v = _mm512_min_ps(one, _mm512_max_ps(zero, v));
+            _mm512_storeu_ps(acc + i, v);
+        }
+        normalize_scalar(acc + i, divisor, amplitude, count - i);
+    }
+#endif // RELNO_ARCH_X86
+
+#if defined(RELNO_ARCH_ARM64)
+    static void accumulate_neon(float* acc, const float* src, float weight, std::size_t count) {
+        const float32x4_t w = vdupq_n_f32(weight);
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)  // vmul + vadd, not the fused vmla / vfma
+            vst1q_f32(acc + i, vaddq_f32(vld1q_f32(acc + i), vmulq_f32(vld1q_f32(src + i), w)));
+        accumulate_scalar(acc + i, src + i, weight, count - i);
+    }
+
+    static void normalize_neon(float* acc, float divisor, float amplitude, std::size_t count) {
+        const float32x4_t d = vdupq_n_f32(divisor);
+        const float32x4_t a = vdupq_n_f32(amplitude);
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const float32x4_t v = vmulq_f32(vdivq_f32(vld1q_f32(acc + i), d), a);
+            // vmax / vmin return NaN for NaN lanes; select keeps -0 (only v < 0 / v > 1 change)
+            float32x4_t r = vbslq_f32(vcltq_f32(v, zero), zero, v);
+            r = vbslq_f32(vcgtq_f32(r, one), one, r);
+            vst1q_f32(acc + i, r);
+        }
+        normalize_scalar(acc + i, divisor, amplitude, count - i);
+    }
+#endif // RELNO_ARCH_ARM64
+
+    static const KernelTable<AccumulateKernel> kAccumulateKernels = [] {
+        KernelTable<AccumulateKernel> t;
+        t.scalar = accumulate_scalar;
+#if defined(RELNO_ARCH_X86)
+        t.sse2 = accumulate_sse2;
+        t.avx2 = accumulate_avx2;
+        t.avx512 = accumulate_avx512;
+#elif defined(RELNO_ARCH_ARM64)
+        t.neon = accumulate_neon;
+#endif
+        return t;
+    }();
+
+    static const KernelTable<NormalizeKernel> kNormalizeKernels = [] {
+        KernelTable<NormalizeKernel> t;
+        t.scalar = normalize_scalar;
+#if defined(RELNO_ARCH_X86)
+        t.sse2 = normalize_sse2;
+        t.avx2 = normalize_avx2;
+        t.avx512 = normalize_avx512;
+#elif defined(RELNO_ARCH_ARM64)
+        t.neon = normalize_neon;
+#endif
+        return t;
+    }();
+
+    void PinkNoise::build_integral(const float* src, float* dst, int width, int height, const GenerateOptions& options) {
+        const IntegralRowsKernel rowsKernel = kIntegralRowsKernels.get();
+        const int iw = width + 1;
+        const int ih = height + 1;
         // zero first row
         for (int x = 0; x < iw; ++x) dst[x] = 0.0f;
 
-        for (int y = 1; y < ih; ++y) {
-            float rowSum = 0.0f;
-            dst[y * iw + 0] = 0.0f; // first column
-            const float* srcRow = src + (y - 1) * width;
-            float* dstRow = dst + y * iw;
-            for (int x = 1; x < iw; ++x) {
-                rowSum += srcRow[x - 1];
-                // integral = previous row integral + rowSum
-                dstRow[x] = dstRow[x - iw] + rowSum;
+        // dst rows [y0, y1) += the row above, columns [x0, x1) (the x loop vectorizes)
+        auto addRowsAbove = [&](int y0, int y1, int x0, int x1) {
+            for (int y = y0; y < y1; ++y) {
+                const float* prev = dst + static_cast<std::size_t>(y - 1) * iw;
+                float* cur = dst + static_cast<std::size_t>(y) * iw;
+                for (int x = x0; x < x1; ++x)
+                    cur[x] = prev[x] + cur[x];
             }
+        };
+
+        ThreadPool& pool = options.pool ? *options.pool : default_thread_pool();
+        if (std::min(resolve_thread_count(options.threads), pool.size()) <= 1) {
+            // Single worker: run the column pass on each band while it is still in cache
+            for (int y = 0; y < height; y += kBandRows) {
+                const int y1 = std::min(y + kBandRows, height);
+                rowsKernel(src, dst, width, y, y1);
+                addRowsAbove(y + 1, y1 + 1, 0, iw);
+            }
+            return;
         }
+
+        // 1) row prefix sums, bands of rows in parallel
+        parallel_for_tiles(width, height, width, kBandRows, options.threads, &pool, [&](const Tile& band) {
+            rowsKernel(src, dst, width, band.y, band.y + band.height);
+        });
+
+        // 2) add the previous row, top to bottom, strips of columns in parallel
+        parallel_for_tiles(iw, 1, kIntegralStripColumns, 1, options.threads, &pool, [&](const Tile& strip) {
+            addRowsAbove(1, ih, strip.x, strip.x + strip.width);
+        });
     }
 
     // Box average using integral image. Writes mean into out (w*h). blockSize >=1.
@@ -184,75 +439,487 @@ namespace Noise {
         }
     }
 
+    // -----------------------------
+    // Block-grid engine
+    // -----------------------------
+    // The box averages only ever read the summed-area table at block corners, so
+    // the table is only kept at the corner columns x = 0, b, 2b, ..., width:
+    //   1) rows:    running prefix sum of each white row, stored at the corner
+    //               columns; the white values are drawn chunk by chunk and never stored
+    //   2) columns: corner rows y += row y-1, top to bottom
+    //   3) splat:   each block mean (same four-corner difference and division as
+    //               the integral path) times the octave weight is added to its pixels
+    // The float additions are the ones the full table performs, so every corner
+    // value, block mean and output pixel is bit-identical to PinkEngine::Integral.
+    // Row y of the corner buffer holds I(y+1, corner c); I(0, c) is 0.
+
+    // white values drawn per chunk in the row pass
+    static constexpr int kCornerChunk = 64;
+
+    static int block_grid_columns(int width, int blockSize) {
+        return (width + blockSize - 1) / blockSize + 1;
+    }
+
+    // Prefix sums of `rows` (<= kBandRows) white rows sampled at the corner columns.
+    // fill(x0, n, vals) writes the values of columns [x0, x0 + n) of row r to vals[r].
+    template <typename Fill>
+    static void corner_prefix_rows(float* out, int rows, int width, int blockSize, Fill&& fill) {
+        const int cols = block_grid_columns(width, blockSize);
+        alignas(64) float vals[kBandRows][kCornerChunk];
+        float sums[kBandRows] = {};
+        for (int r = 0; r < rows; ++r) out[static_cast<std::size_t>(r) * cols] = 0.0f;
+
+        int corner = 1;
+        int nextX = std::min(blockSize, width);
+        for (int x0 = 0; x0 < width; x0 += kCornerChunk) {
+            const int n = std::min(kCornerChunk, width - x0);
+            fill(x0, n, vals);
+            for (int k = 0; k < n; ++k) {
+                for (int r = 0; r < rows; ++r) sums[r] += vals[r][k];
+                if (x0 + k + 1 == nextX) {
+                    for (int r = 0; r < rows; ++r) out[static_cast<std::size_t>(r) * cols + corner] = sums[r];
+                    ++corner;
+                    nextX = std::min(nextX + blockSize, width);
+                }
+            }
+        }
+    }
+
+    // Builds the corner columns of one octave's summed-area table into `corners`
+    // (height rows of block_grid_columns() floats)
+    static void build_block_grid(float* corners, int width, int height, int blockSize,
+        unsigned int layerSeed, const GenerateOptions& options) {
+        const int cols = block_grid_columns(width, blockSize);
+
+        // corner rows [y0, y1) += the row above, columns [c0, c1)
+        auto addRowsAbove = [&](int y0, int y1, int c0, int c1) {
+            for (int y = std::max(y0, 1); y < y1; ++y) {
+                const float* prev = corners + static_cast<std::size_t>(y - 1) * cols;
+                float* cur = corners + static_cast<std::size_t>(y) * cols;
+                for (int c = c0; c < c1; ++c)
+                    cur[c] = prev[c] + cur[c];
+            }
+        };
+
+        if (options.rng != RngBackend::Counter) {
+            // one mt19937 stream in row-major order, as generate_white_layer draws it
+            std::mt19937 rng(layerSeed);
+            std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+            for (int y = 0; y < height; ++y) {
+                corner_prefix_rows(corners + static_cast<std::size_t>(y) * cols, 1, width, blockSize,
+                    [&](int, int n, float (*vals)[kCornerChunk]) {
+                        for (int k = 0; k < n; ++k) vals[0][k] = dist(rng);
+                    });
+                addRowsAbove(y, y + 1, 0, cols);
+            }
+            return;
+        }
+
+        // Counter RNG: bands of rows are independent until the column pass
+        auto counterBand = [&](int y0, int y1) {
+            corner_prefix_rows(corners + static_cast<std::size_t>(y0) * cols, y1 - y0, width, blockSize,
+                [&](int x0, int n, float (*vals)[kCornerChunk]) {
+                    for (int r = 0; r < y1 - y0; ++r)
+                        counter_uniform_row(layerSeed, static_cast<std::uint32_t>(y0 + r),
+                            static_cast<std::uint32_t>(x0), vals[r], static_cast<std::size_t>(n));
+                });
+        };
+
+        ThreadPool& pool = options.pool ? *options.pool : default_thread_pool();
+        if (std::min(resolve_thread_count(options.threads), pool.size()) <= 1) {
+            for (int y = 0; y < height; y += kBandRows) {
+                const int y1 = std::min(y + kBandRows, height);
+                counterBand(y, y1);
+                addRowsAbove(y, y1, 0, cols);
+            }
+            return;
+        }
+
+        parallel_for_tiles(width, height, width, kBandRows, options.threads, &pool, [&](const Tile& band) {
+            counterBand(band.y, band.y + band.height);
+        });
+        parallel_for_tiles(cols, 1, kIntegralStripColumns, 1, options.threads, &pool, [&](const Tile& strip) {
+            addRowsAbove(1, height, strip.x, strip.x + strip.width);
+        });
+    }
+
+    // Mean of block column c between the corner rows `top` (nullptr: the table's
+    // zero row) and `bottom`, over `count` pixels:
+    // summed area table I(y2,x2) - I(y1,x2) - I(y2,x1) + I(y1,x1)
+    static inline float block_mean(const float* top, const float* bottom, int c, int count) {
+        const float s =
+            bottom[c + 1] -
+            (top ? top[c + 1] : 0.0f) -
+            bottom[c] +
+            (top ? top[c] : 0.0f);
+        return (count > 0) ? (s / count) : 0.0f;
+    }
+
+    // acc += blockMean * weight for every pixel, block means from the corner columns
+    static void splat_block_means(float* dst, std::size_t stride, const float* corners, int width, int height,
+        int blockSize, float weight, const GenerateOptions& options) {
+        const int cols = block_grid_columns(width, blockSize);
+        parallel_for_tiles(width, height, width, kBandRows, options.threads, options.pool, [&](const Tile& band) {
+            for (int y = band.y; y < band.y + band.height; ++y) {
+                const int y1 = (y / blockSize) * blockSize;
+                const int y2 = std::min(y1 + blockSize, height);
+                const float* top = y1 > 0 ? corners + static_cast<std::size_t>(y1 - 1) * cols : nullptr;
+                const float* bottom = corners + static_cast<std::size_t>(y2 - 1) * cols;
+                float* accRow = dst + static_cast<std::size_t>(y) * stride;
+
+                for (int c = 0; c + 1 < cols; ++c) {
+                    const int x1 = c * blockSize;
+                    const int x2 = std::min(x1 + blockSize, width);
+                    const float value = block_mean(top, bottom, c, (y2 - y1) * (x2 - x1)) * weight;
+                    for (int x = x1; x < x2; ++x) accRow[x] += value;
+                }
+            }
+        });
+    }
+
+    // -----------------------------
+    // PinkWorkspace
+    // -----------------------------
+    // Buffers only grow: reserving a size that already fits is free
+    void PinkWorkspace::reserve(int width, int height) {
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+        std::size_t pixels = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+        std::size_t integralSize = static_cast<std::size_t>(width + 1) * static_cast<std::size_t>(height + 1);
+        if (layer_.size < pixels) layer_ = AlignedBuffer(pixels);
+        if (average_.size < pixels) average_ = AlignedBuffer(pixels);
+        if (integral_.size < integralSize) integral_ = AlignedBuffer(integralSize);
+    }
+
+    void PinkWorkspace::reserve_block_grid(int width, int height, int blockSize) {
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+        if (blockSize < 1) throw std::invalid_argument("blockSize must be >= 1, got: " + std::to_string(blockSize));
+        std::size_t cornerSize = static_cast<std::size_t>(height) * static_cast<std::size_t>(block_grid_columns(width, blockSize));
+        if (corners_.size < cornerSize) corners_ = AlignedBuffer(cornerSize);
+    }
+
+    std::size_t PinkWorkspace::size_bytes() const noexcept {
+        return (layer_.size + average_.size + integral_.size + corners_.size) * sizeof(float);
+    }
+
+    // -----------------------------
+    // Octave spacing and weights
+    // -----------------------------
+    // base spacing derived from sampleRate to emulate frequency spacing
+    static float pink_base_spacing(int sampleRate) {
+        return std::max(1.0f, std::sqrt(static_cast<float>(sampleRate) / 44100.0f));
+    }
+
+    static int pink_block_size(float baseSpacing, int octave) {
+        return static_cast<int>(std::max(1.0f, baseSpacing * std::pow(2.0f, static_cast<float>(octave))));
+    }
+
+    static float pink_octave_weight(int blockSize, float alpha) {
+        return 1.0f / std::pow(static_cast<float>(blockSize), alpha);
+    }
+
+    // -----------------------------
+    // Compact storage
+    // -----------------------------
+    // PinkStorage::Compact keeps white values as 16-bit fixed point,
+    // q = uint(u * 65536) in [0, 65535] (u = q / 65536 up to 2^-16), and sums
+    // them per block in 64-bit integers. Block means are therefore exact at any
+    // map size, where the float table's running sums lose low bits as they grow.
+    // 1-pixel octaves keep q (2 bytes per pixel), larger ones one float mean per
+    // block; the octave sum and normalization run row by row into a per-band row
+    // buffer and each finished row goes to emit(y, row).
+    //
+    // Any rectangle of the map can be built on its own: an octave covers the
+    // whole blocks the rectangle touches (drawing their white values outside it
+    // too), so tiles agree exactly with the full map. That needs per-pixel
+    // Counter values; the mt19937 stream only exists for the whole map.
+    static constexpr float kCompactScale = 65536.0f;
+
+    struct CompactOctave {
+        int blockSize = 1;
+        float weight = 0.0f;
+        int column0 = 0;                    // blockSize > 1: first block column / row of `means`
+        int row0 = 0;
+        BasicNoiseMap<std::uint16_t> white; // blockSize 1: q per pixel of the region
+        NoiseMap means;                     // blockSize > 1: means of the blocks touching the region
+    };
+
+    // Scratch of the worker running a band; it only grows, so repeated calls only
+    // allocate the octave tables themselves
+    struct CompactScratch {
+        AlignedBuffer rows;                 // accumulate pass: octave sum, then one white row
+        std::vector<std::uint64_t> sums;    // block means: integer sums of one block row
+        std::vector<CompactOctave> layers;  // octave list, empty between calls (capacity only)
+    };
+    static thread_local CompactScratch t_compactScratch;
+
+    static inline std::uint16_t compact_quantize(float u) {
+        // u < 1, so u * 65536 < 65536; the clamp only guards against rounding up to 1
+        const std::uint32_t q = static_cast<std::uint32_t>(u * kCompactScale);
+        return static_cast<std::uint16_t>(std::min<std::uint32_t>(q, 65535u));
+    }
+
+    // Draws columns [x0, x1) of rows [y0, y1) chunk by chunk: row(y, x, n, vals)
+    // receives the values of columns [x, x + n) of row y. `rng` (the map's
+    // mt19937 stream, whole rows only) or Counter values.
+    template <typename Row>
+    static void draw_compact_rows(int x0, int x1, int y0, int y1, unsigned int layerSeed, std::mt19937* rng, Row&& row) {
+        alignas(64) float vals[kCornerChunk];
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        for (int y = y0; y < y1; ++y) {
+            for (int x = x0; x < x1; x += kCornerChunk) {
+                const int n = std::min(kCornerChunk, x1 - x);
+                if (rng) {
+                    for (int k = 0; k < n; ++k) vals[k] = dist(*rng);
+                }
+                else {
+                    counter_uniform_row(layerSeed, static_cast<std::uint32_t>(y), static_cast<std::uint32_t>(x),
+                        vals, static_cast<std::size_t>(n));
+                }
+                row(y, x, n, vals);
+            }
+        }
+    }
+
+    // White layer (blockSize 1) or block means of one octave over `region` of a
+    // width x height map. The mt19937 stream (whole map only) is drawn serially in
+    // row-major order; Counter rows run in parallel bands.
+    static void build_compact_octave(CompactOctave& octave, int width, int height, const Tile& region,
+        unsigned int layerSeed, const GenerateOptions& options) {
+        const int b = octave.blockSize;
+        const std::uint64_t pixels = static_cast<std::uint64_t>(region.width) * static_cast<std::uint64_t>(region.height);
+        const bool serial = options.rng != RngBackend::Counter;
+        std::optional<std::mt19937> rng;
+        if (serial) rng.emplace(layerSeed);
+        std::mt19937* stream = serial ? &*rng : nullptr;
+
+        if (b == 1) {
+            {
+                const StageTimer timer(StatsStage::Setup, "pink", 0);
+                octave.white = BasicNoiseMap<std::uint16_t>(region.width, region.height);
+            }
+            const StageTimer timer(StatsStage::Evaluate, "pink", pixels, options.threads, options.pool);
+            auto fill = [&](int y0, int y1) {
+                draw_compact_rows(region.x, region.x + region.width, y0, y1, layerSeed, stream, [&](int y, int x, int n, const float* vals) {
+                    std::uint16_t* out = octave.white.row(y - region.y).data() + (x - region.x);
+                    for (int k = 0; k < n; ++k) out[k] = compact_quantize(vals[k]);
+                });
+            };
+            if (serial) fill(region.y, region.y + region.height);
+            else parallel_for_tiles(region.width, region.height, region.width, kBandRows, options.threads, options.pool,
+                [&](const Tile& band) { fill(region.y + band.y, region.y + band.y + band.height); });
+            return;
+        }
+
+        octave.column0 = region.x / b;
+        octave.row0 = region.y / b;
+        const int cols = (region.x + region.width + b - 1) / b - octave.column0;
+        const int rows = (region.y + region.height + b - 1) / b - octave.row0;
+        const int x0 = octave.column0 * b;
+        const int x1 = std::min((octave.column0 + cols) * b, width);
+        {
+            const StageTimer timer(StatsStage::Setup, "pink", 0);
+            octave.means = NoiseMap(cols, rows);
+        }
+        const StageTimer timer(StatsStage::BoxAverage, "pink", pixels, options.threads, options.pool);
+        // block rows [r0, r1) of `means`: one row of integer sums at a time
+        auto blockRows = [&](int r0, int r1) {
+            std::vector<std::uint64_t>& sums = t_compactScratch.sums;
+            sums.resize(static_cast<std::size_t>(cols));
+            for (int r = r0; r < r1; ++r) {
+                const int y1 = (octave.row0 + r) * b;
+                const int y2 = std::min(y1 + b, height);
+                std::fill(sums.begin(), sums.end(), std::uint64_t(0));
+                draw_compact_rows(x0, x1, y1, y2, layerSeed, stream, [&](int, int x, int n, const float* vals) {
+                    int c = (x - x0) / b;
+                    int next = std::min(x0 + (c + 1) * b, x1);
+                    for (int k = 0; k < n; ++k) {
+                        if (x + k == next) {
+                            ++c;
+                            next = std::min(next + b, x1);
+                        }
+                        sums[static_cast<std::size_t>(c)] += compact_quantize(vals[k]);
+                    }
+                });
+                float* out = octave.means.row(r).data();
+                for (int c = 0; c < cols; ++c) {
+                    const int bx1 = x0 + c * b;
+                    const int bx2 = std::min(bx1 + b, width);
+                    const double count = static_cast<double>(y2 - y1) * static_cast<double>(bx2 - bx1);
+                    out[c] = static_cast<float>(static_cast<double>(sums[static_cast<std::size_t>(c)]) / (count * kCompactScale));
+                }
+            }
+        };
+        if (serial) blockRows(0, rows);
+        else parallel_for_tiles(cols, rows, cols, std::max(1, kBandRows / b), options.threads, options.pool,
+            [&](const Tile& band) { blockRows(band.y, band.y + band.height); });
+    }
+
+    // `region` of the width x height pink map; arguments already checked and
+    // defaulted by the caller. emit(y, row) gets the region.width pixels of map row y.
+    template <typename Emit>
+    static void generate_pink_compact(int width, int height, const Tile& region, int octaves, float alpha, int sampleRate,
+        float amplitude, int seed, const GenerateOptions& options, Emit&& emit) {
+        const float baseSpacing = pink_base_spacing(sampleRate);
+        // a nested call on this thread finds the list empty and allocates its own
+        std::vector<CompactOctave> layers;
+        layers.swap(t_compactScratch.layers);
+        layers.resize(static_cast<std::size_t>(octaves));
+        double totalWeight = 0.0;
+        for (int o = 0; o < octaves; ++o) {
+            throw_if_cancelled();
+            CompactOctave& octave = layers[static_cast<std::size_t>(o)];
+            octave.blockSize = pink_block_size(baseSpacing, o);
+            octave.weight = pink_octave_weight(octave.blockSize, alpha);
+            totalWeight += octave.weight;
+            const int octaveSeed = (seed >= 0) ? (seed + o) : (-1);
+            build_compact_octave(octave, width, height, region, resolve_layer_seed(octaveSeed, seed), options);
+        }
+
+        const int w = region.width;
+        const int xEnd = region.x + w;
+        const std::uint64_t pixels = static_cast<std::uint64_t>(w) * static_cast<std::uint64_t>(region.height);
+        const StageTimer timer(StatsStage::Accumulate, "pink", pixels, options.threads, options.pool);
+        const AccumulateKernel accumulate = kAccumulateKernels.get();
+        const NormalizeKernel normalize = kNormalizeKernels.get();
+        parallel_for_tiles(w, region.height, w, kBandRows, options.threads, options.pool, [&](const Tile& band) {
+            // white row starts on its own cache line
+            const std::size_t whiteOffset = (static_cast<std::size_t>(w) + 15) & ~std::size_t(15);
+            AlignedBuffer& scratch = t_compactScratch.rows;
+            if (scratch.size < whiteOffset + static_cast<std::size_t>(w))
+                scratch = AlignedBuffer(whiteOffset + static_cast<std::size_t>(w));
+            float* acc = scratch.get();
+            float* white = acc + whiteOffset;
+            for (int y = region.y + band.y; y < region.y + band.y + band.height; ++y) {
+                std::fill(acc, acc + w, 0.0f);
+                for (const CompactOctave& octave : layers) {
+                    const int b = octave.blockSize;
+                    if (b == 1) {
+                        const std::uint16_t* q = octave.white.row(y - region.y).data();
+                        for (int x = 0; x < w; ++x) white[x] = static_cast<float>(q[x]) * (1.0f / kCompactScale);
+                        accumulate(acc, white, octave.weight, static_cast<std::size_t>(w));
+                        continue;
+                    }
+                    const float* means = octave.means.row(y / b - octave.row0).data();
+                    for (int c = 0, x1 = octave.column0 * b; x1 < xEnd; ++c, x1 += b) {
+                        const float value = means[c] * octave.weight;
+                        const int x2 = std::min(x1 + b, xEnd);
+                        for (int x = std::max(x1, region.x); x < x2; ++x) acc[x - region.x] += value;
+                    }
+                }
+                normalize(acc, static_cast<float>(totalWeight), amplitude, static_cast<std::size_t>(w));
+                emit(y, static_cast<const float*>(acc));
+            }
+        });
+        layers.clear(); // frees the octave tables, keeps the list's capacity for the next call
+        layers.swap(t_compactScratch.layers);
+    }
+
     // -----------------------------
     // High-level generator
     // -----------------------------
-    std::vector<std::vector<float>> generate_pink_map(
+    void generate_pink_into(
+        PinkWorkspace& workspace,
+        float* dst,
+        std::size_t stride,
         int width,
         int height,
         int octaves,
         float alpha,
         int sampleRate,
         float amplitude,
-        int seed
+        int seed,
+        const GenerateOptions& options
     ) {
         if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
         if (octaves < 1) throw std::invalid_argument("octaves must be >= 1");
+        if (!dst) throw std::invalid_argument("dst must not be null");
+        if (stride < static_cast<std::size_t>(width)) throw std::invalid_argument("stride must be >= width");
         if (alpha < 0.0f) alpha = 0.0f;
         if (amplitude <= 0.0f) amplitude = 1.0f;
         if (sampleRate < 1) sampleRate = 44100;
 
-        // accumulator (contiguous aligned)
-        AlignedBuffer accBuf(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
-        float* acc = accBuf.get();
-        std::fill(acc, acc + (width * height), 0.0f);
+        if (options.pinkStorage == PinkStorage::Compact) {
+            generate_pink_compact(width, height, Tile{ 0, 0, width, height }, octaves, alpha, sampleRate, amplitude, seed, options, [&](int y, const float* row) {
+                std::memcpy(dst + static_cast<std::size_t>(y) * stride, row, static_cast<std::size_t>(width) * sizeof(float));
+            });
+            return;
+        }
 
-        // integral image temp buffer size (width+1)*(height+1)
-        AlignedBuffer integralBuf(static_cast<std::size_t>(width + 1) * static_cast<std::size_t>(height + 1));
-        float* integral = integralBuf.get();
+        const std::uint64_t pixels = static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height);
 
-        // white layer buffer
-        AlignedBuffer layerBuf(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
-        float* layer = layerBuf.get();
+        // accumulator: the destination itself
+        {
+            const StageTimer timer(StatsStage::Setup, "pink", pixels);
+            for (int y = 0; y < height; ++y)
+                std::fill(dst + y * stride, dst + y * stride + width, 0.0f);
+        }
 
         PinkNoise pn(seed);
 
         double totalWeight = 0.0;
 
-        // base spacing derived from sampleRate to emulate frequency spacing
-        float baseSpacing = std::max(1.0f, std::sqrt(static_cast<float>(sampleRate) / 44100.0f));
-
-        // threading config
-        unsigned int hw = std::max(1u, std::thread::hardware_concurrency());
-        unsigned int numThreads = std::min<unsigned int>(hw, 8); // conservative cap
+        const float baseSpacing = pink_base_spacing(sampleRate);
 
         for (int o = 0; o < octaves; ++o) {
-            int blockSize = static_cast<int>(std::max(1.0f, baseSpacing * std::pow(2.0f, static_cast<float>(o))));
+            throw_if_cancelled(); // Mt19937 white layers are drawn serially, outside any tile
+            int blockSize = pink_block_size(baseSpacing, o);
             int octaveSeed = (seed >= 0) ? (seed + o) : (-1);
+            float weight = pink_octave_weight(blockSize, alpha);
+            totalWeight += weight;
+
+            const bool blockGrid = options.pinkEngine == PinkEngine::BlockGrid ||
+                (options.pinkEngine == PinkEngine::Auto && blockSize > 1);
+            if (blockGrid) {
+                // corner columns of the table only; block means go straight into dst
+                {
+                    const StageTimer timer(StatsStage::Setup, "pink", 0);
+                    workspace.reserve_block_grid(width, height, blockSize);
+                }
+                {
+                    const StageTimer timer(StatsStage::Integral, "pink", pixels, options.threads, options.pool);
+                    build_block_grid(workspace.corners(), width, height, blockSize,
+                        resolve_layer_seed(octaveSeed, seed), options);
+                }
+                const StageTimer timer(StatsStage::BoxAverage, "pink", pixels, options.threads, options.pool);
+                splat_block_means(dst, stride, workspace.corners(), width, height, blockSize, weight, options);
+                continue;
+            }
+
+            {
+                const StageTimer timer(StatsStage::Setup, "pink", 0);
+                workspace.reserve(width, height);
+            }
+
+            // integral image temp buffer size (width+1)*(height+1)
+            float* integral = workspace.integral();
+
+            // white layer buffer
+            float* layer = workspace.layer();
+
+            // box averages; separate from 'layer' to avoid a read/write race
+            float* avg = workspace.average();
 
             // 1) generate white layer
-            pn.generate_white_layer(layer, width, height, octaveSeed);
+            {
+                const StageTimer timer(StatsStage::Evaluate, "pink", pixels, options.threads, options.pool);
+                pn.generate_white_layer(layer, width, height, octaveSeed, options);
+            }
 
-            // 2) build integral image (single-threaded; O(width*height))
+            // 2) build integral image (row and column passes on the worker pool)
             // integral buffer has (height+1) rows of (width+1) floats
             // set to 0 at start (constructor zeros buffer)
-            PinkNoise::build_integral(layer, integral, width, height);
-
-            // 3) compute box-average using integral and write into temp 'layer' buffer (reuse layerBuf)
-            // We'll write the averages into a separate aligned buffer 'avgBuf' to avoid race
-            AlignedBuffer avgBuf(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
-            float* avg = avgBuf.get();
-
-            // We parallelize block-averaging by rows: each thread computes its row range
-            std::vector<std::thread> workers;
-            std::atomic<int> nextRow{ 0 };
+            {
+                const StageTimer timer(StatsStage::Integral, "pink", pixels, options.threads, options.pool);
+                PinkNoise::build_integral(layer, integral, width, height, options);
+            }
 
-            // Replaced old worker lambda compare to last push 
-            auto worker = [&]() {
-                int y;
+            // 3) compute box-average using integral and write into the workspace 'avg' buffer
+            // Full-width bands of rows are spread over the shared worker pool
+            StageTimer boxTimer(StatsStage::BoxAverage, "pink", pixels, options.threads, options.pool);
+            parallel_for_tiles(width, height, width, kBandRows, options.threads, options.pool, [&](const Tile& band) {
                 int iw = width + 1;
 
-                while ((y = nextRow.fetch_add(1, std::memory_order_relaxed)) < height) {
+                for (int y = band.y; y < band.y + band.height; ++y) {
 
                     int by = (y / blockSize) * blockSize;
                     int ey = std::min(by + blockSize, height);
@@ -280,105 +947,310 @@ namespace Noise {
                         avg[y * width + x] = (count > 0) ? (s / count) : 0.0f;
                     }
                 }
-                };
+            });
+            boxTimer.stop();
 
+            // 4) accumulate with weight: acc += avg * weight (row by row: acc rows are strided)
+            const StageTimer timer(StatsStage::Accumulate, "pink", pixels);
+            const AccumulateKernel accumulate = kAccumulateKernels.get();
+            for (int y = 0; y < height; ++y)
+                accumulate(dst + y * stride, avg + static_cast<std::size_t>(y) * width, weight, static_cast<std::size_t>(width));
+        }
 
-            // Replaced thread creation as compare to last push
-            for (unsigned int t = 0; t < numThreads; ++t)
-                workers.emplace_back(worker); // no thread id needed (zero-arg lambda)
-            for (auto& th : workers) th.join();
-                workers.clear();
+        // Normalize accumulator by totalWeight and apply amplitude
+        const StageTimer timer(StatsStage::Normalize, "pink", pixels);
+        const NormalizeKernel normalize = kNormalizeKernels.get();
+        for (int y = 0; y < height; ++y)
+            normalize(dst + y * stride, static_cast<float>(totalWeight), amplitude, static_cast<std::size_t>(width));
+    }
 
-            // 4) accumulate with weight: acc += avg * weight
-            float weight = 1.0f / std::pow(static_cast<float>(blockSize), alpha);
-            totalWeight += weight;
+    void generate_pink_into(
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        int octaves,
+        float alpha,
+        int sampleRate,
+        float amplitude,
+        int seed,
+        const GenerateOptions& options
+    ) {
+        PinkWorkspace workspace;
+        generate_pink_into(workspace, dst, stride, width, height, octaves, alpha, sampleRate, amplitude, seed, options);
+    }
 
-            // Vectorized accumulate if AVX2 available
-#if defined(__AVX2__)
-            const int N = width * height;
-            int i = 0;
-            const int step = 8; // 8 floats per __m256
-            __m256 wv = _mm256_set1_ps(weight);
-            for (; i + step <= N; i += step) {
-                __m256 a = _mm256_load_ps(acc + i);
-                __m256 b = _mm256_load_ps(avg + i);
-                __m256 prod = _mm256_mul_ps(b, wv);
-                __m256 sum = _mm256_add_ps(a, prod);
-                _mm256_store_ps(acc + i, sum);
+    NoiseMap generate_pink_noisemap(
+        int width,
+        int height,
+        int octaves,
+        float alpha,
+        int sampleRate,
+        float amplitude,
+        int seed,
+        const GenerateOptions& options
+    ) {
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+        if (octaves < 1) throw std::invalid_argument("octaves must be >= 1");
+
+        NoiseMap out = [&] {
+            const StageTimer timer(StatsStage::Setup, "pink", 0);
+            return NoiseMap(width, height);
+        }();
+        generate_pink_into(out.data(), out.stride(), width, height, octaves, alpha, sampleRate, amplitude, seed, options);
+        return out;
+    }
+
+    std::vector<std::vector<float>> generate_pink_map(
+        int width,
+        int height,
+        int octaves,
+        float alpha,
+        int sampleRate,
+        float amplitude,
+        int seed
+    ) {
+        return generate_pink_noisemap(width, height, octaves, alpha, sampleRate, amplitude, seed).to_vector();
+    }
+
+    void generate_pink_half_into(
+        std::uint16_t* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        int octaves,
+        float alpha,
+        int sampleRate,
+        float amplitude,
+        int seed,
+        const GenerateOptions& options
+    ) {
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+        if (octaves < 1) throw std::invalid_argument("octaves must be >= 1");
+        if (!dst) throw std::invalid_argument("dst must not be null");
+        if (stride < static_cast<std::size_t>(width)) throw std::invalid_argument("stride must be >= width");
+        if (alpha < 0.0f) alpha = 0.0f;
+        if (amplitude <= 0.0f) amplitude = 1.0f;
+        if (sampleRate < 1) sampleRate = 44100;
+
+        generate_pink_compact(width, height, Tile{ 0, 0, width, height }, octaves, alpha, sampleRate, amplitude, seed, options, [&](int y, const float* row) {
+            floats_to_halves(row, dst + static_cast<std::size_t>(y) * stride, static_cast<std::size_t>(width));
+        });
+    }
+
+    HalfMap generate_pink_halfmap(
+        int width,
+        int height,
+        int octaves,
+        float alpha,
+        int sampleRate,
+        float amplitude,
+        int seed,
+        const GenerateOptions& options
+    ) {
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+        if (octaves < 1) throw std::invalid_argument("octaves must be >= 1");
+
+        HalfMap out = [&] {
+            const StageTimer timer(StatsStage::Setup, "pink", 0);
+            return HalfMap(width, height);
+        }();
+        generate_pink_half_into(out.data(), out.stride(), width, height, octaves, alpha, sampleRate, amplitude, seed, options);
+        return out;
+    }
+
+    void generate_pink_region_into(
+        float* dst,
+        std::size_t stride,
+        int mapWidth,
+        int mapHeight,
+        int x,
+        int y,
+        int width,
+        int height,
+        int octaves,
+        float alpha,
+        int sampleRate,
+        float amplitude,
+        int seed,
+        const GenerateOptions& options
+    ) {
+        if (mapWidth <= 0 || mapHeight <= 0) throw std::invalid_argument("mapWidth/mapHeight must be > 0");
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+        if (x < 0 || y < 0 || x > mapWidth - width || y > mapHeight - height)
+            throw std::out_of_range("pink region (" + std::to_string(x) + ", " + std::to_string(y) + ") " +
+                std::to_string(width) + "x" + std::to_string(height) + " outside the " +
+                std::to_string(mapWidth) + "x" + std::to_string(mapHeight) + " map");
+        if (octaves < 1) throw std::invalid_argument("octaves must be >= 1");
+        if (seed < 0) throw std::invalid_argument("seed must be >= 0 for pink regions, got: " + std::to_string(seed));
+        if (!dst) throw std::invalid_argument("dst must not be null");
+        if (stride < static_cast<std::size_t>(width)) throw std::invalid_argument("stride must be >= width");
+        if (alpha < 0.0f) alpha = 0.0f;
+        if (amplitude <= 0.0f) amplitude = 1.0f;
+        if (sampleRate < 1) sampleRate = 44100;
+
+        GenerateOptions regionOptions = options;
+        regionOptions.rng = RngBackend::Counter;
+        regionOptions.pinkStorage = PinkStorage::Compact;
+        generate_pink_compact(mapWidth, mapHeight, Tile{ x, y, width, height }, octaves, alpha, sampleRate, amplitude, seed,
+            regionOptions, [&](int row, const float* values) {
+                std::memcpy(dst + static_cast<std::size_t>(row - y) * stride, values, static_cast<std::size_t>(width) * sizeof(float));
+            });
+    }
+
+    void save_pink_tiled_raw(
+        int width,
+        int height,
+        int octaves,
+        float alpha,
+        int sampleRate,
+        float amplitude,
+        int seed,
+        const std::string& filename,
+        const std::string& outputDir,
+        const RawTileOptions& rawOptions,
+        const GenerateOptions& options
+    ) {
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+        if (octaves < 1) throw std::invalid_argument("octaves must be >= 1");
+        // every tile has to draw the same layers
+        if (seed < 0) seed = static_cast<int>(std::random_device{}() & 0x7FFFFFFFu);
+
+        // the tiles are the parallel work: each one runs on a single thread
+        GenerateOptions tileOptions = options;
+        tileOptions.threads = 1;
+        const std::filesystem::path file = resolve_raw_path(filename, outputDir);
+        write_tiled_raw_map(file, width, height, [&](float* dst, std::size_t stride, const Tile& tile) {
+            generate_pink_region_into(dst, stride, width, height, tile.x, tile.y, tile.width, tile.height,
+                octaves, alpha, sampleRate, amplitude, seed, tileOptions);
+        }, rawOptions, options);
+
+        if (std::ostream* log = log_stream()) *log << "[OK] Pink noise raw map saved at: " << file.string() << "\n";
+    }
+
+    // -----------------------------
+    // Cached octave layers
+    // -----------------------------
+    // Every octave runs the block-grid engine (the same values as either engine)
+    // and keeps only its block means
+    PinkLayers::PinkLayers(int width, int height, int octaves, int sampleRate, int seed, const GenerateOptions& options)
+        : width_(width), height_(height) {
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+        if (octaves < 1) throw std::invalid_argument("octaves must be >= 1");
+        if (sampleRate < 1) sampleRate = 44100;
+
+        const std::uint64_t pixels = static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height);
+        const float baseSpacing = pink_base_spacing(sampleRate);
+        PinkWorkspace workspace;
+        for (int o = 0; o < octaves; ++o) {
+            throw_if_cancelled();
+            const int blockSize = pink_block_size(baseSpacing, o);
+            const int octaveSeed = (seed >= 0) ? (seed + o) : (-1);
+            const int cols = block_grid_columns(width, blockSize) - 1;
+            const int rows = (height + blockSize - 1) / blockSize;
+            {
+                const StageTimer timer(StatsStage::Setup, "pink", 0);
+                workspace.reserve_block_grid(width, height, blockSize);
+                blockSizes_.push_back(blockSize);
+                means_.emplace_back(cols, rows);
             }
-            // tail
-            for (; i < N; ++i) acc[i] += avg[i] * weight;
-#else
-            int N = width * height;
-            for (int i = 0; i < N; ++i) acc[i] += avg[i] * weight;
-#endif
-            // avgBuf frees on scope exit
+            {
+                const StageTimer timer(StatsStage::Integral, "pink", pixels, options.threads, options.pool);
+                build_block_grid(workspace.corners(), width, height, blockSize, resolve_layer_seed(octaveSeed, seed), options);
+            }
+            const StageTimer timer(StatsStage::BoxAverage, "pink", pixels, options.threads, options.pool);
+            const float* corners = workspace.corners();
+            NoiseMap& means = means_.back();
+            parallel_for_tiles(cols, rows, cols, kBandRows, options.threads, options.pool, [&](const Tile& band) {
+                for (int by = band.y; by < band.y + band.height; ++by) {
+                    const int y1 = by * blockSize;
+                    const int y2 = std::min(y1 + blockSize, height);
+                    const float* top = y1 > 0 ? corners + static_cast<std::size_t>(y1 - 1) * (cols + 1) : nullptr;
+                    const float* bottom = corners + static_cast<std::size_t>(y2 - 1) * (cols + 1);
+                    float* out = means.row(by).data();
+                    for (int c = 0; c < cols; ++c) {
+                        const int x1 = c * blockSize;
+                        const int x2 = std::min(x1 + blockSize, width);
+                        out[c] = block_mean(top, bottom, c, (y2 - y1) * (x2 - x1));
+                    }
+                }
+            });
         }
+    }
 
-        // Normalize accumulator by totalWeight and apply amplitude. Vectorize where possible
-        int Npix = width * height;
-#if defined(__AVX2__)
-        int i = 0;
-        __m256 invW = _mm256_set1_ps(static_cast<float>(1.0 / totalWeight));
-        __m256 ampv = _mm256_set1_ps(amplitude);
-        for (; i + 8 <= Npix; i += 8) {
-            __m256 v = _mm256_load_ps(acc + i);
-            v = _mm256_mul_ps(v, invW);
-            v = _mm256_mul_ps(v, ampv);
-            // clamp 0..1
-            __m256 zero = _mm256_setzero_ps();
-            __m256 one = _mm256_set1_ps(1.0f);
-            v = _mm256_max_ps(zero, _mm256_min_ps(v, one));
-            _mm256_store_ps(acc + i, v);
-        }
-        for (; i < Npix; ++i) {
-            float val = acc[i] / static_cast<float>(totalWeight);
-            val = val * amplitude;
-            if (val < 0.0f) val = 0.0f;
-            if (val > 1.0f) val = 1.0f;
-            acc[i] = val;
-        }
-#else
-        for (int i = 0; i < Npix; ++i) {
-            float val = acc[i] / static_cast<float>(totalWeight);
-            val = val * amplitude;
-            if (val < 0.0f) val = 0.0f;
-            if (val > 1.0f) val = 1.0f;
-            acc[i] = val;
-        }
-#endif
+    std::size_t PinkLayers::size_bytes() const {
+        std::size_t bytes = 0;
+        for (const NoiseMap& means : means_) bytes += means.size_bytes();
+        return bytes;
+    }
 
-        // Convert contiguous acc buffer to std::vector<std::vector<float>> for public API
-        std::vector<std::vector<float>> out(height, std::vector<float>(width));
-        for (int y = 0; y < height; ++y) {
-            std::memcpy(out[y].data(), acc + (std::size_t)y * width, sizeof(float) * static_cast<std::size_t>(width));
+    // Per row, the octaves' weighted block means in octave order, then the
+    // normalization: the operations generate_pink_into performs on each pixel
+    void PinkLayers::compose_into(float* dst, std::size_t stride, float alpha, float amplitude, int octaves,
+        const GenerateOptions& options) const {
+        if (octaves < 0 || octaves > this->octaves())
+            throw std::invalid_argument("octaves must be in [0," + std::to_string(this->octaves()) + "], got: " + std::to_string(octaves));
+        if (!dst) throw std::invalid_argument("dst must not be null");
+        if (stride < static_cast<std::size_t>(width_)) throw std::invalid_argument("stride must be >= width");
+        if (alpha < 0.0f) alpha = 0.0f;
+        if (amplitude <= 0.0f) amplitude = 1.0f;
+
+        const std::size_t count = octaves == 0 ? means_.size() : static_cast<std::size_t>(octaves);
+        std::vector<float> weights(count);
+        double totalWeight = 0.0;
+        for (std::size_t o = 0; o < count; ++o) {
+            weights[o] = pink_octave_weight(blockSizes_[o], alpha);
+            totalWeight += weights[o];
         }
+
+        const std::uint64_t pixels = static_cast<std::uint64_t>(width_) * static_cast<std::uint64_t>(height_);
+        const StageTimer timer(StatsStage::Accumulate, "pink", pixels, options.threads, options.pool);
+        const AccumulateKernel accumulate = kAccumulateKernels.get();
+        const NormalizeKernel normalize = kNormalizeKernels.get();
+        parallel_for_tiles(width_, height_, width_, kBandRows, options.threads, options.pool, [&](const Tile& band) {
+            for (int y = band.y; y < band.y + band.height; ++y) {
+                float* row = dst + static_cast<std::size_t>(y) * stride;
+                std::fill(row, row + width_, 0.0f);
+                for (std::size_t o = 0; o < count; ++o) {
+                    const int blockSize = blockSizes_[o];
+                    const float weight = weights[o];
+                    const float* means = means_[o].row(y / blockSize).data();
+                    if (blockSize == 1) {
+                        accumulate(row, means, weight, static_cast<std::size_t>(width_));
+                        continue;
+                    }
+                    for (int c = 0, x1 = 0; x1 < width_; ++c, x1 += blockSize) {
+                        const float value = means[c] * weight;
+                        const int x2 = std::min(x1 + blockSize, width_);
+                        for (int x = x1; x < x2; ++x) row[x] += value;
+                    }
+                }
+                normalize(row, static_cast<float>(totalWeight), amplitude, static_cast<std::size_t>(width_));
+            }
+        });
+    }
+
+    NoiseMap PinkLayers::compose(float alpha, float amplitude, int octaves, const GenerateOptions& options) const {
+        NoiseMap out = [&] {
+            const StageTimer timer(StatsStage::Setup, "pink", 0);
+            return NoiseMap(width_, height_);
+        }();
+        compose_into(out.data(), out.stride(), alpha, amplitude, octaves, options);
         return out;
     }
 
     // Save image uses previous utility style: single-channel
-    void save_pink_image(const std::vector<std::vector<float>>& noise, const std::string& filename, const std::string& outputDir) {
+    void save_pink_image(const NoiseMap& noise, const std::string& filename, const std::string& outputDir, const ImageSaveOptions& imageOptions) {
+        if (noise.empty()) throw std::invalid_argument("Cannot save empty pink map.");
+        ImageSaveOptions saveOptions = imageOptions;
+        if (saveOptions.jpegQuality == 0) saveOptions.jpegQuality = 95;
+        std::filesystem::path file = save_noise_image(noise, filename, outputDir, saveOptions);
+        if (std::ostream* log = log_stream()) *log << "[OK] Pink noise saved at: " << file.string() << "\n";
+    }
+
+    void save_pink_image(const std::vector<std::vector<float>>& noise, const std::string& filename, const std::string& outputDir, const ImageSaveOptions& imageOptions) {
         if (noise.empty() || noise[0].empty()) throw std::invalid_argument("Cannot save empty pink map.");
-        int height = static_cast<int>(noise.size());
-        int width = static_cast<int>(noise[0].size());
-        std::vector<unsigned char> img(width * height);
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                img[y * width + x] = static_cast<unsigned char>(std::clamp(noise[y][x], 0.0f, 1.0f) * 255.0f);
-        std::filesystem::path outDir =
-    outputDir.empty()
-        ? (std::filesystem::current_path().parent_path() / "ImageOutput")
-        : std::filesystem::path(outputDir);
-
-        std::filesystem::create_directories(outDir);
-        std::filesystem::path file = outDir / filename;
-        std::string ext = file.extension().string();
-        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-        int res = 0;
-        if (ext == ".jpg" || ext == ".jpeg") res = stbi_write_jpg(file.string().c_str(), width, height, 1, img.data(), 95);
-        else res = stbi_write_png(file.string().c_str(), width, height, 1, img.data(), width);
-        if (res == 0) throw std::runtime_error("Failed to write pink noise image: " + file.string());
-        std::cout << "[OK] Pink noise saved at: " << file.string() << "\n";
+        save_pink_image(NoiseMap::from_vector(noise), filename, outputDir, imageOptions);
     }
 
     std::vector<std::vector<float>> create_pinknoise(
@@ -393,9 +1265,24 @@ namespace Noise {
         const std::string& filename,
         const std::string& outputDir
     ) {
-        auto map = generate_pink_map(width, height, octaves, alpha, sampleRate, amplitude, seed);
+        if (mode == OutputMode::Mmap) {
+            // Generated in place into the mapped file; the returned copy is read back from it
+            std::filesystem::path file = resolve_raw_path(filename, outputDir);
+            MappedRawMap mapped = MappedRawMap::generate(file, width, height, [&](float* dst, std::size_t stride) {
+                generate_pink_into(dst, stride, width, height, octaves, alpha, sampleRate, amplitude, seed);
+            });
+            if (std::ostream* log = log_stream()) *log << "[OK] Pink noise raw map saved at: " << file.string() << "\n";
+            return mapped.to_noisemap().to_vector();
+        }
+
+        auto map = generate_pink_noisemap(width, height, octaves, alpha, sampleRate, amplitude, seed);
         if (mode == OutputMode::Image) save_pink_image(map, filename, outputDir);
-        return map;
+        if (mode == OutputMode::Raw) {
+            std::filesystem::path file = resolve_raw_path(filename, outputDir);
+            save_raw_map(map, file);
+            if (std::ostream* log = log_stream()) *log << "[OK] Pink noise raw map saved at: " << file.string() << "\n";
+        }
+        return map.to_vector();
     }
 
 } // namespace Noise
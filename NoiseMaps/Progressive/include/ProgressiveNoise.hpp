@@ -0,0 +1,92 @@
+// ProgressiveNoise.hpp
+// --------------------
+// Progressive Perlin / Simplex maps for interactive previews. Each step adds
+// work to a map that is usable after every step: first whole maps at reduced
+// resolution, then the full-resolution octaves one by one, where octaves not yet
+// computed at full resolution are taken from the finest coarse level. Every
+// octave layer is kept, so changing only the persistence (or dropping octaves)
+// re-weights the cached layers without evaluating any noise. The finished map
+// equals generate_perlin_noisemap / generate_simplex_noisemap bit for bit.
+//
+// Usage:
+//   Noise::PerlinNoise perlin(42);
+//   Noise::ProgressiveNoise progressive(perlin, 2048, 2048, params);
+//   while (progressive.step())
+//       show(progressive.preview());              // 1/4, 1/2, then full resolution
+//
+//   params.persistence = 0.65f;                   // slider moved
+//   progressive.set_params(params);               // weighted sum only
+//   show(progressive.preview());
+
+#pragma once
+#include <vector>
+#include "Noise.hpp"
+#include "NoiseMap.hpp"
+#include "GenerateOptions.hpp"
+
+namespace Noise {
+
+    struct ProgressiveOptions {
+        // Reduced-resolution levels before full resolution: level L samples every
+        // 2^L-th world pixel on both axes. The coarsest level is the first preview.
+        int coarseLevels = 2;
+        // Full-resolution octaves added per step (coarse levels run whole)
+        int octavesPerStep = 1;
+        GenerateOptions generate;   // threads / pool / tile size of every step
+    };
+
+    class ProgressiveNoise {
+    public:
+        // `generator` must outlive this object. Nothing is evaluated before step().
+        ProgressiveNoise(const PerlinNoise& generator, int width, int height, const PerlinParams& params,
+            const ProgressiveOptions& options = {});
+        ProgressiveNoise(const SimplexNoise& generator, int width, int height, const SimplexParams& params,
+            const ProgressiveOptions& options = {});
+
+        // Runs the next step and updates preview(); false when there was nothing left to do
+        bool step();
+
+        // Runs every remaining step and returns the full-resolution map
+        const NoiseMap& finish();
+
+        // True when every octave exists at full resolution
+        bool complete() const;
+
+        // Current map: ceil(width / 2^level()) x ceil(height / 2^level()) pixels,
+        // pixel (x, y) being world pixel (x << level(), y << level()). Empty before
+        // the first step.
+        const NoiseMap& preview() const { return preview_; }
+        int level() const { return previewLevel_; }
+
+        // Octaves computed at full resolution so far
+        int octaves_done() const;
+
+        // New parameters. Persistence and the octave count re-weight the cached
+        // layers (new octaves are computed by later steps); any other change
+        // discards them and starts over from the coarsest level. Perlin objects
+        // take PerlinParams, Simplex objects SimplexParams.
+        void set_params(const PerlinParams& params);
+        void set_params(const SimplexParams& params);
+
+        // Discards every layer and the preview
+        void reset();
+
+    private:
+        void assign(const PerlinParams& params);
+        void evaluate_layer(int level, int octave);
+        void compose(int level);
+        int find_level_with_layers() const;
+
+        const PerlinNoise* perlin_ = nullptr;
+        const SimplexNoise* simplex_ = nullptr;
+        int width_;
+        int height_;
+        PerlinParams params_;               // Simplex: frequency 1
+        ProgressiveOptions options_;
+        std::vector<float> frequencies_;    // per octave, same running product as the generators
+        std::vector<std::vector<NoiseMap>> layers_; // [level][octave]: raw noise, empty = not computed
+        NoiseMap preview_;
+        int previewLevel_ = 0;
+    };
+
+} // namespace Noise
@@ -0,0 +1,257 @@
+// ProgressiveNoise.cpp
+#include "ProgressiveNoise.hpp"
+#include "FractalParams.hpp"
+#include "NoiseStats.hpp"
+#include "OctaveLayers.hpp"
+#include "TileScheduler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace Noise {
+
+    // ---------------------------------------------------------
+    // Construction and parameters
+    // ---------------------------------------------------------
+    static void validate_progressive_params(int width, int height, const PerlinParams& p, const ProgressiveOptions& options) {
+        if (width <= 0)
+            throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
+        if (height <= 0)
+            throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
+        validate_fractal_params(p);
+        if (options.coarseLevels < 0 || options.coarseLevels > 16)
+            throw std::invalid_argument("coarseLevels must be in [0,16], got: " + std::to_string(options.coarseLevels));
+        if (options.octavesPerStep < 1)
+            throw std::invalid_argument("octavesPerStep must be >= 1, got: " + std::to_string(options.octavesPerStep));
+    }
+
+    ProgressiveNoise::ProgressiveNoise(const PerlinNoise& generator, int width, int height, const PerlinParams& params,
+        const ProgressiveOptions& options)
+        : perlin_(&generator), width_(width), height_(height), options_(options) {
+        validate_progressive_params(width, height, params, options);
+        layers_.resize(static_cast<std::size_t>(options.coarseLevels) + 1);
+        assign(params);
+    }
+
+    ProgressiveNoise::ProgressiveNoise(const SimplexNoise& generator, int width, int height, const SimplexParams& params,
+        const ProgressiveOptions& options)
+        : simplex_(&generator), width_(width), height_(height), options_(options) {
+        validate_progressive_params(width, height, as_fractal_params<PerlinParams>(params), options);
+        layers_.resize(static_cast<std::size_t>(options.coarseLevels) + 1);
+        assign(as_fractal_params<PerlinParams>(params));
+    }
+
+    // Layers depend on scale, frequency, lacunarity and base; persistence only
+    // weights them and the octave count only selects them
+    void ProgressiveNoise::assign(const PerlinParams& params) {
+        const bool keepLayers = !frequencies_.empty() && params.scale == params_.scale && params.frequency == params_.frequency &&
+            params.lacunarity == params_.lacunarity && params.base == params_.base;
+        if (!keepLayers) {
+            for (std::vector<NoiseMap>& level : layers_) level.clear();
+            frequencies_.clear();
+        }
+        params_ = params;
+
+        float freq = frequencies_.empty() ? params.frequency : frequencies_.back() * params.lacunarity;
+        while (static_cast<int>(frequencies_.size()) < params.octaves) {
+            frequencies_.push_back(freq);
+            freq *= params.lacunarity;
+        }
+        for (std::vector<NoiseMap>& level : layers_) {
+            if (static_cast<int>(level.size()) < params.octaves) level.resize(static_cast<std::size_t>(params.octaves));
+        }
+
+        const int level = find_level_with_layers();
+        if (level < 0) preview_ = NoiseMap();
+        else compose(level);
+    }
+
+    void ProgressiveNoise::set_params(const PerlinParams& params) {
+        if (!perlin_)
+            throw std::invalid_argument("set_params: PerlinParams given to a Simplex ProgressiveNoise");
+        validate_progressive_params(width_, height_, params, options_);
+        assign(params);
+    }
+
+    void ProgressiveNoise::set_params(const SimplexParams& params) {
+        if (!simplex_)
+            throw std::invalid_argument("set_params: SimplexParams given to a Perlin ProgressiveNoise");
+        validate_progressive_params(width_, height_, as_fractal_params<PerlinParams>(params), options_);
+        assign(as_fractal_params<PerlinParams>(params));
+    }
+
+    void ProgressiveNoise::reset() {
+        for (std::vector<NoiseMap>& level : layers_) {
+            for (NoiseMap& layer : level) layer = NoiseMap();
+        }
+        preview_ = NoiseMap();
+        previewLevel_ = 0;
+    }
+
+    // ---------------------------------------------------------
+    // Steps
+    // ---------------------------------------------------------
+    // Finest level holding at least one of the current octaves, or -1
+    int ProgressiveNoise::find_level_with_layers() const {
+        for (int level = 0; level < static_cast<int>(layers_.size()); ++level) {
+            for (int o = 0; o < params_.octaves; ++o) {
+                if (!layers_[static_cast<std::size_t>(level)][static_cast<std::size_t>(o)].empty()) return level;
+            }
+        }
+        return -1;
+    }
+
+    bool ProgressiveNoise::step() {
+        // Coarsest level with missing octaves: coarse levels are filled in one step,
+        // full resolution octavesPerStep octaves at a time
+        for (int level = static_cast<int>(layers_.size()) - 1; level >= 0; --level) {
+            std::vector<NoiseMap>& layers = layers_[static_cast<std::size_t>(level)];
+            int budget = level > 0 ? params_.octaves : options_.octavesPerStep;
+            bool ran = false;
+            for (int o = 0; o < params_.octaves && budget > 0; ++o) {
+                if (!layers[static_cast<std::size_t>(o)].empty()) continue;
+                evaluate_layer(level, o);
+                --budget;
+                ran = true;
+            }
+            if (ran) {
+                compose(find_level_with_layers());
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const NoiseMap& ProgressiveNoise::finish() {
+        while (step()) {}
+        return preview_;
+    }
+
+    bool ProgressiveNoise::complete() const {
+        return octaves_done() == params_.octaves;
+    }
+
+    int ProgressiveNoise::octaves_done() const {
+        const std::vector<NoiseMap>& full = layers_.front();
+        return static_cast<int>(std::count_if(full.begin(), full.begin() + params_.octaves,
+            [](const NoiseMap& layer) { return !layer.empty(); }));
+    }
+
+    // ---------------------------------------------------------
+    // Layers and composition
+    // ---------------------------------------------------------
+    // Raw noise of one octave at one level, sampled exactly like the map generators
+    void ProgressiveNoise::evaluate_layer(int level, int octave) {
+        const int w = ((width_ - 1) >> level) + 1;
+        const int h = ((height_ - 1) >> level) + 1;
+        NoiseMap layer = [&] {
+            const StageTimer timer(StatsStage::Setup, perlin_ ? "perlin" : "simplex", 0);
+            return NoiseMap(w, h);
+        }();
+        const GenerateOptions& options = options_.generate;
+        const StageTimer timer(StatsStage::Evaluate, perlin_ ? "perlin" : "simplex",
+            static_cast<std::uint64_t>(w) * static_cast<std::uint64_t>(h), options.threads, options.pool);
+
+        const float freq = frequencies_[static_cast<std::size_t>(octave)];
+        const float scale = params_.scale;
+        const float base = params_.base;
+        parallel_for_tiles(w, h, options.tileSize, options.tileSize, options.threads, options.pool, [&](const Tile& tile) {
+            constexpr int chunk = 64;
+            alignas(64) float xs[chunk];
+            alignas(64) float ys[chunk];
+
+            const int xEnd = tile.x + tile.width;
+            for (int y = tile.y; y < tile.y + tile.height; ++y) {
+                float* row = layer.row(y).data();
+                const float ny = (static_cast<float>(static_cast<std::int64_t>(y) << level) + base) / scale * freq;
+                std::fill(ys, ys + chunk, ny);
+                for (int x0 = tile.x; x0 < xEnd; x0 += chunk) {
+                    const int n = std::min(chunk, xEnd - x0);
+                    for (int i = 0; i < n; ++i)
+                        xs[i] = (static_cast<float>(static_cast<std::int64_t>(x0 + i) << level) + base) / scale * freq;
+                    if (perlin_) perlin_->noise_batch(xs, ys, row + x0, static_cast<std::size_t>(n));
+                    else simplex_->noise2D_batch(xs, ys, row + x0, static_cast<std::size_t>(n));
+                }
+            }
+        });
+        layers_[static_cast<std::size_t>(level)][static_cast<std::size_t>(octave)] = std::move(layer);
+    }
+
+    // Preview at `level`: each octave comes from that level or, while missing
+    // there, from the finest coarser level holding it (nearest pixel). Octaves
+    // missing everywhere are left out of the sum and of its normalization.
+    void ProgressiveNoise::compose(int level) {
+        struct Source {
+            const NoiseMap* layer;
+            int shift;          // level difference to the preview
+            float amplitude;
+        };
+        std::vector<Source> sources;
+        float maxAmplitude = 0.0f;
+        float amplitude = 1.0f;
+        for (int o = 0; o < params_.octaves; ++o) {
+            for (int l = level; l < static_cast<int>(layers_.size()); ++l) {
+                const NoiseMap& layer = layers_[static_cast<std::size_t>(l)][static_cast<std::size_t>(o)];
+                if (layer.empty()) continue;
+                sources.push_back({ &layer, l - level, amplitude });
+                maxAmplitude += amplitude;
+                break;
+            }
+            amplitude *= params_.persistence;
+        }
+
+        const int w = ((width_ - 1) >> level) + 1;
+        const int h = ((height_ - 1) >> level) + 1;
+        if (preview_.width() != w || preview_.height() != h || previewLevel_ != level) {
+            const StageTimer timer(StatsStage::Setup, "progressive", 0);
+            preview_ = NoiseMap(w, h);
+        }
+        previewLevel_ = level;
+
+        const GenerateOptions& options = options_.generate;
+        const StageTimer timer(StatsStage::Accumulate, "progressive",
+            static_cast<std::uint64_t>(w) * static_cast<std::uint64_t>(h), options.threads, options.pool);
+        const bool simplex = simplex_ != nullptr;
+        const bool sameLevel = std::all_of(sources.begin(), sources.end(), [](const Source& s) { return s.shift == 0; });
+        std::vector<float> amplitudes;
+        for (const Source& s : sources) amplitudes.push_back(s.amplitude);
+
+        // Same per-pixel operations, in the same octave order, as the generators' fused loop
+        parallel_for_tiles(w, h, options.tileSize, options.tileSize, options.threads, options.pool, [&](const Tile& tile) {
+            const int xEnd = tile.x + tile.width;
+            std::vector<const float*> rows(sources.size());
+            for (int y = tile.y; y < tile.y + tile.height; ++y) {
+                float* row = preview_.row(y).data();
+                if (sameLevel) {
+                    // every octave at this level (a finished map or a re-weight): one SIMD pass
+                    for (std::size_t k = 0; k < sources.size(); ++k) rows[k] = sources[k].layer->row(y).data() + tile.x;
+                    weighted_sum(row + tile.x, rows.data(), amplitudes.data(), sources.size(), static_cast<std::size_t>(tile.width));
+                }
+                else {
+                    std::fill(row + tile.x, row + xEnd, 0.0f);
+                    for (const Source& s : sources) {
+                        const float* src = s.layer->row(y >> s.shift).data();
+                        if (s.shift == 0) {
+                            for (int x = tile.x; x < xEnd; ++x)
+                                row[x] += src[x] * s.amplitude;
+                        }
+                        else {
+                            for (int x = tile.x; x < xEnd; ++x)
+                                row[x] += src[x >> s.shift] * s.amplitude;
+                        }
+                    }
+                }
+                if (simplex) {
+                    for (int x = tile.x; x < xEnd; ++x)
+                        row[x] = FractalTraits<SimplexNoise>::normalize(row[x], maxAmplitude);
+                }
+                else {
+                    for (int x = tile.x; x < xEnd; ++x)
+                        row[x] = FractalTraits<PerlinNoise>::normalize(row[x], maxAmplitude);
+                }
+            }
+        });
+    }
+
+} // namespace Noise
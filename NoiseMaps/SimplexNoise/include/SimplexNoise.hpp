@@ -7,18 +7,54 @@
 //   auto map = Noise::create_simplexnoise(512, 512, 40.0f, 5, 0.5f, 2.2f, 0.0f, 42, "image", "SimplexNoise.png");
 
 #pragma once
+#include <array>
 #include <vector>
 #include <string>
+#include <cstddef>
+#include <cstdint>
+#include "NoiseMap.hpp"
+#include "GenerateOptions.hpp"
+#include "ChunkCache.hpp"
+#include "FractalNoise.hpp"
+#include "ImageOutput.hpp"
+#include "RawMap.hpp"
 
 namespace Noise {
 
     // Forward declare OutputMode (from Noise.hpp)
     enum class OutputMode;
 
+    // Lattice indices of a periodic window for noise2D_periodic_batch, precomputed
+    // so the kernels never take a modulo: the permutation index of every lattice
+    // column and row the window (with cell shifts shiftX, shiftY) can touch, and
+    // the column offset that wraps a row back into the period.
+    // Covers window coordinates in [0, extentX] x [0, extentY].
+    class SimplexWrapTable {
+    public:
+        SimplexWrapTable(int periodX, int periodY, std::int64_t shiftX, std::int64_t shiftY, int extentX, int extentY);
+
+        int period_x() const { return periodX_; }
+        int period_y() const { return periodY_; }
+        const std::int32_t* columns() const { return columns_.data(); }
+        const std::int32_t* rows() const { return rows_.data(); }
+        const std::int32_t* row_offsets() const { return rowOffsets_.data(); }
+
+    private:
+        int periodX_;
+        int periodY_;
+        std::vector<std::int32_t> columns_;
+        std::vector<std::int32_t> rows_;
+        std::vector<std::int32_t> rowOffsets_;
+    };
+
     class SimplexNoise {
     private:
-        std::vector<int> perm;
-        const float grad3[8][2] = {
+        // Inline tables: 256 shuffled bytes repeated twice, and the gradient index
+        // perm[i] % 8 of every entry. The 4 trailing bytes let 32-bit gathers read
+        // the last entry without going past the array.
+        alignas(64) std::array<std::uint8_t, 512 + 4> perm{};
+        alignas(64) std::array<std::uint8_t, 512 + 4> permMod8{};
+        static constexpr float grad3[8][2] = {
             {1, 1}, {-1, 1}, {1, -1}, {-1, -1},
             {1, 0}, {-1, 0}, {0, 1}, {0, -1}
         };
@@ -29,9 +65,87 @@ namespace Noise {
     public:
         explicit SimplexNoise(int seed = -1);
         float noise2D(float xin, float yin) const;
+
+        // The 512-entry permutation table (256 shuffled bytes repeated twice); the
+        // gradient index of entry i is permutation()[i] & 7
+        const std::uint8_t* permutation() const { return perm.data(); }
+
+        // Batched noise2D(): out[i] = noise2D(x[i], y[i]) for i < count, bit-for-bit
+        // identical to the scalar path. Branchless (mask-based) AVX-512 / AVX2 / NEON
+        // kernels are picked at runtime from the CPU, scalar otherwise.
+        void noise2D_batch(const float* x, const float* y, float* out, std::size_t count) const;
+
+        // Simplex noise repeating every periodX x periodY cells (periods >= 1):
+        // noise2D_periodic(x + periodX, y, ...) == noise2D_periodic(x, y, ...). The
+        // simplex grid cannot repeat along both axes as noise2D lays it out, so this
+        // samples the same kind of grid turned to put one triangle edge along x. A
+        // cell is one edge (sqrt(2/3) noise2D units) wide and two triangle rows
+        // (sqrt(2) units) tall; the values differ from noise2D.
+        float noise2D_periodic(float x, float y, int periodX, int periodY) const;
+
+        // Batched periodic noise over a window: out[i] = noise2D_periodic(x[i] + shiftX,
+        // y[i] + shiftY, periodX, periodY) with the table's shifts and periods, up to
+        // the rounding of that sum. x[i] / y[i] must lie in the table's extent.
+        void noise2D_periodic_batch(const SimplexWrapTable& wrap, const float* x, const float* y,
+            float* out, std::size_t count) const;
+    };
+
+    // FractalNoise<SimplexNoise, N>: the octave sum in [-max, max] is mapped to [0, 1].
+    // The runtime generators start at frequency 1 (pass frequency = 1 to match them).
+    template <>
+    struct FractalTraits<SimplexNoise> {
+        static void noise_batch(const SimplexNoise& noise, const float* x, const float* y, float* out, std::size_t count) {
+            noise.noise2D_batch(x, y, out, count);
+        }
+        static float normalize(float sum, float maxAmplitude) { return (sum / maxAmplitude) * 0.5f + 0.5f; }
     };
 
-    // Generate multi-octave Simplex noise map
+    // Generate multi-octave Simplex noise into a caller-provided buffer: row y starts
+    // at dst + y * stride (stride in floats, >= width). Does not allocate the output;
+    // tiles are spread over options.threads workers with identical results.
+    void generate_simplex_into(
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base = 0.0f,
+        int seed = -1,
+        const GenerateOptions& options = {}
+    );
+
+    // Same as above with a prebuilt generator (skips rebuilding the permutation table)
+    void generate_simplex_into(
+        const SimplexNoise& noiseGen,
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base = 0.0f,
+        const GenerateOptions& options = {}
+    );
+
+    // Generate multi-octave Simplex noise map (contiguous, 64-byte aligned result)
+    NoiseMap generate_simplex_noisemap(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base = 0.0f,
+        int seed = -1,
+        const GenerateOptions& options = {}
+    );
+
+    // Same as generate_simplex_noisemap, copied into a nested vector
     std::vector<std::vector<float>> generate_simplex_map(
         int width,
         int height,
@@ -43,11 +157,143 @@ namespace Noise {
         int seed = -1
     );
 
-    // Save to grayscale PNG or JPEG (auto-detected from extension)
-    // If outputDir is empty, uses default ImageOutput/ directory
+    // Seamlessly tiling multi-octave map: the output repeats exactly at width x
+    // height, with no extra area generated. Each octave samples noise2D_periodic
+    // with periods of round(width / scale * lacunarity^o / sqrt(2/3)) x
+    // round(height / scale * lacunarity^o / sqrt(2)) cells (at least 1), so
+    // features keep the size of generate_simplex_into to within that rounding;
+    // values differ from it. Throws std::invalid_argument for the same arguments
+    // as generate_simplex_into, or when a period exceeds 2^24.
+    void generate_simplex_tileable_into(
+        const SimplexNoise& noiseGen,
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base = 0.0f,
+        const GenerateOptions& options = {}
+    );
+
+    NoiseMap generate_simplex_tileable_noisemap(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base = 0.0f,
+        int seed = -1,
+        const GenerateOptions& options = {}
+    );
+
+    // Fractal settings for the region / chunk API (same meaning as the arguments of
+    // generate_simplex_noisemap)
+    struct SimplexParams {
+        float scale = 40.0f;
+        int octaves = 5;
+        float persistence = 0.5f;
+        float lacunarity = 2.0f;
+        float base = 0.0f;
+    };
+
+    // Generates the width x height window of the infinite noise plane whose top-left
+    // pixel is world pixel (originX, originY). Windows sharing pixels agree exactly,
+    // so neighbouring chunks join without seams. Origin (0, 0) reproduces
+    // generate_simplex_into.
+    void generate_simplex_region_into(
+        const SimplexNoise& noiseGen,
+        const SimplexParams& params,
+        float* dst,
+        std::size_t stride,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const GenerateOptions& options = {}
+    );
+
+    NoiseMap generate_simplex_region(
+        const SimplexNoise& noiseGen,
+        const SimplexParams& params,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const GenerateOptions& options = {}
+    );
+
+    // Square chunk (chunkX, chunkY) of a chunkSize grid over the world. Safe to call
+    // concurrently with one shared generator.
+    NoiseMap generate_simplex_chunk(
+        const SimplexNoise& noiseGen,
+        const SimplexParams& params,
+        std::int64_t chunkX,
+        std::int64_t chunkY,
+        int chunkSize,
+        const GenerateOptions& options = {}
+    );
+
+    // Cache key of generate_simplex_chunk for SimplexNoise(seed) and `params`
+    ChunkKey simplex_chunk_key(int seed, const SimplexParams& params, std::int64_t chunkX, std::int64_t chunkY, int chunkSize);
+
+    // generate_simplex_chunk through `cache` (hits are not copied; seed must be >= 0)
+    ChunkCache::MapPtr generate_simplex_chunk_cached(
+        ChunkCache& cache,
+        int seed,
+        const SimplexParams& params,
+        std::int64_t chunkX,
+        std::int64_t chunkY,
+        int chunkSize,
+        const GenerateOptions& options = {}
+    );
+
+    // Save to grayscale PNG, JPEG or half-float EXR (auto-detected from extension);
+    // PNG / JPEG values are clamped to [0, 1]. If outputDir is empty, uses default ImageOutput/ directory
+    void save_simplex_image(const NoiseMap& noise,
+        const std::string& filename = "simplex_noise.png",
+        const std::string& outputDir = "",
+        const ImageSaveOptions& imageOptions = {});
+
     void save_simplex_image(const std::vector<std::vector<float>>& noise,
         const std::string& filename = "simplex_noise.png",
-        const std::string& outputDir = "");
+        const std::string& outputDir = "",
+        const ImageSaveOptions& imageOptions = {});
+
+    // Generates a region band by band straight into a PNG (generation of the next
+    // band overlaps encoding of the current one); same pixels as
+    // save_simplex_image(generate_simplex_region(...))
+    void save_simplex_region_image(
+        const SimplexNoise& noiseGen,
+        const SimplexParams& params,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const std::string& filename = "simplex_noise.png",
+        const std::string& outputDir = "",
+        const GenerateOptions& options = {},
+        const ImageSaveOptions& imageOptions = {}
+    );
+
+    // Generates a region tile by tile into a tiled .rnm file (see write_tiled_raw_map):
+    // peak memory is one tile per worker, so the map may be far larger than RAM.
+    // Same pixels as generate_simplex_region(...)
+    void save_simplex_tiled_raw(
+        const SimplexNoise& noiseGen,
+        const SimplexParams& params,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const std::string& filename = "simplex_noise.rnm",
+        const std::string& outputDir = "",
+        const RawTileOptions& rawOptions = {},
+        const GenerateOptions& options = {}
+    );
 
     // Entry wrapper  same structure as other noise types
     std::vector<std::vector<float>> create_simplexnoise(
@@ -1,11 +1,21 @@
 ﻿#include "Noise.hpp"  // full OutputMode definition
 #include "SimplexNoise.hpp"
 #include <random>
+#include <cstdint>
 #include <cmath>
 #include <iostream>
 #include <algorithm> // for std::shuffle, std::clamp
 #include <filesystem>
-#include "stb_image_write.h"
+#include "CpuFeatures.hpp"
+#include "NoiseStats.hpp"
+#include "TileScheduler.hpp"
+#include "RawMap.hpp"
+
+#if defined(RELNO_ARCH_X86)
+#include <immintrin.h>
+#elif defined(RELNO_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
 
 #ifndef __cpp_lib_clamp
 namespace std {
@@ -23,10 +33,9 @@ namespace Noise {
     // Constructor � creates permutation table
     // ---------------------------------------------------------
     SimplexNoise::SimplexNoise(int seed) {
-        perm.resize(512);
-        std::vector<int> p(256);
+        std::array<std::uint8_t, 256> p;
         for (int i = 0; i < 256; ++i)
-            p[i] = i;
+            p[i] = static_cast<std::uint8_t>(i);
 
         if (seed >= 0) {
             std::mt19937 rng(seed);
@@ -38,13 +47,17 @@ namespace Noise {
             std::shuffle(p.begin(), p.end(), rng);
         }
 
-        for (int i = 0; i < 512; ++i)
+        for (int i = 0; i < 512; ++i) {
             perm[i] = p[i & 255];
+            permMod8[i] = static_cast<std::uint8_t>(p[i & 255] & 7);
+        }
     }
 
     // ---------------------------------------------------------
     // 2D Simplex noise: returns value in [-1, 1]
     // ---------------------------------------------------------
+    // Corner selection and the t >= 0 falloff are plain selects (no data-dependent
+    // branches); the batched kernels below run the same sequence with lane masks.
     float SimplexNoise::noise2D(float xin, float yin) const {
         float s = (xin + yin) * F2;
         int i = static_cast<int>(std::floor(xin + s));
@@ -56,9 +69,9 @@ namespace Noise {
         float x0 = xin - X0;
         float y0 = yin - Y0;
 
-        int i1, j1;
-        if (x0 > y0) { i1 = 1; j1 = 0; }
-        else { i1 = 0; j1 = 1; }
+        // lower (x0 > y0) or upper triangle
+        int i1 = (x0 > y0) ? 1 : 0;
+        int j1 = 1 - i1;
 
         float x1 = x0 - i1 + G2;
         float y1 = y0 - j1 + G2;
@@ -67,49 +80,481 @@ namespace Noise {
 
         int ii = i & 255;
         int jj = j & 255;
-        int gi0 = perm[ii + perm[jj]] % 8;
-        int gi1 = perm[ii + i1 + perm[jj + j1]] % 8;
-        int gi2 = perm[ii + 1 + perm[jj + 1]] % 8;
-
-        float n0, n1, n2;
-        n0 = n1 = n2 = 0.0f;
+        int gi0 = permMod8[ii + perm[jj]];
+        int gi1 = permMod8[ii + i1 + perm[jj + j1]];
+        int gi2 = permMod8[ii + 1 + perm[jj + 1]];
 
         float t0 = 0.5f - x0 * x0 - y0 * y0;
-        if (t0 >= 0.0f) {
-            t0 *= t0;
-            n0 = t0 * t0 * (grad3[gi0][0] * x0 + grad3[gi0][1] * y0);
-        }
+        float t0sq = t0 * t0;
+        float n0 = (t0 >= 0.0f) ? t0sq * t0sq * (grad3[gi0][0] * x0 + grad3[gi0][1] * y0) : 0.0f;
 
         float t1 = 0.5f - x1 * x1 - y1 * y1;
-        if (t1 >= 0.0f) {
-            t1 *= t1;
-            n1 = t1 * t1 * (grad3[gi1][0] * x1 + grad3[gi1][1] * y1);
-        }
+        float t1sq = t1 * t1;
+        float n1 = (t1 >= 0.0f) ? t1sq * t1sq * (grad3[gi1][0] * x1 + grad3[gi1][1] * y1) : 0.0f;
 
         float t2 = 0.5f - x2 * x2 - y2 * y2;
-        if (t2 >= 0.0f) {
-            t2 *= t2;
-            n2 = t2 * t2 * (grad3[gi2][0] * x2 + grad3[gi2][1] * y2);
-        }
+        float t2sq = t2 * t2;
+        float n2 = (t2 >= 0.0f) ? t2sq * t2sq * (grad3[gi2][0] * x2 + grad3[gi2][1] * y2) : 0.0f;
 
         // Scale constant for 2D
         return 70.0f * (n0 + n1 + n2);
     }
 
     // ---------------------------------------------------------
-    // Multi-octave Simplex map generator
+    // Batched Simplex kernels
     // ---------------------------------------------------------
-    std::vector<std::vector<float>> generate_simplex_map(
+    // Same operation sequence as noise2D() per lane, so results are bit-for-bit
+    // identical. The simplex corner is chosen with a compare mask, each corner's
+    // contribution is masked to zero where t < 0, and the 8 gradients are read
+    // with an in-register permute instead of the grad3 table. Tables are read with
+    // 32-bit gathers at byte offsets; the permutes only use the low index bits, so
+    // gradient indices from permMod8 need no mask.
+    using SimplexBatchKernel = void (*)(const std::uint8_t* perm, const std::uint8_t* permMod8,
+        const float* xs, const float* ys, float* out, std::size_t count);
+
+    // grad3 split into components
+    alignas(64) static const float kGradX[16] = { 1, -1, 1, -1, 1, -1, 0, 0, 1, -1, 1, -1, 1, -1, 0, 0 };
+    alignas(64) static const float kGradY[16] = { 1, 1, -1, -1, 0, 0, 1, -1, 1, 1, -1, -1, 0, 0, 1, -1 };
+
+#if defined(RELNO_ARCH_X86)
+    RELNO_TARGET_AVX2
+    static inline __m256 simplex_corner_avx2(__m256 x, __m256 y, __m256i gi, __m256 gx, __m256 gy) {
+        const __m256 t = _mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(0.5f), _mm256_mul_ps(x, x)), _mm256_mul_ps(y, y));
+        const __m256 tsq = _mm256_mul_ps(t, t);
+        const __m256 dot = _mm256_add_ps(
+            _mm256_mul_ps(_mm256_permutevar8x32_ps(gx, gi), x),
+            _mm256_mul_ps(_mm256_permutevar8x32_ps(gy, gi), y));
+        const __m256 n = _mm256_mul_ps(_mm256_mul_ps(tsq, tsq), dot);
+        return _mm256_and_ps(_mm256_cmp_ps(t, _mm256_setzero_ps(), _CMP_GE_OQ), n);
+    }
+
+    RELNO_TARGET_AVX2
+    static inline __m256i simplex_gather_avx2(const std::uint8_t* table, __m256i idx) {
+        return _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), idx, 1);
+    }
+
+    RELNO_TARGET_AVX2
+    static void simplex_noise_avx2(const std::uint8_t* perm, const std::uint8_t* permMod8,
+        const float* xs, const float* ys, float* out, std::size_t count) {
+        const __m256 F2v = _mm256_set1_ps(0.36602540378f);
+        const __m256 G2v = _mm256_set1_ps(0.2113248654f);
+        const __m256 G2x2 = _mm256_set1_ps(2.0f * 0.2113248654f);
+        const __m256 onef = _mm256_set1_ps(1.0f);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i mask255 = _mm256_set1_epi32(255);
+        const __m256 gx = _mm256_load_ps(kGradX);
+        const __m256 gy = _mm256_load_ps(kGradY);
+
+        std::size_t k = 0;
+        for (; k + 8 <= count; k += 8) {
+            const __m256 xin = _mm256_loadu_ps(xs + k);
+            const __m256 yin = _mm256_loadu_ps(ys + k);
+            const __m256 s = _mm256_mul_ps(_mm256_add_ps(xin, yin), F2v);
+            const __m256i i = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(xin, s)));
+            const __m256i j = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(yin, s)));
+
+            const __m256 t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(i, j)), G2v);
+            const __m256 x0 = _mm256_sub_ps(xin, _mm256_sub_ps(_mm256_cvtepi32_ps(i), t));
+            const __m256 y0 = _mm256_sub_ps(yin, _mm256_sub_ps(_mm256_cvtepi32_ps(j), t));
+
+            // i1 = x0 > y0, j1 = 1 - i1 (as 0/1 integers)
+            const __m256i lower = _mm256_castps_si256(_mm256_cmp_ps(x0, y0, _CMP_GT_OQ));
+            const __m256i i1 = _mm256_and_si256(lower, one);
+            const __m256i j1 = _mm256_sub_epi32(one, i1);
+
+            const __m256 x1 = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_cvtepi32_ps(i1)), G2v);
+            const __m256 y1 = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_cvtepi32_ps(j1)), G2v);
+            const __m256 x2 = _mm256_add_ps(_mm256_sub_ps(x0, onef), G2x2);
+            const __m256 y2 = _mm256_add_ps(_mm256_sub_ps(y0, onef), G2x2);
+
+            const __m256i ii = _mm256_and_si256(i, mask255);
+            const __m256i jj = _mm256_and_si256(j, mask255);
+            const __m256i pj0 = _mm256_and_si256(simplex_gather_avx2(perm, jj), mask255);
+            const __m256i pj1 = _mm256_and_si256(simplex_gather_avx2(perm, _mm256_add_epi32(jj, j1)), mask255);
+            const __m256i pj2 = _mm256_and_si256(simplex_gather_avx2(perm, _mm256_add_epi32(jj, one)), mask255);
+            const __m256i gi0 = simplex_gather_avx2(permMod8, _mm256_add_epi32(ii, pj0));
+            const __m256i gi1 = simplex_gather_avx2(permMod8, _mm256_add_epi32(_mm256_add_epi32(ii, i1), pj1));
+            const __m256i gi2 = simplex_gather_avx2(permMod8, _mm256_add_epi32(_mm256_add_epi32(ii, one), pj2));
+
+            const __m256 n0 = simplex_corner_avx2(x0, y0, gi0, gx, gy);
+            const __m256 n1 = simplex_corner_avx2(x1, y1, gi1, gx, gy);
+            const __m256 n2 = simplex_corner_avx2(x2, y2, gi2, gx, gy);
+            const __m256 sum = _mm256_add_ps(_mm256_add_ps(n0, n1), n2);
+            _mm256_storeu_ps(out + k, _mm256_mul_ps(_mm256_set1_ps(70.0f), sum));
+        }
+    }
+
+    RELNO_TARGET_AVX512
+    static inline __m512 simplex_corner_avx512(__m512 x, __m512 y, __m512i gi, __m512 gx, __m512 gy) {
+        const __m512 t = _mm512_sub_ps(_mm512_sub_ps(_mm512_set1_ps(0.5f), _mm512_mul_ps(x, x)), _mm512_mul_ps(y, y));
+        const __m512 tsq = _mm512_mul_ps(t, t);
+        const __m512 dot = _mm512_add_ps(
+            _mm512_mul_ps(_mm512_permutexvar_ps(gi, gx), x),
+            _mm512_mul_ps(_mm512_permutexvar_ps(gi, gy), y));
+        const __m512 n = _mm512_mul_ps(_mm512_mul_ps(tsq, tsq), dot);
+        return _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(t, _mm512_setzero_ps(), _CMP_GE_OQ), n);
+    }
+
+    RELNO_TARGET_AVX512
+    static void simplex_noise_avx512(const std::uint8_t* perm, const std::uint8_t* permMod8,
+        const float* xs, const float* ys, float* out, std::size_t count) {
+        const __m512 F2v = _mm512_set1_ps(0.36602540378f);
+        const __m512 G2v = _mm512_set1_ps(0.2113248654f);
+        const __m512 G2x2 = _mm512_set1_ps(2.0f * 0.2113248654f);
+        const __m512 onef = _mm512_set1_ps(1.0f);
+        const __m512i one = _mm512_set1_epi32(1);
+        const __m512i mask255 = _mm512_set1_epi32(255);
+        const __m512 gx = _mm512_load_ps(kGradX);
+        const __m512 gy = _mm512_load_ps(kGradY);
+
+        std::size_t k = 0;
+        for (; k + 16 <= count; k += 16) {
+            const __m512 xin = _mm512_loadu_ps(xs + k);
+            const __m512 yin = _mm512_loadu_ps(ys + k);
+            const __m512 s = _mm512_mul_ps(_mm512_add_ps(xin, yin), F2v);
+            const __m512i i = _mm512_cvttps_epi32(
+                _mm512_roundscale_ps(_mm512_add_ps(xin, s), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+            const __m512i j = _mm512_cvttps_epi32(
+                _mm512_roundscale_ps(_mm512_add_ps(yin, s), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+
+            const __m512 t = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_add_epi32(i, j)), G2v);
+            const __m512 x0 = _mm512_sub_ps(xin, _mm512_sub_ps(_mm512_cvtepi32_ps(i), t));
+            const __m512 y0 = _mm512_sub_ps(yin, _mm512_sub_ps(_mm512_cvtepi32_ps(j), t));
+
+            const __mmask16 lower = _mm512_cmp_ps_mask(x0, y0, _CMP_GT_OQ);
+            const __m512i i1 = _mm512_maskz_mov_epi32(lower, one);
+            const __m512i j1 = _mm512_sub_epi32(one, i1);
+
+            const __m512 x1 = _mm512_add_ps(_mm512_sub_ps(x0, _mm512_cvtepi32_ps(i1)), G2v);
+            const __m512 y1 = _mm512_add_ps(_mm512_sub_ps(y0, _mm512_cvtepi32_ps(j1)), G2v);
+            const __m512 x2 = _mm512_add_ps(_mm512_sub_ps(x0, onef), G2x2);
+            const __m512 y2 = _mm512_add_ps(_mm512_sub_ps(y0, onef), G2x2);
+
+            const __m512i ii = _mm512_and_si512(i, mask255);
+            const __m512i jj = _mm512_and_si512(j, mask255);
+            const __m512i pj0 = _mm512_and_si512(_mm512_i32gather_epi32(jj, perm, 1), mask255);
+            const __m512i pj1 = _mm512_and_si512(_mm512_i32gather_epi32(_mm512_add_epi32(jj, j1), perm, 1), mask255);
+            const __m512i pj2 = _mm512_and_si512(_mm512_i32gather_epi32(_mm512_add_epi32(jj, one), perm, 1), mask255);
+            const __m512i gi0 = _mm512_i32gather_epi32(_mm512_add_epi32(ii, pj0), permMod8, 1);
+            const __m512i gi1 = _mm512_i32gather_epi32(_mm512_add_epi32(_mm512_add_epi32(ii, i1), pj1), permMod8, 1);
+            const __m512i gi2 = _mm512_i32gather_epi32(_mm512_add_epi32(_mm512_add_epi32(ii, one), pj2), permMod8, 1);
+
+            const __m512 n0 = simplex_corner_avx512(x0, y0, gi0, gx, gy);
+            const __m512 n1 = simplex_corner_avx512(x1, y1, gi1, gx, gy);
+            const __m512 n2 = simplex_corner_avx512(x2, y2, gi2, gx, gy);
+            const __m512 sum = _mm512_add_ps(_mm512_add_ps(n0, n1), n2);
+            _mm512_storeu_ps(out + k, _mm512_mul_ps(_mm512_set1_ps(70.0f), sum));
+        }
+        // remaining 8-wide block (AVX-512F implies AVX2)
+        simplex_noise_avx2(perm, permMod8, xs + k, ys + k, out + k, count - k);
+    }
+#endif // RELNO_ARCH_X86
+
+#if defined(RELNO_ARCH_ARM64)
+    // NEON has no gather: look the four lanes up individually
+    static inline int32x4_t simplex_lookup_neon(const std::uint8_t* perm, int32x4_t idx) {
+        int32_t lanes[4];
+        vst1q_s32(lanes, idx);
+        const int32_t vals[4] = { perm[lanes[0]], perm[lanes[1]], perm[lanes[2]], perm[lanes[3]] };
+        return vld1q_s32(vals);
+    }
+
+    static inline float32x4_t simplex_corner_neon(float32x4_t x, float32x4_t y, int32x4_t gi) {
+        int32_t lanes[4];
+        vst1q_s32(lanes, gi);
+        const float gxs[4] = { kGradX[lanes[0]], kGradX[lanes[1]], kGradX[lanes[2]], kGradX[lanes[3]] };
+        const float gys[4] = { kGradY[lanes[0]], kGradY[lanes[1]], kGradY[lanes[2]], kGradY[lanes[3]] };
+        const float32x4_t t = vsubq_f32(vsubq_f32(vdupq_n_f32(0.5f), vmulq_f32(x, x)), vmulq_f32(y, y));
+        const float32x4_t tsq = vmulq_f32(t, t);
+        const float32x4_t dot = vaddq_f32(vmulq_f32(vld1q_f32(gxs), x), vmulq_f32(vld1q_f32(gys), y));
+        const float32x4_t n = vmulq_f32(vmulq_f32(tsq, tsq), dot);
+        return vreinterpretq_f32_u32(vandq_u32(vcgeq_f32(t, vdupq_n_f32(0.0f)), vreinterpretq_u32_f32(n)));
+    }
+
+    static void simplex_noise_neon(const std::uint8_t* perm, const std::uint8_t* permMod8,
+        const float* xs, const float* ys, float* out, std::size_t count) {
+        const float32x4_t F2v = vdupq_n_f32(0.36602540378f);
+        const float32x4_t G2v = vdupq_n_f32(0.2113248654f);
+        const float32x4_t G2x2 = vdupq_n_f32(2.0f * 0.2113248654f);
+        const float32x4_t onef = vdupq_n_f32(1.0f);
+        const int32x4_t one = vdupq_n_s32(1);
+        const int32x4_t mask255 = vdupq_n_s32(255);
+
+        std::size_t k = 0;
+        for (; k + 4 <= count; k += 4) {
+            const float32x4_t xin = vld1q_f32(xs + k);
+            const float32x4_t yin = vld1q_f32(ys + k);
+            const float32x4_t s = vmulq_f32(vaddq_f32(xin, yin), F2v);
+            const int32x4_t i = vcvtq_s32_f32(vrndmq_f32(vaddq_f32(xin, s)));
+            const int32x4_t j = vcvtq_s32_f32(vrndmq_f32(vaddq_f32(yin, s)));
+
+            const float32x4_t t = vmulq_f32(vcvtq_f32_s32(vaddq_s32(i, j)), G2v);
+            const float32x4_t x0 = vsubq_f32(xin, vsubq_f32(vcvtq_f32_s32(i), t));
+            const float32x4_t y0 = vsubq_f32(yin, vsubq_f32(vcvtq_f32_s32(j), t));
+
+            const int32x4_t i1 = vandq_s32(vreinterpretq_s32_u32(vcgtq_f32(x0, y0)), one);
+            const int32x4_t j1 = vsubq_s32(one, i1);
+
+            const float32x4_t x1 = vaddq_f32(vsubq_f32(x0, vcvtq_f32_s32(i1)), G2v);
+            const float32x4_t y1 = vaddq_f32(vsubq_f32(y0, vcvtq_f32_s32(j1)), G2v);
+            const float32x4_t x2 = vaddq_f32(vsubq_f32(x0, onef), G2x2);
+            const float32x4_t y2 = vaddq_f32(vsubq_f32(y0, onef), G2x2);
+
+            const int32x4_t ii = vandq_s32(i, mask255);
+            const int32x4_t jj = vandq_s32(j, mask255);
+            const int32x4_t gi0 = simplex_lookup_neon(permMod8, vaddq_s32(ii, simplex_lookup_neon(perm, jj)));
+            const int32x4_t gi1 = simplex_lookup_neon(permMod8,
+                vaddq_s32(vaddq_s32(ii, i1), simplex_lookup_neon(perm, vaddq_s32(jj, j1))));
+            const int32x4_t gi2 = simplex_lookup_neon(permMod8,
+                vaddq_s32(vaddq_s32(ii, one), simplex_lookup_neon(perm, vaddq_s32(jj, one))));
+
+            const float32x4_t sum = vaddq_f32(vaddq_f32(simplex_corner_neon(x0, y0, gi0),
+                simplex_corner_neon(x1, y1, gi1)), simplex_corner_neon(x2, y2, gi2));
+            vst1q_f32(out + k, vmulq_f32(vdupq_n_f32(70.0f), sum));
+        }
+    }
+#endif // RELNO_ARCH_ARM64
+
+    // No SSE2 variant (it has no floor and no gathers) and a null scalar slot: the
+    // SSE2 and scalar tiers run the scalar loop
+    static const KernelTable<SimplexBatchKernel> kSimplexKernels = [] {
+        KernelTable<SimplexBatchKernel> t;
+#if defined(RELNO_ARCH_X86)
+        t.avx2 = simplex_noise_avx2;
+        t.avx512 = simplex_noise_avx512;
+#elif defined(RELNO_ARCH_ARM64)
+        t.neon = simplex_noise_neon;
+#endif
+        return t;
+    }();
+
+    void SimplexNoise::noise2D_batch(const float* x, const float* y, float* out, std::size_t count) const {
+        const SimplexBatchKernel kernel = kSimplexKernels.get();
+
+        // Vector kernels process whole SIMD blocks; the scalar loop finishes the tail
+        std::size_t done = 0;
+        if (kernel) {
+            std::size_t blocks = count & ~static_cast<std::size_t>(7);
+            kernel(perm.data(), permMod8.data(), x, y, out, blocks);
+            done = blocks;
+        }
+        for (std::size_t k = done; k < count; ++k)
+            out[k] = noise2D(x[k], y[k]);
+    }
+
+    // ---------------------------------------------------------
+    // Periodic (tileable) noise
+    // ---------------------------------------------------------
+    // Cell (x, y) of the periodic frame is the skewed lattice point (x + y, 2y):
+    // x runs along a triangle edge and y across it, so moving periodX cells along x
+    // or periodY cells along y lands on a lattice point again. A corner (i, j) wraps
+    // to row j mod 2 * periodY, which moves its column back by periodY per wrap,
+    // then to that column mod periodX. Per sample this is noise2D from the skewed
+    // position on, with the corner hashes read from a SimplexWrapTable.
+    static int positive_mod(std::int64_t v, int m) {
+        const int r = static_cast<int>(v % m);
+        return r < 0 ? r + m : r;
+    }
+
+    static std::int64_t floor_div(std::int64_t v, std::int64_t m) {
+        const std::int64_t q = v / m;
+        return (v % m != 0 && v < 0) ? q - 1 : q;
+    }
+
+    SimplexWrapTable::SimplexWrapTable(int periodX, int periodY, std::int64_t shiftX, std::int64_t shiftY, int extentX, int extentY)
+        : periodX_(periodX), periodY_(periodY) {
+        if (periodX < 1 || periodY < 1)
+            throw std::invalid_argument("periods must be >= 1, got: " + std::to_string(periodX) + "x" + std::to_string(periodY));
+        if (extentX < 0 || extentY < 0)
+            throw std::invalid_argument("extents must be >= 0, got: " + std::to_string(extentX) + "x" + std::to_string(extentY));
+        const int sx = positive_mod(shiftX, periodX);
+        const int sy = positive_mod(shiftY, periodY);
+        const std::int64_t rowPeriod = 2 * static_cast<std::int64_t>(periodY);
+
+        // window cell (x, y) is lattice cell (x + sx, y + sy): skewed column x + y + sx + sy, row 2 * (y + sy).
+        // Rows up to 2 * extentY + 2 (the far corner of a cell, plus one for rounding)
+        rows_.resize(2 * static_cast<std::size_t>(extentY) + 4);
+        rowOffsets_.resize(rows_.size());
+        for (std::size_t j = 0; j < rows_.size(); ++j) {
+            const std::int64_t row = static_cast<std::int64_t>(j) + 2 * static_cast<std::int64_t>(sy);
+            const std::int64_t wraps = row / rowPeriod;
+            rows_[j] = static_cast<std::int32_t>((row - wraps * rowPeriod) & 255);
+            rowOffsets_[j] = positive_mod(-wraps * periodY, periodX);
+        }
+        // columns up to extentX + extentY + 2, shifted by a row offset < periodX
+        columns_.resize(static_cast<std::size_t>(extentX) + extentY + periodX + 4);
+        int column = positive_mod(static_cast<std::int64_t>(sx) + sy, periodX);
+        for (std::int32_t& c : columns_) {
+            c = column & 255;
+            if (++column == periodX) column = 0;
+        }
+    }
+
+    // noise2D from the skewed position (integer part i, j; fraction fi, fj) on;
+    // gradient(di, dj) returns the gradient index of corner (i + di, j + dj)
+    template <typename GradientIndex>
+    static inline float simplex_periodic_cell(float fi, float fj, GradientIndex&& gradient) {
+        const float G2 = 0.2113248654f;
+        float t = (fi + fj) * G2;
+        float x0 = fi - t;
+        float y0 = fj - t;
+
+        int i1 = (x0 > y0) ? 1 : 0;
+        int j1 = 1 - i1;
+
+        float x1 = x0 - i1 + G2;
+        float y1 = y0 - j1 + G2;
+        float x2 = x0 - 1.0f + 2.0f * G2;
+        float y2 = y0 - 1.0f + 2.0f * G2;
+
+        int gi0 = gradient(0, 0);
+        int gi1 = gradient(i1, j1);
+        int gi2 = gradient(1, 1);
+
+        float t0 = 0.5f - x0 * x0 - y0 * y0;
+        float t0sq = t0 * t0;
+        float n0 = (t0 >= 0.0f) ? t0sq * t0sq * (kGradX[gi0] * x0 + kGradY[gi0] * y0) : 0.0f;
+
+        float t1 = 0.5f - x1 * x1 - y1 * y1;
+        float t1sq = t1 * t1;
+        float n1 = (t1 >= 0.0f) ? t1sq * t1sq * (kGradX[gi1] * x1 + kGradY[gi1] * y1) : 0.0f;
+
+        float t2 = 0.5f - x2 * x2 - y2 * y2;
+        float t2sq = t2 * t2;
+        float n2 = (t2 >= 0.0f) ? t2sq * t2sq * (kGradX[gi2] * x2 + kGradY[gi2] * y2) : 0.0f;
+
+        return 70.0f * (n0 + n1 + n2);
+    }
+
+    float SimplexNoise::noise2D_periodic(float x, float y, int periodX, int periodY) const {
+        if (periodX < 1 || periodY < 1)
+            throw std::invalid_argument("periods must be >= 1, got: " + std::to_string(periodX) + "x" + std::to_string(periodY));
+        const float si = x + y;
+        const float sj = y + y;
+        const float fsi = std::floor(si);
+        const float fsj = std::floor(sj);
+        const std::int64_t i = static_cast<std::int64_t>(fsi);
+        const std::int64_t j = static_cast<std::int64_t>(fsj);
+        const std::int64_t rowPeriod = 2 * static_cast<std::int64_t>(periodY);
+        return simplex_periodic_cell(si - fsi, sj - fsj, [&](int di, int dj) {
+            const std::int64_t row = j + dj;
+            const std::int64_t wraps = floor_div(row, rowPeriod);
+            const int I = positive_mod(i + di - wraps * periodY, periodX) & 255;
+            const int J = static_cast<int>((row - wraps * rowPeriod) & 255);
+            return static_cast<int>(permMod8[I + perm[J]]);
+        });
+    }
+
+    using SimplexPeriodicKernel = void (*)(const std::uint8_t* perm, const std::uint8_t* permMod8, const SimplexWrapTable& wrap,
+        const float* xs, const float* ys, float* out, std::size_t count);
+
+    static void simplex_periodic_scalar(const std::uint8_t* perm, const std::uint8_t* permMod8, const SimplexWrapTable& wrap,
+        const float* xs, const float* ys, float* out, std::size_t count) {
+        const std::int32_t* columns = wrap.columns();
+        const std::int32_t* rows = wrap.rows();
+        const std::int32_t* rowOffsets = wrap.row_offsets();
+        for (std::size_t k = 0; k < count; ++k) {
+            const float si = xs[k] + ys[k];
+            const float sj = ys[k] + ys[k];
+            const float fsi = std::floor(si);
+            const float fsj = std::floor(sj);
+            const int i = static_cast<int>(fsi);
+            const int j = static_cast<int>(fsj);
+            out[k] = simplex_periodic_cell(si - fsi, sj - fsj, [&](int di, int dj) {
+                const int row = j + dj;
+                return static_cast<int>(permMod8[columns[i + di + rowOffsets[row]] + perm[rows[row]]]);
+            });
+        }
+    }
+
+#if defined(RELNO_ARCH_X86)
+    // Gradient index of corners (i, j) for 8 lanes through the wrap table
+    RELNO_TARGET_AVX2
+    static inline __m256i simplex_periodic_index_avx2(const std::uint8_t* perm, const std::uint8_t* permMod8,
+        const SimplexWrapTable& wrap, __m256i i, __m256i j) {
+        const __m256i J = _mm256_i32gather_epi32(wrap.rows(), j, 4);
+        const __m256i offset = _mm256_i32gather_epi32(wrap.row_offsets(), j, 4);
+        const __m256i I = _mm256_i32gather_epi32(wrap.columns(), _mm256_add_epi32(i, offset), 4);
+        const __m256i pj = _mm256_and_si256(simplex_gather_avx2(perm, J), _mm256_set1_epi32(255));
+        return simplex_gather_avx2(permMod8, _mm256_add_epi32(I, pj));
+    }
+
+    RELNO_TARGET_AVX2
+    static void simplex_periodic_avx2(const std::uint8_t* perm, const std::uint8_t* permMod8, const SimplexWrapTable& wrap,
+        const float* xs, const float* ys, float* out, std::size_t count) {
+        const __m256 G2v = _mm256_set1_ps(0.2113248654f);
+        const __m256 G2x2 = _mm256_set1_ps(2.0f * 0.2113248654f);
+        const __m256 onef = _mm256_set1_ps(1.0f);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256 gx = _mm256_load_ps(kGradX);
+        const __m256 gy = _mm256_load_ps(kGradY);
+
+        std::size_t k = 0;
+        for (; k + 8 <= count; k += 8) {
+            const __m256 x = _mm256_loadu_ps(xs + k);
+            const __m256 y = _mm256_loadu_ps(ys + k);
+            const __m256 si = _mm256_add_ps(x, y);
+            const __m256 sj = _mm256_add_ps(y, y);
+            const __m256 fsi = _mm256_floor_ps(si);
+            const __m256 fsj = _mm256_floor_ps(sj);
+            const __m256i i = _mm256_cvttps_epi32(fsi);
+            const __m256i j = _mm256_cvttps_epi32(fsj);
+            const __m256 fi = _mm256_sub_ps(si, fsi);
+            const __m256 fj = _mm256_sub_ps(sj, fsj);
+
+            const __m256 t = _mm256_mul_ps(_mm256_add_ps(fi, fj), G2v);
+            const __m256 x0 = _mm256_sub_ps(fi, t);
+            const __m256 y0 = _mm256_sub_ps(fj, t);
+
+            const __m256i lower = _mm256_castps_si256(_mm256_cmp_ps(x0, y0, _CMP_GT_OQ));
+            const __m256i i1 = _mm256_and_si256(lower, one);
+            const __m256i j1 = _mm256_sub_epi32(one, i1);
+
+            const __m256 x1 = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_cvtepi32_ps(i1)), G2v);
+            const __m256 y1 = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_cvtepi32_ps(j1)), G2v);
+            const __m256 x2 = _mm256_add_ps(_mm256_sub_ps(x0, onef), G2x2);
+            const __m256 y2 = _mm256_add_ps(_mm256_sub_ps(y0, onef), G2x2);
+
+            const __m256i gi0 = simplex_periodic_index_avx2(perm, permMod8, wrap, i, j);
+            const __m256i gi1 = simplex_periodic_index_avx2(perm, permMod8, wrap, _mm256_add_epi32(i, i1), _mm256_add_epi32(j, j1));
+            const __m256i gi2 = simplex_periodic_index_avx2(perm, permMod8, wrap, _mm256_add_epi32(i, one), _mm256_add_epi32(j, one));
+
+            const __m256 n0 = simplex_corner_avx2(x0, y0, gi0, gx, gy);
+            const __m256 n1 = simplex_corner_avx2(x1, y1, gi1, gx, gy);
+            const __m256 n2 = simplex_corner_avx2(x2, y2, gi2, gx, gy);
+            const __m256 sum = _mm256_add_ps(_mm256_add_ps(n0, n1), n2);
+            _mm256_storeu_ps(out + k, _mm256_mul_ps(_mm256_set1_ps(70.0f), sum));
+        }
+        simplex_periodic_scalar(perm, permMod8, wrap, xs + k, ys + k, out + k, count - k);
+    }
+#endif // RELNO_ARCH_X86
+
+    // The AVX-512 tier uses the AVX2 kernel (gathers dominate); NEON and SSE2 run scalar
+    static const KernelTable<SimplexPeriodicKernel> kSimplexPeriodicKernels = [] {
+        KernelTable<SimplexPeriodicKernel> t;
+        t.scalar = simplex_periodic_scalar;
+#if defined(RELNO_ARCH_X86)
+        t.avx2 = simplex_periodic_avx2;
+#endif
+        return t;
+    }();
+
+    void SimplexNoise::noise2D_periodic_batch(const SimplexWrapTable& wrap, const float* x, const float* y,
+        float* out, std::size_t count) const {
+        kSimplexPeriodicKernels.get()(perm.data(), permMod8.data(), wrap, x, y, out, count);
+    }
+
+    // ---------------------------------------------------------
+    // Parameter validation shared by every map entry point
+    // ---------------------------------------------------------
+    static void validate_simplex_params(
         int width,
         int height,
         float scale,
         int octaves,
         float persistence,
-        float lacunarity,
-        float base,
-        int seed
+        float lacunarity
     ) {
-        // Validate parameters
         if (width <= 0)
             throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
         if (height <= 0)
@@ -122,81 +567,482 @@ namespace Noise {
             throw std::invalid_argument("persistence must be in [0,1], got: " + std::to_string(persistence));
         if (lacunarity <= 0.0f)
             throw std::invalid_argument("lacunarity must be > 0, got: " + std::to_string(lacunarity));
+    }
 
-        SimplexNoise noiseGen(seed);
-        std::vector<std::vector<float>> noise(height, std::vector<float>(width, 0.0f));
+    // ---------------------------------------------------------
+    // Multi-octave Simplex generator over a window of the plane
+    // ---------------------------------------------------------
+    // dst pixel (x, y) is world pixel (originX + x, originY + y); sample positions
+    // depend only on that integer coordinate, so overlapping windows agree exactly.
+    static void simplex_fractal_into(
+        const SimplexNoise& noiseGen,
+        float* dst,
+        std::size_t stride,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        const GenerateOptions& options
+    ) {
+        validate_simplex_params(width, height, scale, octaves, persistence, lacunarity);
+        if (!dst)
+            throw std::invalid_argument("dst must not be null");
+        if (stride < static_cast<std::size_t>(width))
+            throw std::invalid_argument("stride must be >= width, got: " + std::to_string(stride));
 
-        float amplitude = 1.0f;
-        float maxAmp = 0.0f;
-        float frequency = 1.0f;
+        const StageTimer timer(StatsStage::Evaluate, "simplex",
+            static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height), options.threads, options.pool);
 
-        for (int o = 0; o < octaves; ++o) {
-            for (int y = 0; y < height; ++y) {
-                for (int x = 0; x < width; ++x) {
-                    float nx = (x + base) / scale * frequency;
-                    float ny = (y + base) / scale * frequency;
-                    noise[y][x] += noiseGen.noise2D(nx, ny) * amplitude;
-                }
+        // Common presets run a FractalNoise specialization (same values; see PerlinNoise.cpp)
+        if (options.octaveMode != OctaveMode::Layered) {
+            if (const FractalPresetFn<SimplexNoise> preset = find_fractal_preset<SimplexNoise>(octaves, persistence, lacunarity)) {
+                preset(noiseGen, dst, stride, originX, originY, width, height, scale, 1.0f, base, options);
+                return;
             }
+        }
+
+        float maxAmp = 0.0f;
+        float amplitude = 1.0f;
+        for (int o = 0; o < octaves; ++o) {
             maxAmp += amplitude;
             amplitude *= persistence;
-            frequency *= lacunarity;
         }
 
-        // Normalize to [0,1]
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                noise[y][x] = (noise[y][x] / maxAmp) * 0.5f + 0.5f;
+        const bool fused = use_fused_octaves(options.octaveMode, width, height, options.tileSize);
+
+        // Tiles are independent and each runs the full octave stack, so the output does
+        // not depend on the thread count, tile size or octave mode
+        parallel_for_tiles(width, height, options.tileSize, options.tileSize, options.threads, options.pool, [&](const Tile& tile) {
+            // Rows are evaluated in fixed-size chunks through the batched kernel
+            constexpr int chunk = 64;
+            alignas(64) float xs[chunk];
+            alignas(64) float ys[chunk];
+            alignas(64) float vals[chunk];
+
+            const int xEnd = tile.x + tile.width;
+            const int yEnd = tile.y + tile.height;
+
+            if (fused) {
+                // Octave sum of one chunk stays in a local accumulator; dst is written once
+                alignas(64) float acc[chunk];
+                for (int y = tile.y; y < yEnd; ++y) {
+                    float* row = dst + y * stride;
+                    for (int x0 = tile.x; x0 < xEnd; x0 += chunk) {
+                        int n = std::min(chunk, xEnd - x0);
+                        std::fill(acc, acc + n, 0.0f);
+
+                        float amplitude = 1.0f;
+                        float frequency = 1.0f;
+                        for (int o = 0; o < octaves; ++o) {
+                            float ny = (static_cast<float>(originY + y) + base) / scale * frequency;
+                            std::fill(ys, ys + n, ny);
+                            for (int i = 0; i < n; ++i)
+                                xs[i] = (static_cast<float>(originX + x0 + i) + base) / scale * frequency;
+                            noiseGen.noise2D_batch(xs, ys, vals, static_cast<std::size_t>(n));
+                            for (int i = 0; i < n; ++i)
+                                acc[i] += vals[i] * amplitude;
+                            amplitude *= persistence;
+                            frequency *= lacunarity;
+                        }
+
+                        for (int i = 0; i < n; ++i)
+                            row[x0 + i] = (acc[i] / maxAmp) * 0.5f + 0.5f;
+                    }
+                }
+                return;
+            }
+
+            for (int y = tile.y; y < yEnd; ++y)
+                std::fill(dst + y * stride + tile.x, dst + y * stride + xEnd, 0.0f);
+
+            float amplitude = 1.0f;
+            float frequency = 1.0f;
+            for (int o = 0; o < octaves; ++o) {
+                for (int y = tile.y; y < yEnd; ++y) {
+                    float* row = dst + y * stride;
+                    float ny = (static_cast<float>(originY + y) + base) / scale * frequency;
+                    std::fill(ys, ys + chunk, ny);
+                    for (int x0 = tile.x; x0 < xEnd; x0 += chunk) {
+                        int n = std::min(chunk, xEnd - x0);
+                        for (int i = 0; i < n; ++i)
+                            xs[i] = (static_cast<float>(originX + x0 + i) + base) / scale * frequency;
+                        noiseGen.noise2D_batch(xs, ys, vals, static_cast<std::size_t>(n));
+                        for (int i = 0; i < n; ++i)
+                            row[x0 + i] += vals[i] * amplitude;
+                    }
+                }
+                amplitude *= persistence;
+                frequency *= lacunarity;
+            }
 
+            // Normalize to [0,1]
+            for (int y = tile.y; y < yEnd; ++y) {
+                float* row = dst + y * stride;
+                for (int x = tile.x; x < xEnd; ++x)
+                    row[x] = (row[x] / maxAmp) * 0.5f + 0.5f;
+            }
+        });
+    }
+
+    // ---------------------------------------------------------
+    // Multi-octave Simplex generator into a caller-provided buffer
+    // ---------------------------------------------------------
+    void generate_simplex_into(
+        const SimplexNoise& noiseGen,
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        const GenerateOptions& options
+    ) {
+        simplex_fractal_into(noiseGen, dst, stride, 0, 0, width, height, scale, octaves, persistence, lacunarity, base, options);
+    }
+
+    void generate_simplex_into(
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        const GenerateOptions& options
+    ) {
+        validate_simplex_params(width, height, scale, octaves, persistence, lacunarity);
+        const SimplexNoise noiseGen = [&] {
+            const StageTimer timer(StatsStage::Setup, "simplex", 0);
+            return SimplexNoise(seed);
+        }();
+        generate_simplex_into(noiseGen, dst, stride, width, height, scale, octaves, persistence, lacunarity, base, options);
+    }
+
+    // ---------------------------------------------------------
+    // Multi-octave Simplex map generator
+    // ---------------------------------------------------------
+    NoiseMap generate_simplex_noisemap(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        const GenerateOptions& options
+    ) {
+        validate_simplex_params(width, height, scale, octaves, persistence, lacunarity);
+        NoiseMap noise = [&] {
+            const StageTimer timer(StatsStage::Setup, "simplex", 0);
+            return NoiseMap(width, height);
+        }();
+        generate_simplex_into(noise.data(), noise.stride(), width, height, scale, octaves, persistence, lacunarity, base, seed, options);
         return noise;
     }
 
+    std::vector<std::vector<float>> generate_simplex_map(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed
+    ) {
+        return generate_simplex_noisemap(width, height, scale, octaves, persistence, lacunarity, base, seed).to_vector();
+    }
+
     // ---------------------------------------------------------
-    // Save as grayscale PNG or JPEG (auto-detected from extension)
+    // Tileable maps
     // ---------------------------------------------------------
-    void save_simplex_image(const std::vector<std::vector<float>>& noise, const std::string& filename, const std::string& outputDir) {
-        if (noise.empty() || noise[0].empty()) {
-            throw std::invalid_argument("Cannot save empty noise map.");
-        }
+    // Lattice period of one map axis: the cells the untiled map spans across
+    // `extent` pixels, rounded to a whole number
+    static int simplex_tile_period(int extent, double cellsPerPixel, int octave) {
+        const double cells = std::round(static_cast<double>(extent) * cellsPerPixel);
+        if (!(cells <= static_cast<double>(1 << 24)))
+            throw std::invalid_argument("octave " + std::to_string(octave) + " needs a lattice period above 2^24 cells, got: " + std::to_string(cells));
+        return std::max(1, static_cast<int>(cells));
+    }
 
-        int height = noise.size();
-        int width = noise[0].size();
+    // Base shift of `period` cells per `extent` pixels: whole cells go into the
+    // wrap table, the fraction into the sample coordinates
+    static std::int64_t simplex_tile_shift(int period, int extent, float base, float& step, float& offset) {
+        step = static_cast<float>(static_cast<double>(period) / extent);
+        const double shift = static_cast<double>(base) * period / extent;
+        const double whole = std::floor(shift);
+        offset = static_cast<float>(shift - whole);
+        return static_cast<std::int64_t>(std::fmod(whole, static_cast<double>(period)));
+    }
 
-        std::vector<unsigned char> img(width * height);
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                img[y * width + x] = static_cast<unsigned char>(std::clamp(noise[y][x], 0.0f, 1.0f) * 255.0f);
+    // One octave of a tileable map: pixel (x, y) samples window cell
+    // (x * stepX + offsetX, y * stepY + offsetY)
+    struct SimplexTileOctave {
+        SimplexWrapTable wrap;
+        float stepX, stepY;
+        float offsetX, offsetY;
+    };
 
-        // Determine output directory: use custom or default
-        std::filesystem::path outDir;
-        if (outputDir.empty()) {
-            outDir = std::filesystem::current_path().parent_path() / "ImageOutput";
-        }
-        else {
-            outDir = outputDir;
-        }
-        std::filesystem::create_directories(outDir);
-        std::filesystem::path outputFile = outDir / filename;
-        std::string extension = outputFile.extension().string();
+    void generate_simplex_tileable_into(
+        const SimplexNoise& noiseGen,
+        float* dst,
+        std::size_t stride,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        const GenerateOptions& options
+    ) {
+        validate_simplex_params(width, height, scale, octaves, persistence, lacunarity);
+        if (!dst)
+            throw std::invalid_argument("dst must not be null");
+        if (stride < static_cast<std::size_t>(width))
+            throw std::invalid_argument("stride must be >= width, got: " + std::to_string(stride));
 
-        // Convert extension to lowercase for comparison
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        // noise2D units per cell of the periodic frame
+        const double cellWidth = std::sqrt(2.0 / 3.0);
+        const double cellHeight = std::sqrt(2.0);
 
-        int result = 0;
-        if (extension == ".jpg" || extension == ".jpeg") {
-            // Save as JPEG with quality 90 (range: 1-100, higher = better quality)
-            result = stbi_write_jpg(outputFile.string().c_str(), width, height, 1, img.data(), 90);
-        }
-        else {
-            // Default to PNG
-            result = stbi_write_png(outputFile.string().c_str(), width, height, 1, img.data(), width);
+        std::vector<SimplexTileOctave> layers;
+        std::vector<float> amplitudes;
+        float maxAmp = 0.0f;
+        {
+            const StageTimer timer(StatsStage::Setup, "simplex", 0);
+            layers.reserve(static_cast<std::size_t>(octaves));
+            float amplitude = 1.0f;
+            float frequency = 1.0f;
+            for (int o = 0; o < octaves; ++o) {
+                const double unitsPerPixel = static_cast<double>(frequency) / scale;
+                const int periodX = simplex_tile_period(width, unitsPerPixel / cellWidth, o);
+                const int periodY = simplex_tile_period(height, unitsPerPixel / cellHeight, o);
+                float stepX, stepY, offsetX, offsetY;
+                const std::int64_t shiftX = simplex_tile_shift(periodX, width, base, stepX, offsetX);
+                const std::int64_t shiftY = simplex_tile_shift(periodY, height, base, stepY, offsetY);
+                layers.push_back({ SimplexWrapTable(periodX, periodY, shiftX, shiftY, periodX + 1, periodY + 1),
+                    stepX, stepY, offsetX, offsetY });
+                amplitudes.push_back(amplitude);
+                maxAmp += amplitude;
+                amplitude *= persistence;
+                frequency *= lacunarity;
+            }
         }
 
-        if (result == 0) {
-            throw std::runtime_error("Failed to write image file: " + outputFile.string());
-        }
+        const StageTimer timer(StatsStage::Evaluate, "simplex",
+            static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height), options.threads, options.pool);
+
+        // All octaves of a chunk run back to back (the wrap tables are small)
+        parallel_for_tiles(width, height, options.tileSize, options.tileSize, options.threads, options.pool, [&](const Tile& tile) {
+            constexpr int chunk = 64;
+            alignas(64) float xs[chunk];
+            alignas(64) float ys[chunk];
+            alignas(64) float vals[chunk];
+            alignas(64) float acc[chunk];
 
-        std::cout << "[OK] Simplex noise image saved at: " << outputFile.string() << "\n";
+            const int xEnd = tile.x + tile.width;
+            for (int y = tile.y; y < tile.y + tile.height; ++y) {
+                float* row = dst + y * stride;
+                for (int x0 = tile.x; x0 < xEnd; x0 += chunk) {
+                    const int n = std::min(chunk, xEnd - x0);
+                    std::fill(acc, acc + n, 0.0f);
+                    for (int o = 0; o < octaves; ++o) {
+                        const SimplexTileOctave& layer = layers[static_cast<std::size_t>(o)];
+                        std::fill(ys, ys + n, static_cast<float>(y) * layer.stepY + layer.offsetY);
+                        for (int i = 0; i < n; ++i)
+                            xs[i] = static_cast<float>(x0 + i) * layer.stepX + layer.offsetX;
+                        noiseGen.noise2D_periodic_batch(layer.wrap, xs, ys, vals, static_cast<std::size_t>(n));
+                        const float amplitude = amplitudes[static_cast<std::size_t>(o)];
+                        for (int i = 0; i < n; ++i)
+                            acc[i] += vals[i] * amplitude;
+                    }
+                    for (int i = 0; i < n; ++i)
+                        row[x0 + i] = (acc[i] / maxAmp) * 0.5f + 0.5f;
+                }
+            }
+        });
+    }
+
+    NoiseMap generate_simplex_tileable_noisemap(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        const GenerateOptions& options
+    ) {
+        validate_simplex_params(width, height, scale, octaves, persistence, lacunarity);
+        NoiseMap noise = [&] {
+            const StageTimer timer(StatsStage::Setup, "simplex", 0);
+            return NoiseMap(width, height);
+        }();
+        const SimplexNoise generator = [&] {
+            const StageTimer timer(StatsStage::Setup, "simplex", 0);
+            return SimplexNoise(seed);
+        }();
+        generate_simplex_tileable_into(generator, noise.data(), noise.stride(), width, height, scale, octaves, persistence, lacunarity, base, options);
+        return noise;
+    }
+
+    // ---------------------------------------------------------
+    // World-space regions and chunks
+    // ---------------------------------------------------------
+    void generate_simplex_region_into(
+        const SimplexNoise& noiseGen,
+        const SimplexParams& params,
+        float* dst,
+        std::size_t stride,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const GenerateOptions& options
+    ) {
+        simplex_fractal_into(noiseGen, dst, stride, originX, originY, width, height,
+            params.scale, params.octaves, params.persistence, params.lacunarity, params.base, options);
+    }
+
+    NoiseMap generate_simplex_region(
+        const SimplexNoise& noiseGen,
+        const SimplexParams& params,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const GenerateOptions& options
+    ) {
+        validate_simplex_params(width, height, params.scale, params.octaves, params.persistence, params.lacunarity);
+        NoiseMap noise = [&] {
+            const StageTimer timer(StatsStage::Setup, "simplex", 0);
+            return NoiseMap(width, height);
+        }();
+        generate_simplex_region_into(noiseGen, params, noise.data(), noise.stride(), originX, originY, width, height, options);
+        return noise;
+    }
+
+    NoiseMap generate_simplex_chunk(
+        const SimplexNoise& noiseGen,
+        const SimplexParams& params,
+        std::int64_t chunkX,
+        std::int64_t chunkY,
+        int chunkSize,
+        const GenerateOptions& options
+    ) {
+        if (chunkSize <= 0)
+            throw std::invalid_argument("chunkSize must be > 0, got: " + std::to_string(chunkSize));
+        return generate_simplex_region(noiseGen, params, chunkX * chunkSize, chunkY * chunkSize, chunkSize, chunkSize, options);
+    }
+
+    ChunkKey simplex_chunk_key(int seed, const SimplexParams& params, std::int64_t chunkX, std::int64_t chunkY, int chunkSize) {
+        ChunkKey key;
+        key.generator = static_cast<std::uint32_t>(ChunkGenerator::Simplex);
+        key.seed = seed;
+        key.set_param(0, params.scale);
+        key.set_param(1, static_cast<std::int32_t>(params.octaves));
+        key.set_param(2, params.persistence);
+        key.set_param(3, params.lacunarity);
+        key.set_param(4, params.base);
+        key.chunkX = chunkX;
+        key.chunkY = chunkY;
+        key.chunkSize = chunkSize;
+        return key;
+    }
+
+    ChunkCache::MapPtr generate_simplex_chunk_cached(
+        ChunkCache& cache,
+        int seed,
+        const SimplexParams& params,
+        std::int64_t chunkX,
+        std::int64_t chunkY,
+        int chunkSize,
+        const GenerateOptions& options
+    ) {
+        if (seed < 0)
+            throw std::invalid_argument("seed must be >= 0 for cached chunks, got: " + std::to_string(seed));
+        return cache.get_or_create(simplex_chunk_key(seed, params, chunkX, chunkY, chunkSize), [&] {
+            SimplexNoise noiseGen(seed);
+            return generate_simplex_chunk(noiseGen, params, chunkX, chunkY, chunkSize, options);
+        });
+    }
+
+    // ---------------------------------------------------------
+    // Save as grayscale PNG, JPEG or EXR (auto-detected from extension)
+    // ---------------------------------------------------------
+    void save_simplex_image(const NoiseMap& noise, const std::string& filename, const std::string& outputDir, const ImageSaveOptions& imageOptions) {
+        std::filesystem::path outputFile = save_noise_image(noise, filename, outputDir, imageOptions);
+        if (std::ostream* log = log_stream()) *log << "[OK] Simplex noise image saved at: " << outputFile.string() << "\n";
+    }
+
+    void save_simplex_region_image(
+        const SimplexNoise& noiseGen,
+        const SimplexParams& params,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const std::string& filename,
+        const std::string& outputDir,
+        const GenerateOptions& options,
+        const ImageSaveOptions& imageOptions
+    ) {
+        validate_simplex_params(width, height, params.scale, params.octaves, params.persistence, params.lacunarity);
+
+        ImageSaveOptions saveOptions = imageOptions;
+        if (!saveOptions.pool) saveOptions.pool = options.pool;
+        std::filesystem::path outputFile = save_noise_image_bands(filename, outputDir, width, height,
+            [&](float* band, std::size_t stride, int y0, int rows) {
+                generate_simplex_region_into(noiseGen, params, band, stride, originX, originY + y0, width, rows, options);
+            }, saveOptions);
+
+        if (std::ostream* log = log_stream()) *log << "[OK] Simplex noise image saved at: " << outputFile.string() << "\n";
+    }
+
+    void save_simplex_tiled_raw(
+        const SimplexNoise& noiseGen,
+        const SimplexParams& params,
+        std::int64_t originX,
+        std::int64_t originY,
+        int width,
+        int height,
+        const std::string& filename,
+        const std::string& outputDir,
+        const RawTileOptions& rawOptions,
+        const GenerateOptions& options
+    ) {
+        validate_simplex_params(width, height, params.scale, params.octaves, params.persistence, params.lacunarity);
+
+        // the tiles are the parallel work: each one runs on a single thread
+        GenerateOptions tileOptions = options;
+        tileOptions.threads = 1;
+        const std::filesystem::path file = resolve_raw_path(filename, outputDir);
+        write_tiled_raw_map(file, width, height, [&](float* dst, std::size_t stride, const Tile& tile) {
+            generate_simplex_region_into(noiseGen, params, dst, stride, originX + tile.x, originY + tile.y, tile.width, tile.height, tileOptions);
+        }, rawOptions, options);
+
+        if (std::ostream* log = log_stream()) *log << "[OK] Simplex noise raw map saved at: " << file.string() << "\n";
+    }
+
+    void save_simplex_image(const std::vector<std::vector<float>>& noise, const std::string& filename, const std::string& outputDir, const ImageSaveOptions& imageOptions) {
+        if (noise.empty() || noise[0].empty()) {
+            throw std::invalid_argument("Cannot save empty noise map.");
+        }
+        save_simplex_image(NoiseMap::from_vector(noise), filename, outputDir, imageOptions);
     }
 
     // ---------------------------------------------------------
@@ -215,13 +1061,30 @@ namespace Noise {
         const std::string& filename,
         const std::string& outputDir
     ) {
-        auto noise = generate_simplex_map(width, height, scale, octaves, persistence, lacunarity, base, seed);
+        if (mode == OutputMode::Mmap) {
+            // Generated in place into the mapped file; the returned copy is read back from it
+            std::filesystem::path file = resolve_raw_path(filename, outputDir);
+            MappedRawMap mapped = MappedRawMap::generate(file, width, height, [&](float* dst, std::size_t stride) {
+                generate_simplex_into(dst, stride, width, height, scale, octaves, persistence, lacunarity, base, seed);
+            });
+            if (std::ostream* log = log_stream()) *log << "[OK] Simplex noise raw map saved at: " << file.string() << "\n";
+            return mapped.to_noisemap().to_vector();
+        }
+
+        auto noise = generate_simplex_noisemap(width, height, scale, octaves, persistence, lacunarity, base, seed);
 
         switch (mode) {
         case OutputMode::Image:
             save_simplex_image(noise, filename, outputDir);
             break;
+        case OutputMode::Raw: {
+            std::filesystem::path file = resolve_raw_path(filename, outputDir);
+            save_raw_map(noise, file);
+            if (std::ostream* log = log_stream()) *log << "[OK] Simplex noise raw map saved at: " << file.string() << "\n";
+            break;
+        }
         case OutputMode::None:
+        case OutputMode::Mmap:
             // Do nothing, just return the noise
             break;
         case OutputMode::Map:
@@ -230,7 +1093,7 @@ namespace Noise {
             break;
         }
 
-        return noise;
+        return noise.to_vector();
     }
 
 } // namespace Noise
@@ -1,4 +1,4 @@
-// WhiteNoise.hpp
+﻿// WhiteNoise.hpp
 // ----------------
 // A simple, standalone C++ header for generating 2D white noise maps.
 //
@@ -12,6 +12,10 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <cstddef>
+#include "NoiseMap.hpp"
+#include "GenerateOptions.hpp"
+#include "ImageOutput.hpp"
 
 namespace Noise {
 
@@ -21,13 +25,26 @@ namespace Noise {
     class WhiteNoise {
     public:
         static std::vector<std::vector<float>> generate(int width, int height, int seed = -1);
+        // Same values as generate(), in a contiguous 64-byte aligned map.
+        // options.rng = RngBackend::Counter switches to per-pixel Philox values that
+        // are generated in parallel (rows over options.threads workers) and with SIMD.
+        static NoiseMap generate_map(int width, int height, int seed = -1, const GenerateOptions& options = {});
+        // Same values written into a caller-provided buffer (row y at dst + y * stride)
+        static void generate_into(float* dst, std::size_t stride, int width, int height, int seed = -1,
+            const GenerateOptions& options = {});
         static void show(const std::vector<std::vector<float>>& noise);
+        static void show(const NoiseMap& noise);
 
-        // Save to grayscale PNG or JPEG (auto-detected from extension)
+        // Save to grayscale PNG, JPEG or EXR (auto-detected from extension)
         // If outputDir is empty, uses default ImageOutput/ directory
+        static void save(const NoiseMap& noise,
+            const std::string& filename = "white_noise.png",
+            const std::string& outputDir = "",
+            const ImageSaveOptions& imageOptions = {});
         static void save(const std::vector<std::vector<float>>& noise,
             const std::string& filename = "white_noise.png",
-            const std::string& outputDir = "");
+            const std::string& outputDir = "",
+            const ImageSaveOptions& imageOptions = {});
     };
 
     // Wrapper
@@ -3,8 +3,12 @@
 #include <iostream>
 #include <random>
 #include <algorithm>  // for std::transform
-#include "stb_image_write.h"
 #include <filesystem>
+#include "Cancellation.hpp"
+#include "CounterRng.hpp"
+#include "NoiseStats.hpp"
+#include "TileScheduler.hpp"
+#include "RawMap.hpp"
 
 
 namespace Noise {
@@ -13,6 +17,25 @@ namespace Noise {
     // Generate white noise: returns a 2D vector of floats [0,1]
     // -------------------------------------------------------------
     std::vector<std::vector<float>> WhiteNoise::generate(int width, int height, int seed) {
+        return generate_map(width, height, seed).to_vector();
+    }
+
+    // -------------------------------------------------------------
+    // Generate white noise into a contiguous NoiseMap
+    // -------------------------------------------------------------
+    NoiseMap WhiteNoise::generate_map(int width, int height, int seed, const GenerateOptions& options) {
+        NoiseMap noise = [&] {
+            const StageTimer timer(StatsStage::Setup, "white", 0);
+            return NoiseMap(width > 0 ? width : 0, height > 0 ? height : 0);
+        }();
+        generate_into(noise.data(), noise.stride(), width, height, seed, options);
+        return noise;
+    }
+
+    // -------------------------------------------------------------
+    // Generate white noise into a caller-provided buffer
+    // -------------------------------------------------------------
+    void WhiteNoise::generate_into(float* dst, std::size_t stride, int width, int height, int seed, const GenerateOptions& options) {
         // Validate parameters
         if (width <= 0) {
             throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
@@ -20,19 +43,38 @@ namespace Noise {
         if (height <= 0) {
             throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
         }
+        if (!dst) {
+            throw std::invalid_argument("dst must not be null");
+        }
+        if (stride < static_cast<std::size_t>(width)) {
+            throw std::invalid_argument("stride must be >= width, got: " + std::to_string(stride));
+        }
+
+        const std::uint64_t pixels = static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height);
+        if (options.rng == RngBackend::Counter) {
+            const StageTimer timer(StatsStage::Evaluate, "white", pixels, options.threads, options.pool);
+            // Every pixel is independent: bands of rows go to the worker pool
+            const std::uint32_t key = static_cast<std::uint32_t>(seed >= 0 ? seed : std::random_device{}());
+            parallel_for_tiles(width, height, width, 16, options.threads, options.pool, [&](const Tile& band) {
+                for (int y = band.y; y < band.y + band.height; ++y)
+                    counter_uniform_row(key, static_cast<std::uint32_t>(y), 0, dst + y * stride, static_cast<std::size_t>(width));
+            });
+            return;
+        }
 
-        std::vector<std::vector<float>> noise(height, std::vector<float>(width));
+        const StageTimer timer(StatsStage::Evaluate, "white", pixels);
 
         // Random number generator setup
         std::mt19937 rng(seed >= 0 ? seed : std::random_device{}());
         std::uniform_real_distribution<float> dist(0.0f, 1.0f);
 
-        // Fill with random values
-        for (int y = 0; y < height; ++y)
+        // Fill with random values (one serial stream: cancellation is checked per row)
+        for (int y = 0; y < height; ++y) {
+            throw_if_cancelled();
+            float* row = dst + y * stride;
             for (int x = 0; x < width; ++x)
-                noise[y][x] = dist(rng);
-
-        return noise;
+                row[x] = dist(rng);
+        }
     }
 
     // -------------------------------------------------------------
@@ -42,14 +84,21 @@ namespace Noise {
         if (noise.empty() || noise[0].empty()) {
             throw std::invalid_argument("Cannot show empty noise map.");
         }
+        show(NoiseMap::from_vector(noise));
+    }
+
+    void WhiteNoise::show(const NoiseMap& noise) {
+        if (noise.empty()) {
+            throw std::invalid_argument("Cannot show empty noise map.");
+        }
 
         std::cout << "\n[Preview of White Noise Map]\n";
-        int previewH = std::min((int)noise.size(), 10);
-        int previewW = std::min((int)noise[0].size(), 20);
+        int previewH = std::min(noise.height(), 10);
+        int previewW = std::min(noise.width(), 20);
 
         for (int y = 0; y < previewH; ++y) {
             for (int x = 0; x < previewW; ++x) {
-                char c = (noise[y][x] > 0.5f) ? '#' : '.';
+                char c = (noise(x, y) > 0.5f) ? '#' : '.';
                 std::cout << c;
             }
             std::cout << "\n";
@@ -58,54 +107,18 @@ namespace Noise {
     }
 
     // -------------------------------------------------------------
-    // Save as grayscale PNG or JPEG (auto-detected from extension)
+    // Save as grayscale PNG, JPEG or EXR (auto-detected from extension)
     // -------------------------------------------------------------
-    void WhiteNoise::save(const std::vector<std::vector<float>>& noise, const std::string& filename, const std::string& outputDir) {
+    void WhiteNoise::save(const std::vector<std::vector<float>>& noise, const std::string& filename, const std::string& outputDir, const ImageSaveOptions& imageOptions) {
         if (noise.empty() || noise[0].empty()) {
             throw std::invalid_argument("Cannot save empty noise map.");
         }
+        save(NoiseMap::from_vector(noise), filename, outputDir, imageOptions);
+    }
 
-        int height = noise.size();
-        int width = noise[0].size();
-
-        std::vector<unsigned char> imgData(width * height);
-
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                imgData[y * width + x] = static_cast<unsigned char>(noise[y][x] * 255.0f);
-
-        // Determine output directory: use custom or default
-        std::filesystem::path outDir;
-        if (outputDir.empty()) {
-            outDir = std::filesystem::current_path().parent_path() / "ImageOutput";
-        }
-        else {
-            outDir = outputDir;
-        }
-        std::filesystem::create_directories(outDir);
-
-        // Save file there
-        std::filesystem::path outputFile = outDir / filename;
-        std::string extension = outputFile.extension().string();
-
-        // Convert extension to lowercase for comparison
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-
-        int result = 0;
-        if (extension == ".jpg" || extension == ".jpeg") {
-            // Save as JPEG with quality 90 (range: 1-100, higher = better quality)
-            result = stbi_write_jpg(outputFile.string().c_str(), width, height, 1, imgData.data(), 90);
-        }
-        else {
-            // Default to PNG
-            result = stbi_write_png(outputFile.string().c_str(), width, height, 1, imgData.data(), width);
-        }
-
-        if (result == 0) {
-            throw std::runtime_error("Failed to write image file: " + outputFile.string());
-        }
-
-        std::cout << "[OK] White noise image saved at: " << outputFile.string() << "\n";
+    void WhiteNoise::save(const NoiseMap& noise, const std::string& filename, const std::string& outputDir, const ImageSaveOptions& imageOptions) {
+        std::filesystem::path outputFile = save_noise_image(noise, filename, outputDir, imageOptions);
+        if (std::ostream* log = log_stream()) *log << "[OK] White noise image saved at: " << outputFile.string() << "\n";
     }
 
     // -------------------------------------------------------------
@@ -113,7 +126,17 @@ namespace Noise {
     // -------------------------------------------------------------
     std::vector<std::vector<float>> create_whitenoise(int width, int height, int seed,
         OutputMode mode, const std::string& filename, const std::string& outputDir) {
-        auto noise = WhiteNoise::generate(width, height, seed);
+        if (mode == OutputMode::Mmap) {
+            // Generated in place into the mapped file; the returned copy is read back from it
+            std::filesystem::path file = resolve_raw_path(filename, outputDir);
+            MappedRawMap mapped = MappedRawMap::generate(file, width, height, [&](float* dst, std::size_t stride) {
+                WhiteNoise::generate_into(dst, stride, width, height, seed);
+            });
+            if (std::ostream* log = log_stream()) *log << "[OK] White noise raw map saved at: " << file.string() << "\n";
+            return mapped.to_noisemap().to_vector();
+        }
+
+        auto noise = WhiteNoise::generate_map(width, height, seed);
 
         switch (mode) {
         case OutputMode::Map:
@@ -122,12 +145,19 @@ namespace Noise {
         case OutputMode::Image:
             WhiteNoise::save(noise, filename, outputDir);
             break;
+        case OutputMode::Raw: {
+            std::filesystem::path file = resolve_raw_path(filename, outputDir);
+            save_raw_map(noise, file);
+            if (std::ostream* log = log_stream()) *log << "[OK] White noise raw map saved at: " << file.string() << "\n";
+            break;
+        }
         case OutputMode::None:
+        case OutputMode::Mmap:
             // Do nothing, just return the noise
             break;
         }
 
-        return noise;
+        return noise.to_vector();
     }
 
 } // namespace Noise
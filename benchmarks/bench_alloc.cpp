@@ -0,0 +1,83 @@
+// bench_alloc.cpp
+// ---------------
+// Counting replacements of the global allocation functions for RelNoD_Bench.
+// They live in a translation unit of their own so the compiler never inlines
+// them next to the library's new-expressions.
+
+#include "bench_alloc.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// ---------------------------------------------------------
+// Allocation counting (every replaceable operator new in the process: plain,
+// array, nothrow and aligned forms)
+// ---------------------------------------------------------
+static std::atomic<std::uint64_t> g_newCalls{ 0 };
+static std::atomic<std::uint64_t> g_newBytes{ 0 };
+
+std::uint64_t heap_new_calls() noexcept { return g_newCalls.load(std::memory_order_relaxed); }
+std::uint64_t heap_new_bytes() noexcept { return g_newBytes.load(std::memory_order_relaxed); }
+
+static void* counted_malloc(std::size_t bytes) noexcept {
+    g_newCalls.fetch_add(1, std::memory_order_relaxed);
+    g_newBytes.fetch_add(bytes, std::memory_order_relaxed);
+    return std::malloc(bytes ? bytes : 1);
+}
+
+// Over-allocates and stores the malloc pointer just before the aligned block
+static void* counted_aligned_malloc(std::size_t bytes, std::align_val_t alignment) noexcept {
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    g_newCalls.fetch_add(1, std::memory_order_relaxed);
+    g_newBytes.fetch_add(bytes, std::memory_order_relaxed);
+    void* raw = std::malloc(bytes + align - 1 + sizeof(void*));
+    if (!raw) return nullptr;
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+    void* aligned = reinterpret_cast<void*>((start + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1));
+    static_cast<void**>(aligned)[-1] = raw;
+    return aligned;
+}
+
+static void aligned_release(void* p) noexcept {
+    if (p) std::free(static_cast<void**>(p)[-1]);
+}
+
+void* operator new(std::size_t bytes) {
+    if (void* p = counted_malloc(bytes)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t bytes) {
+    if (void* p = counted_malloc(bytes)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t bytes, const std::nothrow_t&) noexcept { return counted_malloc(bytes); }
+void* operator new[](std::size_t bytes, const std::nothrow_t&) noexcept { return counted_malloc(bytes); }
+void* operator new(std::size_t bytes, std::align_val_t alignment) {
+    if (void* p = counted_aligned_malloc(bytes, alignment)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t bytes, std::align_val_t alignment) {
+    if (void* p = counted_aligned_malloc(bytes, alignment)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t bytes, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_aligned_malloc(bytes, alignment);
+}
+void* operator new[](std::size_t bytes, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_aligned_malloc(bytes, alignment);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { ::operator delete(p); }
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { ::operator delete(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { ::operator delete(p); }
+void operator delete(void* p, std::align_val_t) noexcept { aligned_release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { aligned_release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { aligned_release(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { aligned_release(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { aligned_release(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { aligned_release(p); }
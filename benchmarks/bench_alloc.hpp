@@ -0,0 +1,11 @@
+// bench_alloc.hpp
+// ---------------
+// Heap traffic counters of RelNoD_Bench: calls to, and bytes requested from,
+// every replaceable operator new in the process (plain, array, nothrow and
+// aligned forms), since program start.
+
+#pragma once
+#include <cstdint>
+
+std::uint64_t heap_new_calls() noexcept;
+std::uint64_t heap_new_bytes() noexcept;
@@ -0,0 +1,394 @@
+// bench_main.cpp
+// --------------
+// RelNoD_Bench: throughput benchmarks for every generator and the image encoders.
+// Each case runs until --min-time has elapsed and reports time per iteration,
+// Mpixels/s and heap traffic per iteration (operator new + aligned map storage).
+//
+// Usage:
+//   RelNoD_Bench                                   // full sweep
+//   RelNoD_Bench --filter=perlin --sizes=1024,4096 --threads=1,8 --min-time=1
+//   RelNoD_Bench --filter=pink --isa=sse2            // SIMD tier comparison
+
+#include "Noise.hpp"
+#include "CpuFeatures.hpp"
+#include "ThreadPool.hpp"
+#include "TileScheduler.hpp"
+#include "RawMap.hpp"
+#include "NoiseBatch.hpp"
+#include "bench_alloc.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string filter;
+        std::vector<int> sizes{ 256, 1024, 4096, 8192 };
+        std::vector<unsigned> threads;
+        double minTime = 0.5; // seconds per case
+        std::string isa;      // empty = active_simd_isa()
+    };
+
+    struct Case {
+        std::string name;
+        long long pixels = 0;
+        std::function<void()> run;
+        bool zeroAllocs = false; // steady state must not touch the heap (generate_*_into)
+    };
+
+    struct Counters {
+        std::uint64_t allocs = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    Counters read_counters() {
+        Noise::AllocationStats aligned = Noise::aligned_allocation_stats();
+        Counters c;
+        c.allocs = heap_new_calls() + aligned.allocations;
+        c.bytes = heap_new_bytes() + aligned.bytes;
+        return c;
+    }
+
+    std::vector<std::string> split(const std::string& list) {
+        std::vector<std::string> out;
+        std::stringstream ss(list);
+        for (std::string item; std::getline(ss, item, ',');)
+            if (!item.empty()) out.push_back(item);
+        return out;
+    }
+
+    std::string format_time(double seconds) {
+        char buf[32];
+        if (seconds >= 1.0) std::snprintf(buf, sizeof(buf), "%.3f s", seconds);
+        else if (seconds >= 1e-3) std::snprintf(buf, sizeof(buf), "%.3f ms", seconds * 1e3);
+        else std::snprintf(buf, sizeof(buf), "%.3f us", seconds * 1e6);
+        return buf;
+    }
+
+    std::string format_bytes(double bytes) {
+        char buf[32];
+        if (bytes >= 1024.0 * 1024.0) std::snprintf(buf, sizeof(buf), "%.1f MiB", bytes / (1024.0 * 1024.0));
+        else if (bytes >= 1024.0) std::snprintf(buf, sizeof(buf), "%.1f KiB", bytes / 1024.0);
+        else std::snprintf(buf, sizeof(buf), "%.0f B", bytes);
+        return buf;
+    }
+
+    // Returns false when a zeroAllocs case allocated
+    bool run_case(const Case& c, const Options& opt) {
+        c.run(); // warm-up: lazy tables, kernel dispatch, page faults
+
+        const Counters before = read_counters();
+        const auto start = Clock::now();
+        long long iterations = 0;
+        double elapsed = 0.0;
+        do {
+            c.run();
+            ++iterations;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < opt.minTime);
+        const Counters after = read_counters();
+
+        const double perIter = elapsed / static_cast<double>(iterations);
+        const double mpix = static_cast<double>(c.pixels) * static_cast<double>(iterations) / elapsed / 1e6;
+        const double allocs = static_cast<double>(after.allocs - before.allocs) / static_cast<double>(iterations);
+        const double bytes = static_cast<double>(after.bytes - before.bytes) / static_cast<double>(iterations);
+
+        std::printf("%-52s %12s %10lld %10.2f %12.1f %12s\n",
+            c.name.c_str(), format_time(perIter).c_str(), iterations, mpix, allocs, format_bytes(bytes).c_str());
+        const bool ok = !c.zeroAllocs || after.allocs == before.allocs;
+        if (!ok) std::printf("  FAIL: expected no allocations per iteration\n");
+        std::fflush(stdout);
+        return ok;
+    }
+
+    // Discards the "[OK] ... saved" lines of the save_* functions while timing them
+    struct MuteStdout {
+        std::ostringstream sink;
+        std::streambuf* old = std::cout.rdbuf(sink.rdbuf());
+        ~MuteStdout() { std::cout.rdbuf(old); }
+    };
+
+    std::string size_name(int size) {
+        return std::to_string(size) + "x" + std::to_string(size);
+    }
+
+    // Input of the encoder cases, generated once per size outside the timed loop
+    const Noise::NoiseMap& encode_input(int size) {
+        static Noise::NoiseMap map;
+        static int mapSize = 0;
+        if (mapSize != size) {
+            map = Noise::generate_perlin_noisemap(size, size, 40.0f, 4, 1.0f, 0.5f, 2.0f, 0.0f, 42);
+            mapSize = size;
+        }
+        return map;
+    }
+
+    std::vector<Case> build_cases(const Options& opt, const std::filesystem::path& tmpDir) {
+        using namespace Noise;
+        std::vector<Case> cases;
+        const int octaveSweep[] = { 1, 4, 8 };
+        const int pinkOctaveSweep[] = { 1, 6 };
+
+        for (int size : opt.sizes) {
+            const long long px = static_cast<long long>(size) * size;
+            const std::string sz = size_name(size);
+
+            cases.push_back({ "white/" + sz, px, [=] {
+                WhiteNoise::generate_map(size, size, 1);
+            } });
+            for (unsigned t : opt.threads) {
+                GenerateOptions go;
+                go.threads = t;
+                go.rng = RngBackend::Counter;
+                cases.push_back({ "white/" + sz + "/rng:counter/threads:" + std::to_string(t), px, [=] {
+                    WhiteNoise::generate_map(size, size, 1, go);
+                } });
+            }
+
+            for (int oct : octaveSweep) {
+                for (unsigned t : opt.threads) {
+                    GenerateOptions go;
+                    go.threads = t;
+                    const std::string suffix = "/oct:" + std::to_string(oct) + "/threads:" + std::to_string(t);
+                    cases.push_back({ "perlin/" + sz + suffix, px, [=] {
+                        generate_perlin_noisemap(size, size, 40.0f, oct, 1.0f, 0.5f, 2.0f, 0.0f, 42, go);
+                    } });
+                    cases.push_back({ "simplex/" + sz + suffix, px, [=] {
+                        generate_simplex_noisemap(size, size, 40.0f, oct, 0.5f, 2.0f, 0.0f, 42, go);
+                    } });
+                }
+            }
+
+            // Writing into reused buffers: no allocation per call, whatever the thread count
+            for (unsigned t : opt.threads) {
+                GenerateOptions go;
+                go.threads = t;
+                const std::string suffix = "/into/threads:" + std::to_string(t);
+                auto perlin = std::make_shared<PerlinNoise>(42);
+                auto simplex = std::make_shared<SimplexNoise>(42);
+                auto map = std::make_shared<NoiseMap>(size, size);
+                auto workspace = std::make_shared<PinkWorkspace>(size, size);
+                cases.push_back({ "perlin/" + sz + "/oct:6" + suffix, px, [=] {
+                    generate_perlin_into(*perlin, map->data(), map->stride(), size, size, 40.0f, 6, 1.0f, 0.5f, 2.0f, 0.0f, go);
+                }, true });
+                cases.push_back({ "simplex/" + sz + "/oct:6" + suffix, px, [=] {
+                    generate_simplex_into(*simplex, map->data(), map->stride(), size, size, 40.0f, 6, 0.5f, 2.0f, 0.0f, go);
+                }, true });
+                GenerateOptions integral = go;
+                integral.pinkEngine = PinkEngine::Integral;
+                GenerateOptions counter = go;
+                counter.rng = RngBackend::Counter;
+                for (const auto& pink : { std::make_pair(std::string(""), go), std::make_pair(std::string("/engine:integral"), integral),
+                         std::make_pair(std::string("/rng:counter"), counter) }) {
+                    const GenerateOptions po = pink.second;
+                    cases.push_back({ "pink/" + sz + "/oct:6" + pink.first + suffix, px, [=] {
+                        generate_pink_into(*workspace, map->data(), map->stride(), size, size, 6, 1.0f, 44100, 1.0f, 42, po);
+                    }, true });
+                }
+            }
+
+            for (int oct : pinkOctaveSweep) {
+                for (unsigned t : opt.threads) {
+                    GenerateOptions go;
+                    go.threads = t;
+                    cases.push_back({ "pink/" + sz + "/oct:" + std::to_string(oct) + "/threads:" + std::to_string(t), px, [=] {
+                        generate_pink_noisemap(size, size, oct, 1.0f, 44100, 1.0f, 42, go);
+                    } });
+                    GenerateOptions integral = go;
+                    integral.pinkEngine = PinkEngine::Integral;
+                    cases.push_back({ "pink/" + sz + "/oct:" + std::to_string(oct) + "/engine:integral/threads:" + std::to_string(t), px, [=] {
+                        generate_pink_noisemap(size, size, oct, 1.0f, 44100, 1.0f, 42, integral);
+                    } });
+                    cases.push_back({ "pink/" + sz + "/oct:" + std::to_string(oct) + "/storage:half/threads:" + std::to_string(t), px, [=] {
+                        generate_pink_halfmap(size, size, oct, 1.0f, 44100, 1.0f, 42, go);
+                    } });
+                    go.rng = RngBackend::Counter;
+                    cases.push_back({ "pink/" + sz + "/oct:" + std::to_string(oct) + "/rng:counter/threads:" + std::to_string(t), px, [=] {
+                        generate_pink_noisemap(size, size, oct, 1.0f, 44100, 1.0f, 42, go);
+                    } });
+                }
+            }
+
+            // Encoders only: the map is generated once, outside the timed loop
+            for (const char* ext : { "png", "jpg" }) {
+                const std::string file = std::string("bench_encode.") + ext;
+                cases.push_back({ std::string("encode/") + ext + "/" + sz, px, [=] {
+                    const NoiseMap& map = encode_input(size);
+                    MuteStdout mute;
+                    save_perlin_image(map, file, tmpDir.string());
+                } });
+            }
+            // High-precision heightmap output: 16-bit PNG and half-float EXR
+            {
+                ImageSaveOptions io;
+                io.bitDepth = 16;
+                cases.push_back({ "encode/png16/" + sz, px, [=] {
+                    save_noise_image(encode_input(size), "bench_encode16.png", tmpDir.string(), io);
+                } });
+                cases.push_back({ "encode/exr/" + sz, px, [=] {
+                    save_noise_image(encode_input(size), "bench_encode.exr", tmpDir.string());
+                } });
+            }
+            for (int level : { 1, 6 }) {
+                for (unsigned t : opt.threads) {
+                    ImageSaveOptions io;
+                    io.compressionLevel = level;
+                    io.threads = t;
+                    cases.push_back({ "encode/png/" + sz + "/level:" + std::to_string(level) + "/threads:" + std::to_string(t), px, [=] {
+                        const NoiseMap& map = encode_input(size);
+                        MuteStdout mute;
+                        save_perlin_image(map, "bench_encode.png", tmpDir.string(), io);
+                    } });
+                }
+            }
+
+            for (RawFormat format : { RawFormat::Float32, RawFormat::Float16 }) {
+                const std::string fmt = format == RawFormat::Float32 ? "f32" : "f16";
+                cases.push_back({ "encode/raw-" + fmt + "/" + sz, px, [=] {
+                    save_raw_map(encode_input(size), tmpDir / "bench_encode.rnm", format);
+                } });
+            }
+
+            // Generation and PNG encoding overlapped band by band, no full map in memory
+            cases.push_back({ "export/perlin-region-png/" + sz, px, [=] {
+                static const PerlinNoise generator(42);
+                PerlinParams params;
+                params.octaves = 4;
+                MuteStdout mute;
+                save_perlin_region_image(generator, params, 0, 0, size, size, "bench_export.png", tmpDir.string());
+            } });
+
+            // 64 maps with edge size / 8 over 8 seeds (same pixel count as one size x size map):
+            // one batch against one call per map
+            const int edge = std::max(16, size / 8);
+            const long long batchPx = 64LL * edge * edge;
+            const std::string batchName = "batch/" + std::to_string(edge) + "x" + std::to_string(edge) + "/jobs:64/mixed";
+            std::vector<BatchJob> jobs;
+            for (int i = 0; i < 64; ++i) {
+                PerlinParams perlin;
+                perlin.octaves = 4;
+                PinkParams pink;
+                pink.octaves = 4;
+                jobs.push_back(i % 4 == 3 ? BatchJob::pink(edge, edge, i % 8, pink) : BatchJob::perlin(edge, edge, i % 8, perlin));
+            }
+            for (unsigned t : opt.threads) {
+                BatchOptions bo;
+                bo.threads = t;
+                cases.push_back({ batchName + "/threads:" + std::to_string(t), batchPx, [=] {
+                    generate_batch(jobs, bo);
+                } });
+                GenerateOptions go;
+                go.threads = t;
+                cases.push_back({ batchName + "/loop/threads:" + std::to_string(t), batchPx, [=] {
+                    std::vector<NoiseMap> maps;
+                    for (const BatchJob& job : jobs) {
+                        if (job.kind == BatchNoise::Pink)
+                            maps.push_back(generate_pink_noisemap(edge, edge, 4, 1.0f, 44100, 1.0f, job.seed, go));
+                        else
+                            maps.push_back(generate_perlin_noisemap(edge, edge, 40.0f, 4, 1.0f, 0.5f, 2.0f, 0.0f, job.seed, go));
+                    }
+                } });
+            }
+        }
+        return cases;
+    }
+
+    void print_usage() {
+        std::printf(
+            "RelNoD_Bench [--filter=<substring>] [--sizes=256,1024,...] [--threads=1,2,...] [--min-time=<seconds>] [--isa=<tier>]\n"
+            "  --filter    run only cases whose name contains the substring (e.g. perlin/4096)\n"
+            "  --sizes     square map edges (default 256,1024,4096,8192)\n"
+            "  --threads   worker counts to sweep (default 1,2,4,... up to the core count)\n"
+            "  --min-time  minimum measured time per case (default 0.5)\n"
+            "  --isa       SIMD tier to dispatch on: scalar, sse2, avx2, avx512, neon (default: best supported)\n");
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* key) -> const char* {
+            std::size_t n = std::char_traits<char>::length(key);
+            return arg.compare(0, n, key) == 0 ? arg.c_str() + n : nullptr;
+        };
+        if (const char* v = value("--filter=")) opt.filter = v;
+        else if (const char* v = value("--sizes=")) {
+            opt.sizes.clear();
+            for (const auto& s : split(v)) opt.sizes.push_back(std::stoi(s));
+        }
+        else if (const char* v = value("--threads=")) {
+            opt.threads.clear();
+            for (const auto& s : split(v)) opt.threads.push_back(static_cast<unsigned>(std::stoul(s)));
+        }
+        else if (const char* v = value("--min-time=")) opt.minTime = std::stod(v);
+        else if (const char* v = value("--isa=")) opt.isa = v;
+        else {
+            print_usage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    if (!opt.isa.empty()) {
+        bool known = false;
+        for (Noise::SimdIsa isa : { Noise::SimdIsa::Scalar, Noise::SimdIsa::SSE2, Noise::SimdIsa::AVX2,
+                 Noise::SimdIsa::AVX512, Noise::SimdIsa::NEON }) {
+            if (opt.isa != Noise::simd_isa_name(isa)) continue;
+            known = true;
+            try {
+                Noise::force_simd_isa(isa);
+            }
+            catch (const std::invalid_argument& e) {
+                std::fprintf(stderr, "%s\n", e.what());
+                return 1;
+            }
+        }
+        if (!known) {
+            print_usage();
+            return 1;
+        }
+    }
+
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    if (opt.threads.empty()) {
+        for (unsigned t = 1; t < hw; t *= 2) opt.threads.push_back(t);
+        opt.threads.push_back(hw);
+    }
+
+    // Large enough for the biggest requested thread count, even beyond the core count
+    Noise::ThreadPool pool(*std::max_element(opt.threads.begin(), opt.threads.end()));
+    Noise::set_default_thread_pool(&pool);
+
+    const std::filesystem::path tmpDir = std::filesystem::temp_directory_path() / "relnod_bench";
+    std::filesystem::create_directories(tmpDir);
+
+    std::printf("RelNoD_Bench: %u hardware threads, SIMD tier %s\n", hw, Noise::simd_isa_name(Noise::active_simd_isa()));
+    std::printf("%-52s %12s %10s %10s %12s %12s\n", "Benchmark", "Time/iter", "Iterations", "Mpix/s", "Allocs/iter", "Bytes/iter");
+    std::printf("%s\n", std::string(113, '-').c_str());
+
+    bool ok = true;
+    for (const Case& c : build_cases(opt, tmpDir)) {
+        if (!opt.filter.empty() && c.name.find(opt.filter) == std::string::npos) continue;
+        ok = run_case(c, opt) && ok;
+    }
+
+    Noise::set_default_thread_pool(nullptr);
+    std::error_code ec;
+    std::filesystem::remove_all(tmpDir, ec);
+    return ok ? 0 : 1;
+}
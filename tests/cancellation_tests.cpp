@@ -0,0 +1,156 @@
+// cancellation_tests.cpp
+// ----------------------
+// RelNoD_CancellationTests: cooperative cancellation (Cancellation.hpp,
+// Async.hpp). Cancelled calls must throw GenerationCancelled itself, also from
+// batches and from work running on pool workers, and cancelled exports must not
+// leave partial files behind. Prints one line per check and exits non-zero
+// when any of them fails.
+//
+// Usage:
+//   ctest -R Cancellation --output-on-failure
+//   RelNoD_CancellationTests                   // from the build directory
+
+#include "Noise.hpp"
+#include "Async.hpp"
+#include "Cancellation.hpp"
+#include "NoiseBatch.hpp"
+#include "ThreadPool.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using namespace Noise;
+    using Clock = std::chrono::steady_clock;
+
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void check(bool ok, const std::string& what) {
+        ++g_checks;
+        if (!ok) ++g_failures;
+        std::printf("%s %s\n", ok ? "[ ok ]" : "[FAIL]", what.c_str());
+    }
+
+    // "cancelled" when fn throws GenerationCancelled, otherwise what happened instead
+    template <typename Fn>
+    std::string outcome(Fn&& fn) {
+        try {
+            fn();
+            return "returned";
+        }
+        catch (const GenerationCancelled&) {
+            return "cancelled";
+        }
+        catch (const std::exception& e) {
+            return std::string("threw: ") + e.what();
+        }
+    }
+
+    std::vector<BatchJob> large_batch() {
+        PerlinParams params;
+        params.octaves = 8;
+        std::vector<BatchJob> jobs;
+        for (int seed = 0; seed < 64; ++seed) jobs.push_back(BatchJob::perlin(1024, 1024, seed, params));
+        return jobs;
+    }
+
+    // ---------------------------------------------------------
+    // Async batches
+    // ---------------------------------------------------------
+    void test_async_batch(ThreadPool& pool) {
+        const std::vector<BatchJob> jobs = large_batch();
+        BatchOptions options;
+        options.pool = &pool;
+
+        AsyncOptions async;
+        async.pool = &pool;
+        AsyncResult<std::vector<BatchResult>> result = generate_async([&] { return generate_batch(jobs, options); }, async);
+        // Let the batch get going on every worker before cancelling it
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        const Clock::time_point cancelled = Clock::now();
+        result.cancel();
+        const std::string got = outcome([&] { result.get(); });
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - cancelled).count();
+        check(got == "cancelled", "cancelled async batch throws GenerationCancelled (" + got + ")");
+        std::printf("       returned %.1f ms after cancel()\n", ms);
+
+        AsyncResult<std::vector<BatchResult>> queued = generate_async([&] { return generate_batch(jobs, options); }, async);
+        queued.cancel();
+        const std::string early = outcome([&] { queued.get(); });
+        check(early == "cancelled", "async batch cancelled right away throws GenerationCancelled (" + early + ")");
+    }
+
+    // ---------------------------------------------------------
+    // Work claimed by pool workers
+    // ---------------------------------------------------------
+    void test_pool_workers_see_token(ThreadPool& pool) {
+        // Every participant runs a whole map; the workers' maps are only
+        // cancelled when ThreadPool::run hands them the caller's token
+        CancelToken token;
+        token.cancel();
+        const CancelScope scope(token);
+        std::vector<std::string> results(pool.size());
+        pool.run(pool.size(), [&](unsigned w) {
+            GenerateOptions serial;
+            serial.threads = 1;
+            results[w] = outcome([&] { generate_perlin_noisemap(512, 512, 40.0f, 6, 1.0f, 0.5f, 2.0f, 0.0f, 1, serial); });
+        });
+        bool all = true;
+        for (const std::string& r : results) {
+            if (!r.empty() && r != "cancelled") all = false;
+        }
+        check(all, "generators on pool workers see the caller's token");
+    }
+
+    // ---------------------------------------------------------
+    // Exports
+    // ---------------------------------------------------------
+    void test_exports(const std::filesystem::path& dir) {
+        PerlinNoise perlin(3);
+        PerlinParams params;
+        CancelToken token;
+        token.cancel();
+        const CancelScope scope(token);
+
+        for (const char* name : { "region.png", "region.exr" }) {
+            const std::string got = outcome([&] { save_perlin_region_image(perlin, params, 0, 0, 512, 512, name, dir.string()); });
+            check(got == "cancelled", std::string("cancelled ") + name + " export throws GenerationCancelled (" + got + ")");
+            check(!std::filesystem::exists(dir / name), std::string("cancelled ") + name + " export leaves no file");
+        }
+
+        const NoiseMap map(256, 256);
+        const std::string exr = outcome([&] { save_noise_image(map, "map.exr", dir.string()); });
+        check(exr == "cancelled", "cancelled save_noise_image .exr throws GenerationCancelled (" + exr + ")");
+        check(!std::filesystem::exists(dir / "map.exr"), "cancelled save_noise_image .exr leaves no file");
+    }
+
+} // namespace
+
+int main() {
+    set_log_stream(nullptr);
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "relnod_cancellation_tests";
+    std::filesystem::create_directories(dir);
+
+    try {
+        ThreadPool pool(4); // real workers even on a single-core machine
+        test_async_batch(pool);
+        test_pool_workers_see_token(pool);
+        test_exports(dir);
+    }
+    catch (const std::exception& e) {
+        std::printf("[FAIL] unexpected exception: %s\n", e.what());
+        ++g_failures;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    std::printf("%d checks, %d failed\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,446 @@
+// consistency_tests.cpp
+// ---------------------
+// RelNoD_ConsistencyTests: checks the library's bit-identity guarantees, i.e.
+// that every SIMD tier, thread count and tile size, and every alternative path
+// to a map (regions, tiled .rnm files, octave layers, progressive previews,
+// batches, noise graphs), produce exactly the maps of the plain serial calls.
+// Prints one line per check and exits non-zero when any of them fails.
+//
+// Usage:
+//   ctest -R Consistency --output-on-failure
+//   RelNoD_ConsistencyTests                    // from the build directory
+
+#include "Noise.hpp"
+#include "CpuFeatures.hpp"
+#include "CounterRng.hpp"
+#include "HalfFloat.hpp"
+#include "ImageOutput.hpp"
+#include "NoiseBatch.hpp"
+#include "NoiseGraph.hpp"
+#include "OctaveLayers.hpp"
+#include "ProgressiveNoise.hpp"
+#include "RawMap.hpp"
+#include "ThreadPool.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace Noise;
+
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void check(bool ok, const std::string& what) {
+        ++g_checks;
+        if (!ok) ++g_failures;
+        std::printf("%s %s\n", ok ? "[ ok ]" : "[FAIL]", what.c_str());
+    }
+
+    bool same(const NoiseMap& a, const NoiseMap& b) {
+        if (a.width() != b.width() || a.height() != b.height()) return false;
+        for (int y = 0; y < a.height(); ++y) {
+            if (std::memcmp(a.row(y).data(), b.row(y).data(), sizeof(float) * static_cast<std::size_t>(a.width())) != 0)
+                return false;
+        }
+        return true;
+    }
+
+    // Map sizes are odd on purpose: partial tiles, partial SIMD lanes and short chunks
+    constexpr int kWidth = 301;
+    constexpr int kHeight = 77;
+
+    // ---------------------------------------------------------
+    // SIMD tiers
+    // ---------------------------------------------------------
+    // Everything a kernel table dispatches, serialized to bytes
+    std::vector<unsigned char> dispatched_outputs() {
+        std::vector<unsigned char> out;
+        auto put = [&](const void* p, std::size_t n) {
+            const unsigned char* c = static_cast<const unsigned char*>(p);
+            out.insert(out.end(), c, c + n);
+        };
+        auto putMap = [&](const NoiseMap& m) {
+            for (int y = 0; y < m.height(); ++y) put(m.row(y).data(), sizeof(float) * static_cast<std::size_t>(m.width()));
+        };
+
+        GenerateOptions serial;
+        serial.threads = 1;
+        putMap(generate_perlin_noisemap(kWidth, kHeight, 20.0f, 5, 1.0f, 0.5f, 2.0f, 0.0f, 3, serial)); // preset
+        putMap(generate_perlin_noisemap(kWidth, kHeight, 20.0f, 3, 1.0f, 0.6f, 2.0f, 0.0f, 3, serial)); // runtime loop
+        putMap(generate_simplex_noisemap(kWidth, kHeight, 20.0f, 5, 0.5f, 2.0f, 0.0f, 3, serial));
+        putMap(generate_simplex_noisemap(kWidth, kHeight, 20.0f, 3, 0.6f, 2.1f, 0.0f, 3, serial));
+        putMap(generate_perlin_tileable_noisemap(kWidth, kHeight, 20.0f, 4, 1.0f, 0.5f, 2.0f, 0.0f, 3, serial));
+        putMap(generate_simplex_tileable_noisemap(kWidth, kHeight, 20.0f, 4, 0.5f, 2.0f, 0.0f, 3, serial));
+        for (PinkEngine engine : { PinkEngine::Integral, PinkEngine::BlockGrid }) {
+            for (RngBackend rng : { RngBackend::Mt19937, RngBackend::Counter }) {
+                GenerateOptions pink = serial;
+                pink.pinkEngine = engine;
+                pink.rng = rng;
+                putMap(generate_pink_noisemap(kWidth, kHeight, 6, 1.0f, 44100, 1.3f, 7, pink));
+            }
+        }
+        GenerateOptions compact = serial;
+        compact.rng = RngBackend::Counter;
+        compact.pinkStorage = PinkStorage::Compact;
+        putMap(generate_pink_noisemap(kWidth, kHeight, 6, 1.0f, 44100, 1.3f, 7, compact));
+        GenerateOptions counter = serial;
+        counter.rng = RngBackend::Counter;
+        putMap(WhiteNoise::generate_map(kWidth, kHeight, 5, counter));
+
+        // Quantizers and conversions, with the special values
+        std::vector<float> values(1003);
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> dist(-0.5f, 1.5f);
+        for (float& v : values) v = dist(rng);
+        values[3] = NAN;
+        values[5] = -0.0f;
+        values[7] = 1.0f;
+        values[9] = 0.99999f;
+        values[11] = INFINITY;
+        values[13] = -INFINITY;
+        std::vector<std::uint8_t> unorm8(values.size());
+        std::vector<std::uint16_t> unorm16(values.size());
+        std::vector<std::uint8_t> unorm16be(values.size() * 2);
+        std::vector<std::uint16_t> halves(values.size());
+        std::vector<float> back(values.size());
+        quantize_unorm8(values.data(), unorm8.data(), values.size());
+        quantize_unorm16(values.data(), unorm16.data(), values.size());
+        quantize_unorm16_be(values.data(), unorm16be.data(), values.size());
+        floats_to_halves(values.data(), halves.data(), values.size());
+        halves_to_floats(halves.data(), back.data(), values.size());
+        put(unorm8.data(), unorm8.size());
+        put(unorm16.data(), unorm16.size() * 2);
+        put(unorm16be.data(), unorm16be.size());
+        put(halves.data(), halves.size() * 2);
+        put(back.data(), back.size() * sizeof(float));
+        std::vector<float> uniform(1003);
+        counter_uniform_row(9, 4, 17, uniform.data(), uniform.size());
+        put(uniform.data(), uniform.size() * sizeof(float));
+        return out;
+    }
+
+    void test_simd_tiers() {
+        force_simd_isa(SimdIsa::Scalar);
+        const std::vector<unsigned char> reference = dispatched_outputs();
+        for (SimdIsa isa : { SimdIsa::SSE2, SimdIsa::AVX2, SimdIsa::AVX512, SimdIsa::NEON }) {
+            if (!simd_isa_supported(isa)) continue;
+            force_simd_isa(isa);
+            check(dispatched_outputs() == reference, std::string("simd tier ") + simd_isa_name(isa) + " == scalar");
+        }
+        force_simd_isa(best_simd_isa());
+    }
+
+    // ---------------------------------------------------------
+    // Threads and tiles
+    // ---------------------------------------------------------
+    void test_threads_and_tiles() {
+        ThreadPool pool(8); // real workers even on a single-core machine
+        GenerateOptions serial;
+        serial.threads = 1;
+        const NoiseMap perlin = generate_perlin_noisemap(kWidth, kHeight, 20.0f, 6, 1.0f, 0.55f, 2.0f, 0.5f, 3, serial);
+        const NoiseMap perlinPreset = generate_perlin_noisemap(kWidth, kHeight, 20.0f, 6, 1.0f, 0.5f, 2.0f, 0.5f, 3, serial);
+        const NoiseMap simplex = generate_simplex_noisemap(kWidth, kHeight, 20.0f, 6, 0.5f, 2.0f, 0.5f, 3, serial);
+        GenerateOptions counterSerial = serial;
+        counterSerial.rng = RngBackend::Counter;
+        const NoiseMap pink = generate_pink_noisemap(kWidth, kHeight, 6, 1.0f, 44100, 1.0f, 7, counterSerial);
+        const NoiseMap pinkMt = generate_pink_noisemap(kWidth, kHeight, 6, 1.0f, 44100, 1.0f, 7, serial);
+
+        for (unsigned threads : { 2u, 3u, 8u }) {
+            for (int tileSize : { 17, 64, 1000 }) {
+                for (OctaveMode mode : { OctaveMode::Layered, OctaveMode::Fused }) {
+                    GenerateOptions o;
+                    o.threads = threads;
+                    o.tileSize = tileSize;
+                    o.pool = &pool;
+                    o.octaveMode = mode;
+                    const std::string tag = " threads " + std::to_string(threads) + " tile " + std::to_string(tileSize) +
+                        (mode == OctaveMode::Fused ? " fused" : " layered");
+                    check(same(generate_perlin_noisemap(kWidth, kHeight, 20.0f, 6, 1.0f, 0.55f, 2.0f, 0.5f, 3, o), perlin), "perlin" + tag);
+                    check(same(generate_perlin_noisemap(kWidth, kHeight, 20.0f, 6, 1.0f, 0.5f, 2.0f, 0.5f, 3, o), perlinPreset), "perlin preset" + tag);
+                    check(same(generate_simplex_noisemap(kWidth, kHeight, 20.0f, 6, 0.5f, 2.0f, 0.5f, 3, o), simplex), "simplex" + tag);
+                }
+                GenerateOptions o;
+                o.threads = threads;
+                o.tileSize = tileSize;
+                o.pool = &pool;
+                o.rng = RngBackend::Counter;
+                const std::string tag = " threads " + std::to_string(threads) + " tile " + std::to_string(tileSize);
+                check(same(generate_pink_noisemap(kWidth, kHeight, 6, 1.0f, 44100, 1.0f, 7, o), pink), "pink counter" + tag);
+                o.rng = RngBackend::Mt19937;
+                check(same(generate_pink_noisemap(kWidth, kHeight, 6, 1.0f, 44100, 1.0f, 7, o), pinkMt), "pink mt19937" + tag);
+            }
+        }
+    }
+
+    // ---------------------------------------------------------
+    // Regions, tiled .rnm files and raw round trips
+    // ---------------------------------------------------------
+    void test_regions_and_raw(const std::filesystem::path& dir) {
+        PerlinNoise perlin(11);
+        PerlinParams pp;
+        pp.scale = 37.0f;
+        pp.octaves = 6;
+        SimplexNoise simplex(4);
+        SimplexParams sp;
+        sp.scale = 50.0f;
+        sp.octaves = 5;
+
+        const NoiseMap perlinMap = generate_perlin_noisemap(kWidth, kHeight, pp.scale, pp.octaves, pp.frequency, pp.persistence, pp.lacunarity, pp.base, 11);
+        check(same(generate_perlin_region(perlin, pp, 0, 0, kWidth, kHeight), perlinMap), "perlin region at origin == map");
+
+        // Overlapping windows agree on their shared pixels
+        const NoiseMap wide = generate_perlin_region(perlin, pp, -100, 40, 300, 100);
+        const NoiseMap inner = generate_perlin_region(perlin, pp, -37, 55, 120, 60);
+        bool overlap = true;
+        for (int y = 0; y < inner.height(); ++y) {
+            if (std::memcmp(inner.row(y).data(), wide.row(y + 15).data() + 63, sizeof(float) * static_cast<std::size_t>(inner.width())) != 0)
+                overlap = false;
+        }
+        check(overlap, "perlin regions agree where they overlap");
+
+        const NoiseMap perlinRegion = generate_perlin_region(perlin, pp, -37, 55, 500, 300);
+        save_perlin_tiled_raw(perlin, pp, -37, 55, 500, 300, (dir / "perlin.rnm").string(), "", { 128, 96 });
+        check(same(load_raw_map(dir / "perlin.rnm"), perlinRegion), "perlin tiled .rnm == region");
+        check(same(MappedRawMap::open(dir / "perlin.rnm").read_region(100, 50, 200, 100),
+            generate_perlin_region(perlin, pp, 63, 105, 200, 100)), "perlin tiled .rnm read_region == region");
+
+        const NoiseMap simplexRegion = generate_simplex_region(simplex, sp, 1000, -2000, 333, 211);
+        save_simplex_tiled_raw(simplex, sp, 1000, -2000, 333, 211, (dir / "simplex.rnm").string(), "", { 100, 100 });
+        check(same(load_raw_map(dir / "simplex.rnm"), simplexRegion), "simplex tiled .rnm == region");
+
+        GenerateOptions compact;
+        compact.rng = RngBackend::Counter;
+        compact.pinkStorage = PinkStorage::Compact;
+        save_pink_tiled_raw(333, 211, 6, 1.2f, 44100, 1.0f, 9, (dir / "pink.rnm").string(), "", { 96, 96 });
+        check(same(load_raw_map(dir / "pink.rnm"), generate_pink_noisemap(333, 211, 6, 1.2f, 44100, 1.0f, 9, compact)),
+            "pink tiled .rnm == compact counter map");
+
+        save_raw_map(perlinMap, dir / "map.rnm");
+        check(same(load_raw_map(dir / "map.rnm"), perlinMap), "float32 .rnm round trip");
+        const MappedRawMap view = MappedRawMap::open(dir / "map.rnm");
+        bool samples = true;
+        for (int y = 0; y < kHeight; ++y) {
+            for (int x = 0; x < kWidth; ++x) {
+                if (view.sample(x, y) != perlinMap.row(y)[x]) samples = false;
+            }
+        }
+        check(samples, "mapped .rnm sample == map");
+        save_raw_map(perlinMap, dir / "map16.rnm", RawFormat::Float16);
+        const NoiseMap halfMap = load_raw_map(dir / "map16.rnm");
+        bool halfExact = true;
+        for (int y = 0; y < kHeight; ++y) {
+            for (int x = 0; x < kWidth; ++x) {
+                if (halfMap.row(y)[x] != half_to_float(float_to_half(perlinMap.row(y)[x]))) halfExact = false;
+            }
+        }
+        check(halfExact, "float16 .rnm round trip == half rounding");
+
+        // 2 x 2 tiles of 2^30 x 2^30 float32 samples: 2^64 payload bytes, 0 once wrapped
+        std::vector<char> bytes(64 + sizeof(float));
+        std::ifstream(dir / "perlin.rnm", std::ios::binary).read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        const auto put_u32 = [&](std::size_t at, std::uint32_t v) {
+            for (int i = 0; i < 4; ++i) bytes[at + i] = static_cast<char>((v >> (8 * i)) & 0xFFu);
+        };
+        put_u32(8, 0x7FFFFFFFu);
+        put_u32(12, 0x7FFFFFFFu);
+        put_u32(24, 0x40000000u);
+        put_u32(28, 0x40000000u);
+        std::ofstream(dir / "crafted.rnm", std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        bool rejected = false;
+        try {
+            MappedRawMap::open(dir / "crafted.rnm");
+        }
+        catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        check(rejected, "tiled .rnm header whose payload size wraps is rejected");
+    }
+
+    // ---------------------------------------------------------
+    // Octave layers and progressive previews
+    // ---------------------------------------------------------
+    void test_layers_and_progressive() {
+        PerlinNoise perlin(42);
+        SimplexNoise simplex(42);
+
+        const OctaveLayers<PerlinNoise> perlinLayers(perlin, kWidth, kHeight, 7, 37.0f, 1.3f, 2.1f, 3.5f);
+        bool perlinOk = true;
+        for (float persistence : { 0.0f, 0.5f, 0.77f, 1.0f }) {
+            for (int octaves : { 1, 4, 7 }) {
+                if (!same(perlinLayers.compose(persistence, octaves),
+                    generate_perlin_noisemap(kWidth, kHeight, 37.0f, octaves, 1.3f, persistence, 2.1f, 3.5f, 42)))
+                    perlinOk = false;
+            }
+        }
+        check(perlinOk, "perlin octave layers == map");
+
+        const OctaveLayers<SimplexNoise> simplexLayers(simplex, kWidth, kHeight, 5, 50.0f, 1.0f, 2.0f, -4.0f);
+        bool simplexOk = true;
+        for (float persistence : { 0.2f, 0.5f, 0.9f }) {
+            if (!same(simplexLayers.compose(persistence), generate_simplex_noisemap(kWidth, kHeight, 50.0f, 5, persistence, 2.0f, -4.0f, 42)))
+                simplexOk = false;
+        }
+        check(simplexOk, "simplex octave layers == map");
+
+        const PinkLayers pinkLayers(kWidth, kHeight, 6, 44100, 7);
+        bool pinkOk = true;
+        for (float alpha : { 0.0f, 1.0f, 2.0f }) {
+            for (float amplitude : { 1.0f, 0.7f }) {
+                if (!same(pinkLayers.compose(alpha, amplitude), generate_pink_noisemap(kWidth, kHeight, 6, alpha, 44100, amplitude, 7)))
+                    pinkOk = false;
+            }
+        }
+        check(pinkOk, "pink layers == map");
+
+        PerlinParams pp;
+        pp.scale = 37.0f;
+        pp.octaves = 6;
+        pp.frequency = 1.3f;
+        pp.base = 3.5f;
+        ProgressiveNoise progressive(perlin, kWidth, kHeight, pp);
+        progressive.finish();
+        check(same(progressive.preview(), generate_perlin_noisemap(kWidth, kHeight, 37.0f, 6, 1.3f, 0.5f, 2.0f, 3.5f, 42)),
+            "progressive perlin == map");
+        pp.persistence = 0.63f;
+        progressive.set_params(pp);
+        check(same(progressive.preview(), generate_perlin_noisemap(kWidth, kHeight, 37.0f, 6, 1.3f, 0.63f, 2.0f, 3.5f, 42)),
+            "progressive perlin re-weighted == map");
+
+        SimplexParams sp;
+        sp.scale = 50.0f;
+        sp.octaves = 3;
+        sp.persistence = 0.7f;
+        sp.lacunarity = 2.2f;
+        ProgressiveOptions po;
+        po.coarseLevels = 3;
+        po.octavesPerStep = 2;
+        ProgressiveNoise progressiveSimplex(simplex, kWidth, kHeight, sp, po);
+        progressiveSimplex.finish();
+        check(same(progressiveSimplex.preview(), generate_simplex_noisemap(kWidth, kHeight, 50.0f, 3, 0.7f, 2.2f, 0.0f, 42)),
+            "progressive simplex == map");
+    }
+
+    // ---------------------------------------------------------
+    // Batches and noise graphs
+    // ---------------------------------------------------------
+    void test_batch_and_graph(const std::filesystem::path& dir) {
+        PerlinParams pp;
+        pp.octaves = 4;
+        SimplexParams sp;
+        sp.octaves = 3;
+        PinkParams kp;
+        kp.octaves = 5;
+
+        std::vector<BatchJob> jobs;
+        std::vector<NoiseMap> expected;
+        for (int s = 0; s < 4; ++s) {
+            jobs.push_back(BatchJob::perlin(97 + s * 13, 61, s % 3, pp));
+            expected.push_back(generate_perlin_noisemap(97 + s * 13, 61, pp.scale, pp.octaves, pp.frequency, pp.persistence, pp.lacunarity, pp.base, s % 3));
+            jobs.push_back(BatchJob::simplex(64, 80 + s, s % 2, sp));
+            expected.push_back(generate_simplex_noisemap(64, 80 + s, sp.scale, sp.octaves, sp.persistence, sp.lacunarity, sp.base, s % 2));
+            jobs.push_back(BatchJob::pink(50 + s, 70, s, kp));
+            expected.push_back(generate_pink_noisemap(50 + s, 70, kp.octaves, kp.alpha, kp.sampleRate, kp.amplitude, s));
+            jobs.push_back(BatchJob::white(33, 17 + s, s));
+            expected.push_back(WhiteNoise::generate_map(33, 17 + s, s));
+        }
+        jobs.push_back(BatchJob::pink(200, 100, 5, kp, "batch_pink.rnm"));
+        jobs.back().outputDir = dir.string();
+        const NoiseMap pinkFile = generate_pink_noisemap(200, 100, kp.octaves, kp.alpha, kp.sampleRate, kp.amplitude, 5);
+
+        for (unsigned threads : { 1u, 3u }) {
+            ThreadPool pool(threads);
+            BatchOptions options;
+            options.pool = &pool;
+            options.threads = threads;
+            const std::vector<BatchResult> results = generate_batch(jobs, options);
+            bool ok = true;
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                if (!same(results[i].map, expected[i])) ok = false;
+            }
+            ok = ok && same(load_raw_map(results.back().file), pinkFile);
+            check(ok, "batch == single calls, threads " + std::to_string(threads));
+        }
+
+        PerlinNoise perlin(11);
+        PerlinParams gp;
+        gp.scale = 37.0f;
+        gp.octaves = 6;
+        gp.persistence = 0.6f;
+        gp.base = 3.0f;
+        SimplexNoise simplex(5);
+        SimplexParams gs;
+        gs.scale = 50.0f;
+        gs.octaves = 5;
+        {
+            NoiseGraph graph;
+            graph.perlin(perlin, gp);
+            GenerateOptions o;
+            o.tileSize = 37;
+            check(same(graph.generate(-37, 55, 300, 200, o), generate_perlin_region(perlin, gp, -37, 55, 300, 200)), "graph perlin == region");
+        }
+        {
+            NoiseGraph graph;
+            graph.simplex(simplex, gs);
+            check(same(graph.generate(100, -20, 300, 200), generate_simplex_region(simplex, gs, 100, -20, 300, 200)), "graph simplex == region");
+        }
+        {
+            NoiseGraph graph;
+            PinkParams pink;
+            pink.octaves = 5;
+            graph.pink(500, 400, pink, 3);
+            NoiseMap reference(120, 90);
+            generate_pink_region_into(reference.data(), reference.stride(), 500, 400, 30, 40, 120, 90, 5, 1.0f, 44100, 1.0f, 3);
+            GenerateOptions o;
+            o.tileSize = 32;
+            check(same(graph.generate(30, 40, 120, 90, o), reference), "graph pink == pink region");
+        }
+        {
+            // Constant 0.5 offsets leave the warp at the source's own pixels
+            NoiseGraph graph;
+            const NoiseGraph::Node source = graph.perlin(perlin, gp);
+            const NoiseGraph::Node half = graph.constant(0.5f);
+            graph.warp(source, half, half, 40.0f);
+            check(same(graph.generate(0, 0, 200, 100), generate_perlin_region(perlin, gp, 0, 0, 200, 100)), "graph identity warp == region");
+            const NoiseGraph::Node offset = graph.simplex(simplex, gs);
+            graph.set_output(graph.blend(graph.warp(source, offset, offset, 40.0f), graph.ridged(source), graph.normalize(source, 0.2f, 0.8f)));
+            GenerateOptions o;
+            o.tileSize = 19;
+            check(same(graph.generate(-10, -10, 260, 140), graph.generate(-10, -10, 260, 140, o)), "graph output independent of tile size");
+        }
+    }
+
+} // namespace
+
+int main() {
+    set_log_stream(nullptr);
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "relnod_consistency_tests";
+    std::filesystem::create_directories(dir);
+
+    try {
+        test_simd_tiers();
+        test_threads_and_tiles();
+        test_regions_and_raw(dir);
+        test_layers_and_progressive();
+        test_batch_and_graph(dir);
+    }
+    catch (const std::exception& e) {
+        std::printf("[FAIL] unexpected exception: %s\n", e.what());
+        ++g_failures;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    std::printf("%d checks, %d failed\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
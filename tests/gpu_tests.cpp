@@ -0,0 +1,115 @@
+// gpu_tests.cpp
+// -------------
+// RelNoD_GpuTests: the OpenCL backend (GpuNoise.hpp) against the CPU region
+// generators. On a bit_exact() device every map must equal generate_*_region
+// bit for bit, elsewhere agree within |gpu - cpu| <= 2e-7. Passes without
+// checks when the machine has no OpenCL device. Prints one line per check and
+// exits non-zero when any of them fails.
+//
+// Usage:
+//   cmake -DBUILD_GPU=ON ...; ctest -R Gpu --output-on-failure
+//   RelNoD_GpuTests                            // from the build directory
+
+#include "Noise.hpp"
+#include "GpuNoise.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace Noise;
+
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void check(bool ok, const std::string& what) {
+        ++g_checks;
+        if (!ok) ++g_failures;
+        std::printf("%s %s\n", ok ? "[ ok ]" : "[FAIL]", what.c_str());
+    }
+
+    constexpr float kTolerance = 2e-7f;
+
+    // Bit for bit on exact devices, within kTolerance elsewhere
+    void check_map(const GpuContext& gpu, const NoiseMap& got, const NoiseMap& want, const std::string& what) {
+        if (got.width() != want.width() || got.height() != want.height()) {
+            check(false, what + " (size differs)");
+            return;
+        }
+        bool identical = true;
+        float worst = 0.0f;
+        for (int y = 0; y < want.height(); ++y) {
+            const float* g = got.row(y).data();
+            const float* w = want.row(y).data();
+            if (std::memcmp(g, w, sizeof(float) * static_cast<std::size_t>(want.width())) != 0) identical = false;
+            for (int x = 0; x < want.width(); ++x) worst = std::max(worst, std::fabs(g[x] - w[x]));
+        }
+        if (gpu.bit_exact()) check(identical, what + " == CPU region");
+        else check(worst <= kTolerance, what + " within 2e-7 of the CPU region (max " + std::to_string(worst) + ")");
+    }
+
+    // Odd sizes and negative origins: partial work groups and the int64 position path
+    struct Window {
+        std::int64_t x, y;
+        int width, height;
+    };
+    const Window kWindows[] = { { 0, 0, 301, 77 }, { -1037, 2055, 257, 129 } };
+
+    void test_perlin(const GpuContext& gpu) {
+        const PerlinNoise perlin(11);
+        const GpuPerlin gpuPerlin(gpu, perlin);
+        PerlinParams params;
+        params.scale = 37.0f;
+        params.octaves = 6;
+        params.base = 0.25f;
+        for (const Window& w : kWindows) {
+            check_map(gpu, gpuPerlin.generate_region(params, w.x, w.y, w.width, w.height).download(),
+                generate_perlin_region(perlin, params, w.x, w.y, w.width, w.height),
+                "perlin " + std::to_string(w.width) + "x" + std::to_string(w.height) + " at (" + std::to_string(w.x) + ", " + std::to_string(w.y) + ")");
+        }
+    }
+
+    void test_simplex(const GpuContext& gpu) {
+        const SimplexNoise simplex(4);
+        const GpuSimplex gpuSimplex(gpu, simplex);
+        SimplexParams params;
+        params.scale = 50.0f;
+        params.octaves = 5;
+        params.persistence = 0.6f;
+        for (const Window& w : kWindows) {
+            check_map(gpu, gpuSimplex.generate_region(params, w.x, w.y, w.width, w.height).download(),
+                generate_simplex_region(simplex, params, w.x, w.y, w.width, w.height),
+                "simplex " + std::to_string(w.width) + "x" + std::to_string(w.height) + " at (" + std::to_string(w.x) + ", " + std::to_string(w.y) + ")");
+        }
+    }
+
+} // namespace
+
+int main() {
+    set_log_stream(nullptr);
+    try {
+        const std::vector<std::string> devices = GpuContext::devices();
+        if (devices.empty()) {
+            std::printf("no OpenCL device, skipped\n");
+            return 0;
+        }
+        const GpuContext gpu;
+        std::printf("device %s (%s)\n", gpu.device_name().c_str(), gpu.bit_exact() ? "bit exact" : "within 2e-7");
+        test_perlin(gpu);
+        test_simplex(gpu);
+    }
+    catch (const std::exception& e) {
+        std::printf("[FAIL] unexpected exception: %s\n", e.what());
+        ++g_failures;
+    }
+
+    std::printf("%d checks, %d failed\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}